@@ -64,6 +64,13 @@ void ZipOutputStream::putNextEntry(const std::string& entryName) {
 }
 
 
+void ZipOutputStream::putRawEntry( const std::string &entryName, StorageMethod method,
+                                   const char *data, uint32 compressed_size,
+                                   uint32 size, uint32 crc ) {
+  ozf->putRawEntry( ZipCDirEntry( entryName ), method, data, compressed_size, size, crc ) ;
+}
+
+
 void ZipOutputStream::setComment( const std::string &comment ) {
   ozf->setComment( comment ) ;
 }
@@ -54,6 +54,13 @@ public:
   */
   void putNextEntry(const std::string& entryName);
 
+  /** Writes a complete entry with already compressed data.
+      @see ZipOutputStreambuf::putRawEntry()
+  */
+  void putRawEntry( const std::string &entryName, StorageMethod method,
+                    const char *data, uint32 compressed_size,
+                    uint32 size, uint32 crc ) ;
+
   /** Sets the global comment for the Zip archive. */
   void setComment( const std::string& comment ) ;
 
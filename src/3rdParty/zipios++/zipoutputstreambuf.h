@@ -49,6 +49,18 @@ public:
       entry. */
   void putNextEntry( const ZipCDirEntry &entry ) ;
 
+  /** Writes a complete entry whose data has already been prepared by
+      the caller, i.e. compressed with raw deflate if method is DEFLATED,
+      or the plain data if method is STORED. Closes the current entry
+      (if one is open).
+      @param data the (compressed) entry data.
+      @param compressed_size the number of bytes in data.
+      @param size the size of the uncompressed data.
+      @param crc the CRC32 of the uncompressed data. */
+  void putRawEntry( const ZipCDirEntry &entry, StorageMethod method,
+                    const char *data, uint32 compressed_size,
+                    uint32 size, uint32 crc ) ;
+
   /** Sets the global comment for the Zip archive. */
   void setComment( const string &comment ) ;
 
@@ -2124,6 +2124,7 @@ void Application::initTypes()
     App::FeatureTestAbsAddress     ::init();
     App::FeatureTestPlacement      ::init();
     App::FeatureTestAttribute      ::init();
+    App::FeatureTestParallel       ::init();
 
     // Feature class
     App::FeaturePython             ::init();
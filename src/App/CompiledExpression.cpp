@@ -0,0 +1,1049 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/***************************************************************************
+ *   This file is part of FreeCAD.                                         *
+ *                                                                         *
+ *   FreeCAD is free software: you can redistribute it and/or modify it    *
+ *   under the terms of the GNU Lesser General Public License as           *
+ *   published by the Free Software Foundation, either version 2.1 of the  *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   FreeCAD is distributed in the hope that it will be useful, but        *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with FreeCAD. If not, see                               *
+ *   <https://www.gnu.org/licenses/>.                                      *
+ *                                                                         *
+ **************************************************************************/
+
+#include "PreCompiled.h"
+
+#include <boost/math/special_functions/round.hpp>
+#include <boost/math/special_functions/trunc.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numbers>
+
+#include <Base/Exception.h>
+#include <Base/Interpreter.h>
+#include <Base/Tools.h>
+
+#include "CompiledExpression.h"
+#include "ExpressionParser.h"
+#include "Property.h"
+
+
+using namespace App;
+using Base::Quantity;
+using Base::Unit;
+
+namespace
+{
+
+using Value = CompiledExpression::Value;
+
+// Integers up to this magnitude convert to double without rounding
+constexpr long long maxExactInteger = 1LL << std::numeric_limits<double>::digits;
+
+bool isExact(long value)
+{
+    return value >= -maxExactInteger && value <= maxExactInteger;
+}
+
+// The value of a number or unit node, the same as pyFromQuantity()
+bool fromQuantity(const Quantity& quantity, Value& value)
+{
+    if (!quantity.getUnit().isEmpty()) {
+        value = quantity;
+        return true;
+    }
+    double num = quantity.getValue();
+    double intpart {};
+    if (std::modf(num, &intpart) == 0.0) {
+        if (intpart >= std::numeric_limits<int>::min()
+            && intpart <= std::numeric_limits<int>::max()) {
+            value = static_cast<long>(intpart);
+            return true;
+        }
+        if (intpart < 0.0 && intpart >= static_cast<double>(std::numeric_limits<long>::min())) {
+            value = static_cast<long>(intpart);
+            return true;
+        }
+        if (intpart > 0.0 && intpart <= static_cast<double>(std::numeric_limits<long>::max())) {
+            // pyFromQuantity() truncates these to int, leave them to Python
+            return false;
+        }
+    }
+    value = num;
+    return true;
+}
+
+bool fromAny(const boost::any& any, Value& value)
+{
+    if (any.type() == typeid(long)) {
+        value = boost::any_cast<long>(any);
+    }
+    else if (any.type() == typeid(double)) {
+        value = boost::any_cast<double>(any);
+    }
+    else if (any.type() == typeid(Quantity)) {
+        value = boost::any_cast<const Quantity&>(any);
+    }
+    else {
+        return false;
+    }
+    return true;
+}
+
+boost::any toAny(const Value& value)
+{
+    return std::visit(
+        [](const auto& val) {
+            return boost::any(val);
+        },
+        value);
+}
+
+// Python converts ints and floats to Quantity like this
+Quantity toQuantity(const Value& value)
+{
+    if (const auto* quantity = std::get_if<Quantity>(&value)) {
+        return *quantity;
+    }
+    if (const auto* num = std::get_if<double>(&value)) {
+        return Quantity(*num);
+    }
+    return Quantity(static_cast<double>(std::get<long>(value)));
+}
+
+double toDouble(const Value& value)
+{
+    if (const auto* quantity = std::get_if<Quantity>(&value)) {
+        return quantity->getValue();
+    }
+    if (const auto* num = std::get_if<double>(&value)) {
+        return *num;
+    }
+    return static_cast<double>(std::get<long>(value));
+}
+
+bool isTrue(const Value& value)
+{
+    return toDouble(value) != 0.0;
+}
+
+bool isComparison(int op)
+{
+    switch (op) {
+        case OperatorExpression::EQ:
+        case OperatorExpression::NEQ:
+        case OperatorExpression::LT:
+        case OperatorExpression::GT:
+        case OperatorExpression::LTE:
+        case OperatorExpression::GTE:
+            return true;
+        default:
+            return false;
+    }
+}
+
+template<typename T>
+long compare(int op, const T& left, const T& right)
+{
+    switch (op) {
+        case OperatorExpression::EQ:
+            return left == right ? 1 : 0;
+        case OperatorExpression::NEQ:
+            return left != right ? 1 : 0;
+        case OperatorExpression::LT:
+            return left < right ? 1 : 0;
+        case OperatorExpression::GT:
+            return left > right ? 1 : 0;
+        case OperatorExpression::LTE:
+            return left <= right ? 1 : 0;
+        default:
+            return left >= right ? 1 : 0;
+    }
+}
+
+// Comparison of two quantities as done by QuantityPy::richCompare()
+long compareQuantity(int op, const Quantity& left, const Quantity& right)
+{
+    switch (op) {
+        case OperatorExpression::EQ:
+            return left == right ? 1 : 0;
+        case OperatorExpression::NEQ:
+            return !(left == right) ? 1 : 0;
+        case OperatorExpression::LT:
+            return left < right ? 1 : 0;
+        case OperatorExpression::GT:
+            return !(left < right) && !(left == right) ? 1 : 0;
+        case OperatorExpression::LTE:
+            return (left < right) || (left == right) ? 1 : 0;
+        default:
+            return !(left < right) ? 1 : 0;
+    }
+}
+
+// The float remainder of Python
+double floatRemainder(double left, double right)
+{
+    double mod = std::fmod(left, right);
+    if (mod != 0.0) {
+        if ((right < 0.0) != (mod < 0.0)) {
+            mod += right;
+        }
+    }
+    else {
+        mod = std::copysign(0.0, right);
+    }
+    return mod;
+}
+
+bool isOddInteger(double value)
+{
+    return std::fmod(std::fabs(value), 2.0) == 1.0;
+}
+
+// The float power of Python, fails where Python raises or leaves the reals
+bool floatPower(double base, double exponent, double& result)
+{
+    if (!std::isfinite(base) || !std::isfinite(exponent)) {
+        return false;
+    }
+    if (exponent == 0.0) {
+        result = 1.0;
+        return true;
+    }
+    if (base == 0.0) {
+        if (exponent < 0.0) {
+            return false;
+        }
+        result = isOddInteger(exponent) ? base : 0.0;
+        return true;
+    }
+    bool negate = false;
+    if (base < 0.0) {
+        if (exponent != std::floor(exponent)) {
+            return false;
+        }
+        base = -base;
+        negate = isOddInteger(exponent);
+    }
+    result = base == 1.0 ? 1.0 : std::pow(base, exponent);
+    if (std::isinf(result)) {
+        return false;
+    }
+    if (negate) {
+        result = -result;
+    }
+    return true;
+}
+
+bool addInteger(long left, long right, long& result)
+{
+    if ((right > 0 && left > std::numeric_limits<long>::max() - right)
+        || (right < 0 && left < std::numeric_limits<long>::min() - right)) {
+        return false;
+    }
+    result = left + right;
+    return true;
+}
+
+bool subtractInteger(long left, long right, long& result)
+{
+    if ((right < 0 && left > std::numeric_limits<long>::max() + right)
+        || (right > 0 && left < std::numeric_limits<long>::min() + right)) {
+        return false;
+    }
+    result = left - right;
+    return true;
+}
+
+bool multiplyInteger(long left, long right, long& result)
+{
+    constexpr long max = std::numeric_limits<long>::max();
+    constexpr long min = std::numeric_limits<long>::min();
+    if (left > 0) {
+        if ((right > 0 && left > max / right) || (right < 0 && right < min / left)) {
+            return false;
+        }
+    }
+    else if (left < 0) {
+        if ((right > 0 && left < min / right) || (right < 0 && right < max / left)) {
+            return false;
+        }
+    }
+    result = left * right;
+    return true;
+}
+
+bool powerInteger(long base, long exponent, long& result)
+{
+    long res = 1;
+    while (exponent > 0) {
+        if ((exponent & 1) != 0 && !multiplyInteger(res, base, res)) {
+            return false;
+        }
+        exponent >>= 1;
+        if (exponent > 0 && !multiplyInteger(base, base, base)) {
+            return false;
+        }
+    }
+    result = res;
+    return true;
+}
+
+// Operators on Python ints
+bool integerOperator(int op, long left, long right, Value& result)
+{
+    long res {};
+    switch (op) {
+        case OperatorExpression::ADD:
+            if (!addInteger(left, right, res)) {
+                return false;
+            }
+            break;
+        case OperatorExpression::SUB:
+            if (!subtractInteger(left, right, res)) {
+                return false;
+            }
+            break;
+        case OperatorExpression::MUL:
+        case OperatorExpression::UNIT:
+            if (!multiplyInteger(left, right, res)) {
+                return false;
+            }
+            break;
+        case OperatorExpression::DIV:
+            // Python divides small ints as doubles, larger ones are rounded differently
+            if (right == 0 || !isExact(left) || !isExact(right)) {
+                return false;
+            }
+            result = static_cast<double>(left) / static_cast<double>(right);
+            return true;
+        case OperatorExpression::MOD:
+            if (right == 0) {
+                return false;
+            }
+            if (right == -1) {
+                res = 0;
+                break;
+            }
+            res = left % right;
+            if (res != 0 && ((res < 0) != (right < 0))) {
+                res += right;
+            }
+            break;
+        case OperatorExpression::POW:
+            if (right < 0) {
+                double num {};
+                if (!floatPower(static_cast<double>(left), static_cast<double>(right), num)) {
+                    return false;
+                }
+                result = num;
+                return true;
+            }
+            if (!powerInteger(left, right, res)) {
+                return false;
+            }
+            break;
+        default:
+            if (!isComparison(op)) {
+                return false;
+            }
+            res = compare(op, left, right);
+            break;
+    }
+    result = res;
+    return true;
+}
+
+// Operators on Python floats, or a float and an int
+bool floatOperator(int op, double left, double right, Value& result)
+{
+    double res {};
+    switch (op) {
+        case OperatorExpression::ADD:
+            res = left + right;
+            break;
+        case OperatorExpression::SUB:
+            res = left - right;
+            break;
+        case OperatorExpression::MUL:
+        case OperatorExpression::UNIT:
+            res = left * right;
+            break;
+        case OperatorExpression::DIV:
+            if (right == 0.0) {
+                return false;
+            }
+            res = left / right;
+            break;
+        case OperatorExpression::MOD:
+            if (right == 0.0) {
+                return false;
+            }
+            res = floatRemainder(left, right);
+            break;
+        case OperatorExpression::POW:
+            if (!floatPower(left, right, res)) {
+                return false;
+            }
+            break;
+        default:
+            if (!isComparison(op)) {
+                return false;
+            }
+            result = compare(op, left, right);
+            return true;
+    }
+    result = res;
+    return true;
+}
+
+// Operators with a quantity, as implemented by QuantityPy
+bool quantityOperator(int op, const Value& left, const Value& right, Value& result)
+{
+    const auto* quantity = std::get_if<Quantity>(&left);
+    switch (op) {
+        case OperatorExpression::ADD:
+            result = toQuantity(left) + toQuantity(right);
+            return true;
+        case OperatorExpression::SUB:
+            result = toQuantity(left) - toQuantity(right);
+            return true;
+        case OperatorExpression::MUL:
+        case OperatorExpression::UNIT:
+            result = toQuantity(left) * toQuantity(right);
+            return true;
+        case OperatorExpression::DIV:
+            result = toQuantity(left) / toQuantity(right);
+            return true;
+        case OperatorExpression::MOD: {
+            double divisor = toDouble(right);
+            if (!quantity || divisor == 0.0) {
+                return false;
+            }
+            result = Quantity(floatRemainder(quantity->getValue(), divisor), quantity->getUnit());
+            return true;
+        }
+        case OperatorExpression::POW:
+            if (!quantity) {
+                return false;
+            }
+            if (const auto* exponent = std::get_if<Quantity>(&right)) {
+                result = quantity->pow(*exponent);
+            }
+            else {
+                result = quantity->pow(toDouble(right));
+            }
+            return true;
+        default:
+            if (!isComparison(op)) {
+                return false;
+            }
+            if (quantity && std::holds_alternative<Quantity>(right)) {
+                result = compareQuantity(op, *quantity, std::get<Quantity>(right));
+            }
+            else {
+                result = compare(op, toDouble(left), toDouble(right));
+            }
+            return true;
+    }
+}
+
+bool binaryOperator(int op, const Value& left, const Value& right, Value& result)
+{
+    if (std::holds_alternative<Quantity>(left) || std::holds_alternative<Quantity>(right)) {
+        return quantityOperator(op, left, right, result);
+    }
+    const auto* leftInt = std::get_if<long>(&left);
+    const auto* rightInt = std::get_if<long>(&right);
+    if (leftInt && rightInt) {
+        return integerOperator(op, *leftInt, *rightInt, result);
+    }
+    // Python compares an int and a float exactly
+    if (isComparison(op)
+        && ((leftInt && !isExact(*leftInt)) || (rightInt && !isExact(*rightInt)))) {
+        return false;
+    }
+    return floatOperator(op, toDouble(left), toDouble(right), result);
+}
+
+bool unaryOperator(int op, Value& value)
+{
+    if (op == OperatorExpression::POS) {
+        return true;
+    }
+    if (auto* num = std::get_if<long>(&value)) {
+        if (*num == std::numeric_limits<long>::min()) {
+            return false;
+        }
+        *num = -*num;
+    }
+    else if (auto* num = std::get_if<double>(&value)) {
+        *num = -*num;
+    }
+    else {
+        value = std::get<Quantity>(value) * -1.0;
+    }
+    return true;
+}
+
+bool isMathFunction(int f)
+{
+    switch (f) {
+        case FunctionExpression::ABS:
+        case FunctionExpression::ACOS:
+        case FunctionExpression::ASIN:
+        case FunctionExpression::ATAN:
+        case FunctionExpression::ATAN2:
+        case FunctionExpression::CATH:
+        case FunctionExpression::CBRT:
+        case FunctionExpression::CEIL:
+        case FunctionExpression::COS:
+        case FunctionExpression::COSH:
+        case FunctionExpression::EXP:
+        case FunctionExpression::FLOOR:
+        case FunctionExpression::HYPOT:
+        case FunctionExpression::LOG:
+        case FunctionExpression::LOG10:
+        case FunctionExpression::MOD:
+        case FunctionExpression::POW:
+        case FunctionExpression::ROUND:
+        case FunctionExpression::SIN:
+        case FunctionExpression::SINH:
+        case FunctionExpression::SQRT:
+        case FunctionExpression::TAN:
+        case FunctionExpression::TANH:
+        case FunctionExpression::TRUNC:
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool isAggregateFunction(int f)
+{
+    switch (f) {
+        case FunctionExpression::AVERAGE:
+        case FunctionExpression::MAX:
+        case FunctionExpression::MIN:
+        case FunctionExpression::SUM:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// The aggregate functions of single values, the same as the collectors of
+// FunctionExpression::evalAggregate()
+bool aggregateFunction(int f, const Value* args, int count, Value& result)
+{
+    Quantity q;
+    q.setUnit(toQuantity(args[0]).getUnit());
+    for (int i = 0; i < count; ++i) {
+        Quantity value = toQuantity(args[i]);
+        switch (f) {
+            case FunctionExpression::AVERAGE:
+            case FunctionExpression::SUM:
+                q += value;
+                break;
+            case FunctionExpression::MIN:
+                if (i == 0 || value < q) {
+                    q = value;
+                }
+                break;
+            case FunctionExpression::MAX:
+                if (i == 0 || value > q) {
+                    q = value;
+                }
+                break;
+            default:
+                return false;
+        }
+    }
+    if (f == FunctionExpression::AVERAGE) {
+        q = q / static_cast<double>(count);
+    }
+    return fromQuantity(q, result);
+}
+
+// The math functions, with the unit checks of FunctionExpression::evaluate()
+bool mathFunction(int f, const Value* args, int count, Value& result)
+{
+    using std::numbers::pi;
+
+    Quantity v1 = toQuantity(args[0]);
+    Quantity v2 = count > 1 ? toQuantity(args[1]) : Quantity();
+    Quantity v3 = count > 2 ? toQuantity(args[2]) : Quantity();
+
+    double output {};
+    Unit unit;
+    double scaler = 1;
+    double value = v1.getValue();
+
+    switch (f) {
+        case FunctionExpression::COS:
+        case FunctionExpression::SIN:
+        case FunctionExpression::TAN:
+            if (!v1.isDimensionlessOrUnit(Unit::Angle)) {
+                return false;
+            }
+            value = Base::toRadians(value);
+            break;
+        case FunctionExpression::ACOS:
+        case FunctionExpression::ASIN:
+        case FunctionExpression::ATAN:
+            if (!v1.isDimensionless()) {
+                return false;
+            }
+            unit = Unit::Angle;
+            scaler = 180.0 / pi;
+            break;
+        case FunctionExpression::EXP:
+        case FunctionExpression::LOG:
+        case FunctionExpression::LOG10:
+        case FunctionExpression::SINH:
+        case FunctionExpression::TANH:
+        case FunctionExpression::COSH:
+            if (!v1.isDimensionless()) {
+                return false;
+            }
+            break;
+        case FunctionExpression::ROUND:
+        case FunctionExpression::TRUNC:
+        case FunctionExpression::CEIL:
+        case FunctionExpression::FLOOR:
+        case FunctionExpression::ABS:
+            unit = v1.getUnit();
+            break;
+        case FunctionExpression::SQRT:
+            unit = v1.getUnit().sqrt();
+            break;
+        case FunctionExpression::CBRT:
+            unit = v1.getUnit().cbrt();
+            break;
+        case FunctionExpression::ATAN2:
+            if (count < 2 || v1.getUnit() != v2.getUnit()) {
+                return false;
+            }
+            unit = Unit::Angle;
+            scaler = 180.0 / pi;
+            break;
+        case FunctionExpression::MOD:
+            if (count < 2
+                || (v1.getUnit() != v2.getUnit() && !v1.isDimensionless()
+                    && !v2.isDimensionless())) {
+                return false;
+            }
+            unit = v1.getUnit();
+            break;
+        case FunctionExpression::POW: {
+            if (count < 2 || !v2.isDimensionless()) {
+                return false;
+            }
+            double exponent = v2.getValue();
+            if (!v1.isDimensionless()) {
+                if (exponent - boost::math::round(exponent) >= 1e-9) {
+                    return false;
+                }
+                unit = v1.getUnit().pow(exponent);
+            }
+            break;
+        }
+        case FunctionExpression::HYPOT:
+        case FunctionExpression::CATH:
+            if (count < 2 || v1.getUnit() != v2.getUnit()
+                || (count > 2 && v2.getUnit() != v3.getUnit())) {
+                return false;
+            }
+            unit = v1.getUnit();
+            break;
+        default:
+            return false;
+    }
+
+    switch (f) {
+        case FunctionExpression::ACOS:
+            output = std::acos(value);
+            break;
+        case FunctionExpression::ASIN:
+            output = std::asin(value);
+            break;
+        case FunctionExpression::ATAN:
+            output = std::atan(value);
+            break;
+        case FunctionExpression::ABS:
+            output = std::fabs(value);
+            break;
+        case FunctionExpression::EXP:
+            output = std::exp(value);
+            break;
+        case FunctionExpression::LOG:
+            output = std::log(value);
+            break;
+        case FunctionExpression::LOG10:
+            output = std::log(value) / std::log(10.0);
+            break;
+        case FunctionExpression::SIN:
+            output = std::sin(value);
+            break;
+        case FunctionExpression::SINH:
+            output = std::sinh(value);
+            break;
+        case FunctionExpression::TAN:
+            output = std::tan(value);
+            break;
+        case FunctionExpression::TANH:
+            output = std::tanh(value);
+            break;
+        case FunctionExpression::SQRT:
+            output = std::sqrt(value);
+            break;
+        case FunctionExpression::CBRT:
+            output = std::cbrt(value);
+            break;
+        case FunctionExpression::COS:
+            output = std::cos(value);
+            break;
+        case FunctionExpression::COSH:
+            output = std::cosh(value);
+            break;
+        case FunctionExpression::MOD:
+            output = std::fmod(value, v2.getValue());
+            break;
+        case FunctionExpression::ATAN2:
+            output = std::atan2(value, v2.getValue());
+            break;
+        case FunctionExpression::POW:
+            output = std::pow(value, v2.getValue());
+            break;
+        case FunctionExpression::HYPOT:
+            output = std::sqrt(std::pow(v1.getValue(), 2) + std::pow(v2.getValue(), 2)
+                               + (count > 2 ? std::pow(v3.getValue(), 2) : 0));
+            break;
+        case FunctionExpression::CATH:
+            output = std::sqrt(std::pow(v1.getValue(), 2) - std::pow(v2.getValue(), 2)
+                               - (count > 2 ? std::pow(v3.getValue(), 2) : 0));
+            break;
+        case FunctionExpression::ROUND:
+            output = boost::math::round(value);
+            break;
+        case FunctionExpression::TRUNC:
+            output = boost::math::trunc(value);
+            break;
+        case FunctionExpression::CEIL:
+            output = std::ceil(value);
+            break;
+        case FunctionExpression::FLOOR:
+            output = std::floor(value);
+            break;
+        default:
+            return false;
+    }
+
+    result = Quantity(scaler * output, unit);
+    return true;
+}
+
+bool loadVariable(const VariableExpression* var, Value& value)
+{
+    const ObjectIdentifier& path = var->getPath();
+    int ptype = 0;
+    int numSubComponents = 0;
+    const Property* prop = path.getProperty(&ptype, &numSubComponents);
+    if (!prop || ptype != 0) {
+        return false;
+    }
+    boost::any any;
+    return prop->getNumericPathValue(path, numSubComponents, any) && fromAny(any, value);
+}
+
+}  // namespace
+
+std::unique_ptr<CompiledExpression> CompiledExpression::compile(const Expression* expr)
+{
+    std::unique_ptr<CompiledExpression> res(new CompiledExpression());
+    if (!expr || !res->lower(expr)) {
+        return {};
+    }
+    // Nothing to gain if Python computes the whole value
+    if (res->code.size() == 1 && res->code.front().code == OpCode::Python) {
+        return {};
+    }
+    return res;
+}
+
+void CompiledExpression::emit(OpCode code, int arg, int count, const Expression* node)
+{
+    this->code.push_back({code, arg, count, node});
+}
+
+void CompiledExpression::push(int num)
+{
+    depth += num;
+    maxDepth = std::max(maxDepth, depth);
+}
+
+void CompiledExpression::pop(int num)
+{
+    depth -= num;
+}
+
+bool CompiledExpression::lowerPython(const Expression* expr)
+{
+    emit(OpCode::Python, 0, 0, expr);
+    push(1);
+    pythonNodes = true;
+    return true;
+}
+
+bool CompiledExpression::lower(const Expression* expr)
+{
+    if (expr->hasComponent()) {
+        // Indexing or attributes of a Python value
+        return lowerPython(expr);
+    }
+
+    if (const auto* var = freecad_cast<const VariableExpression*>(expr)) {
+        int ptype = 0;
+        int numSubComponents = 0;
+        const ObjectIdentifier& path = var->getPath();
+        const Property* prop = path.getProperty(&ptype, &numSubComponents);
+        if (ptype != 0) {
+            return lowerPython(expr);
+        }
+        if (prop) {
+            boost::any any;
+            try {
+                if (!prop->getNumericPathValue(path, numSubComponents, any)) {
+                    return lowerPython(expr);
+                }
+            }
+            catch (const Base::Exception&) {  // NOLINT(bugprone-empty-catch)
+                // An invalid index and the like, left to evaluate()
+            }
+            catch (const std::exception&) {  // NOLINT(bugprone-empty-catch)
+            }
+        }
+        emit(OpCode::Load, 0, 0, var);
+        push(1);
+        return true;
+    }
+
+    if (const auto* op = freecad_cast<const OperatorExpression*>(expr)) {
+        if (!lower(op->getLeft())) {
+            return false;
+        }
+        int oper = op->getOperator();
+        if (oper == OperatorExpression::NEG || oper == OperatorExpression::POS) {
+            emit(OpCode::Unary, oper);
+            return true;
+        }
+        if (!lower(op->getRight())) {
+            return false;
+        }
+        emit(OpCode::Binary, oper);
+        pop(1);
+        return true;
+    }
+
+    if (const auto* func = freecad_cast<const FunctionExpression*>(expr)) {
+        const auto& args = func->getArgs();
+        int f = func->getFunction();
+        if (!func->getOwner() || args.empty()) {
+            return false;
+        }
+        if (f == FunctionExpression::HIDDENREF || f == FunctionExpression::HREF) {
+            return lower(args[0]);
+        }
+        if (f == FunctionExpression::CREATE) {
+            // Must not be called twice when its value turns out not to be a number
+            return false;
+        }
+        if (isAggregateFunction(f)) {
+            // Ranges of cells are collected by Python
+            if (std::any_of(args.begin(), args.end(), [](const Expression* arg) {
+                    return arg->isDerivedFrom<RangeExpression>();
+                })) {
+                return lowerPython(expr);
+            }
+        }
+        else if (!isMathFunction(f)) {
+            return lowerPython(expr);
+        }
+        // Only the first three arguments of the math functions are evaluated
+        int count = static_cast<int>(
+            isAggregateFunction(f) ? args.size() : std::min<std::size_t>(args.size(), 3));
+        for (int i = 0; i < count; ++i) {
+            if (!lower(args[i])) {
+                return false;
+            }
+        }
+        emit(OpCode::Function, f, count);
+        pop(count - 1);
+        return true;
+    }
+
+    if (const auto* cond = freecad_cast<const ConditionalExpression*>(expr)) {
+        if (!lower(cond->getCondition())) {
+            return false;
+        }
+        std::size_t jumpToFalse = code.size();
+        emit(OpCode::JumpIfFalse);
+        pop(1);
+        if (!lower(cond->getTrueExpr())) {
+            return false;
+        }
+        std::size_t jumpToEnd = code.size();
+        emit(OpCode::Jump);
+        pop(1);
+        code[jumpToFalse].arg = static_cast<int>(code.size());
+        if (!lower(cond->getFalseExpr())) {
+            return false;
+        }
+        code[jumpToEnd].arg = static_cast<int>(code.size());
+        return true;
+    }
+
+    Value value;
+    if (const auto* constant = freecad_cast<const ConstantExpression*>(expr)) {
+        if (constant->isNumber()) {
+            if (!fromQuantity(constant->getQuantity(), value)) {
+                return false;
+            }
+        }
+        else if (constant->getName() == "True") {
+            value = 1L;
+        }
+        else if (constant->getName() == "False") {
+            value = 0L;
+        }
+        else {
+            return false;
+        }
+    }
+    else if (expr->is<NumberExpression>() || expr->is<UnitExpression>()) {
+        const auto* unit = static_cast<const UnitExpression*>(expr);
+        if (!fromQuantity(unit->getQuantity(), value)) {
+            return false;
+        }
+    }
+    else {
+        return false;
+    }
+
+    emit(OpCode::Push, static_cast<int>(constants.size()));
+    constants.push_back(std::move(value));
+    push(1);
+    return true;
+}
+
+bool CompiledExpression::evaluatePython(const Expression* expr, Value& value) const
+{
+    Base::PyGILStateLocker lock;
+    try {
+        if (fromAny(pyObjectToAny(expr->getPyValue()), value)) {
+            return true;
+        }
+    }
+    catch (Py::Exception&) {
+        PyErr_Clear();
+        return false;
+    }
+    notNumeric = true;
+    return false;
+}
+
+bool CompiledExpression::evaluate(boost::any& value) const
+{
+    if (notNumeric) {
+        return false;
+    }
+
+    std::vector<Value> stack;
+    stack.reserve(maxDepth);
+
+    try {
+        std::size_t pc = 0;
+        while (pc < code.size()) {
+            const Instruction& ins = code[pc++];
+            switch (ins.code) {
+                case OpCode::Push:
+                    stack.push_back(constants[ins.arg]);
+                    break;
+                case OpCode::Load: {
+                    Value val;
+                    if (!loadVariable(static_cast<const VariableExpression*>(ins.node), val)) {
+                        return false;
+                    }
+                    stack.push_back(std::move(val));
+                    break;
+                }
+                case OpCode::Python: {
+                    Value val;
+                    if (!evaluatePython(ins.node, val)) {
+                        return false;
+                    }
+                    stack.push_back(std::move(val));
+                    break;
+                }
+                case OpCode::Unary:
+                    if (!unaryOperator(ins.arg, stack.back())) {
+                        return false;
+                    }
+                    break;
+                case OpCode::Binary: {
+                    Value res;
+                    if (!binaryOperator(ins.arg, stack[stack.size() - 2], stack.back(), res)) {
+                        return false;
+                    }
+                    stack.pop_back();
+                    stack.back() = std::move(res);
+                    break;
+                }
+                case OpCode::Function: {
+                    Value res;
+                    std::size_t first = stack.size() - ins.count;
+                    bool done = isAggregateFunction(ins.arg)
+                        ? aggregateFunction(ins.arg, &stack[first], ins.count, res)
+                        : mathFunction(ins.arg, &stack[first], ins.count, res);
+                    if (!done) {
+                        return false;
+                    }
+                    stack.resize(first);
+                    stack.push_back(std::move(res));
+                    break;
+                }
+                case OpCode::JumpIfFalse: {
+                    bool cond = isTrue(stack.back());
+                    stack.pop_back();
+                    if (!cond) {
+                        pc = ins.arg;
+                    }
+                    break;
+                }
+                case OpCode::Jump:
+                    pc = ins.arg;
+                    break;
+            }
+        }
+    }
+    catch (const Base::Exception&) {
+        // E.g. a unit mismatch, Python reports the error
+        return false;
+    }
+    catch (const std::exception&) {
+        return false;
+    }
+
+    value = toAny(stack.back());
+    return true;
+}
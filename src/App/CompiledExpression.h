@@ -0,0 +1,127 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/***************************************************************************
+ *   This file is part of FreeCAD.                                         *
+ *                                                                         *
+ *   FreeCAD is free software: you can redistribute it and/or modify it    *
+ *   under the terms of the GNU Lesser General Public License as           *
+ *   published by the Free Software Foundation, either version 2.1 of the  *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   FreeCAD is distributed in the hope that it will be useful, but        *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with FreeCAD. If not, see                               *
+ *   <https://www.gnu.org/licenses/>.                                      *
+ *                                                                         *
+ **************************************************************************/
+
+#ifndef APP_COMPILEDEXPRESSION_H
+#define APP_COMPILEDEXPRESSION_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <variant>
+#include <vector>
+
+#include <boost/any.hpp>
+#include <Base/Quantity.h>
+#include <FCGlobal.h>
+
+namespace App
+{
+
+class Expression;
+
+/** Native evaluation form of an expression
+ *
+ * Numeric expressions, made of numbers, units, constants, references to numeric
+ * properties, operators, conditionals, the math functions and the aggregate functions of
+ * single values, are lowered to the code of a small stack machine that works on longs,
+ * doubles and quantities. It gives the same
+ * result as Expression::getPyValue() converted by App::pyObjectToAny(), following the
+ * int and float rules of Python, but it creates no Python object and doesn't need the GIL.
+ *
+ * Other references and functions, e.g. to a coordinate of a placement or the vector
+ * functions, are evaluated by Python and their values used if they are numbers. Anything
+ * else is left to Python: compile() fails if the expression can't give a number, and
+ * evaluate() fails if Python would not compute the value the native way, e.g. on an
+ * integer overflow, a division by zero or a unit mismatch. The whole expression is then
+ * evaluated by Python, which gives the value or the error.
+ *
+ * The code refers to the nodes of the expression and must not outlive it.
+ */
+class AppExport CompiledExpression
+{
+public:
+    /// A value on the stack
+    using Value = std::variant<long, double, Base::Quantity>;
+
+    /// Compile \a expr, returns null if it can only be evaluated by Python
+    static std::unique_ptr<CompiledExpression> compile(const Expression* expr);
+
+    /** Evaluate the expression
+     * @param value returns the value, a Base::Quantity, a double or a long
+     * @return false if the value must be computed by Python
+     */
+    bool evaluate(boost::any& value) const;
+
+    /// Whether some nodes are evaluated by Python, which needs the GIL
+    bool usesPython() const
+    {
+        return pythonNodes;
+    }
+
+    /// The number of instructions
+    std::size_t size() const
+    {
+        return code.size();
+    }
+
+private:
+    enum class OpCode
+    {
+        Push,         // push constants[arg]
+        Load,         // push the value of the variable node
+        Python,       // push the value of node computed by Python
+        Unary,        // apply the operator arg to the top value
+        Binary,       // apply the operator arg to the two top values
+        Function,     // apply the function arg to the count top values
+        JumpIfFalse,  // pop a value, continue at arg if it is false
+        Jump,         // continue at arg
+    };
+
+    struct Instruction
+    {
+        OpCode code;
+        int arg {0};
+        int count {0};
+        const Expression* node {nullptr};
+    };
+
+    CompiledExpression() = default;
+
+    bool lower(const Expression* expr);
+    bool lowerPython(const Expression* expr);
+    void emit(OpCode code, int arg = 0, int count = 0, const Expression* node = nullptr);
+    void push(int num);
+    void pop(int num);
+    bool evaluatePython(const Expression* expr, Value& value) const;
+
+private:
+    std::vector<Instruction> code;
+    std::vector<Value> constants;
+    int depth {0};
+    int maxDepth {0};
+    bool pythonNodes {false};
+    // Set once a node evaluated by Python gave no number, it will most likely not change
+    mutable std::atomic<bool> notNumeric {false};
+};
+
+}  // namespace App
+
+#endif  // APP_COMPILEDEXPRESSION_H
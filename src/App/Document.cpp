@@ -23,8 +23,13 @@
 #include "PreCompiled.h"
 
 #ifndef _PreComp_
+#include <atomic>
 #include <bitset>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
 #include <stack>
+#include <thread>
 #include <boost/filesystem.hpp>
 #include <deque>
 #include <iostream>
@@ -108,6 +113,22 @@ namespace App
 
 static bool globalIsRestoring;
 static bool globalIsRelabeling;
+// lock held by the current thread if it is a parallel recompute worker
+static thread_local std::unique_lock<std::mutex>* recomputeWorkerLock;
+// objects of a level of a parallel recompute that are done, see waitForRecomputeTurn()
+struct RecomputeTurn
+{
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::vector<char> done;
+    // index of the first object that is not done
+    size_t first = 0;
+};
+static thread_local RecomputeTurn* recomputeWorkerTurn;
+// index of the object executed by the current worker in RecomputeTurn::done
+static thread_local size_t recomputeWorkerTask;
+// bumped on any change of object dependencies in any document
+static unsigned long globalDependencyRevision = 1;
 
 DocumentP::DocumentP()
 {
@@ -617,6 +638,9 @@ void Document::clearDocument()
     d->clearRecomputeLog();
     d->objectLabelManager.clear();
     d->objectArray.clear();
+    d->dirtyObjects.clear();
+    d->expressionIndex.clear();
+    _dependencyChanged();
     d->objectMap.clear();
     d->objectNameManager.clear();
     d->objectIdMap.clear();
@@ -808,7 +832,14 @@ void Document::onChanged(const Property* prop)
 void Document::onBeforeChangeProperty(const TransactionalObject* Who, const Property* What)
 {
     if (Who->isDerivedFrom<App::DocumentObject>()) {
-        signalBeforeChangeObject(*static_cast<const App::DocumentObject*>(Who), *What);
+        auto obj = static_cast<const App::DocumentObject*>(Who);
+        if (recomputeWorkerLock) {
+            // observers are notified by the main thread, see _recomputeParallel()
+            d->deferredSignals.push_back({obj, What, true});
+        }
+        else {
+            signalBeforeChangeObject(*obj, *What);
+        }
     }
     if (!d->rollback && !globalIsRelabeling) {
         _checkTransaction(nullptr, What, __LINE__);
@@ -820,6 +851,10 @@ void Document::onBeforeChangeProperty(const TransactionalObject* Who, const Prop
 
 void Document::onChangedProperty(const DocumentObject* Who, const Property* What)
 {
+    if (recomputeWorkerLock) {
+        d->deferredSignals.push_back({Who, What, false});
+        return;
+    }
     signalChangedObject(*Who, *What);
 }
 
@@ -2160,11 +2195,19 @@ bool Document::saveToFile(const char* filename) const
 
         writer.setComment("FreeCAD Document");
         writer.setLevel(compression);
+        if (hGrp->GetBool("ParallelSave", false)) {
+            writer.setThreads(std::max(1U, std::thread::hardware_concurrency()));
+        }
         writer.putNextEntry("Document.xml");
 
         if (hGrp->GetBool("SaveBinaryBrep", false)) {
             writer.setMode("BinaryBrep");
         }
+        // Compact binary encoding of Document.xml, see Base::BinaryXMLEncoder
+        if (hGrp->GetBool("SaveBinaryDocument", false)) {
+            writer.setMode("BinaryDocument");
+            writer.beginBinaryXML();
+        }
 
         writer.Stream() << "<?xml version='1.0' encoding='utf-8'?>" << endl
                         << "<!--" << endl
@@ -2175,6 +2218,7 @@ bool Document::saveToFile(const char* filename) const
 
         // Special handling for Gui document.
         signalSaveDocument(writer);
+        writer.endBinaryXML();
 
         // write additional files
         writer.writeFiles();
@@ -2283,6 +2327,9 @@ void Document::restore(const char* filename,
     d->clearRecomputeLog();
     d->objectLabelManager.clear();
     d->objectArray.clear();
+    d->dirtyObjects.clear();
+    d->expressionIndex.clear();
+    _dependencyChanged();
     d->objectNameManager.clear();
     d->objectMap.clear();
     d->objectIdMap.clear();
@@ -2314,6 +2361,12 @@ void Document::restore(const char* filename,
         throw Base::FileException("Error reading compression file", filename);
     }
 
+    ParameterGrp::handle hGrp =
+        GetApplication().GetParameterGroupByPath("User parameter:BaseApp/Preferences/Document");
+    if (hGrp->GetBool("ParallelRestore", false)) {
+        reader.ReadFilesThreads = std::max(1U, std::thread::hardware_concurrency());
+    }
+
     GetApplication().signalStartRestoreDocument(*this);
     setStatus(Document::Restoring, true);
 
@@ -2653,6 +2706,31 @@ bool Document::hasLinksTo(const DocumentObject* obj) const
     return !links.empty();
 }
 
+std::vector<std::pair<App::DocumentObject*, App::ObjectIdentifier>>
+Document::getExpressionDependents(const DocumentObject* obj,
+                                  const char* propName,
+                                  bool recursive) const
+{
+    auto result = d->expressionIndex.getBindings(obj, propName);
+    if (!recursive) {
+        return result;
+    }
+
+    // A bound property changes with its expression, follow the bindings depending on it
+    std::set<std::pair<App::DocumentObject*, App::ObjectIdentifier>> done(result.begin(),
+                                                                          result.end());
+    for (std::size_t i = 0; i < result.size(); ++i) {
+        DocumentObject* owner = result[i].first;
+        std::string name = result[i].second.getPropertyName();
+        for (auto& binding : d->expressionIndex.getBindings(owner, name.c_str())) {
+            if (done.insert(binding).second) {
+                result.push_back(std::move(binding));
+            }
+        }
+    }
+    return result;
+}
+
 std::vector<App::DocumentObject*> Document::getInList(const DocumentObject* me) const
 {
     // result list
@@ -2909,6 +2987,86 @@ void Document::_rebuildDependencyList(const std::vector<App::DocumentObject*>& o
     (void)objs;
 }
 
+void Document::_dependencyChanged()
+{
+    ++globalDependencyRevision;
+}
+
+void Document::_objectTouched(DocumentObject* obj)
+{
+    d->dirtyObjects.insert(obj);
+}
+
+void Document::_expressionsChanged(const PropertyExpressionContainer* prop)
+{
+    d->expressionIndex.invalidate(prop);
+}
+
+std::vector<App::DocumentObject*> Document::_getDirtyDependencyList(int options)
+{
+    // The sorted dependency list of all objects is kept until any object
+    // dependency changes, which is signaled by PropertyLinkBase through
+    // DocumentObject::clearOutListCache(). Note that the revision is global,
+    // because the list includes externally linked objects.
+    bool rebuild = d->sortedRevision != globalDependencyRevision || d->sortedOptions != options;
+    if (rebuild) {
+        d->sortedObjects = getDependencyList(d->objectArray, DepSort | options);
+        d->sortedIndex.clear();
+        d->externalObjects.clear();
+        for (size_t i = 0; i < d->sortedObjects.size(); ++i) {
+            auto obj = d->sortedObjects[i];
+            d->sortedIndex[obj] = i;
+            if (obj->getDocument() != this) {
+                d->externalObjects.push_back(obj);
+            }
+        }
+        d->sortedRevision = globalDependencyRevision;
+        d->sortedOptions = options;
+    }
+
+    std::unordered_set<DocumentObject*> dirtyObjects;
+    dirtyObjects.swap(d->dirtyObjects);
+
+    ParameterGrp::handle hGrp =
+        GetApplication().GetParameterGroupByPath("User parameter:BaseApp/Preferences/Document");
+    if (rebuild || !hGrp->GetBool("IncrementalRecompute", true)) {
+        return d->sortedObjects;
+    }
+
+    // Changes of externally linked objects are tracked by their own document
+    for (auto obj : d->externalObjects) {
+        if (obj->isTouched() || obj->mustRecompute()) {
+            dirtyObjects.insert(obj);
+        }
+    }
+
+    // Collect the touched objects and everything depending on them
+    std::unordered_set<DocumentObject*> cone;
+    std::vector<DocumentObject*> pending;
+    for (auto obj : dirtyObjects) {
+        if (d->sortedIndex.count(obj) && cone.insert(obj).second) {
+            pending.push_back(obj);
+        }
+    }
+    while (!pending.empty()) {
+        auto obj = pending.back();
+        pending.pop_back();
+        for (auto inObj : obj->getInList()) {
+            if (d->sortedIndex.count(inObj) && cone.insert(inObj).second) {
+                pending.push_back(inObj);
+            }
+        }
+    }
+
+    std::vector<DocumentObject*> res(cone.begin(), cone.end());
+    std::sort(res.begin(), res.end(), [this](DocumentObject* a, DocumentObject* b) {
+        return d->sortedIndex[a] < d->sortedIndex[b];
+    });
+    FC_LOG("Recompute " << res.size() << " out of " << d->sortedObjects.size()
+                        << " objects in dependency list");
+    return res;
+}
+
 /**
  * @brief Signal that object identifiers, typically a property or document object has been renamed.
  *
@@ -2930,13 +3088,52 @@ void Document::renameObjectIdentifiers(
         ++it;
     }
 
+    // Only the objects with an expression referencing a renamed path need to be visited
+    std::set<DocumentObject*> dependents;
+    bool all = false;
+    for (const auto& v : extendedPaths) {
+        DocumentObject* obj = v.first.getDocumentObject();
+        if (!obj) {
+            all = true;
+            break;
+        }
+        auto objs = d->expressionIndex.getDependentObjects(obj);
+        dependents.insert(objs.begin(), objs.end());
+    }
+
     for (auto it : d->objectArray) {
-        if (selector(it)) {
+        if ((all || dependents.count(it)) && selector(it)) {
             it->renameObjectIdentifiers(extendedPaths);
         }
     }
 }
 
+// Return the execution time of the most expensive dependency chain of the
+// topologically sorted objects.
+static double _criticalPathTime(const std::vector<App::DocumentObject*>& objs,
+                                const std::map<const App::DocumentObject*, double>& timings)
+{
+    std::map<const App::DocumentObject*, double> finishTimes;
+    double res = 0.0;
+    for (auto obj : objs) {
+        if (!obj->isAttachedToDocument()) {
+            continue;
+        }
+        double start = 0.0;
+        for (auto dep : obj->getOutList()) {
+            auto it = finishTimes.find(dep);
+            if (it != finishTimes.end()) {
+                start = std::max(start, it->second);
+            }
+        }
+        auto it = timings.find(obj);
+        double finish = start + (it == timings.end() ? 0.0 : it->second);
+        finishTimes[obj] = finish;
+        res = std::max(res, finish);
+    }
+    return res;
+}
+
 int Document::recompute(const std::vector<App::DocumentObject*>& objs,
                         bool force,
                         bool* hasError,
@@ -2998,8 +3195,8 @@ int Document::recompute(const std::vector<App::DocumentObject*>& objs,
     }
     std::reverse(topoSortedObjects.begin(),topoSortedObjects.end());
 #else
-    auto topoSortedObjects =
-        getDependencyList(objs.empty() ? d->objectArray : objs, DepSort | options);
+    auto topoSortedObjects = objs.empty() ? _getDirtyDependencyList(options)
+                                          : getDependencyList(objs, DepSort | options);
 #endif
     for (auto obj : topoSortedObjects) {
         obj->setStatus(ObjectStatus::PendingRecompute, true);
@@ -3008,11 +3205,15 @@ int Document::recompute(const std::vector<App::DocumentObject*>& objs,
     ParameterGrp::handle hGrp =
         GetApplication().GetParameterGroupByPath("User parameter:BaseApp/Preferences/Document");
     bool canAbort = hGrp->GetBool("CanAbortRecompute", true);
+    bool parallel = hGrp->GetBool("ParallelRecompute", false);
 
     std::set<App::DocumentObject*> filter;
+    std::map<const App::DocumentObject*, double> timings;
     size_t idx = 0;
 
     FC_TIME_INIT(t2);
+    d->recomputeStats = RecomputeStats();
+    auto wallStart = std::chrono::steady_clock::now();
 
     try {
         // maximum two passes to allow some form of dependency inversion
@@ -3023,6 +3224,19 @@ int Document::recompute(const std::vector<App::DocumentObject*>& objs,
                                                                 topoSortedObjects.size());
             }
             FC_LOG("Recompute pass " << passes);
+            if (parallel && passes == 0) {
+                bool aborted = false;
+                objectCount += _recomputeParallel(topoSortedObjects,
+                                                  filter,
+                                                  timings,
+                                                  seq.get(),
+                                                  hasError,
+                                                  aborted);
+                idx = topoSortedObjects.size();
+                if (aborted) {
+                    passes = 2;
+                }
+            }
             for (; idx < topoSortedObjects.size(); ++idx) {
                 auto obj = topoSortedObjects[idx];
                 if (!obj->isAttachedToDocument() || filter.find(obj) != filter.end()) {
@@ -3033,7 +3247,11 @@ int Document::recompute(const std::vector<App::DocumentObject*>& objs,
                 if (obj->mustRecompute()) {
                     doRecompute = true;
                     ++objectCount;
+                    auto start = std::chrono::steady_clock::now();
                     int res = _recomputeFeature(obj);
+                    timings[obj] += std::chrono::duration<double>(
+                                        std::chrono::steady_clock::now() - start)
+                                        .count();
                     if (res) {
                         if (hasError) {
                             *hasError = true;
@@ -3087,12 +3305,33 @@ int Document::recompute(const std::vector<App::DocumentObject*>& objs,
 
     FC_TIME_LOG(t2, "Recompute");
 
+    auto& stats = d->recomputeStats;
+    stats.objectCount = objectCount;
+    stats.wallTime =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+    stats.serialTime = 0.0;
+    for (const auto& v : timings) {
+        stats.serialTime += v.second;
+    }
+    stats.criticalPathTime = _criticalPathTime(topoSortedObjects, timings);
+    FC_LOG("Recompute " << objectCount << " objects, wall time " << stats.wallTime
+                        << "s, serial time " << stats.serialTime << "s, critical path "
+                        << stats.criticalPathTime << "s");
+
     for (auto obj : topoSortedObjects) {
         if (!obj->isAttachedToDocument()) {
             continue;
         }
         obj->setStatus(ObjectStatus::PendingRecompute, false);
         obj->setStatus(ObjectStatus::Recompute2, false);
+        // Keep failed objects for the next recompute. The others reported the
+        // changes of their output properties while executing, forget them.
+        if (obj->getDocument() == this && obj->isTouched()) {
+            d->dirtyObjects.insert(obj);
+        }
+        else {
+            d->dirtyObjects.erase(obj);
+        }
     }
 
     signalRecomputed(*this, topoSortedObjects);
@@ -3131,6 +3370,228 @@ int Document::recompute(const std::vector<App::DocumentObject*>& objs,
     return objectCount;
 }
 
+const Document::RecomputeStats& Document::getRecomputeStats() const
+{
+    return d->recomputeStats;
+}
+
+bool Document::isRecomputeWorker()
+{
+    return recomputeWorkerLock != nullptr;
+}
+
+void Document::waitForRecomputeTurn()
+{
+    if (!recomputeWorkerTurn) {
+        return;
+    }
+    auto& turn = *recomputeWorkerTurn;
+    {
+        std::lock_guard<std::mutex> lock(turn.mutex);
+        if (turn.first >= recomputeWorkerTask) {
+            return;
+        }
+    }
+    // Let the objects before this one finish, the turn is released before the
+    // unlocker takes the document lock again
+    RecomputeUnlocker unlocker;
+    std::unique_lock<std::mutex> lock(turn.mutex);
+    turn.condition.wait(lock, [&turn]() {
+        return turn.first >= recomputeWorkerTask;
+    });
+}
+
+int Document::_recomputeParallel(const std::vector<App::DocumentObject*>& objs,
+                                 std::set<App::DocumentObject*>& filter,
+                                 std::map<const App::DocumentObject*, double>& timings,
+                                 Base::SequencerLauncher* seq,
+                                 bool* hasError,
+                                 bool& aborted)
+{
+    // Group the topologically sorted objects into levels, so that objects only
+    // depend on objects of lower levels. Objects of the same level are
+    // independent of each other, and can be executed concurrently once all
+    // lower levels are done.
+    std::map<const App::DocumentObject*, size_t> levelMap;
+    std::vector<std::vector<App::DocumentObject*>> levels;
+    for (auto obj : objs) {
+        if (!obj->isAttachedToDocument()) {
+            continue;
+        }
+        size_t level = 0;
+        for (auto dep : obj->getOutList()) {
+            auto it = levelMap.find(dep);
+            if (it != levelMap.end()) {
+                level = std::max(level, it->second + 1);
+            }
+        }
+        levelMap[obj] = level;
+        if (levels.size() <= level) {
+            levels.resize(level + 1);
+        }
+        levels[level].push_back(obj);
+    }
+
+    ParameterGrp::handle hGrp =
+        GetApplication().GetParameterGroupByPath("User parameter:BaseApp/Preferences/Document");
+    long maxThreads = hGrp->GetInt("ParallelRecomputeThreads", 0);
+    if (maxThreads <= 0) {
+        maxThreads = std::max(1U, std::thread::hardware_concurrency());
+    }
+
+    struct Task
+    {
+        App::DocumentObject* obj;
+        bool doRecompute;
+        int result;
+        double time;
+    };
+
+    auto runTask = [this](Task& task) {
+        auto start = std::chrono::steady_clock::now();
+        task.result = _recomputeFeature(task.obj);
+        task.time =
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    int objectCount = 0;
+    for (const auto& level : levels) {
+        std::vector<Task> tasks;
+        std::vector<Task*> workerTasks;
+        tasks.reserve(level.size());
+        for (auto obj : level) {
+            if (!obj->isAttachedToDocument() || filter.find(obj) != filter.end()) {
+                continue;
+            }
+            // ask the object if it should be recomputed
+            tasks.push_back({obj, obj->mustRecompute(), 0, 0.0});
+        }
+        for (auto& task : tasks) {
+            if (task.doRecompute && task.obj->canRecomputeInParallel()) {
+                workerTasks.push_back(&task);
+            }
+        }
+
+        if (workerTasks.size() > 1) {
+            // Worker threads hold the document lock except inside
+            // RecomputeUnlocker, and the document defers object change
+            // signals until they are joined, so that observers are only
+            // called by the main thread.
+            std::atomic<size_t> next(0);
+            RecomputeTurn turn;
+            turn.done.resize(workerTasks.size(), 0);
+            auto worker = [&]() {
+                std::unique_lock<std::mutex> lock(d->recomputeMutex);
+                recomputeWorkerLock = &lock;
+                recomputeWorkerTurn = &turn;
+                for (size_t i = next++; i < workerTasks.size(); i = next++) {
+                    recomputeWorkerTask = i;
+                    runTask(*workerTasks[i]);
+                    std::lock_guard<std::mutex> turnLock(turn.mutex);
+                    turn.done[i] = 1;
+                    while (turn.first < turn.done.size() && turn.done[turn.first]) {
+                        ++turn.first;
+                    }
+                    turn.condition.notify_all();
+                }
+                recomputeWorkerTurn = nullptr;
+                recomputeWorkerLock = nullptr;
+            };
+
+            std::vector<std::thread> threads;
+            auto count = std::min<size_t>(maxThreads, workerTasks.size());
+            {
+                // Let workers evaluate Python expressions
+                std::unique_ptr<Base::PyGILStateRelease> release;
+                if (PyGILState_Check()) {
+                    release = std::make_unique<Base::PyGILStateRelease>();
+                }
+                for (size_t i = 0; i < count; ++i) {
+                    threads.emplace_back(worker);
+                }
+                for (auto& thread : threads) {
+                    thread.join();
+                }
+            }
+            d->recomputeStats.parallelCount += static_cast<int>(workerTasks.size());
+
+            // The properties already hold their new values when the before
+            // change signals are replayed, see canRecomputeInParallel()
+            decltype(d->deferredSignals) signals;
+            signals.swap(d->deferredSignals);
+            for (const auto& signal : signals) {
+                if (signal.before) {
+                    signalBeforeChangeObject(*signal.object, *signal.property);
+                }
+                else {
+                    signalChangedObject(*signal.object, *signal.property);
+                }
+            }
+        }
+        else {
+            workerTasks.clear();
+        }
+
+        for (auto& task : tasks) {
+            if (task.doRecompute
+                && std::find(workerTasks.begin(), workerTasks.end(), &task)
+                    == workerTasks.end()) {
+                runTask(task);
+            }
+        }
+
+        // Same as the serial loop in recompute(), in topological order
+        for (auto& task : tasks) {
+            auto obj = task.obj;
+            if (task.doRecompute) {
+                ++objectCount;
+                timings[obj] += task.time;
+                if (task.result) {
+                    if (hasError) {
+                        *hasError = true;
+                    }
+                    if (task.result < 0) {
+                        aborted = true;
+                        return objectCount;
+                    }
+                    // if something happened filter all object in its
+                    // inListRecursive from the queue then proceed
+                    obj->getInListEx(filter, true);
+                    filter.insert(obj);
+                    continue;
+                }
+            }
+            if (obj->isTouched() || task.doRecompute) {
+                signalRecomputedObject(*obj);
+                obj->purgeTouched();
+                // set all dependent object touched to force recompute
+                for (auto inObjIt : obj->getInList()) {
+                    inObjIt->enforceRecompute();
+                }
+            }
+            if (seq) {
+                seq->next(true);
+            }
+        }
+    }
+    return objectCount;
+}
+
+RecomputeUnlocker::RecomputeUnlocker()
+    : unlocked(recomputeWorkerLock != nullptr)
+{
+    if (unlocked) {
+        recomputeWorkerLock->unlock();
+    }
+}
+
+RecomputeUnlocker::~RecomputeUnlocker()
+{
+    if (unlocked) {
+        recomputeWorkerLock->lock();
+    }
+}
+
 /*!
   Does almost the same as topologicalSort() until no object with an input degree of zero
   can be found. It then searches for objects with an output degree of zero until neither
@@ -3442,6 +3903,8 @@ DocumentObject* Document::addObject(const char* sType,
     pcObject->pcNameInDocument = &(d->objectMap.find(ObjectName)->first);
     // insert in the vector
     d->objectArray.push_back(pcObject);
+    _dependencyChanged();
+    d->expressionIndex.addObject(pcObject);
     // Register the current Label even though it is (probably) about to change
     registerLabel(pcObject->Label.getStrValue());
 
@@ -3539,6 +4002,8 @@ Document::addObjects(const char* sType, const std::vector<std::string>& objectNa
         pcObject->pcNameInDocument = &(d->objectMap.find(ObjectName)->first);
         // insert in the vector
         d->objectArray.push_back(pcObject);
+        _dependencyChanged();
+        d->expressionIndex.addObject(pcObject);
         // Register the current Label even though it is about to change
         registerLabel(pcObject->Label.getStrValue());
 
@@ -3612,6 +4077,8 @@ void Document::addObject(DocumentObject* pcObject, const char* pObjectName)
     pcObject->pcNameInDocument = &(d->objectMap.find(ObjectName)->first);
     // insert in the vector
     d->objectArray.push_back(pcObject);
+    _dependencyChanged();
+    d->expressionIndex.addObject(pcObject);
     // Register the current Label even though it is about to change
     registerLabel(pcObject->Label.getStrValue());
 
@@ -3644,6 +4111,8 @@ void Document::_addObject(DocumentObject* pcObject, const char* pObjectName)
     }
     d->objectIdMap[pcObject->_Id] = pcObject;
     d->objectArray.push_back(pcObject);
+    _dependencyChanged();
+    d->expressionIndex.addObject(pcObject);
     registerLabel(pcObject->Label.getStrValue());
     // cache the pointer to the name string in the Object (for performance of
     // DocumentObject::getNameInDocument())
@@ -3764,6 +4233,9 @@ void Document::removeObject(const char* sName)
             break;
         }
     }
+    d->dirtyObjects.erase(pos->second);
+    d->expressionIndex.removeObject(pos->second);
+    _dependencyChanged();
 
     // In case the object gets deleted the pointer must be nullified
     if (tobedestroyed) {
@@ -3859,6 +4331,9 @@ void Document::_removeObject(DocumentObject* pcObject)
             break;
         }
     }
+    d->dirtyObjects.erase(pcObject);
+    d->expressionIndex.removeObject(pcObject);
+    _dependencyChanged();
 
     // for a rollback delete the object
     if (d->rollback) {
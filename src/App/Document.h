@@ -34,6 +34,7 @@
 #include "PropertyStandard.h"
 
 #include <map>
+#include <set>
 #include <vector>
 #include <utility>
 #include <list>
@@ -42,6 +43,7 @@
 
 namespace Base
 {
+class SequencerLauncher;
 class Writer;
 }
 
@@ -55,6 +57,7 @@ class DocumentPy;
 class Application;
 class Transaction;
 class StringHasher;
+class PropertyExpressionContainer;
 using StringHasherRef = Base::Reference<StringHasher>;
 
 /**
@@ -404,6 +407,35 @@ public:
                   int options = 0);
     /// Recompute only one feature
     bool recomputeFeature(DocumentObject* Feat, bool recursive = false);
+    /// Timing summary of the last recompute()
+    struct RecomputeStats
+    {
+        /// number of executed objects
+        int objectCount = 0;
+        /// number of objects executed by worker threads
+        int parallelCount = 0;
+        /// elapsed time of executing the objects in seconds
+        double wallTime = 0.0;
+        /// accumulated execution time of all objects in seconds
+        double serialTime = 0.0;
+        /// execution time of the most expensive dependency chain in seconds,
+        /// i.e. the lower bound of wallTime with unlimited worker threads
+        double criticalPathTime = 0.0;
+    };
+    /// get the timing summary of the last recompute
+    const RecomputeStats& getRecomputeStats() const;
+    /// Indicate if the current thread is a worker of a parallel recompute
+    static bool isRecomputeWorker();
+    /** Wait until the objects recomputed in parallel before the current one are done
+     *
+     * Called by a parallel recompute worker before it changes state shared by
+     * the objects in an order dependent way, e.g. before a StringHasher hands
+     * out a new ID. The objects then change it in the same order on every
+     * recompute, whatever the timing of the worker threads. The document lock
+     * is released while waiting. It does nothing if the current thread is not
+     * a recompute worker.
+     */
+    static void waitForRecomputeTurn();
     /// get the text of the error of a specified object
     const char* getErrorDescription(const App::DocumentObject*) const;
     /// return the status bits
@@ -580,6 +612,22 @@ public:
     /// Check if there is any link to the given object
     bool hasLinksTo(const DocumentObject* obj) const;
 
+    /** Return the expression bindings that depend on a property
+     *
+     * The bindings are looked up in an index of the expressions of this
+     * document, which is kept up to date on each change of an expression.
+     *
+     * @param obj: the referenced object
+     * @param propName: the referenced property, any property of \a obj if null
+     * @param recursive: also return the bindings depending on the properties
+     * set by the returned bindings
+     * @return the objects holding the expressions and the bound paths
+     */
+    std::vector<std::pair<App::DocumentObject*, App::ObjectIdentifier>>
+    getExpressionDependents(const DocumentObject* obj,
+                            const char* propName = nullptr,
+                            bool recursive = false) const;
+
     /// Called by objects during restore to ask for recompute
     void addRecomputeObject(DocumentObject* obj);
 
@@ -641,11 +689,27 @@ protected:
     /// helper which Recompute only this feature
     /// @return 0 if succeeded, 1 if failed, -1 if aborted by user.
     int _recomputeFeature(DocumentObject* Feat);
+    /// helper of recompute() which executes independent objects on worker threads
+    /// @return the number of executed objects, \a aborted is set if aborted by user.
+    int _recomputeParallel(const std::vector<App::DocumentObject*>& objs,
+                           std::set<App::DocumentObject*>& filter,
+                           std::map<const App::DocumentObject*, double>& timings,
+                           Base::SequencerLauncher* seq,
+                           bool* hasError,
+                           bool& aborted);
     void _clearRedos();
 
     /// refresh the internal dependency graph
     void _rebuildDependencyList(
         const std::vector<App::DocumentObject*>& objs = std::vector<App::DocumentObject*>());
+    /// invalidate the cached dependency list of all documents
+    static void _dependencyChanged();
+    /// called by the object on any change that may require recompute
+    void _objectTouched(DocumentObject* obj);
+    /// called by an expression container of an object on any change of its expressions
+    void _expressionsChanged(const PropertyExpressionContainer* prop);
+    /// sorted dependency list of touched objects and the objects depending on them
+    std::vector<App::DocumentObject*> _getDirtyDependencyList(int options);
 
     std::string getTransientDirectoryName(const std::string& uuid,
                                           const std::string& filename) const;
@@ -681,6 +745,31 @@ private:
     bool autoCreated;    // Flag to know if the document was automatically created at startup
 };
 
+/** Temporarily release the document lock held by a parallel recompute worker
+ *
+ * With parallel recompute enabled, worker threads execute objects that return
+ * true in DocumentObject::canRecomputeInParallel() while holding a per document
+ * lock, so property changes, transactions and string hashers are still accessed
+ * by one thread at a time. An object may create an instance of this class on
+ * the stack around code that only reads its inputs and touches no document data,
+ * e.g. the OCC algorithm of a boolean operation, to let other workers proceed
+ * meanwhile. It does nothing if the current thread is not a recompute worker.
+ */
+class AppExport RecomputeUnlocker
+{
+public:
+    RecomputeUnlocker();
+    ~RecomputeUnlocker();
+
+    RecomputeUnlocker(const RecomputeUnlocker&) = delete;
+    RecomputeUnlocker(RecomputeUnlocker&&) = delete;
+    RecomputeUnlocker& operator=(const RecomputeUnlocker&) = delete;
+    RecomputeUnlocker& operator=(RecomputeUnlocker&&) = delete;
+
+private:
+    bool unlocked;
+};
+
 template<typename T>
 inline std::vector<T*> Document::getObjectsOfType() const
 {
@@ -1,6 +1,6 @@
 from PropertyContainer import PropertyContainer
 from DocumentObject import DocumentObject
-from typing import Final, List, Tuple, Sequence
+from typing import Final, List, Tuple, Sequence, Dict
 
 
 class Document(PropertyContainer):
@@ -79,6 +79,15 @@ class Document(PropertyContainer):
     OldLabel: Final[str] = ""
     """Contains the old label before change"""
 
+    RecomputeStats: Final[Dict[str, float]] = {}
+    """Timing summary of the last recompute.
+
+    ObjectCount: number of executed objects
+    ParallelCount: number of objects executed by worker threads
+    WallTime: elapsed time of executing the objects in seconds
+    SerialTime: accumulated execution time of all objects in seconds
+    CriticalPathTime: execution time of the most expensive dependency chain in seconds"""
+
     Temporary: Final[bool] = False
     """Check if this is a temporary document"""
 
@@ -405,3 +414,19 @@ class Document(PropertyContainer):
         sort: whether to topologically sort the return list
         """
         ...
+
+    def getExpressionDependents(
+        self, obj: DocumentObject, prop: str = None, recursive: bool = False
+    ) -> List[Tuple[DocumentObject, str]]:
+        """
+        getExpressionDependents(obj, prop=None, recursive=False)
+
+        Returns the expression bindings of this document that depend on a property,
+        as a list of tuples (object, path).
+
+        obj: the referenced object
+        prop: the name of the referenced property, any property of obj if None
+        recursive: whether to also return the bindings depending on the properties
+        set by the returned bindings
+        """
+        ...
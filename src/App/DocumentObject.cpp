@@ -220,6 +220,7 @@ void DocumentObject::touch(bool noRecompute)
     }
     StatusBits.set(ObjectStatus::Touch);
     if (_pDoc) {
+        _pDoc->_objectTouched(this);
         _pDoc->signalTouchedObject(*this);
     }
 }
@@ -862,6 +863,10 @@ void DocumentObject::onChanged(const Property* prop)
         _pDoc->signalRelabelObject(*this);
     }
 
+    if (_pDoc) {
+        _pDoc->_objectTouched(this);
+    }
+
     // set object touched if it is an input property
     if (!testStatus(ObjectStatus::NoTouch) && !(prop->getType() & Prop_Output)
         && !prop->testStatus(Property::Output)) {
@@ -891,6 +896,7 @@ void DocumentObject::clearOutListCache() const
     _outList.clear();
     _outListMap.clear();
     _outListCached = false;
+    Document::_dependencyChanged();
 }
 
 PyObject* DocumentObject::getPyObject()
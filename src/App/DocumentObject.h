@@ -673,6 +673,27 @@ public:
         return 0;
     }
 
+    /** allow parallel recompute
+     *
+     * @return Returns true if this object can be executed by a worker thread
+     * when parallel recompute is enabled (see parameter
+     * BaseApp/Preferences/Document/ParallelRecompute). The worker holds the
+     * document lock while executing, so the object may change its properties
+     * as usual, but must not use anything that is bound to the main thread,
+     * e.g. the progress sequencer or process wide state like the signal handlers
+     * of Base::SignalException. Use App::RecomputeUnlocker around the
+     * actual heavy computation to let other objects run concurrently.
+     *
+     * The change signals of the document are emitted by the main thread
+     * once the workers are done, so when Document::signalBeforeChangeObject
+     * is emitted the property already holds its new value. Objects with
+     * observers that need the old value in that signal must return false.
+     */
+    virtual bool canRecomputeInParallel() const
+    {
+        return false;
+    }
+
     virtual void onUpdateElementReference(const Property*)
     {}
 
@@ -31,6 +31,7 @@
 #include "DocumentObject.h"
 #include "DocumentObjectPy.h"
 #include "MergeDocuments.h"
+#include "ObjectIdentifier.h"
 
 // inclusion of the generated files (generated By DocumentPy.xml)
 #include "DocumentPy.h"
@@ -1159,6 +1160,37 @@ PyObject* DocumentPy::getDependentDocuments(PyObject* args)
     PY_CATCH;
 }
 
+PyObject* DocumentPy::getExpressionDependents(PyObject* args)
+{
+    PyObject* pyobj {};
+    const char* prop = nullptr;
+    PyObject* recursive = Py_False;
+    if (!PyArg_ParseTuple(args,
+                          "O!|zO!",
+                          &DocumentObjectPy::Type,
+                          &pyobj,
+                          &prop,
+                          &PyBool_Type,
+                          &recursive)) {
+        return nullptr;
+    }
+    PY_TRY
+    {
+        auto obj = static_cast<DocumentObjectPy*>(pyobj)->getDocumentObjectPtr();
+        auto bindings =
+            getDocumentPtr()->getExpressionDependents(obj, prop, Base::asBoolean(recursive));
+        Py::List ret;
+        for (const auto& binding : bindings) {
+            Py::Tuple tuple(2);
+            tuple.setItem(0, Py::Object(binding.first->getPyObject(), true));
+            tuple.setItem(1, Py::String(binding.second.toString()));
+            ret.append(tuple);
+        }
+        return Py::new_reference_to(ret);
+    }
+    PY_CATCH;
+}
+
 Py::Boolean DocumentPy::getRestoring() const
 {
     return {getDocumentPtr()->testStatus(Document::Status::Restoring)};
@@ -1189,6 +1221,18 @@ Py::String DocumentPy::getOldLabel() const
     return {getDocumentPtr()->getOldLabel()};
 }
 
+Py::Dict DocumentPy::getRecomputeStats() const
+{
+    const auto& stats = getDocumentPtr()->getRecomputeStats();
+    Py::Dict dict;
+    dict.setItem("ObjectCount", Py::Long(stats.objectCount));
+    dict.setItem("ParallelCount", Py::Long(stats.parallelCount));
+    dict.setItem("WallTime", Py::Float(stats.wallTime));
+    dict.setItem("SerialTime", Py::Float(stats.serialTime));
+    dict.setItem("CriticalPathTime", Py::Float(stats.criticalPathTime));
+    return dict;
+}
+
 Py::Boolean DocumentPy::getTemporary() const
 {
     return {getDocumentPtr()->testStatus(Document::TempDoc)};
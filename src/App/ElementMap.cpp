@@ -1,5 +1,6 @@
 #include "PreCompiled.h"
 #ifndef _PreComp_
+#include <algorithm>
 #include <unordered_map>
 #ifndef FC_DEBUG
 #include <random>
@@ -811,6 +812,27 @@ void ElementMap::erase(const IndexedName& idx)
     ref.clear();
 }
 
+void ElementMap::reserve(std::size_t count)
+{
+    mappedNames.reserve(count);
+}
+
+std::size_t ElementMap::MappedNameHasher::operator()(const MappedName& name) const
+{
+    // FNV-1a over the concatenation of data and postfix, because two names
+    // are equal as long as their combined bytes are equal.
+    std::size_t hash = 14695981039346656037ULL;
+    auto feed = [&hash](const QByteArray& bytes) {
+        for (char c : bytes) {
+            hash ^= static_cast<unsigned char>(c);
+            hash *= 1099511628211ULL;
+        }
+    };
+    feed(name.dataBytes());
+    feed(name.postfixBytes());
+    return hash;
+}
+
 unsigned long ElementMap::size() const
 {
     return mappedNames.size() + childElementSize;
@@ -1077,8 +1099,17 @@ void ElementMap::collectChildMaps(std::map<const ElementMap*, int>& childMapSet,
         }
     }
 
+    // Visit the names in sorted order to keep the postfix indices stable
+    std::vector<const MappedName*> names;
+    names.reserve(this->mappedNames.size());
     for (auto& mappedName : this->mappedNames) {
-        addPostfix(mappedName.first.constPostfix(), postfixMap, postfixes);
+        names.push_back(&mappedName.first);
+    }
+    std::sort(names.begin(), names.end(), [](const MappedName* a, const MappedName* b) {
+        return *a < *b;
+    });
+    for (auto name : names) {
+        addPostfix(name->constPostfix(), postfixMap, postfixes);
     }
 
     childMaps.push_back(this);
@@ -1307,6 +1338,9 @@ std::vector<MappedElement> ElementMap::getAll() const
     for (auto& mappedName : this->mappedNames) {
         ret.emplace_back(mappedName.first, mappedName.second);
     }
+    std::sort(ret.begin(), ret.end(), [](const MappedElement& a, const MappedElement& b) {
+        return a.name < b.name;
+    });
     for (auto& childElement : this->childElements) {
         auto& child = *childElement.childMap;
         IndexedName idx(child.indexedName);
@@ -37,6 +37,7 @@
 #include <functional>
 #include <map>
 #include <memory>
+#include <unordered_map>
 
 
 namespace Data
@@ -150,6 +151,13 @@ public:
 
     unsigned long size() const;
 
+    /** Reserve space for the given number of mapped names
+     *
+     * Call this before adding names in bulk, e.g. when building the element
+     * map of a new shape, to avoid rehashing the name lookup table.
+     */
+    void reserve(std::size_t count);
+
     bool empty() const;
 
     IndexedName find(const MappedName& name, ElementIDRefs* sids = nullptr) const;
@@ -303,7 +311,13 @@ private:
 
     std::map<const char*, IndexedElements, CStringComp> indexedNames;
 
-    std::map<MappedName, IndexedName, std::less<>> mappedNames;
+    /// Hashes the content of a MappedName consistently with MappedName::operator==()
+    struct MappedNameHasher
+    {
+        std::size_t operator()(const MappedName& name) const;
+    };
+
+    std::unordered_map<MappedName, IndexedName, MappedNameHasher> mappedNames;
 
     struct ChildMapInfo
     {
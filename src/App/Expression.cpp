@@ -52,6 +52,7 @@
 #include <Base/Tools.h>
 #include <Base/VectorPy.h>
 
+#include "CompiledExpression.h"
 #include "ExpressionParser.h"
 
 
@@ -1092,10 +1093,23 @@ ExpressionPtr Expression::replaceObject(const DocumentObject *parent,
 }
 
 App::any Expression::getValueAsAny() const {
+    if (auto code = getCompiled()) {
+        App::any value;
+        if (code->evaluate(value))
+            return value;
+    }
     Base::PyGILStateLocker lock;
     return pyObjectToAny(getPyValue());
 }
 
+const CompiledExpression* Expression::getCompiled() const {
+    if (!compileTried) {
+        compiled = CompiledExpression::compile(this);
+        compileTried = true;
+    }
+    return compiled.get();
+}
+
 Py::Object Expression::getPyValue() const {
     try {
         Py::Object pyobj = _getPyValue();
@@ -1113,13 +1127,21 @@ Py::Object Expression::getPyValue() const {
 void Expression::addComponent(Component *component) {
     assert(component);
     components.push_back(component);
+    compiled.reset();
+    compileTried = false;
 }
 
 void Expression::visit(ExpressionVisitor &v) {
+    int changed = v.changed();
     _visit(v);
     for(auto &c : components)
         c->visit(v);
     v.visit(*this);
+    if (v.changed() != changed) {
+        // e.g. a renamed reference may now refer to a property of another type
+        compiled.reset();
+        compileTried = false;
+    }
 }
 
 Expression* Expression::eval() const {
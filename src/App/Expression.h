@@ -44,6 +44,7 @@ namespace App  {
 class DocumentObject;
 class Expression;
 class Document;
+class CompiledExpression;
 
 using ExpressionPtr = std::unique_ptr<Expression>;
 
@@ -186,6 +187,16 @@ public:
 
     boost::any getValueAsAny() const;
 
+    /** Get the native evaluation form of the expression, see App::CompiledExpression
+     *
+     * The expression is compiled on the first call, and again after it has been changed.
+     * getValueAsAny() uses it when available, so calling this is only needed to compile
+     * the expression in advance.
+     *
+     * @return The compiled expression, or null if it can only be evaluated by Python.
+     */
+    const CompiledExpression* getCompiled() const;
+
     Py::Object getPyValue() const;
 
     bool isSame(const Expression &other, bool checkComment=true) const;
@@ -222,6 +233,9 @@ protected:
 
     ComponentList components;
 
+    mutable std::unique_ptr<CompiledExpression> compiled;
+    mutable bool compileTried = false;
+
 public:
     std::string comment;
     // clang-format on
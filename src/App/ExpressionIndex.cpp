@@ -0,0 +1,220 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/***************************************************************************
+ *   This file is part of FreeCAD.                                         *
+ *                                                                         *
+ *   FreeCAD is free software: you can redistribute it and/or modify it    *
+ *   under the terms of the GNU Lesser General Public License as           *
+ *   published by the Free Software Foundation, either version 2.1 of the  *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   FreeCAD is distributed in the hope that it will be useful, but        *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with FreeCAD. If not, see                               *
+ *   <https://www.gnu.org/licenses/>.                                      *
+ *                                                                         *
+ **************************************************************************/
+
+#include "PreCompiled.h"
+
+#include <tuple>
+
+#include "ExpressionIndex.h"
+#include "DocumentObject.h"
+#include "Expression.h"
+#include "PropertyExpressionEngine.h"
+
+
+using namespace App;
+
+bool ExpressionIndex::Entry::operator<(const Entry& other) const
+{
+    return std::tie(object, container, path)
+        < std::tie(other.object, other.container, other.path);
+}
+
+void ExpressionIndex::addObject(DocumentObject* obj)
+{
+    markDirty(obj);
+    // On undo, the expressions of other objects may refer to the object again
+    for (auto dep : obj->getInList()) {
+        if (dep->getDocument() == obj->getDocument()) {
+            markDirty(dep);
+        }
+    }
+}
+
+void ExpressionIndex::removeObject(DocumentObject* obj)
+{
+    for (auto it = dirty.begin(); it != dirty.end();) {
+        if (it->first == obj) {
+            it = dirty.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+    auto it = references.lower_bound(Container(obj, std::string()));
+    while (it != references.end() && it->first.first == obj) {
+        auto container = it->first;
+        ++it;
+        removeContainer(container);
+    }
+
+    // The bindings referencing the object are indexed again, without it
+    auto found = bindings.find(obj);
+    if (found != bindings.end()) {
+        for (const auto& prop : found->second) {
+            for (const auto& entry : prop.second) {
+                if (entry.object != obj) {
+                    dirty.emplace(entry.object, entry.container);
+                }
+            }
+        }
+        bindings.erase(found);
+    }
+}
+
+void ExpressionIndex::invalidate(const PropertyExpressionContainer* prop)
+{
+    auto owner = freecad_cast<DocumentObject*>(prop->getContainer());
+    if (owner && prop->getName()) {
+        dirty.emplace(owner, prop->getName());
+    }
+}
+
+void ExpressionIndex::clear()
+{
+    references.clear();
+    bindings.clear();
+    dirty.clear();
+}
+
+void ExpressionIndex::markDirty(DocumentObject* obj) const
+{
+    std::vector<Property*> props;
+    obj->getPropertyList(props);
+    for (auto prop : props) {
+        if (prop->isDerivedFrom<PropertyExpressionContainer>() && prop->getName()) {
+            dirty.emplace(obj, prop->getName());
+        }
+    }
+}
+
+void ExpressionIndex::removeContainer(const Container& container) const
+{
+    auto it = references.find(container);
+    if (it == references.end()) {
+        return;
+    }
+    for (const auto& ref : it->second) {
+        auto found = bindings.find(ref.object);
+        if (found == bindings.end()) {
+            continue;
+        }
+        auto entries = found->second.find(ref.property);
+        if (entries == found->second.end()) {
+            continue;
+        }
+        entries->second.erase(Entry {container.first, container.second, ref.path});
+        if (entries->second.empty()) {
+            found->second.erase(entries);
+            if (found->second.empty()) {
+                bindings.erase(found);
+            }
+        }
+    }
+    references.erase(it);
+}
+
+void ExpressionIndex::update() const
+{
+    for (const auto& container : dirty) {
+        removeContainer(container);
+
+        DocumentObject* obj = container.first;
+        if (!obj->isAttachedToDocument()) {
+            continue;
+        }
+        auto prop = freecad_cast<PropertyExpressionContainer*>(
+            obj->getPropertyByName(container.second.c_str()));
+        if (!prop) {
+            continue;
+        }
+
+        std::vector<Reference> refs;
+        for (const auto& expr : prop->getExpressions()) {
+            if (!expr.second) {
+                continue;
+            }
+            for (const auto& dep : expr.second->getDeps(Expression::DepAll)) {
+                if (!dep.first) {
+                    continue;
+                }
+                for (const auto& propDeps : dep.second) {
+                    refs.push_back(Reference {dep.first, propDeps.first, expr.first});
+                    bindings[dep.first][propDeps.first].insert(
+                        Entry {obj, container.second, expr.first});
+                }
+            }
+        }
+        if (!refs.empty()) {
+            references.emplace(container, std::move(refs));
+        }
+    }
+    dirty.clear();
+}
+
+std::vector<ExpressionIndex::Binding> ExpressionIndex::getBindings(const DocumentObject* obj,
+                                                                   const char* propName) const
+{
+    update();
+
+    std::vector<Binding> result;
+    auto found = bindings.find(obj);
+    if (found == bindings.end()) {
+        return result;
+    }
+
+    std::set<Binding> done;
+    auto add = [&](const std::set<Entry>& entries) {
+        for (const auto& entry : entries) {
+            Binding binding(entry.object, entry.path);
+            if (done.insert(binding).second) {
+                result.push_back(std::move(binding));
+            }
+        }
+    };
+    if (propName) {
+        auto entries = found->second.find(propName);
+        if (entries != found->second.end()) {
+            add(entries->second);
+        }
+    }
+    else {
+        for (const auto& entries : found->second) {
+            add(entries.second);
+        }
+    }
+    return result;
+}
+
+std::set<DocumentObject*> ExpressionIndex::getDependentObjects(const DocumentObject* obj) const
+{
+    update();
+
+    std::set<DocumentObject*> result;
+    auto found = bindings.find(obj);
+    if (found != bindings.end()) {
+        for (const auto& entries : found->second) {
+            for (const auto& entry : entries.second) {
+                result.insert(entry.object);
+            }
+        }
+    }
+    return result;
+}
@@ -0,0 +1,108 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/***************************************************************************
+ *   This file is part of FreeCAD.                                         *
+ *                                                                         *
+ *   FreeCAD is free software: you can redistribute it and/or modify it    *
+ *   under the terms of the GNU Lesser General Public License as           *
+ *   published by the Free Software Foundation, either version 2.1 of the  *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   FreeCAD is distributed in the hope that it will be useful, but        *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with FreeCAD. If not, see                               *
+ *   <https://www.gnu.org/licenses/>.                                      *
+ *                                                                         *
+ **************************************************************************/
+
+#ifndef APP_EXPRESSIONINDEX_H
+#define APP_EXPRESSIONINDEX_H
+
+#include <map>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <App/ObjectIdentifier.h>
+
+namespace App
+{
+
+class DocumentObject;
+class PropertyExpressionContainer;
+
+/** Reverse index of the expressions of a document
+ *
+ * Maps each referenced property to the expression bindings that read it, so that the
+ * bindings depending on a property are found without visiting all expressions of the
+ * document. A changed expression container is only marked, and indexed again on the next
+ * query, so that editing many expressions in a row stays cheap.
+ *
+ * The containers are identified by their object and name, the objects are added and
+ * removed together with the objects of the document.
+ */
+class ExpressionIndex
+{
+public:
+    /// An expression binding: the object holding the expression and the bound path
+    using Binding = std::pair<App::DocumentObject*, App::ObjectIdentifier>;
+
+    /// Index the expressions of an object added to the document
+    void addObject(App::DocumentObject* obj);
+    /// Forget the expressions of an object removed from the document
+    void removeObject(App::DocumentObject* obj);
+    /// Index the expressions of \a prop again
+    void invalidate(const App::PropertyExpressionContainer* prop);
+    void clear();
+
+    /** The bindings whose expression references a property
+     * @param obj the referenced object
+     * @param propName the referenced property, any property of \a obj if null
+     */
+    std::vector<Binding> getBindings(const App::DocumentObject* obj,
+                                     const char* propName = nullptr) const;
+
+    /// The objects holding an expression that references \a obj
+    std::set<App::DocumentObject*> getDependentObjects(const App::DocumentObject* obj) const;
+
+private:
+    using Container = std::pair<App::DocumentObject*, std::string>;
+
+    struct Entry
+    {
+        App::DocumentObject* object;
+        std::string container;
+        App::ObjectIdentifier path;
+
+        bool operator<(const Entry& other) const;
+    };
+
+    struct Reference
+    {
+        const App::DocumentObject* object;
+        std::string property;
+        App::ObjectIdentifier path;
+    };
+
+    void update() const;
+    void removeContainer(const Container& container) const;
+    void markDirty(App::DocumentObject* obj) const;
+
+private:
+    // The properties referenced by each container
+    mutable std::map<Container, std::vector<Reference>> references;
+    // The bindings referencing each property
+    mutable std::unordered_map<const App::DocumentObject*, std::map<std::string, std::set<Entry>>>
+        bindings;
+    mutable std::set<Container> dirty;
+};
+
+}  // namespace App
+
+#endif  // APP_EXPRESSIONINDEX_H
@@ -24,7 +24,9 @@
 #include "PreCompiled.h"
 #ifndef _PreComp_
 #include <boost/core/ignore_unused.hpp>
+#include <chrono>
 #include <sstream>
+#include <thread>
 #endif
 
 #include <Base/Console.h>
@@ -33,9 +35,11 @@
 #include <Base/Unit.h>
 #include <CXX/Objects.hxx>
 
+#include "Document.h"
 #include "FeatureTest.h"
 #include "Material.h"
 #include "Range.h"
+#include "StringHasher.h"
 
 #ifdef _MSC_VER
 #pragma warning(disable : 4700)
@@ -371,3 +375,38 @@ DocumentObjectExecReturn* FeatureTestAttribute::execute()
     }
     return StdReturn;
 }
+
+// ----------------------------------------------------------------------------
+
+PROPERTY_SOURCE(App::FeatureTestParallel, App::DocumentObject)
+
+
+FeatureTestParallel::FeatureTestParallel()
+{
+    ADD_PROPERTY_TYPE(Source, (nullptr), "Test", Prop_None, "");
+    ADD_PROPERTY_TYPE(Value, (0), "Test", Prop_None, "");
+    ADD_PROPERTY_TYPE(Result, (0), "Test", Prop_Output, "");
+    ADD_PROPERTY_TYPE(Worker, (false), "Test", Prop_Output, "");
+    ADD_PROPERTY_TYPE(Delay, (0), "Test", Prop_None, "");
+    ADD_PROPERTY_TYPE(Strings, (), "Test", Prop_None, "");
+}
+
+DocumentObjectExecReturn* FeatureTestParallel::execute()
+{
+    long result = Value.getValue();
+    if (auto source = freecad_cast<FeatureTestParallel*>(Source.getValue())) {
+        result += source->Result.getValue();
+    }
+    Result.setValue(result);
+    Worker.setValue(Document::isRecomputeWorker());
+    if (Delay.getValue() > 0) {
+        RecomputeUnlocker unlocker;
+        std::this_thread::sleep_for(std::chrono::milliseconds(Delay.getValue()));
+    }
+    if (StringHasherRef hasher = getDocument()->getStringHasher()) {
+        for (const auto& str : Strings.getValues()) {
+            hasher->getID(str.c_str());
+        }
+    }
+    return StdReturn;
+}
@@ -218,6 +218,31 @@ public:
     App::PropertyString Attribute;
 };
 
+/// Feature that is executed by the workers of a parallel recompute
+class FeatureTestParallel: public DocumentObject
+{
+    PROPERTY_HEADER_WITH_OVERRIDE(App::FeatureTestParallel);
+
+public:
+    FeatureTestParallel();
+    DocumentObjectExecReturn* execute() override;
+    bool canRecomputeInParallel() const override
+    {
+        return true;
+    }
+
+    App::PropertyLink Source;
+    App::PropertyInteger Value;
+    /// the Value plus the Result of Source
+    App::PropertyInteger Result;
+    /// if the last execution ran in a worker thread
+    App::PropertyBool Worker;
+    /// milliseconds spent unlocked before interning Strings, to reorder the workers
+    App::PropertyInteger Delay;
+    /// interned into the string hasher of the document on execution
+    App::PropertyStringList Strings;
+};
+
 
 }  // namespace App
 
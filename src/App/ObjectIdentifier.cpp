@@ -1404,15 +1404,21 @@ ObjectIdentifier& ObjectIdentifier::operator<<(ObjectIdentifier::Component&& val
 
 /**
  * @brief Get pointer to property pointed to by this object identifier.
+ * @param ptype Returns the type of pseudo property, 0 for a real property.
+ * @param numSubComponents Returns the number of components starting at the property,
+ * the same as numSubComponents() without resolving the path again.
  * @return Point to property if it is uniquely defined, or 0 otherwise.
  */
 
-Property* ObjectIdentifier::getProperty(int* ptype) const
+Property* ObjectIdentifier::getProperty(int* ptype, int* numSubComponents) const
 {
     ResolveResults result(*this);
     if (ptype) {
         *ptype = result.propertyType;
     }
+    if (numSubComponents) {
+        *numSubComponents = static_cast<int>(components.size()) - result.propertyIndex;
+    }
     return result.resolvedProperty;
 }
 
@@ -424,7 +424,7 @@ public:
 
     bool isTouched() const;
 
-    App::Property* getProperty(int* ptype = nullptr) const;
+    App::Property* getProperty(int* ptype = nullptr, int* numSubComponents = nullptr) const;
 
     App::ObjectIdentifier canonicalPath() const;
 
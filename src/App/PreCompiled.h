@@ -68,6 +68,7 @@
 #include <sstream>
 
 // STL
+#include <atomic>
 #include <bitset>
 #include <chrono>
 #include <exception>
@@ -77,11 +78,13 @@
 #include <list>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <queue>
 #include <random>
 #include <set>
 #include <stack>
 #include <string>
+#include <thread>
 #include <tuple>
 #include <unordered_map>
 #include <unordered_set>
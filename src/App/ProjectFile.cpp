@@ -49,6 +49,8 @@
 
 #include "ProjectFile.h"
 #include "DocumentObject.h"
+#include <Base/BinaryXML.h>
+#include <Base/Exception.h>
 #include <Base/FileInfo.h>
 #include <Base/InputSource.h>
 #include <Base/Reader.h>
@@ -217,6 +219,17 @@ bool ProjectFile::loadDocument()
         return false;
     }
     std::unique_ptr<std::istream> str(project.getInputStream("Document.xml"));
+    if (str && Base::BinaryXML::isBinaryXML(*str)) {
+        // convert the binary encoding back to XML text for the DOM parser
+        auto text = std::make_unique<std::stringstream>();
+        try {
+            Base::BinaryXMLDecoder::toXML(*str, *text);
+        }
+        catch (const Base::Exception&) {
+            return false;
+        }
+        str = std::move(text);
+    }
     if (str) {
         std::unique_ptr<XercesDOMParser> parser(new XercesDOMParser);
         parser->setValidationScheme(XercesDOMParser::Val_Auto);
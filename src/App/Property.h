@@ -213,6 +213,27 @@ public:
         return false;
     }
 
+    /** Get the value of the property, or of a path in it, as a number without using Python
+     *
+     * Used by the native evaluation of expressions, see App::CompiledExpression. The value
+     * must be what App::pyObjectToAny() makes of the Python value of the path: a
+     * Base::Quantity, a double or a long, also for booleans.
+     *
+     * @param path the path, it is resolved to this property
+     * @param numSubComponents the number of components of the path starting at the property
+     * @param value returns the value
+     * @return false if the value is not a number or needs Python
+     */
+    virtual bool getNumericPathValue(const App::ObjectIdentifier& path,
+                                     int numSubComponents,
+                                     boost::any& value) const
+    {
+        (void)path;
+        (void)numSubComponents;
+        (void)value;
+        return false;
+    }
+
     /// Convert p to a canonical representation of it
     virtual App::ObjectIdentifier canonicalPath(const App::ObjectIdentifier& p) const;
 
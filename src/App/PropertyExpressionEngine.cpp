@@ -62,6 +62,16 @@ PropertyExpressionContainer::~PropertyExpressionContainer()
     _ExprContainers.erase(this);
 }
 
+void PropertyExpressionContainer::hasSetValue()
+{
+    // Keep the expression index of the document up to date
+    auto owner = freecad_cast<DocumentObject*>(getContainer());
+    if (owner && owner->isAttachedToDocument()) {
+        owner->getDocument()->_expressionsChanged(this);
+    }
+    PropertyXLinkContainer::hasSetValue();
+}
+
 void PropertyExpressionContainer::slotRelabelDocument(const App::Document& doc)
 {
     // For use a private _ExprContainers to track all living
@@ -135,6 +145,8 @@ Property* PropertyExpressionEngine::Copy() const
 
 void PropertyExpressionEngine::hasSetValue()
 {
+    invalidateEvaluationOrder();
+
     App::DocumentObject* owner = dynamic_cast<App::DocumentObject*>(getContainer());
     if (!owner || !owner->isAttachedToDocument() || owner->isRestoring()
         || testFlag(LinkDetached)) {
@@ -580,6 +592,30 @@ protected:
  * dependencies.
  */
 
+static bool isExecuted(const ObjectIdentifier& path,
+                       PropertyExpressionEngine::ExecuteOption option)
+{
+    if (option == PropertyExpressionEngine::ExecuteAll) {
+        return true;
+    }
+    auto prop = path.getProperty();
+    if (!prop) {
+        throw Base::RuntimeError("Path does not resolve to a property.");
+    }
+    bool is_output =
+        prop->testStatus(App::Property::Output) || (prop->getType() & App::Prop_Output);
+    if ((is_output && option == PropertyExpressionEngine::ExecuteNonOutput)
+        || (!is_output && option == PropertyExpressionEngine::ExecuteOutput)) {
+        return false;
+    }
+    if (option == PropertyExpressionEngine::ExecuteOnRestore
+        && !prop->testStatus(Property::Transient) && !(prop->getType() & Prop_Transient)
+        && !prop->testStatus(Property::EvalOnRestore)) {
+        return false;
+    }
+    return true;
+}
+
 void PropertyExpressionEngine::buildGraph(const ExpressionMap& exprs,
                                           boost::unordered_map<int, ObjectIdentifier>& revNodes,
                                           DiGraph& g,
@@ -590,22 +626,8 @@ void PropertyExpressionEngine::buildGraph(const ExpressionMap& exprs,
 
     // Build data structure for graph
     for (const auto& expr : exprs) {
-        if (option != ExecuteAll) {
-            auto prop = expr.first.getProperty();
-            if (!prop) {
-                throw Base::RuntimeError("Path does not resolve to a property.");
-            }
-            bool is_output =
-                prop->testStatus(App::Property::Output) || (prop->getType() & App::Prop_Output);
-            if ((is_output && option == ExecuteNonOutput)
-                || (!is_output && option == ExecuteOutput)) {
-                continue;
-            }
-            if (option == ExecuteOnRestore && !prop->testStatus(Property::Transient)
-                && !(prop->getType() & Prop_Transient)
-                && !prop->testStatus(Property::EvalOnRestore)) {
-                continue;
-            }
+        if (!isExecuted(expr.first, option)) {
+            continue;
         }
         buildGraphStructures(expr.first, expr.second.expression, nodes, revNodes, edges);
     }
@@ -635,30 +657,63 @@ void PropertyExpressionEngine::buildGraph(const ExpressionMap& exprs,
  * The code below builds a graph for all expressions in the engine, and
  * finds any circular dependencies. It also computes the internal evaluation
  * order, in case properties depends on each other.
+ *
+ * The order of all expressions is kept until they change, see
+ * invalidateEvaluationOrder(). The order for the other options is taken from
+ * it, as a subset of a topological order is a valid order of its own.
  */
 
 std::vector<App::ObjectIdentifier>
 PropertyExpressionEngine::computeEvaluationOrder(ExecuteOption option)
 {
-    std::vector<App::ObjectIdentifier> evaluationOrder;
-    boost::unordered_map<int, ObjectIdentifier> revNodes;
-    DiGraph g;
+    if (!evaluationOrderValid) {
+        std::vector<App::ObjectIdentifier> order;
+        boost::unordered_map<int, ObjectIdentifier> revNodes;
+        DiGraph g;
 
-    buildGraph(expressions, revNodes, g, option);
+        buildGraph(expressions, revNodes, g);
 
-    /* Compute evaluation order for expressions */
-    std::vector<int> c;
-    topological_sort(g, std::back_inserter(c));
+        /* Compute evaluation order for expressions */
+        std::vector<int> c;
+        topological_sort(g, std::back_inserter(c));
 
-    for (int i : c) {
-        // we return the evaluation order for our properties, not the dependencies
-        // the topo sort will contain node ids for both our props and their deps
-        if (revNodes.find(i) != revNodes.end()) {
-            evaluationOrder.push_back(revNodes[i]);
+        for (int i : c) {
+            // we return the evaluation order for our properties, not the dependencies
+            // the topo sort will contain node ids for both our props and their deps
+            if (revNodes.find(i) != revNodes.end()) {
+                order.push_back(revNodes[i]);
+            }
         }
+
+        evaluationOrder = std::move(order);
+        evaluationOrderValid = true;
+    }
+
+    if (option == ExecuteAll) {
+        return evaluationOrder;
     }
 
-    return evaluationOrder;
+    std::vector<App::ObjectIdentifier> order;
+    for (const auto& path : evaluationOrder) {
+        if (isExecuted(path, option)) {
+            order.push_back(path);
+        }
+    }
+    return order;
+}
+
+/**
+ * @brief Discard the cached evaluation order.
+ *
+ * Called whenever the set of expressions or their references change, i.e. on
+ * setValue(), renames and restore, which all end in hasSetValue(), and when
+ * element or document references are updated.
+ */
+
+void PropertyExpressionEngine::invalidateEvaluationOrder()
+{
+    evaluationOrderValid = false;
+    evaluationOrder.clear();
 }
 
 /**
@@ -722,15 +777,15 @@ DocumentObjectExecReturn* App::PropertyExpressionEngine::execute(ExecuteOption o
     resetter r(running);
 
     // Compute evaluation order
-    std::vector<App::ObjectIdentifier> evaluationOrder = computeEvaluationOrder(option);
-    std::vector<ObjectIdentifier>::const_iterator it = evaluationOrder.begin();
+    std::vector<App::ObjectIdentifier> order = computeEvaluationOrder(option);
+    std::vector<ObjectIdentifier>::const_iterator it = order.begin();
 
 #ifdef FC_PROPERTYEXPRESSIONENGINE_LOG
     std::clog << "Computing expressions for " << getName() << std::endl;
 #endif
 
     /* Evaluate the expressions, and update properties */
-    for (; it != evaluationOrder.end(); ++it) {
+    for (; it != order.end(); ++it) {
 
         // Get property to update
         Property* prop = it->getProperty();
@@ -1047,6 +1102,7 @@ void PropertyExpressionEngine::updateElementReference(DocumentObject* feature,
         if (e.second.expression) {
             e.second.expression->visit(v);
             if (v.changed()) {
+                invalidateEvaluationOrder();
                 expressionChanged(e.first);
                 v.reset();
             }
@@ -1200,6 +1256,7 @@ void PropertyExpressionEngine::setExpressions(
 
 void PropertyExpressionEngine::onRelabeledDocument(const App::Document& doc)
 {
+    invalidateEvaluationOrder();
     RelabelDocumentExpressionVisitor v(doc);
     for (auto& e : expressions) {
         if (e.second.expression) {
@@ -58,6 +58,7 @@ public:
     virtual void setExpressions(std::map<App::ObjectIdentifier, App::ExpressionPtr>&& exprs) = 0;
 
 protected:
+    void hasSetValue() override;
     virtual void onRelabeledDocument(const App::Document& doc) = 0;
 
 private:
@@ -202,6 +203,7 @@ private:
 #endif
 
     std::vector<App::ObjectIdentifier> computeEvaluationOrder(ExecuteOption option);
+    void invalidateEvaluationOrder();
 
     void buildGraphStructures(const App::ObjectIdentifier& path,
                               const std::shared_ptr<Expression> expression,
@@ -223,6 +225,10 @@ private:
 
     ExpressionMap expressions; /**< Stored expressions */
 
+    /**< Evaluation order of all expressions, kept until the expressions change */
+    std::vector<App::ObjectIdentifier> evaluationOrder;
+    bool evaluationOrderValid = false;
+
     ValidatorFunc validator; /**< Valdiator functor */
 
     struct RestoredExpression
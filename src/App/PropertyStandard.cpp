@@ -164,6 +164,17 @@ void PropertyInteger::setPathValue(const ObjectIdentifier& path, const boost::an
     }
 }
 
+bool PropertyInteger::getNumericPathValue(const ObjectIdentifier& /*path*/,
+                                          int numSubComponents,
+                                          boost::any& value) const
+{
+    if (numSubComponents != 1) {
+        return false;
+    }
+    value = _lValue;
+    return true;
+}
+
 
 //**************************************************************************
 //**************************************************************************
@@ -1116,6 +1127,17 @@ const boost::any PropertyFloat::getPathValue(const ObjectIdentifier& path) const
     return _dValue;
 }
 
+bool PropertyFloat::getNumericPathValue(const ObjectIdentifier& /*path*/,
+                                        int numSubComponents,
+                                        boost::any& value) const
+{
+    if (numSubComponents != 1) {
+        return false;
+    }
+    value = _dValue;
+    return true;
+}
+
 //**************************************************************************
 //**************************************************************************
 // PropertyFloatConstraint
@@ -2117,6 +2139,18 @@ const boost::any PropertyBool::getPathValue(const ObjectIdentifier& path) const
     return _lValue;
 }
 
+bool PropertyBool::getNumericPathValue(const ObjectIdentifier& /*path*/,
+                                       int numSubComponents,
+                                       boost::any& value) const
+{
+    if (numSubComponents != 1) {
+        return false;
+    }
+    // Python booleans are converted to long
+    value = _lValue ? 1L : 0L;
+    return true;
+}
+
 //**************************************************************************
 //**************************************************************************
 // PropertyBoolList
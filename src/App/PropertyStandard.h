@@ -90,6 +90,9 @@ public:
     {
         return _lValue;
     }
+    bool getNumericPathValue(const App::ObjectIdentifier& path,
+                             int numSubComponents,
+                             boost::any& value) const override;
 
     bool isSame(const Property& other) const override
     {
@@ -580,6 +583,9 @@ public:
 
     void setPathValue(const App::ObjectIdentifier& path, const boost::any& value) override;
     const boost::any getPathValue(const App::ObjectIdentifier& path) const override;
+    bool getNumericPathValue(const App::ObjectIdentifier& path,
+                             int numSubComponents,
+                             boost::any& value) const override;
 
     bool isSame(const Property& other) const override
     {
@@ -958,6 +964,9 @@ public:
 
     void setPathValue(const App::ObjectIdentifier& path, const boost::any& value) override;
     const boost::any getPathValue(const App::ObjectIdentifier& path) const override;
+    bool getNumericPathValue(const App::ObjectIdentifier& path,
+                             int numSubComponents,
+                             boost::any& value) const override;
 
     bool isSame(const Property& other) const override
     {
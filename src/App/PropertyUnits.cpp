@@ -137,6 +137,18 @@ const boost::any PropertyQuantity::getPathValue(const ObjectIdentifier& /*path*/
     return quantity;
 }
 
+bool PropertyQuantity::getNumericPathValue(const ObjectIdentifier& /*path*/,
+                                           int numSubComponents,
+                                           boost::any& value) const
+{
+    if (numSubComponents != 1) {
+        return false;
+    }
+    // The same as getPyObject(), without the format
+    value = Quantity(_dValue, _Unit);
+    return true;
+}
+
 //**************************************************************************
 // PropertyQuantityConstraint
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
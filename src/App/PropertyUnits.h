@@ -84,6 +84,9 @@ public:
 
     void setPathValue(const App::ObjectIdentifier& path, const boost::any& value) override;
     const boost::any getPathValue(const App::ObjectIdentifier& path) const override;
+    bool getNumericPathValue(const App::ObjectIdentifier& path,
+                             int numSubComponents,
+                             boost::any& value) const override;
 
     bool isSame(const Property& other) const override
     {
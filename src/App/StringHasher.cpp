@@ -25,6 +25,8 @@
 #include <QCryptographicHash>
 #include <QHash>
 #include <deque>
+#include <mutex>
+#include <shared_mutex>
 
 #include <Base/Console.h>
 #include <Base/Reader.h>
@@ -39,6 +41,7 @@
 #include <boost/io/ios_state.hpp>
 #include <boost/iostreams/stream.hpp>
 
+#include "Document.h"
 #include "MappedElement.h"
 #include "StringHasher.h"
 #include "StringHasherPy.h"
@@ -83,8 +86,14 @@ class StringHasher::HashMap: public HashMapBase
 public:
     bool SaveAll = false;
     int Threshold = 0;
+
+    /// Guards the table, lookups take a shared lock, insertions an exclusive one
+    mutable std::shared_mutex mutex;
 };
 
+using ReadLock = std::shared_lock<std::shared_mutex>;
+using WriteLock = std::unique_lock<std::shared_mutex>;
+
 ///////////////////////////////////////////////////////////
 
 TYPESYSTEM_SOURCE_ABSTRACT(App::StringID, Base::BaseClass)
@@ -92,6 +101,7 @@ TYPESYSTEM_SOURCE_ABSTRACT(App::StringID, Base::BaseClass)
 StringID::~StringID()
 {
     if (_hasher) {
+        WriteLock lock(_hasher->_hashes->mutex);
         _hasher->_hashes->right.erase(_id);
     }
 }
@@ -196,6 +206,8 @@ void StringHasher::compact()
         return;
     }
 
+    WriteLock lock(_hashes->mutex);
+
     // Make a list of all the table entries that have only a single reference and are not marked
     // "persistent"
     std::deque<StringIDRef> pendings;
@@ -278,9 +290,12 @@ StringIDRef StringHasher::getID(const QByteArray& data, Options options)
         dataID._data = data;
     }
 
-    auto it = _hashes->left.find(&dataID);
-    if (it != _hashes->left.end()) {
-        return {it->first};
+    {
+        ReadLock lock(_hashes->mutex);
+        auto it = _hashes->left.find(&dataID);
+        if (it != _hashes->left.end()) {
+            return {it->first};
+        }
     }
 
     if (!hashed && !nocopy) {
@@ -295,8 +310,8 @@ StringIDRef StringHasher::getID(const QByteArray& data, Options options)
     if (hashed) {
         flags.setFlag(StringID::Flag::Hashed);
     }
-    StringIDRef sid(new StringID(lastID() + 1, dataID._data, flags));
-    return {insert(sid)};
+    StringIDRef sid(new StringID(0, dataID._data, flags));
+    return {insertNew(sid)};
 }
 
 StringIDRef StringHasher::getID(const Data::MappedName& name, const QVector<StringIDRef>& sids)
@@ -322,13 +337,16 @@ StringIDRef StringHasher::getID(const Data::MappedName& name, const QVector<Stri
     }
 
     // Check to see if there is already an entry in the hash table for this StringID
-    auto it = _hashes->left.find(&tempID);
-    if (it != _hashes->left.end()) {
-        auto res = StringIDRef(it->first);
-        if (indexed) {
-            res._index = indexed.getIndex();
+    {
+        ReadLock lock(_hashes->mutex);
+        auto it = _hashes->left.find(&tempID);
+        if (it != _hashes->left.end()) {
+            auto res = StringIDRef(it->first);
+            if (indexed) {
+                res._index = indexed.getIndex();
+            }
+            return res;
         }
-        return res;
     }
 
     if (!indexed && name.isRaw()) {
@@ -350,7 +368,7 @@ StringIDRef StringHasher::getID(const Data::MappedName& name, const QVector<Stri
     }
 
     // The real StringID object that we are going to insert
-    StringIDRef newStringIDRef(new StringID(lastID() + 1, tempID._data));
+    StringIDRef newStringIDRef(new StringID(0, tempID._data));
     StringID& newStringID = *newStringIDRef._sid;
     if (tempID._postfix.size() != 0) {
         newStringID._flags.setFlag(StringID::Flag::Postfixed);
@@ -430,7 +448,7 @@ StringIDRef StringHasher::getID(const Data::MappedName& name, const QVector<Stri
         }
     }
 
-    return {insert(newStringIDRef), indexed.getIndex()};
+    return {insertNew(newStringIDRef), indexed.getIndex()};
 }
 
 StringIDRef StringHasher::getID(long id, int index) const
@@ -438,6 +456,7 @@ StringIDRef StringHasher::getID(long id, int index) const
     if (id <= 0) {
         return {};
     }
+    ReadLock lock(_hashes->mutex);
     auto it = _hashes->right.find(id);
     if (it == _hashes->right.end()) {
         return {};
@@ -506,6 +525,8 @@ void StringHasher::saveStream(std::ostream& stream) const
     long lastID = 0;
     bool relative = false;
 
+    ReadLock lock(_hashes->mutex);
+
     for (auto& hasher : _hashes->right) {
         auto& d = *hasher.second;
         long id = d._id;
@@ -727,7 +748,28 @@ void StringHasher::restoreStreamNew(std::istream& stream, std::size_t count)
     }
 }
 
+StringID* StringHasher::insertNew(const StringIDRef& sid)
+{
+    assert(sid && sid._sid->_hasher == nullptr);
+    // New IDs are handed out in the order of the objects of a parallel recompute
+    Document::waitForRecomputeTurn();
+    WriteLock lock(_hashes->mutex);
+    // Another thread may have added the same string since the caller looked it up
+    auto it = _hashes->left.find(sid._sid);
+    if (it != _hashes->left.end()) {
+        return it->first;
+    }
+    sid._sid->_id = lastID() + 1;
+    return insertLocked(sid);
+}
+
 StringID* StringHasher::insert(const StringIDRef& sid)
+{
+    WriteLock lock(_hashes->mutex);
+    return insertLocked(sid);
+}
+
+StringID* StringHasher::insertLocked(const StringIDRef& sid)
 {
     assert(sid && sid._sid->_hasher == nullptr);
     auto& hasher = *sid._sid;
@@ -763,6 +805,7 @@ void StringHasher::restoreStream(std::istream& stream, std::size_t count)
 
 void StringHasher::clear()
 {
+    WriteLock lock(_hashes->mutex);
     for (auto& hasher : _hashes->right) {
         hasher.second->_hasher = nullptr;
         hasher.second->unref();
@@ -772,12 +815,14 @@ void StringHasher::clear()
 
 size_t StringHasher::size() const
 {
+    ReadLock lock(_hashes->mutex);
     return _hashes->size();
 }
 
 size_t StringHasher::count() const
 {
     size_t count = 0;
+    ReadLock lock(_hashes->mutex);
     for (auto& hasher : _hashes->right) {
         if (hasher.second->isMarked() || hasher.second->isPersistent()) {
             ++count;
@@ -855,6 +900,7 @@ PyObject* StringHasher::getPyObject()
 std::map<long, StringIDRef> StringHasher::getIDMap() const
 {
     std::map<long, StringIDRef> ret;
+    ReadLock lock(_hashes->mutex);
     for (auto& hasher : _hashes->right) {
         ret.emplace_hint(ret.end(), hasher.first, StringIDRef(hasher.second));
     }
@@ -863,6 +909,7 @@ std::map<long, StringIDRef> StringHasher::getIDMap() const
 
 void StringHasher::clearMarks() const
 {
+    WriteLock lock(_hashes->mutex);
     for (auto& hasher : _hashes->right) {
         hasher.second->_flags.setFlag(StringID::Flag::Marked, false);
     }
@@ -771,7 +771,19 @@ public:
     friend class StringID;
 
 protected:
+    /// Insert a restored StringID that already carries its ID
     StringID* insert(const StringIDRef& sid);
+    /** Insert a new StringID, assigning it the next free ID
+     *
+     * If an equal string has been added concurrently, the existing StringID is
+     * returned instead. On a parallel recompute worker it first waits for the
+     * objects recomputed before the current one, see
+     * Document::waitForRecomputeTurn(), so that the IDs don't depend on the
+     * timing of the threads.
+     */
+    StringID* insertNew(const StringIDRef& sid);
+    StringID* insertLocked(const StringIDRef& sid);
+    /// Last assigned ID, the caller must hold the table lock
     long lastID() const;
     void saveStream(std::ostream& stream) const;
     void restoreStream(std::istream& stream, std::size_t count);
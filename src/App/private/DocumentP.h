@@ -28,6 +28,7 @@
 #endif
 
 #include <map>
+#include <mutex>
 #include <string>
 #include <memory>
 #include <vector>
@@ -39,8 +40,10 @@
 
 #include <CXX/Objects.hxx>
 
+#include <App/Document.h>
 #include <App/DocumentObject.h>
 #include <App/DocumentObserver.h>
+#include <App/ExpressionIndex.h>
 #include <App/StringHasher.h>
 #include <Base/UniqueNameManager.h>
 
@@ -98,6 +101,29 @@ struct DocumentP
 
     StringHasherRef Hasher;
 
+    // Parallel recompute, see Document::_recomputeParallel()
+    struct DeferredSignal
+    {
+        const DocumentObject* object;
+        const Property* property;
+        bool before;
+    };
+    std::mutex recomputeMutex;
+    std::vector<DeferredSignal> deferredSignals;
+    Document::RecomputeStats recomputeStats;
+
+    // Cached dependency list of all objects, see Document::_getDirtyDependencyList()
+    std::vector<DocumentObject*> sortedObjects;
+    std::unordered_map<const DocumentObject*, size_t> sortedIndex;
+    std::vector<DocumentObject*> externalObjects;
+    unsigned long sortedRevision = 0;
+    int sortedOptions = 0;
+    // objects touched since the last recompute
+    std::unordered_set<DocumentObject*> dirtyObjects;
+
+    // Reverse index of the expressions, see Document::getExpressionDependents()
+    ExpressionIndex expressionIndex;
+
     DocumentP();
 
     void addRecomputeLog(const char* why, App::DocumentObject* obj)
@@ -135,6 +161,9 @@ struct DocumentP
     {
         objectLabelManager.clear();
         objectArray.clear();
+        dirtyObjects.clear();
+        expressionIndex.clear();
+        sortedRevision = 0;
         for (auto& v : objectMap) {
             v.second->setStatus(ObjectStatus::Destroy, true);
             delete (v.second);
@@ -0,0 +1,585 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/***************************************************************************
+ *   This file is part of FreeCAD.                                         *
+ *                                                                         *
+ *   FreeCAD is free software: you can redistribute it and/or modify it    *
+ *   under the terms of the GNU Lesser General Public License as           *
+ *   published by the Free Software Foundation, either version 2.1 of the  *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   FreeCAD is distributed in the hope that it will be useful, but        *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with FreeCAD. If not, see                               *
+ *   <https://www.gnu.org/licenses/>.                                      *
+ *                                                                         *
+ **************************************************************************/
+
+#include "PreCompiled.h"
+
+#ifndef _PreComp_
+#include <array>
+#include <cstring>
+#endif
+
+#include "BinaryXML.h"
+#include "Exception.h"
+
+
+using namespace Base;
+
+namespace
+{
+
+// The first byte can never start an XML text document
+constexpr std::array<char, 8> magic {'\x89', 'F', 'C', 'B', 'X', 'M', 'L', '\x01'};
+
+bool isSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+void appendUtf8(std::string& str, unsigned long code)
+{
+    if (code < 0x80) {
+        str += static_cast<char>(code);
+    }
+    else if (code < 0x800) {
+        str += static_cast<char>(0xC0 | (code >> 6));
+        str += static_cast<char>(0x80 | (code & 0x3F));
+    }
+    else if (code < 0x10000) {
+        str += static_cast<char>(0xE0 | (code >> 12));
+        str += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+        str += static_cast<char>(0x80 | (code & 0x3F));
+    }
+    else {
+        str += static_cast<char>(0xF0 | (code >> 18));
+        str += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+        str += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+        str += static_cast<char>(0x80 | (code & 0x3F));
+    }
+}
+
+// The code point of the character reference "#<digits>" or "#x<hexdigits>"
+unsigned long parseCharReference(const std::string& entity)
+{
+    bool hex = entity.size() > 1 && (entity[1] == 'x' || entity[1] == 'X');
+    std::size_t first = hex ? 2 : 1;
+    if (entity.size() == first) {
+        throw XMLParseException("Character reference without digits");
+    }
+    unsigned long code = 0;
+    for (std::size_t i = first; i < entity.size(); ++i) {
+        char c = entity[i];
+        unsigned long digit = 0;
+        if (c >= '0' && c <= '9') {
+            digit = c - '0';
+        }
+        else if (hex && c >= 'a' && c <= 'f') {
+            digit = c - 'a' + 10;
+        }
+        else if (hex && c >= 'A' && c <= 'F') {
+            digit = c - 'A' + 10;
+        }
+        else {
+            throw XMLParseException("Invalid digit in character reference");
+        }
+        code = code * (hex ? 16 : 10) + digit;
+        if (code > 0x10FFFF) {
+            throw XMLParseException("Character reference out of range");
+        }
+    }
+    return code;
+}
+
+// Resolve the entities in [begin, end), the way an XML parser reports the
+// text. Line breaks are normalized, and in attribute values white space is
+// replaced by blanks.
+std::string unescape(const char* begin, const char* end, bool attribute)
+{
+    std::string res;
+    res.reserve(end - begin);
+    for (const char* p = begin; p != end; ++p) {
+        char c = *p;
+        if (c == '\r') {
+            if (p + 1 != end && p[1] == '\n') {
+                continue;
+            }
+            c = '\n';
+        }
+        if (attribute && isSpace(c)) {
+            res += ' ';
+            continue;
+        }
+        if (c != '&') {
+            res += c;
+            continue;
+        }
+        const char* semicolon = static_cast<const char*>(std::memchr(p, ';', end - p));
+        if (!semicolon) {
+            throw XMLParseException("Unterminated entity reference");
+        }
+        std::string entity(p + 1, semicolon);
+        if (entity == "lt") {
+            res += '<';
+        }
+        else if (entity == "gt") {
+            res += '>';
+        }
+        else if (entity == "amp") {
+            res += '&';
+        }
+        else if (entity == "quot") {
+            res += '"';
+        }
+        else if (entity == "apos") {
+            res += '\'';
+        }
+        else if (!entity.empty() && entity[0] == '#') {
+            appendUtf8(res, parseCharReference(entity));
+        }
+        else {
+            throw XMLParseException("Unknown entity reference");
+        }
+        p = semicolon;
+    }
+    return res;
+}
+
+bool endsWith(const std::string& str, const char* suffix)
+{
+    std::size_t len = std::strlen(suffix);
+    return str.size() >= len && str.compare(str.size() - len, len, suffix) == 0;
+}
+
+void writeEscaped(std::ostream& out, const std::string& str, bool attribute)
+{
+    for (char c : str) {
+        switch (c) {
+            case '<':
+                out << "&lt;";
+                break;
+            case '>':
+                out << "&gt;";
+                break;
+            case '&':
+                out << "&amp;";
+                break;
+            case '"':
+                if (attribute) {
+                    out << "&quot;";
+                    break;
+                }
+                out << c;
+                break;
+            case '\n':
+                if (attribute) {
+                    out << "&#10;";
+                    break;
+                }
+                out << c;
+                break;
+            case '\r':
+                out << "&#13;";
+                break;
+            case '\t':
+                if (attribute) {
+                    out << "&#9;";
+                    break;
+                }
+                out << c;
+                break;
+            default:
+                out << c;
+                break;
+        }
+    }
+}
+
+}  // namespace
+
+bool BinaryXML::isBinaryXML(std::istream& stream)
+{
+    return stream.peek() == static_cast<unsigned char>(magic[0]);
+}
+
+// ----------------------------------------------------------------------------
+
+BinaryXMLEncoder::BinaryXMLEncoder(std::ostream& out)
+    : out(out)
+{
+    out.write(magic.data(), magic.size());
+}
+
+BinaryXMLEncoder::~BinaryXMLEncoder()
+{
+    try {
+        finish();
+    }
+    catch (...) {
+        // a destructor must not throw
+    }
+}
+
+void BinaryXMLEncoder::finish()
+{
+    if (finished) {
+        return;
+    }
+    finished = true;
+    flushText();
+    writeByte(static_cast<unsigned char>(BinaryXML::Event::EndDocument));
+}
+
+BinaryXMLEncoder::int_type BinaryXMLEncoder::overflow(int_type c)
+{
+    if (c != traits_type::eof()) {
+        put(static_cast<char>(c));
+    }
+    return traits_type::not_eof(c);
+}
+
+std::streamsize BinaryXMLEncoder::xsputn(const char* s, std::streamsize num)
+{
+    for (std::streamsize i = 0; i < num; ++i) {
+        put(s[i]);
+    }
+    return num;
+}
+
+void BinaryXMLEncoder::put(char c)
+{
+    switch (state) {
+        case State::Text:
+            if (c == '<') {
+                state = State::Markup;
+                markup.clear();
+            }
+            else {
+                text += c;
+            }
+            break;
+        case State::Quoted:
+            markup += c;
+            if (c == quote) {
+                state = State::Markup;
+            }
+            break;
+        case State::Markup:
+            markup += c;
+            // Comments, CDATA and processing instructions end with their own
+            // terminator, attribute values may contain '>'
+            if (markup[0] == '!') {
+                if (markup.compare(0, 3, "!--") == 0) {
+                    if (markup.size() >= 6 && endsWith(markup, "-->")) {
+                        handleMarkup();
+                    }
+                }
+                else if (markup.compare(0, 8, "![CDATA[") == 0) {
+                    if (markup.size() >= 11 && endsWith(markup, "]]>")) {
+                        handleMarkup();
+                    }
+                }
+                else if (std::strncmp("![CDATA[", markup.c_str(), markup.size()) == 0
+                         || std::strncmp("!--", markup.c_str(), markup.size()) == 0) {
+                    // not yet known whether this is a comment or a CDATA section
+                }
+                else if (c == '>') {
+                    // document type declaration
+                    handleMarkup();
+                }
+            }
+            else if (markup[0] == '?') {
+                if (markup.size() >= 3 && endsWith(markup, "?>")) {
+                    handleMarkup();
+                }
+            }
+            else if (c == '"' || c == '\'') {
+                state = State::Quoted;
+                quote = c;
+            }
+            else if (c == '>') {
+                handleMarkup();
+            }
+            break;
+    }
+}
+
+void BinaryXMLEncoder::handleMarkup()
+{
+    state = State::Text;
+    if (markup[0] == '?' || markup[0] == '!') {
+        if (markup.compare(0, 8, "![CDATA[") == 0) {
+            flushText();
+            writeByte(static_cast<unsigned char>(BinaryXML::Event::CData));
+            writeString(markup.substr(8, markup.size() - 11));
+        }
+        // drop comments, the XML declaration and the document type
+        return;
+    }
+    flushText();
+    writeTag();
+}
+
+void BinaryXMLEncoder::writeTag()
+{
+    const char* p = markup.c_str();
+    const char* end = p + markup.size() - 1;  // skip the '>'
+    if (*p == '/') {
+        writeByte(static_cast<unsigned char>(BinaryXML::Event::EndElement));
+        --depth;
+        return;
+    }
+
+    bool empty = false;
+    const char* last = end;
+    while (last != p && isSpace(last[-1])) {
+        --last;
+    }
+    if (last != p && last[-1] == '/') {
+        empty = true;
+        end = last - 1;
+    }
+
+    const char* nameEnd = p;
+    while (nameEnd != end && !isSpace(*nameEnd)) {
+        ++nameEnd;
+    }
+    writeByte(static_cast<unsigned char>(empty ? BinaryXML::Event::EmptyElement
+                                               : BinaryXML::Event::StartElement));
+    if (!empty) {
+        ++depth;
+    }
+    writeName(std::string(p, nameEnd));
+
+    std::vector<std::pair<std::string, std::string>> attrs;
+    p = nameEnd;
+    for (;;) {
+        while (p != end && isSpace(*p)) {
+            ++p;
+        }
+        if (p == end) {
+            break;
+        }
+        const char* eq = p;
+        while (eq != end && *eq != '=') {
+            ++eq;
+        }
+        const char* keyEnd = eq;
+        while (keyEnd != p && isSpace(keyEnd[-1])) {
+            --keyEnd;
+        }
+        const char* value = eq == end ? end : eq + 1;
+        while (value != end && isSpace(*value)) {
+            ++value;
+        }
+        if (value == end || (*value != '"' && *value != '\'')) {
+            throw XMLParseException("Invalid attribute");
+        }
+        const char* valueEnd =
+            static_cast<const char*>(std::memchr(value + 1, *value, end - value - 1));
+        if (!valueEnd) {
+            throw XMLParseException("Unterminated attribute value");
+        }
+        attrs.emplace_back(std::string(p, keyEnd), unescape(value + 1, valueEnd, true));
+        p = valueEnd + 1;
+    }
+
+    writeSize(attrs.size());
+    for (const auto& [key, val] : attrs) {
+        writeName(key);
+        writeString(val);
+    }
+}
+
+void BinaryXMLEncoder::flushText()
+{
+    if (text.empty()) {
+        return;
+    }
+    if (depth == 0) {
+        // like an XML parser, ignore white space outside of the root element
+        text.clear();
+        return;
+    }
+    writeByte(static_cast<unsigned char>(BinaryXML::Event::Characters));
+    writeString(unescape(text.data(), text.data() + text.size(), false));
+    text.clear();
+}
+
+void BinaryXMLEncoder::writeByte(unsigned char c)
+{
+    out.put(static_cast<char>(c));
+}
+
+void BinaryXMLEncoder::writeSize(std::size_t size)
+{
+    // LEB128
+    do {
+        unsigned char c = size & 0x7F;
+        size >>= 7;
+        if (size) {
+            c |= 0x80;
+        }
+        writeByte(c);
+    } while (size);
+}
+
+void BinaryXMLEncoder::writeString(const std::string& str)
+{
+    writeSize(str.size());
+    out.write(str.data(), static_cast<std::streamsize>(str.size()));
+}
+
+void BinaryXMLEncoder::writeName(const std::string& name)
+{
+    // Names are written once, later occurrences refer to them by their
+    // one-based index in the order of appearance
+    auto res = names.emplace(name, names.size() + 1);
+    if (res.second) {
+        writeSize(0);
+        writeString(name);
+    }
+    else {
+        writeSize(res.first->second);
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+BinaryXMLDecoder::BinaryXMLDecoder(std::istream& in)
+    : buf(in.rdbuf())
+{
+    std::array<char, magic.size()> header {};
+    if (buf->sgetn(header.data(), header.size()) != static_cast<std::streamsize>(header.size())
+        || header != magic) {
+        throw XMLParseException("Unsupported binary XML format");
+    }
+}
+
+unsigned char BinaryXMLDecoder::readByte()
+{
+    auto c = buf->sbumpc();
+    if (c == std::streambuf::traits_type::eof()) {
+        throw XMLParseException("Unexpected end of binary XML");
+    }
+    return static_cast<unsigned char>(c);
+}
+
+std::size_t BinaryXMLDecoder::readSize()
+{
+    std::size_t size = 0;
+    for (int shift = 0;; shift += 7) {
+        unsigned char c = readByte();
+        size |= static_cast<std::size_t>(c & 0x7F) << shift;
+        if (!(c & 0x80)) {
+            return size;
+        }
+        if (shift > 56) {
+            throw XMLParseException("Invalid size in binary XML");
+        }
+    }
+}
+
+void BinaryXMLDecoder::readString(std::string& str)
+{
+    std::size_t size = readSize();
+    str.resize(size);
+    if (size != 0 && buf->sgetn(str.data(), static_cast<std::streamsize>(size))
+            != static_cast<std::streamsize>(size)) {
+        throw XMLParseException("Unexpected end of binary XML");
+    }
+}
+
+std::size_t BinaryXMLDecoder::readName()
+{
+    std::size_t index = readSize();
+    if (index == 0) {
+        names.emplace_back();
+        readString(names.back());
+        return names.size() - 1;
+    }
+    if (index > names.size()) {
+        throw XMLParseException("Invalid name reference in binary XML");
+    }
+    return index - 1;
+}
+
+BinaryXML::Event BinaryXMLDecoder::next()
+{
+    if (atEnd) {
+        return BinaryXML::Event::EndDocument;
+    }
+    auto event = static_cast<BinaryXML::Event>(readByte());
+    switch (event) {
+        case BinaryXML::Event::EndDocument:
+            atEnd = true;
+            break;
+        case BinaryXML::Event::StartElement:
+        case BinaryXML::Event::EmptyElement: {
+            std::size_t index = readName();
+            elementName = names[index];
+            if (event == BinaryXML::Event::StartElement) {
+                elements.push_back(index);
+            }
+            std::size_t count = readSize();
+            attrs.resize(count);
+            for (auto& [key, value] : attrs) {
+                key = names[readName()];
+                readString(value);
+            }
+            break;
+        }
+        case BinaryXML::Event::EndElement:
+            if (elements.empty()) {
+                throw XMLParseException("Unbalanced end element in binary XML");
+            }
+            elementName = names[elements.back()];
+            elements.pop_back();
+            break;
+        case BinaryXML::Event::Characters:
+        case BinaryXML::Event::CData:
+            readString(chars);
+            break;
+        default:
+            throw XMLParseException("Invalid event in binary XML");
+    }
+    return event;
+}
+
+void BinaryXMLDecoder::toXML(std::istream& in, std::ostream& out)
+{
+    BinaryXMLDecoder decoder(in);
+    out << "<?xml version='1.0' encoding='utf-8'?>\n";
+    for (;;) {
+        auto event = decoder.next();
+        switch (event) {
+            case BinaryXML::Event::EndDocument:
+                return;
+            case BinaryXML::Event::StartElement:
+            case BinaryXML::Event::EmptyElement:
+                out << '<' << decoder.name();
+                for (const auto& [key, value] : decoder.attributes()) {
+                    out << ' ' << key << "=\"";
+                    writeEscaped(out, value, true);
+                    out << '"';
+                }
+                out << (event == BinaryXML::Event::EmptyElement ? "/>" : ">");
+                break;
+            case BinaryXML::Event::EndElement:
+                out << "</" << decoder.name() << '>';
+                break;
+            case BinaryXML::Event::Characters:
+                writeEscaped(out, decoder.text(), false);
+                break;
+            case BinaryXML::Event::CData:
+                out << "<![CDATA[" << decoder.text() << "]]>";
+                break;
+        }
+    }
+}
@@ -0,0 +1,175 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/***************************************************************************
+ *   This file is part of FreeCAD.                                         *
+ *                                                                         *
+ *   FreeCAD is free software: you can redistribute it and/or modify it    *
+ *   under the terms of the GNU Lesser General Public License as           *
+ *   published by the Free Software Foundation, either version 2.1 of the  *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   FreeCAD is distributed in the hope that it will be useful, but        *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with FreeCAD. If not, see                               *
+ *   <https://www.gnu.org/licenses/>.                                      *
+ *                                                                         *
+ **************************************************************************/
+
+#ifndef BASE_BINARYXML_H
+#define BASE_BINARYXML_H
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#ifndef FC_GLOBAL_H
+#include <FCGlobal.h>
+#endif
+
+
+namespace Base
+{
+
+/** Compact binary encoding of an XML document
+ *
+ * The binary form stores the stream of parser events instead of the markup
+ * text: element names and attribute names are interned in a string table,
+ * attribute values and character data are stored length prefixed with all
+ * entities already resolved. Reading it back needs neither tokenizing nor
+ * transcoding, which makes it considerably faster to restore than the XML
+ * text of large documents.
+ *
+ * The encoding is only meant as a storage format for Document.xml, see the
+ * "BinaryDocument" mode of Base::Writer. Base::XMLReader detects it
+ * automatically, and BinaryXMLDecoder::toXML() converts it back to XML text.
+ */
+namespace BinaryXML
+{
+/// Event tags of the binary stream
+enum class Event : unsigned char
+{
+    EndDocument = 0,
+    StartElement = 1,
+    EmptyElement = 2,
+    EndElement = 3,
+    Characters = 4,
+    CData = 5,
+};
+
+/// Check whether the stream starts with binary XML, without consuming anything
+BaseExport bool isBinaryXML(std::istream& stream);
+}  // namespace BinaryXML
+
+/** Stream buffer converting XML text into the binary encoding
+ *
+ * All text written to this buffer is parsed as XML and written as binary
+ * events into the output stream. The XML declaration, comments, processing
+ * instructions and the document type are dropped. The encoding is finished
+ * by calling finish() or by destroying the buffer.
+ */
+class BaseExport BinaryXMLEncoder: public std::streambuf
+{
+public:
+    explicit BinaryXMLEncoder(std::ostream& out);
+    ~BinaryXMLEncoder() override;
+
+    BinaryXMLEncoder(const BinaryXMLEncoder&) = delete;
+    BinaryXMLEncoder(BinaryXMLEncoder&&) = delete;
+    BinaryXMLEncoder& operator=(const BinaryXMLEncoder&) = delete;
+    BinaryXMLEncoder& operator=(BinaryXMLEncoder&&) = delete;
+
+    /// Flush pending text and write the end of document marker
+    void finish();
+
+protected:
+    int_type overflow(int_type c) override;
+    std::streamsize xsputn(const char* s, std::streamsize num) override;
+
+private:
+    void put(char c);
+    void flushText();
+    void handleMarkup();
+    void writeTag();
+    void writeByte(unsigned char c);
+    void writeSize(std::size_t size);
+    void writeString(const std::string& str);
+    void writeName(const std::string& name);
+
+private:
+    enum class State
+    {
+        Text,
+        Markup,
+        Quoted,
+    };
+    std::ostream& out;
+    std::unordered_map<std::string, std::size_t> names;
+    std::string text;
+    std::string markup;
+    State state {State::Text};
+    char quote {0};
+    int depth {0};
+    bool finished {false};
+};
+
+/** Reader of the binary XML encoding
+ *
+ * Returns one event per call of next() with the element name, attributes
+ * and character data available through the accessors.
+ */
+class BaseExport BinaryXMLDecoder
+{
+public:
+    /// The stream must be positioned at the start of the binary XML data
+    explicit BinaryXMLDecoder(std::istream& in);
+
+    /// Read the next event, throws Base::XMLParseException on corrupted data
+    BinaryXML::Event next();
+
+    /// The element name of the last start, empty or end element event
+    const std::string& name() const
+    {
+        return elementName;
+    }
+    /// The attributes of the last start or empty element event
+    const std::vector<std::pair<std::string, std::string>>& attributes() const
+    {
+        return attrs;
+    }
+    /// The data of the last characters or CDATA event
+    const std::string& text() const
+    {
+        return chars;
+    }
+
+    /// Convert binary XML from \a in to XML text written to \a out
+    static void toXML(std::istream& in, std::ostream& out);
+
+private:
+    unsigned char readByte();
+    std::size_t readSize();
+    void readString(std::string& str);
+    std::size_t readName();
+
+private:
+    std::streambuf* buf;
+    std::vector<std::string> names;
+    std::vector<std::size_t> elements;
+    std::string elementName;
+    std::vector<std::pair<std::string, std::string>> attrs;
+    std::string chars;
+    bool atEnd {false};
+};
+
+}  // namespace Base
+
+#endif  // BASE_BINARYXML_H
@@ -24,6 +24,8 @@
 #ifndef APP_PERSISTENCE_H
 #define APP_PERSISTENCE_H
 
+#include <functional>
+
 #include "BaseClass.h"
 
 namespace Base
@@ -115,6 +117,15 @@ public:
      * ostream).
      */
     virtual void SaveDocFile(Writer& /*writer*/) const;
+    /** Return true if SaveDocFile() can be called from a worker thread
+     * In this case SaveDocFile() must only read the object's own data. While the
+     * additional files are written the document is not modified by the main thread.
+     * @see Base::ZipWriter::setThreads
+     */
+    virtual bool canSaveDocFileInThread(const Writer& /*writer*/) const
+    {
+        return false;
+    }
     /** This method is used to restore large amounts of data from a file
      * In this method you simply stream in your SaveDocFile() saved data.
      * Again you have to apply for the call of this method in the Restore() call:
@@ -145,6 +156,23 @@ public:
      * @see Base::Reader,Base::XMLReader
      */
     virtual void RestoreDocFile(Reader& /*reader*/);
+    /** Return true if the object implements RestoreDocFileInThread()
+     * This method is called from the main thread, before the file is read.
+     */
+    virtual bool canRestoreDocFileInThread() const
+    {
+        return false;
+    }
+    /** This method is used to parse the data file in a worker thread
+     * It is called by XMLReader::readFiles() instead of RestoreDocFile() if
+     * parallel reading is enabled and canRestoreDocFileInThread() returns true.
+     * It must only read from the given stream and must neither change the object
+     * itself nor access any other shared data. The returned function applies the
+     * parsed data to the object. It is called from the main thread after all files
+     * have been read, in the order of the files.
+     * @see Base::XMLReader::ReadFilesThreads
+     */
+    virtual std::function<void()> RestoreDocFileInThread(Reader& /*reader*/);
     /// Encodes an attribute upon saving.
     static std::string encodeAttribute(const std::string&);
 
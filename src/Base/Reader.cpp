@@ -24,9 +24,14 @@
 #include "PreCompiled.h"
 
 #ifndef _PreComp_
+#include <condition_variable>
+#include <deque>
 #include <map>
+#include <mutex>
+#include <thread>
 #include <vector>
 #include <iostream>
+#include <sstream>
 #include <string>
 #include <xercesc/sax2/XMLReaderFactory.hpp>
 #include <xercesc/sax2/Attributes.hpp>
@@ -36,6 +41,7 @@
 
 #include "Reader.h"
 #include "Base64.h"
+#include "BinaryXML.h"
 #include "Base64Filter.h"
 #include "Console.h"
 #include "Exception.h"
@@ -60,6 +66,127 @@ XERCES_CPP_NAMESPACE_USE
 
 using namespace std;
 
+namespace
+{
+
+// Parses the data files passed to Base::Persistence::RestoreDocFileInThread()
+// by a pool of worker threads, while the main thread decompresses the next
+// files of the archive.
+class DocFileParser
+{
+public:
+    struct Task
+    {
+        const Base::XMLReader::FileEntry* entry;
+        std::string data;
+        std::function<void()> apply;
+        bool failed = false;
+    };
+
+    DocFileParser(unsigned int threadCount, int fileVersion)
+        : threadCount(threadCount)
+        , fileVersion(fileVersion)
+    {}
+
+    ~DocFileParser()
+    {
+        finish();
+    }
+
+    DocFileParser(const DocFileParser&) = delete;
+    DocFileParser(DocFileParser&&) = delete;
+    DocFileParser& operator=(const DocFileParser&) = delete;
+    DocFileParser& operator=(DocFileParser&&) = delete;
+
+    bool isEnabled() const
+    {
+        return threadCount > 0;
+    }
+
+    void push(const Base::XMLReader::FileEntry& entry, std::string&& data)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            // limit the memory used by decompressed but not yet parsed files
+            cond.wait(lock, [this]() {
+                return pendingSize < maxPendingSize || queue.empty();
+            });
+            pendingSize += data.size();
+            tasks.push_back(std::make_unique<Task>(Task {&entry, std::move(data), {}, false}));
+            queue.push_back(tasks.back().get());
+        }
+        cond.notify_all();
+        if (threads.size() < threadCount) {
+            threads.emplace_back(&DocFileParser::run, this);
+        }
+    }
+
+    /// wait for all files being parsed, and return them in the order of pushing
+    const std::vector<std::unique_ptr<Task>>& finish()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            done = true;
+        }
+        cond.notify_all();
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        threads.clear();
+        return tasks;
+    }
+
+private:
+    void run()
+    {
+        for (;;) {
+            Task* task {};
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                cond.wait(lock, [this]() {
+                    return !queue.empty() || done;
+                });
+                if (queue.empty()) {
+                    return;
+                }
+                task = queue.front();
+                queue.pop_front();
+            }
+
+            std::size_t size = task->data.size();
+            try {
+                std::istringstream stream(std::move(task->data));
+                Base::Reader reader(stream, task->entry->FileName, fileVersion);
+                task->apply = task->entry->Object->RestoreDocFileInThread(reader);
+            }
+            catch (...) {
+                task->failed = true;
+            }
+            task->data = std::string();
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                pendingSize -= size;
+            }
+            cond.notify_all();
+        }
+    }
+
+    static constexpr std::size_t maxPendingSize = std::size_t(256) << 20;
+
+    unsigned int threadCount;
+    int fileVersion;
+    std::vector<std::unique_ptr<Task>> tasks;
+    std::deque<Task*> queue;
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable cond;
+    std::size_t pendingSize = 0;
+    bool done = false;
+};
+
+}  // namespace
+
 
 // ---------------------------------------------------------------------------
 //  Base::XMLReader: Constructors and Destructor
@@ -74,6 +201,19 @@ Base::XMLReader::XMLReader(const char* FileName, std::istream& str)
     str.imbue(std::locale::classic());
 #endif
 
+    // the binary encoding is read without the XML parser
+    if (BinaryXML::isBinaryXML(str)) {
+        try {
+            binary = std::make_unique<BinaryXMLDecoder>(str);
+            ReadType = StartDocument;
+            _valid = true;
+        }
+        catch (const Base::Exception& e) {
+            cerr << "Exception message is: \n" << e.what() << "\n";
+        }
+        return;
+    }
+
     // create the parser
     parser = XMLReaderFactory::createXMLReader();  // NOLINT
 
@@ -160,6 +300,11 @@ bool Base::XMLReader::read()
 {
     ReadType = None;
 
+    if (binary) {
+        readBinary();
+        return true;
+    }
+
     try {
         parser->parseNext(token);
     }
@@ -183,6 +328,45 @@ bool Base::XMLReader::read()
     return true;
 }
 
+void Base::XMLReader::readBinary()
+{
+    // Produce the same state as the SAX handlers below do for a parsed token
+    auto event = binary->next();
+    switch (event) {
+        case BinaryXML::Event::StartElement:
+        case BinaryXML::Event::EmptyElement:
+            Level++;
+            LocalName = binary->name();
+            AttrMap.clear();
+            for (const auto& [key, value] : binary->attributes()) {
+                AttrMap[key] = value;
+            }
+            ReadType = StartElement;
+            if (event == BinaryXML::Event::EmptyElement) {
+                Level--;
+                ReadType = StartEndElement;
+            }
+            break;
+        case BinaryXML::Event::EndElement:
+            Level--;
+            LocalName = binary->name();
+            ReadType = EndElement;
+            break;
+        case BinaryXML::Event::Characters:
+            Characters = binary->text();
+            CharacterCount += static_cast<unsigned int>(Characters.size());
+            ReadType = Chars;
+            break;
+        case BinaryXML::Event::CData:
+            Characters = binary->text();
+            ReadType = EndCDATA;
+            break;
+        case BinaryXML::Event::EndDocument:
+            ReadType = EndDocument;
+            break;
+    }
+}
+
 void Base::XMLReader::readElement(const char* ElementName)
 {
     bool ok {};
@@ -417,6 +601,7 @@ void Base::XMLReader::readFiles(zipios::ZipInputStream& zipstream) const
     }
     std::vector<FileEntry>::const_iterator it = FileList.begin();
     Base::SequencerLauncher seq("Importing project files...", FileList.size());
+    DocFileParser parser(ReadFilesThreads, FileVersion);
     while (entry->isValid() && it != FileList.end()) {
         std::vector<FileEntry>::const_iterator jt = it;
         // Check if the current entry is registered, otherwise check the next registered files as
@@ -426,7 +611,15 @@ void Base::XMLReader::readFiles(zipios::ZipInputStream& zipstream) const
         }
         // If this condition is true both file names match and we can read-in the data, otherwise
         // no file name for the current entry in the zip was registered.
-        if (jt != FileList.end()) {
+        if (jt != FileList.end() && parser.isEnabled()
+            && jt->Object->canRestoreDocFileInThread()) {
+            // Only decompress here and leave parsing to the worker threads
+            std::string data {std::istreambuf_iterator<char>(zipstream),
+                              std::istreambuf_iterator<char>()};
+            parser.push(*jt, std::move(data));
+            it = jt + 1;
+        }
+        else if (jt != FileList.end()) {
             try {
                 Base::Reader reader(zipstream, jt->FileName, FileVersion);
                 jt->Object->RestoreDocFile(reader);
@@ -459,6 +652,23 @@ void Base::XMLReader::readFiles(zipios::ZipInputStream& zipstream) const
             break;
         }
     }
+
+    // Apply the parsed files in a deterministic order
+    for (const auto& task : parser.finish()) {
+        if (!task->failed && task->apply) {
+            try {
+                task->apply();
+            }
+            catch (...) {
+                task->failed = true;
+            }
+        }
+        if (task->failed) {
+            Base::Console().Error("Reading failed from embedded file: %s\n",
+                                  task->entry->FileName.c_str());
+            FailedFiles.push_back(task->entry->FileName);
+        }
+    }
 }
 
 const char* Base::XMLReader::addFile(const char* Name, Base::Persistence* Object)
@@ -59,6 +59,7 @@ XERCES_CPP_NAMESPACE_END
 
 namespace Base
 {
+class BinaryXMLDecoder;
 class Persistence;
 
 /** The XML reader class
@@ -162,6 +163,12 @@ public:
         _verbose = on;
     }
 
+    /// return true if the document is read from the binary encoding, see Base::BinaryXMLDecoder
+    bool isBinary() const
+    {
+        return binary != nullptr;
+    }
+
     /** @name Parser handling */
     //@{
     /// get the local name of the current Element
@@ -267,6 +274,9 @@ public:
     std::string ProgramVersion;
     /// Version of the file format
     int FileVersion {0};
+    /// Number of threads used by readFiles() to parse files concurrently, 0 to read sequentially
+    /// @see Base::Persistence::RestoreDocFileInThread()
+    unsigned int ReadFilesThreads {0};
 
     /// sets simultaneously the global and local PartialRestore bits
     void setPartialRestore(bool on);
@@ -283,6 +293,8 @@ public:
 protected:
     /// read the next element
     bool read();
+    /// read the next event of the binary encoding
+    void readBinary();
 
     // -----------------------------------------------------------------------
     //  Handlers for the SAX ContentHandler interface
@@ -350,8 +362,9 @@ private:
 
 
     FileInfo _File;
-    XERCES_CPP_NAMESPACE_QUALIFIER SAX2XMLReader* parser;
+    XERCES_CPP_NAMESPACE_QUALIFIER SAX2XMLReader* parser {nullptr};
     XERCES_CPP_NAMESPACE_QUALIFIER XMLPScanToken token;
+    std::unique_ptr<BinaryXMLDecoder> binary;
     bool _valid {false};
     bool _verbose {true};
 
@@ -23,8 +23,13 @@
 
 #include "PreCompiled.h"
 #ifndef _PreComp_
+#include <condition_variable>
+#include <deque>
+#include <exception>
 #include <memory>
+#include <mutex>
 #include <set>
+#include <thread>
 #include <vector>
 #include <string>
 #endif
@@ -35,6 +40,7 @@
 
 #include "Writer.h"
 #include "Base64.h"
+#include "BinaryXML.h"
 #include "Base64Filter.h"
 #include "Exception.h"
 #include "FileInfo.h"
@@ -340,8 +346,30 @@ ZipWriter::ZipWriter(std::ostream& os)
     ZipStream.setf(std::ios::fixed, std::ios::floatfield);
 }
 
+void ZipWriter::beginBinaryXML()
+{
+    endBinaryXML();
+    XMLEncoder = std::make_unique<BinaryXMLEncoder>(ZipStream);
+    XMLStream = std::make_unique<std::ostream>(XMLEncoder.get());
+    XMLStream->imbue(ZipStream.getloc());
+    XMLStream->precision(ZipStream.precision());
+    XMLStream->flags(ZipStream.flags());
+}
+
+void ZipWriter::endBinaryXML()
+{
+    if (!XMLEncoder) {
+        return;
+    }
+    XMLStream->flush();
+    XMLEncoder->finish();
+    XMLStream.reset();
+    XMLEncoder.reset();
+}
+
 void ZipWriter::putNextEntry(const char* file, const char* obj)
 {
+    endBinaryXML();
     Writer::putNextEntry(file, obj);
 
     ZipStream.putNextEntry(file);
@@ -349,8 +377,253 @@ void ZipWriter::putNextEntry(const char* file, const char* obj)
     Writer::checkErrNo();
 }
 
+namespace
+{
+
+// Collects the content of an additional file in memory
+class EntryWriter: public Writer
+{
+public:
+    EntryWriter(const std::set<std::string>& modes, int version)
+    {
+        setModes(modes);
+        setFileVersion(version);
+        // use the same formatting as ZipWriter
+#ifdef _MSC_VER
+        StrStream.imbue(std::locale::empty());
+#else
+        StrStream.imbue(std::locale::classic());
+#endif
+        StrStream.precision(std::numeric_limits<double>::digits10 + 1);
+        StrStream.setf(std::ios::fixed, std::ios::floatfield);
+    }
+
+    std::ostream& Stream() override
+    {
+        return StrStream;
+    }
+    void writeFiles() override
+    {}
+
+    std::string takeData()
+    {
+        return std::move(StrStream).str();
+    }
+    std::vector<std::pair<std::string, const Persistence*>> takeFiles() const
+    {
+        std::vector<std::pair<std::string, const Persistence*>> files;
+        for (const auto& entry : FileList) {
+            files.emplace_back(entry.FileName, entry.Object);
+        }
+        return files;
+    }
+
+private:
+    std::ostringstream StrStream;
+};
+
+struct DocFileTask
+{
+    std::string fileName;
+    const Persistence* object {};
+    bool serialized {};
+    std::string data;
+    uint32_t size {};
+    uint32_t crc {};
+    std::vector<std::pair<std::string, const Persistence*>> files;
+    std::vector<std::string> errors;
+    std::exception_ptr error;
+    bool ready {};
+};
+
+void serializeFile(DocFileTask& task, const std::set<std::string>& modes, int version)
+{
+    EntryWriter writer(modes, version);
+    writer.putNextEntry(task.fileName.c_str());
+    task.object->SaveDocFile(writer);
+    task.data = writer.takeData();
+    task.files = writer.takeFiles();
+    task.errors = writer.getErrors();
+    task.serialized = true;
+}
+
+// Compress with raw deflate as expected by the zip format
+void compressFile(DocFileTask& task, int level)
+{
+    if (task.data.size() > std::numeric_limits<uint32_t>::max()) {
+        throw FileException("File too big for the archive", task.fileName.c_str());
+    }
+
+    auto* input = reinterpret_cast<Bytef*>(task.data.data());  // NOLINT
+    task.size = static_cast<uint32_t>(task.data.size());
+    task.crc = static_cast<uint32_t>(crc32(crc32(0L, Z_NULL, 0), input, task.size));
+    if (level == Z_NO_COMPRESSION) {
+        return;
+    }
+
+    z_stream zs {};
+    if (deflateInit2(&zs, level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        throw RuntimeError("Failed to initialize compression");
+    }
+    std::string output(deflateBound(&zs, task.size), '\0');
+    zs.next_in = input;
+    zs.avail_in = task.size;
+    zs.next_out = reinterpret_cast<Bytef*>(output.data());  // NOLINT
+    zs.avail_out = static_cast<uInt>(output.size());
+    int err = deflate(&zs, Z_FINISH);
+    output.resize(zs.total_out);
+    deflateEnd(&zs);
+    if (err != Z_STREAM_END) {
+        throw RuntimeError("Failed to compress file");
+    }
+    task.data = std::move(output);
+}
+
+// Serializes and compresses the additional files of a ZipWriter by a pool of
+// worker threads. The results are taken in the order of pushing.
+class DocFileCompressor
+{
+public:
+    DocFileCompressor(unsigned int threadCount,
+                      int level,
+                      std::set<std::string> modes,
+                      int version)
+        : threadCount(threadCount)
+        , level(level)
+        , modes(std::move(modes))
+        , version(version)
+    {}
+
+    ~DocFileCompressor()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            done = true;
+            queue.clear();
+        }
+        cond.notify_all();
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    DocFileCompressor(const DocFileCompressor&) = delete;
+    DocFileCompressor(DocFileCompressor&&) = delete;
+    DocFileCompressor& operator=(const DocFileCompressor&) = delete;
+    DocFileCompressor& operator=(DocFileCompressor&&) = delete;
+
+    void push(std::unique_ptr<DocFileTask> task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            pendingSize += task->data.size();
+            queue.push_back(task.get());
+            tasks.push_back(std::move(task));
+        }
+        cond.notify_all();
+        if (threads.size() < threadCount) {
+            threads.emplace_back(&DocFileCompressor::run, this);
+        }
+    }
+
+    /// Take the oldest task if it is finished, optionally wait for it
+    std::unique_ptr<DocFileTask> pop(bool wait)
+    {
+        std::unique_ptr<DocFileTask> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            if (tasks.empty()) {
+                return {};
+            }
+            if (wait) {
+                cond.wait(lock, [this]() {
+                    return tasks.front()->ready;
+                });
+            }
+            else if (!tasks.front()->ready) {
+                return {};
+            }
+            task = std::move(tasks.front());
+            tasks.pop_front();
+            pendingSize -= task->data.size();
+        }
+        cond.notify_all();
+        return task;
+    }
+
+    /// Check whether too much data is kept in memory
+    bool isOverLimit()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return pendingSize >= maxPendingSize;
+    }
+
+private:
+    void run()
+    {
+        for (;;) {
+            DocFileTask* task {};
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                // stop taking new files if the memory limit is reached, except the
+                // oldest one which is needed to continue writing the archive
+                cond.wait(lock, [this]() {
+                    return done
+                        || (!queue.empty()
+                            && (pendingSize < maxPendingSize
+                                || queue.front() == tasks.front().get()));
+                });
+                if (done) {
+                    return;
+                }
+                task = queue.front();
+                queue.pop_front();
+            }
+
+            std::size_t size = task->data.size();
+            try {
+                if (!task->serialized) {
+                    serializeFile(*task, modes, version);
+                }
+                compressFile(*task, level);
+            }
+            catch (...) {
+                task->error = std::current_exception();
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                pendingSize = pendingSize - size + task->data.size();
+                task->ready = true;
+            }
+            cond.notify_all();
+        }
+    }
+
+    static constexpr std::size_t maxPendingSize = std::size_t(256) << 20;
+
+    unsigned int threadCount;
+    int level;
+    std::set<std::string> modes;
+    int version;
+    std::deque<std::unique_ptr<DocFileTask>> tasks;
+    std::deque<DocFileTask*> queue;
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable cond;
+    std::size_t pendingSize = 0;
+    bool done = false;
+};
+
+}  // namespace
+
 void ZipWriter::writeFiles()
 {
+    if (Threads > 1) {
+        writeFilesInThreads();
+        return;
+    }
+
     // use a while loop because it is possible that while
     // processing the files new ones can be added
     size_t index = 0;
@@ -364,8 +637,64 @@ void ZipWriter::writeFiles()
     }
 }
 
+void ZipWriter::writeFilesInThreads()
+{
+    DocFileCompressor compressor(Threads, Level, Modes, fileVersion);
+    zipios::StorageMethod method = Level == Z_NO_COMPRESSION ? zipios::STORED : zipios::DEFLATED;
+
+    auto write = [this, method](DocFileTask& task) {
+        if (task.error) {
+            std::rethrow_exception(task.error);
+        }
+        for (const auto& error : task.errors) {
+            addError(error);
+        }
+        Writer::putNextEntry(task.fileName.c_str());
+        ZipStream.putRawEntry(task.fileName,
+                              method,
+                              task.data.data(),
+                              static_cast<zipios::uint32>(task.data.size()),
+                              task.size,
+                              task.crc);
+        Writer::checkErrNo();
+        // the names are only unique within the private writer of the task
+        for (const auto& file : task.files) {
+            addFile(file.first.c_str(), file.second);
+        }
+    };
+
+    // use a while loop because it is possible that while
+    // processing the files new ones can be added
+    size_t index = 0;
+    for (;;) {
+        if (index < FileList.size()) {
+            FileEntry entry = FileList[index];
+            auto task = std::make_unique<DocFileTask>();
+            task->fileName = entry.FileName;
+            task->object = entry.Object;
+            if (!entry.Object->canSaveDocFileInThread(*this)) {
+                serializeFile(*task, Modes, fileVersion);
+            }
+            compressor.push(std::move(task));
+            index++;
+
+            // write out the finished files, and wait for them if too much is pending
+            while (auto finished = compressor.pop(compressor.isOverLimit())) {
+                write(*finished);
+            }
+        }
+        else if (auto finished = compressor.pop(true)) {
+            write(*finished);
+        }
+        else {
+            break;
+        }
+    }
+}
+
 ZipWriter::~ZipWriter()
 {
+    endBinaryXML();
     ZipStream.close();
 }
 
@@ -40,6 +40,7 @@
 namespace Base
 {
 
+class BinaryXMLEncoder;
 class Persistence;
 
 
@@ -209,17 +210,43 @@ public:
 
     std::ostream& Stream() override
     {
-        return ZipStream;
+        return XMLStream ? *XMLStream : ZipStream;
     }
 
+    /** Write the current entry in the binary XML encoding
+     * Everything written to Stream() until the next entry is started, or
+     * endBinaryXML() is called, is converted by a Base::BinaryXMLEncoder.
+     */
+    void beginBinaryXML();
+    /// Finish the binary XML encoding of the current entry
+    void endBinaryXML();
+
     void setComment(const char* str)
     {
         ZipStream.setComment(str);
     }
     void setLevel(int level)
     {
+        Level = level;
         ZipStream.setLevel(level);
     }
+    /** Set the number of threads used by writeFiles()
+     * With more than one thread the additional files are serialized and compressed
+     * into memory buffers concurrently and then written to the archive in order.
+     * Only objects returning true in Persistence::canSaveDocFileInThread() are
+     * serialized in a worker thread, all others are serialized in the calling
+     * thread and only compressed concurrently. In this mode a compression level
+     * of 0 stores the files uncompressed. The default is 0, i.e. write all files
+     * sequentially.
+     */
+    void setThreads(unsigned int threads)
+    {
+        Threads = threads;
+    }
+    unsigned int getThreads() const
+    {
+        return Threads;
+    }
     void putNextEntry(const char* filename, const char* objName = nullptr) override;
 
     ZipWriter(const ZipWriter&) = delete;
@@ -227,8 +254,15 @@ public:
     ZipWriter& operator=(const ZipWriter&) = delete;
     ZipWriter& operator=(ZipWriter&&) = delete;
 
+private:
+    void writeFilesInThreads();
+
 private:
     zipios::ZipOutputStream ZipStream;
+    std::unique_ptr<BinaryXMLEncoder> XMLEncoder;
+    std::unique_ptr<std::ostream> XMLStream;
+    int Level {Z_DEFAULT_COMPRESSION};
+    unsigned int Threads {0};
 };
 
 /** The StringWriter class
@@ -208,7 +208,11 @@ void AutoSaver::saveDocument(const std::string& name, AutoSaveProperty& saver)
                         writer.setMode("BinaryBrep");
 
                     writer.setComment("AutoRecovery file");
-                    writer.setLevel(1); // apparently the fastest compression
+                    // 1 is apparently the fastest compression, 0 stores the files uncompressed
+                    int level = hGrp->GetInt("AutoSaveCompressionLevel", 1);
+                    writer.setLevel(Base::clamp<int>(level, Z_NO_COMPRESSION, Z_BEST_COMPRESSION));
+                    if (hGrp->GetBool("ParallelSave", false))
+                        writer.setThreads(QThreadPool::globalInstance()->maxThreadCount());
                     writer.putNextEntry("Document.xml");
 
                     doc->Save(writer);
@@ -188,56 +188,8 @@ protected:
         return _pclMesh->CountFacets();
     }
 
-    void Pos(const Base::Vector3f& rclPoint,
-             unsigned long& rulX,
-             unsigned long& rulY,
-             unsigned long& rulZ) const
-    {
-        rulX = (unsigned long)((rclPoint.x - _fMinX) / _fGridLenX);
-        rulY = (unsigned long)((rclPoint.y - _fMinY) / _fGridLenY);
-        rulZ = (unsigned long)((rclPoint.z - _fMinZ) / _fGridLenZ);
-
-        assert((rulX < _ulCtGridsX) && (rulY < _ulCtGridsY) && (rulZ < _ulCtGridsZ));
-    }
-
-    void AddFacet(const MeshCore::MeshGeomFacet& rclFacet, unsigned long ulFacetIndex)
-    {
-        unsigned long ulX1;
-        unsigned long ulY1;
-        unsigned long ulZ1;
-        unsigned long ulX2;
-        unsigned long ulY2;
-        unsigned long ulZ2;
-
-        Base::BoundBox3f clBB;
-        clBB.Add(rclFacet._aclPoints[0]);
-        clBB.Add(rclFacet._aclPoints[1]);
-        clBB.Add(rclFacet._aclPoints[2]);
-
-        Pos(Base::Vector3f(clBB.MinX, clBB.MinY, clBB.MinZ), ulX1, ulY1, ulZ1);
-        Pos(Base::Vector3f(clBB.MaxX, clBB.MaxY, clBB.MaxZ), ulX2, ulY2, ulZ2);
-
-
-        if ((ulX1 < ulX2) || (ulY1 < ulY2) || (ulZ1 < ulZ2)) {
-            for (unsigned long ulX = ulX1; ulX <= ulX2; ulX++) {
-                for (unsigned long ulY = ulY1; ulY <= ulY2; ulY++) {
-                    for (unsigned long ulZ = ulZ1; ulZ <= ulZ2; ulZ++) {
-                        if (rclFacet.IntersectBoundingBox(GetBoundBox(ulX, ulY, ulZ))) {
-                            _aulGrid[ulX][ulY][ulZ].insert(ulFacetIndex);
-                        }
-                    }
-                }
-            }
-        }
-        else {
-            _aulGrid[ulX1][ulY1][ulZ1].insert(ulFacetIndex);
-        }
-    }
-
     void InitGrid() override
     {
-        unsigned long i, j;
-
         Base::BoundBox3f clBBMesh = _pclMesh->GetBoundBox().Transformed(_transform);
 
         float fLengthX = clBBMesh.LengthX();
@@ -253,14 +205,7 @@ protected:
         _fGridLenZ = (1.0f + fLengthZ) / float(_ulCtGridsZ);
         _fMinZ = clBBMesh.MinZ - 0.5f;
 
-        _aulGrid.clear();
-        _aulGrid.resize(_ulCtGridsX);
-        for (i = 0; i < _ulCtGridsX; i++) {
-            _aulGrid[i].resize(_ulCtGridsY);
-            for (j = 0; j < _ulCtGridsY; j++) {
-                _aulGrid[i][j].resize(_ulCtGridsZ);
-            }
-        }
+        InitCells();
     }
 
     void RebuildGrid() override
@@ -268,12 +213,12 @@ protected:
         _ulCtElements = _pclMesh->CountFacets();
         InitGrid();
 
-        unsigned long i = 0;
-        MeshCore::MeshFacetIterator clFIter(*_pclMesh);
-        clFIter.Transform(_transform);
-        for (clFIter.Init(); clFIter.More(); clFIter.Next()) {
-            AddFacet(*clFIter, i++);
-        }
+        const MeshCore::MeshKernel& mesh = *_pclMesh;
+        FillGrid([this, &mesh](MeshCore::ElementIndex index, std::vector<unsigned long>& grids) {
+            MeshCore::MeshGeomFacet facet = mesh.GetFacet(index);
+            facet.Transform(_transform);
+            GetFacetGrids(facet, grids);
+        });
     }
 
 private:
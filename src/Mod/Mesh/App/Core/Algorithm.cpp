@@ -25,6 +25,7 @@
 #ifndef _PreComp_
 #include <algorithm>
 #include <limits>
+#include <thread>
 #endif
 
 #include <Base/Console.h>
@@ -33,6 +34,7 @@
 #include "Algorithm.h"
 #include "Approximation.h"
 #include "Elements.h"
+#include "Functional.h"
 #include "Grid.h"
 #include "Iterator.h"
 #include "Triangulation.h"
@@ -171,6 +173,32 @@ bool MeshAlgorithm::NearestFacetOnRay(const Base::Vector3f& rclPt,
     return false;
 }
 
+void MeshAlgorithm::NearestFacetsOnRays(const std::vector<Base::Vector3f>& raclPts,
+                                        const std::vector<Base::Vector3f>& raclDirs,
+                                        const MeshFacetGrid& rclGrid,
+                                        std::vector<Base::Vector3f>& raclRes,
+                                        std::vector<FacetIndex>& raulFacets) const
+{
+    assert(raclPts.size() == raclDirs.size());
+    std::size_t count = std::min(raclPts.size(), raclDirs.size());
+    raclRes.resize(count);
+    raulFacets.resize(count);
+
+    std::size_t threads = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+    threads = std::max<std::size_t>(std::min<std::size_t>(threads, count / 1000), 1);
+    parallel_blocks(count, threads, [&](std::size_t, std::size_t begin, std::size_t end) {
+        for (std::size_t index = begin; index < end; index++) {
+            if (!NearestFacetOnRay(raclPts[index],
+                                   raclDirs[index],
+                                   rclGrid,
+                                   raclRes[index],
+                                   raulFacets[index])) {
+                raulFacets[index] = FACET_INDEX_MAX;
+            }
+        }
+    });
+}
+
 bool MeshAlgorithm::NearestFacetOnRay(const Base::Vector3f& rclPt,
                                       const Base::Vector3f& rclDir,
                                       const std::vector<FacetIndex>& raulFacets,
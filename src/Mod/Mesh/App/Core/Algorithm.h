@@ -125,6 +125,17 @@ public:
                            const MeshFacetGrid& rclGrid,
                            Base::Vector3f& rclRes,
                            FacetIndex& rulFacet) const;
+    /**
+     * Searches for the nearest facet of each of the rays defined by (\a raclPts[i], \a
+     * raclDirs[i]) using the grid \a rclGrid. The intersection points and facet indices are
+     * stored in \a raclRes and \a raulFacets in the order of the rays. If a ray doesn't hit the
+     * mesh its facet index is set to FACET_INDEX_MAX. The rays are processed in parallel.
+     */
+    void NearestFacetsOnRays(const std::vector<Base::Vector3f>& raclPts,
+                             const std::vector<Base::Vector3f>& raclDirs,
+                             const MeshFacetGrid& rclGrid,
+                             std::vector<Base::Vector3f>& raclRes,
+                             std::vector<FacetIndex>& raulFacets) const;
     /**
      * Searches for the first facet of the grid element (\a rGrid) in that the point \a rPt lies
      * into which is a distance not higher than \a fMaxDistance. Of no such facet is found \a
@@ -22,52 +22,328 @@
 
 #include "PreCompiled.h"
 #ifndef _PreComp_
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <future>
 #include <limits>
+#include <numeric>
+#include <thread>
 #endif
 
+#include <Base/Exception.h>
+
 #include "Decimation.h"
+#include "Functional.h"
 #include "MeshKernel.h"
 #include "Simplify.h"
 
 
 using namespace MeshCore;
 
+namespace
+{
+// Minimum number of facets of a chunk when choosing the number of chunks automatically
+const std::size_t MinFacetsPerChunk = 250000;
+// Number of rings of facets around the seams decimated by the seam pass
+const int SeamRings = 3;
+
+using Triangle = std::array<int, 3>;
+
+// Working copy of the mesh for the parallel decimation
+struct DecimationData
+{
+    std::vector<Base::Vector3f> points;
+    std::vector<Base::Vector3f> attributes;
+    std::vector<Triangle> triangles;
+};
+
+// A part of the mesh that is decimated on its own
+struct Part
+{
+    std::vector<int> triangles;
+    int target {0};
+    Simplify alg;
+};
+
+Simplify::Vertex makeVertex(const Base::Vector3f& p, int id, bool locked)
+{
+    Simplify::Vertex v;
+    v.tstart = 0;
+    v.tcount = 0;
+    v.border = 0;
+    v.locked = locked ? 1 : 0;
+    v.id = id;
+    v.p = p;
+    return v;
+}
+
+Simplify::Triangle makeTriangle(int v0, int v1, int v2)
+{
+    Simplify::Triangle t;
+    t.deleted = 0;
+    t.dirty = 0;
+    for (double& j : t.err) {
+        j = 0.0;
+    }
+    t.v[0] = v0;
+    t.v[1] = v1;
+    t.v[2] = v2;
+    return t;
+}
+
+// Fill the algorithm with the triangles of the part and the points they use
+void initPart(Part& part,
+              const DecimationData& data,
+              const std::vector<char>& locked,
+              double attributeWeight)
+{
+    std::vector<int> ids;
+    ids.reserve(part.triangles.size() * 3);
+    for (int index : part.triangles) {
+        const Triangle& tria = data.triangles[index];
+        ids.insert(ids.end(), tria.begin(), tria.end());
+    }
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+
+    Simplify& alg = part.alg;
+    alg.vertices.reserve(ids.size());
+    for (int id : ids) {
+        alg.vertices.push_back(makeVertex(data.points[id], id, locked[id] != 0));
+    }
+    if (!data.attributes.empty()) {
+        alg.attributes.reserve(ids.size());
+        for (int id : ids) {
+            alg.attributes.push_back(data.attributes[id]);
+        }
+        alg.attribute_weight = attributeWeight;
+    }
+
+    auto local = [&ids](int id) {
+        return static_cast<int>(std::lower_bound(ids.begin(), ids.end(), id) - ids.begin());
+    };
+    alg.triangles.reserve(part.triangles.size());
+    for (int index : part.triangles) {
+        const Triangle& tria = data.triangles[index];
+        alg.triangles.push_back(makeTriangle(local(tria[0]), local(tria[1]), local(tria[2])));
+    }
+}
+
+// Replace the triangles of the parts with their decimated triangles
+void mergeParts(DecimationData& data, std::vector<Part>& parts)
+{
+    std::vector<char> replaced(data.triangles.size(), 0);
+    for (const auto& part : parts) {
+        for (int index : part.triangles) {
+            replaced[index] = 1;
+        }
+    }
+
+    std::vector<Triangle> triangles;
+    for (std::size_t index = 0; index < data.triangles.size(); index++) {
+        if (!replaced[index]) {
+            triangles.push_back(data.triangles[index]);
+        }
+    }
+
+    for (auto& part : parts) {
+        const Simplify& alg = part.alg;
+        // Locked points keep their position, all others belong to this part only
+        for (std::size_t i = 0; i < alg.vertices.size(); i++) {
+            data.points[alg.vertices[i].id] = alg.vertices[i].p;
+            if (!alg.attributes.empty()) {
+                data.attributes[alg.vertices[i].id] = alg.attributes[i];
+            }
+        }
+        for (const auto& triangle : alg.triangles) {
+            if (!triangle.deleted) {
+                triangles.push_back({alg.vertices[triangle.v[0]].id,
+                                     alg.vertices[triangle.v[1]].id,
+                                     alg.vertices[triangle.v[2]].id});
+            }
+        }
+        part = Part();
+    }
+
+    data.triangles.swap(triangles);
+}
+// Decimate the parts concurrently so that the mesh has about targetSize triangles
+// afterwards, each part is reduced in proportion to its size
+bool decimateParts(DecimationData& data,
+                   std::vector<Part>& parts,
+                   const std::vector<char>& locked,
+                   int targetSize,
+                   double tolerance,
+                   double attributeWeight,
+                   const MeshSimplify::ProgressHook& hook,
+                   float progressStart,
+                   float progressEnd)
+{
+    std::size_t numTriangles = 0;
+    for (const auto& part : parts) {
+        numTriangles += part.triangles.size();
+    }
+    if (numTriangles == 0) {
+        return true;
+    }
+
+    int64_t remove = static_cast<int64_t>(data.triangles.size()) - targetSize;
+    for (auto& part : parts) {
+        auto size = static_cast<int64_t>(part.triangles.size());
+        int64_t target = size - remove * size / static_cast<int64_t>(numTriangles);
+        part.target = static_cast<int>(std::max<int64_t>(target, 0));
+    }
+
+    std::vector<std::atomic<float>> progress(parts.size());
+    std::atomic<bool> canceled {false};
+    // Reports the progress of all parts, the hook is only called from this thread
+    auto report = [&]() {
+        if (!hook || canceled) {
+            return;
+        }
+        float value = 0.0F;
+        for (const auto& it : progress) {
+            value += it;
+        }
+        value /= static_cast<float>(parts.size());
+        if (!hook(progressStart + (progressEnd - progressStart) * value)) {
+            canceled = true;
+        }
+    };
+    auto run = [&](std::size_t index) {
+        Part& part = parts[index];
+        initPart(part, data, locked, attributeWeight);
+        part.alg.progress = [&progress, &canceled, index](float value) {
+            progress[index] = value;
+            return !canceled;
+        };
+        part.alg.simplify_mesh(part.target, tolerance);
+    };
+
+    for (auto& it : progress) {
+        it = 0.0F;
+    }
+    report();
+    if (canceled) {
+        return false;
+    }
+
+    std::vector<std::future<void>> futures;
+    futures.reserve(parts.size());
+    for (std::size_t index = 0; index < parts.size(); index++) {
+        futures.push_back(std::async(std::launch::async, run, index));
+    }
+
+    // The hook is called while the parts are decimated and once after each part is done, so
+    // that parts decimated faster than the polling interval can be canceled as well
+    for (auto& future : futures) {
+        if (hook) {
+            while (future.wait_for(std::chrono::milliseconds(100)) != std::future_status::ready) {
+                report();
+            }
+        }
+        future.get();
+        report();
+    }
+
+    if (canceled) {
+        return false;
+    }
+
+    mergeParts(data, parts);
+    return true;
+}
+}  // namespace
+
 MeshSimplify::MeshSimplify(MeshKernel& mesh)
     : myKernel(mesh)
 {}
 
-void MeshSimplify::simplify(float tolerance, float reduction)
+void MeshSimplify::setChunks(std::size_t chunks)
+{
+    myChunks = chunks;
+}
+
+void MeshSimplify::setProgressHook(ProgressHook hook)
+{
+    myProgress = std::move(hook);
+}
+
+void MeshSimplify::setPointAttributes(std::vector<Base::Vector3f>* attributes, float weight)
+{
+    myAttributes = attributes;
+    myAttributeWeight = weight;
+}
+
+bool MeshSimplify::simplify(float tolerance, float reduction)
+{
+    const MeshFacetArray& facets = myKernel.GetFacets();
+    int target_count = static_cast<int>(static_cast<float>(facets.size()) * (1.0F - reduction));
+    return decimate(target_count, tolerance);
+}
+
+bool MeshSimplify::simplify(int targetSize)
+{
+    return decimate(targetSize, std::numeric_limits<float>::max());
+}
+
+std::size_t MeshSimplify::numberOfChunks() const
+{
+    if (myChunks > 0) {
+        return myChunks;
+    }
+
+    std::size_t threads = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+    std::size_t chunks = myKernel.CountFacets() / MinFacetsPerChunk;
+    return std::max<std::size_t>(std::min<std::size_t>(threads, chunks), 1);
+}
+
+bool MeshSimplify::decimate(int targetSize, double tolerance)
+{
+    if (myAttributes && myAttributes->size() != myKernel.CountPoints()) {
+        throw Base::ValueError("Number of attributes doesn't match the number of points");
+    }
+
+    std::size_t chunks = std::min<std::size_t>(numberOfChunks(), myKernel.CountFacets());
+    if (chunks > 1) {
+        return decimateParallel(chunks, targetSize, tolerance);
+    }
+
+    return decimateSerial(targetSize, tolerance);
+}
+
+bool MeshSimplify::decimateSerial(int targetSize, double tolerance)
 {
     Simplify alg;
 
     const MeshPointArray& points = myKernel.GetPoints();
+    alg.vertices.reserve(points.size());
     for (std::size_t i = 0; i < points.size(); i++) {
-        Simplify::Vertex v;
-        v.tstart = 0;
-        v.tcount = 0;
-        v.border = 0;
-        v.p = points[i];
-        alg.vertices.push_back(v);
+        alg.vertices.push_back(makeVertex(points[i], static_cast<int>(i), false));
     }
 
     const MeshFacetArray& facets = myKernel.GetFacets();
-    for (std::size_t i = 0; i < facets.size(); i++) {
-        Simplify::Triangle t;
-        t.deleted = 0;
-        t.dirty = 0;
-        for (double& j : t.err) {
-            j = 0.0;
-        }
-        for (int j = 0; j < 3; j++) {
-            t.v[j] = facets[i]._aulPoints[j];
-        }
-        alg.triangles.push_back(t);
+    alg.triangles.reserve(facets.size());
+    for (const auto& facet : facets) {
+        alg.triangles.push_back(makeTriangle(static_cast<int>(facet._aulPoints[0]),
+                                             static_cast<int>(facet._aulPoints[1]),
+                                             static_cast<int>(facet._aulPoints[2])));
     }
 
-    int target_count = static_cast<int>(static_cast<float>(facets.size()) * (1.0F - reduction));
+    if (myAttributes) {
+        alg.attributes = *myAttributes;
+        alg.attribute_weight = myAttributeWeight;
+    }
+    alg.progress = myProgress;
 
     // Simplification starts
-    alg.simplify_mesh(target_count, tolerance);
+    alg.simplify_mesh(targetSize, tolerance);
+    if (alg.canceled) {
+        return false;
+    }
 
     // Simplification done
     MeshPointArray new_points;
@@ -95,63 +371,150 @@ void MeshSimplify::simplify(float tolerance, float reduction)
     }
 
     myKernel.Adopt(new_points, new_facets, true);
+    if (myAttributes) {
+        myAttributes->swap(alg.attributes);
+    }
+    return true;
 }
 
-void MeshSimplify::simplify(int targetSize)
+bool MeshSimplify::decimateParallel(std::size_t chunks, int targetSize, double tolerance)
 {
-    Simplify alg;
-
+    DecimationData data;
     const MeshPointArray& points = myKernel.GetPoints();
-    for (std::size_t i = 0; i < points.size(); i++) {
-        Simplify::Vertex v;
-        v.tstart = 0;
-        v.tcount = 0;
-        v.border = 0;
-        v.p = points[i];
-        alg.vertices.push_back(v);
+    data.points.assign(points.begin(), points.end());
+    const MeshFacetArray& facets = myKernel.GetFacets();
+    data.triangles.reserve(facets.size());
+    for (const auto& facet : facets) {
+        data.triangles.push_back({static_cast<int>(facet._aulPoints[0]),
+                                  static_cast<int>(facet._aulPoints[1]),
+                                  static_cast<int>(facet._aulPoints[2])});
+    }
+    if (myAttributes) {
+        data.attributes = *myAttributes;
     }
 
-    const MeshFacetArray& facets = myKernel.GetFacets();
-    for (std::size_t i = 0; i < facets.size(); i++) {
-        Simplify::Triangle t;
-        t.deleted = 0;
-        t.dirty = 0;
-        for (double& j : t.err) {
-            j = 0.0;
-        }
-        for (int j = 0; j < 3; j++) {
-            t.v[j] = facets[i]._aulPoints[j];
-        }
-        alg.triangles.push_back(t);
+    // Split the facets into chunks along the longest axis of the bounding box
+    const Base::BoundBox3f& box = myKernel.GetBoundBox();
+    std::array<float, 3> lengths = {box.LengthX(), box.LengthY(), box.LengthZ()};
+    auto axis = std::max_element(lengths.begin(), lengths.end()) - lengths.begin();
+    std::vector<float> keys;
+    keys.reserve(data.triangles.size());
+    for (const auto& tria : data.triangles) {
+        keys.push_back(data.points[tria[0]][axis] + data.points[tria[1]][axis]
+                       + data.points[tria[2]][axis]);
     }
 
-    // Simplification starts
-    alg.simplify_mesh(targetSize, std::numeric_limits<float>::max());
+    std::vector<int> order(data.triangles.size());
+    std::iota(order.begin(), order.end(), 0);
+    int threads = static_cast<int>(std::max<unsigned>(std::thread::hardware_concurrency(), 1));
+    parallel_sort(
+        order.begin(),
+        order.end(),
+        [&keys](int lhs, int rhs) {
+            return keys[lhs] < keys[rhs];
+        },
+        threads);
 
-    // Simplification done
-    MeshPointArray new_points;
-    new_points.reserve(alg.vertices.size());
-    for (const auto& vertex : alg.vertices) {
-        new_points.push_back(vertex.p);
+    std::vector<Part> parts(chunks);
+    for (std::size_t chunk = 0; chunk < chunks; chunk++) {
+        parts[chunk].triangles.assign(order.begin() + order.size() * chunk / chunks,
+                                      order.begin() + order.size() * (chunk + 1) / chunks);
     }
+    order.clear();
+    order.shrink_to_fit();
 
-    std::size_t numFacets = 0;
-    for (const auto& triangle : alg.triangles) {
-        if (!triangle.deleted) {
-            numFacets++;
+    // The points shared by several chunks are locked
+    std::vector<char> seams(data.points.size(), 0);
+    {
+        std::vector<int> owner(data.points.size(), -1);
+        for (std::size_t chunk = 0; chunk < chunks; chunk++) {
+            for (int index : parts[chunk].triangles) {
+                for (int id : data.triangles[index]) {
+                    if (owner[id] < 0) {
+                        owner[id] = static_cast<int>(chunk);
+                    }
+                    else if (owner[id] != static_cast<int>(chunk)) {
+                        seams[id] = 1;
+                    }
+                }
+            }
+        }
+    }
+
+    if (!decimateParts(data,
+                       parts,
+                       seams,
+                       targetSize,
+                       tolerance,
+                       myAttributeWeight,
+                       myProgress,
+                       0.0F,
+                       0.9F)) {
+        return false;
+    }
+
+    // Decimate the band of facets around the seams with the band border locked
+    if (static_cast<int>(data.triangles.size()) > targetSize) {
+        for (int ring = 1; ring < SeamRings; ring++) {
+            std::vector<char> band = seams;
+            for (const auto& tria : data.triangles) {
+                if (seams[tria[0]] || seams[tria[1]] || seams[tria[2]]) {
+                    band[tria[0]] = band[tria[1]] = band[tria[2]] = 1;
+                }
+            }
+            seams.swap(band);
+        }
+
+        std::vector<Part> seamParts(1);
+        std::vector<char> border(data.points.size(), 0);
+        for (std::size_t index = 0; index < data.triangles.size(); index++) {
+            const Triangle& tria = data.triangles[index];
+            if (seams[tria[0]] || seams[tria[1]] || seams[tria[2]]) {
+                seamParts.front().triangles.push_back(static_cast<int>(index));
+            }
+            else {
+                border[tria[0]] = border[tria[1]] = border[tria[2]] = 1;
+            }
+        }
+
+        if (!decimateParts(data,
+                           seamParts,
+                           border,
+                           targetSize,
+                           tolerance,
+                           myAttributeWeight,
+                           myProgress,
+                           0.9F,
+                           1.0F)) {
+            return false;
         }
     }
+
+    // Remove the points that are no longer used
+    std::vector<int> newIndex(data.points.size(), -1);
+    MeshPointArray new_points;
+    std::vector<Base::Vector3f> new_attributes;
     MeshFacetArray new_facets;
-    new_facets.reserve(numFacets);
-    for (const auto& triangle : alg.triangles) {
-        if (!triangle.deleted) {
-            MeshFacet face;
-            face._aulPoints[0] = triangle.v[0];
-            face._aulPoints[1] = triangle.v[1];
-            face._aulPoints[2] = triangle.v[2];
-            new_facets.push_back(face);
+    new_facets.reserve(data.triangles.size());
+    for (const auto& tria : data.triangles) {
+        MeshFacet face;
+        for (int j = 0; j < 3; j++) {
+            int& index = newIndex[tria[j]];
+            if (index < 0) {
+                index = static_cast<int>(new_points.size());
+                new_points.push_back(data.points[tria[j]]);
+                if (!data.attributes.empty()) {
+                    new_attributes.push_back(data.attributes[tria[j]]);
+                }
+            }
+            face._aulPoints[j] = index;
         }
+        new_facets.push_back(face);
     }
 
     myKernel.Adopt(new_points, new_facets, true);
+    if (myAttributes) {
+        myAttributes->swap(new_attributes);
+    }
+    return true;
 }
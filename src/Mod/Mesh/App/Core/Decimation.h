@@ -24,21 +24,70 @@
 #ifndef MESH_DECIMATION_H
 #define MESH_DECIMATION_H
 
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+#include <Base/Vector3D.h>
 #include <Mod/Mesh/MeshGlobal.h>
 
 namespace MeshCore
 {
 class MeshKernel;
 
+/**
+ * Decimation of a mesh by edge collapses ordered by quadric error metrics.
+ *
+ * Large meshes can be decimated in parallel: the facets are split into spatial
+ * chunks along the longest axis of the bounding box, and the chunks are
+ * decimated concurrently while the points they share are kept locked. A
+ * final pass then decimates the band of facets around the seams between the
+ * chunks.
+ */
 class MeshExport MeshSimplify
 {
 public:
+    /// Called with the progress in [0,1], returning false cancels the decimation
+    using ProgressHook = std::function<bool(float)>;
+
     explicit MeshSimplify(MeshKernel&);
-    void simplify(float tolerance, float reduction);
-    void simplify(int targetSize);
+
+    /** Sets the number of chunks for the parallel decimation.
+     * 1 decimates the whole mesh at once, which is the default. 0 chooses the
+     * number from the available cores and the size of the mesh, so that small
+     * meshes are still decimated at once.
+     */
+    void setChunks(std::size_t chunks);
+    /** Sets the hook that reports the progress and allows to cancel.
+     * The hook is only called from the thread calling simplify().
+     */
+    void setProgressHook(ProgressHook hook);
+    /** Sets per-point attributes like colors that are preserved by the decimation.
+     * The attributes of the remaining points are interpolated along the collapsed
+     * edges, and the squared difference of the attributes multiplied by \a weight
+     * is added to the error of an edge so that edges across attribute changes are
+     * collapsed last. On success the array is replaced by the attributes of the
+     * points of the decimated mesh.
+     */
+    void setPointAttributes(std::vector<Base::Vector3f>* attributes, float weight);
+
+    /// Returns false if the decimation was canceled, the mesh is then unchanged
+    bool simplify(float tolerance, float reduction);
+    /// Returns false if the decimation was canceled, the mesh is then unchanged
+    bool simplify(int targetSize);
+
+private:
+    bool decimate(int targetSize, double tolerance);
+    bool decimateSerial(int targetSize, double tolerance);
+    bool decimateParallel(std::size_t chunks, int targetSize, double tolerance);
+    std::size_t numberOfChunks() const;
 
 private:
     MeshKernel& myKernel;
+    std::size_t myChunks {1};
+    ProgressHook myProgress;
+    std::vector<Base::Vector3f>* myAttributes {nullptr};
+    float myAttributeWeight {0.0F};
 };
 
 }  // namespace MeshCore
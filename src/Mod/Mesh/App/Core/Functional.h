@@ -24,7 +24,9 @@
 #define MESH_FUNCTIONAL_H
 
 #include <algorithm>
+#include <cstddef>
 #include <future>
+#include <vector>
 
 
 namespace MeshCore
@@ -62,6 +64,33 @@ static void parallel_sort(Iter begin, Iter end, Pred comp, int threads)
     }
 }
 
+/**
+ * Splits the range [0, count) into \a threads consecutive blocks and calls
+ * func(block, begin, end) for each of them in its own thread.
+ */
+template<class Func>
+static void parallel_blocks(std::size_t count, std::size_t threads, Func func)
+{
+    if (threads < 2) {
+        func(0, 0, count);
+        return;
+    }
+
+    std::vector<std::future<void>> futures;
+    futures.reserve(threads - 1);
+    for (std::size_t block = 1; block < threads; block++) {
+        futures.push_back(std::async(std::launch::async,
+                                     func,
+                                     block,
+                                     count * block / threads,
+                                     count * (block + 1) / threads));
+    }
+    func(0, 0, count / threads);
+    for (auto& future : futures) {
+        future.get();
+    }
+}
+
 }  // namespace MeshCore
 
 
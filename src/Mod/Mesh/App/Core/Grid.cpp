@@ -26,9 +26,11 @@
 #include <algorithm>
 #include <cmath>
 #include <limits>
+#include <thread>
 #endif
 
 #include "Algorithm.h"
+#include "Functional.h"
 #include "Grid.h"
 #include "Iterator.h"
 #include "MeshKernel.h"
@@ -36,6 +38,16 @@
 
 using namespace MeshCore;
 
+namespace
+{
+// Number of threads to process \a count items of which each thread should get at least \a minCount
+std::size_t numThreads(std::size_t count, std::size_t minCount)
+{
+    std::size_t threads = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+    return std::max<std::size_t>(std::min<std::size_t>(threads, count / minCount), 1);
+}
+}  // namespace
+
 MeshGrid::MeshGrid(const MeshKernel& rclM)
     : _pclMesh(&rclM)
     , _ulCtElements(0)
@@ -72,7 +84,8 @@ void MeshGrid::Attach(const MeshKernel& rclM)
 
 void MeshGrid::Clear()
 {
-    _aulGrid.clear();
+    _aulOffsets.clear();
+    _aulIndices.clear();
     _pclMesh = nullptr;
 }
 
@@ -130,13 +143,105 @@ void MeshGrid::InitGrid()
     }
 
     // Create data structure
-    _aulGrid.clear();
-    _aulGrid.resize(_ulCtGridsX);
-    for (unsigned long i = 0; i < _ulCtGridsX; i++) {
-        _aulGrid[i].resize(_ulCtGridsY);
-        for (unsigned long j = 0; j < _ulCtGridsY; j++) {
-            _aulGrid[i][j].resize(_ulCtGridsZ);
+    InitCells();
+}
+
+void MeshGrid::InitCells()
+{
+    _aulOffsets.assign(std::size_t(_ulCtGridsX) * _ulCtGridsY * _ulCtGridsZ + 1, 0);
+    _aulIndices.clear();
+}
+
+void MeshGrid::FillGrid(const std::function<void(ElementIndex, std::vector<unsigned long>&)>& cells)
+{
+    // The grid is built in two passes. First, each thread collects the (grid, element) pairs of a
+    // consecutive range of elements and counts them per grid. Then the pairs are scattered into
+    // the index array, each thread starting behind the elements of the previous ranges. This way
+    // the indices of each grid are in ascending order.
+    //
+    // Every thread needs its own counter array, so a thread gets at least as many elements as
+    // there are grids to keep the memory overhead bounded.
+    const std::size_t numCells = std::size_t(_ulCtGridsX) * _ulCtGridsY * _ulCtGridsZ;
+    const std::size_t numElements = _ulCtElements;
+    const std::size_t threads = numThreads(numElements, std::max<std::size_t>(numCells, 10000));
+
+    struct Range
+    {
+        std::vector<std::pair<unsigned long, ElementIndex>> entries;
+        std::vector<std::size_t> counts;
+    };
+    std::vector<Range> ranges(threads);
+
+    auto collect = [&](std::size_t block, std::size_t begin, std::size_t end) {
+        Range& range = ranges[block];
+        range.counts.assign(numCells, 0);
+        range.entries.reserve(end - begin);
+        std::vector<unsigned long> grids;
+        for (std::size_t index = begin; index < end; index++) {
+            grids.clear();
+            cells(ElementIndex(index), grids);
+            for (unsigned long grid : grids) {
+                range.entries.emplace_back(grid, ElementIndex(index));
+                range.counts[grid]++;
+            }
         }
+    };
+    parallel_blocks(numElements, threads, collect);
+
+    // Turn the counters into the write positions of each range
+    _aulOffsets.resize(numCells + 1);
+    std::size_t pos = 0;
+    for (std::size_t cell = 0; cell < numCells; cell++) {
+        _aulOffsets[cell] = pos;
+        for (Range& range : ranges) {
+            std::size_t count = range.counts[cell];
+            range.counts[cell] = pos;
+            pos += count;
+        }
+    }
+    _aulOffsets[numCells] = pos;
+    _aulIndices.resize(pos);
+
+    parallel_blocks(numElements, threads, [&](std::size_t block, std::size_t, std::size_t) {
+        Range& range = ranges[block];
+        for (const auto& [grid, index] : range.entries) {
+            _aulIndices[range.counts[grid]++] = index;
+        }
+        range = Range();
+    });
+}
+
+void MeshGrid::GetFacetGrids(const MeshGeomFacet& rclFacet,
+                             std::vector<unsigned long>& raulGrids) const
+{
+    Base::BoundBox3f clBB;
+    clBB.Add(rclFacet._aclPoints[0]);
+    clBB.Add(rclFacet._aclPoints[1]);
+    clBB.Add(rclFacet._aclPoints[2]);
+
+    auto ulX1 = static_cast<unsigned long>((clBB.MinX - _fMinX) / _fGridLenX);
+    auto ulY1 = static_cast<unsigned long>((clBB.MinY - _fMinY) / _fGridLenY);
+    auto ulZ1 = static_cast<unsigned long>((clBB.MinZ - _fMinZ) / _fGridLenZ);
+    auto ulX2 = static_cast<unsigned long>((clBB.MaxX - _fMinX) / _fGridLenX);
+    auto ulY2 = static_cast<unsigned long>((clBB.MaxY - _fMinY) / _fGridLenY);
+    auto ulZ2 = static_cast<unsigned long>((clBB.MaxZ - _fMinZ) / _fGridLenZ);
+
+    assert((ulX2 < _ulCtGridsX) && (ulY2 < _ulCtGridsY) && (ulZ2 < _ulCtGridsZ));
+
+    // if the facet spans over several grids
+    if ((ulX1 < ulX2) || (ulY1 < ulY2) || (ulZ1 < ulZ2)) {
+        for (auto ulX = ulX1; ulX <= ulX2; ulX++) {
+            for (auto ulY = ulY1; ulY <= ulY2; ulY++) {
+                for (auto ulZ = ulZ1; ulZ <= ulZ2; ulZ++) {
+                    if (rclFacet.IntersectBoundingBox(GetBoundBox(ulX, ulY, ulZ))) {
+                        raulGrids.push_back(GetIndexToPosition(ulX, ulY, ulZ));
+                    }
+                }
+            }
+        }
+    }
+    else {
+        raulGrids.push_back(GetIndexToPosition(ulX1, ulY1, ulZ1));
     }
 }
 
@@ -160,9 +265,8 @@ unsigned long MeshGrid::Inside(const Base::BoundBox3f& rclBB,
     for (auto i = ulMinX; i <= ulMaxX; i++) {
         for (auto j = ulMinY; j <= ulMaxY; j++) {
             for (auto k = ulMinZ; k <= ulMaxZ; k++) {
-                raulElements.insert(raulElements.end(),
-                                    _aulGrid[i][j][k].begin(),
-                                    _aulGrid[i][j][k].end());
+                auto elements = GetCellElements(i, j, k);
+                raulElements.insert(raulElements.end(), elements.begin(), elements.end());
             }
         }
     }
@@ -202,9 +306,8 @@ unsigned long MeshGrid::Inside(const Base::BoundBox3f& rclBB,
         for (auto j = ulMinY; j <= ulMaxY; j++) {
             for (auto k = ulMinZ; k <= ulMaxZ; k++) {
                 if (Base::DistanceP2(GetBoundBox(i, j, k).GetCenter(), rclOrg) < fMinDistP2) {
-                    raulElements.insert(raulElements.end(),
-                                        _aulGrid[i][j][k].begin(),
-                                        _aulGrid[i][j][k].end());
+                    auto elements = GetCellElements(i, j, k);
+                    raulElements.insert(raulElements.end(), elements.begin(), elements.end());
                 }
             }
         }
@@ -239,7 +342,8 @@ unsigned long MeshGrid::Inside(const Base::BoundBox3f& rclBB,
     for (auto i = ulMinX; i <= ulMaxX; i++) {
         for (auto j = ulMinY; j <= ulMaxY; j++) {
             for (auto k = ulMinZ; k <= ulMaxZ; k++) {
-                raulElements.insert(_aulGrid[i][j][k].begin(), _aulGrid[i][j][k].end());
+                auto elements = GetCellElements(i, j, k);
+                raulElements.insert(elements.begin(), elements.end());
             }
         }
     }
@@ -463,7 +567,8 @@ void MeshGrid::SearchNearestFromPoint(const Base::Vector3f& pnt,
                 while (indices.empty() && nX < _ulCtGridsX) {
                     for (unsigned long i = 0; i < _ulCtGridsY; i++) {
                         for (unsigned long j = 0; j < _ulCtGridsZ; j++) {
-                            indices.insert(_aulGrid[nX][i][j].begin(), _aulGrid[nX][i][j].end());
+                            auto elements = GetCellElements(nX, i, j);
+                            indices.insert(elements.begin(), elements.end());
                         }
                     }
                     nX++;
@@ -475,7 +580,8 @@ void MeshGrid::SearchNearestFromPoint(const Base::Vector3f& pnt,
                 while (indices.empty() && nX < _ulCtGridsX) {
                     for (unsigned long i = 0; i < _ulCtGridsY; i++) {
                         for (unsigned long j = 0; j < _ulCtGridsZ; j++) {
-                            indices.insert(_aulGrid[nX][i][j].begin(), _aulGrid[nX][i][j].end());
+                            auto elements = GetCellElements(nX, i, j);
+                            indices.insert(elements.begin(), elements.end());
                         }
                     }
                     nX++;
@@ -487,7 +593,8 @@ void MeshGrid::SearchNearestFromPoint(const Base::Vector3f& pnt,
                 while (indices.empty() && nY < _ulCtGridsY) {
                     for (unsigned long i = 0; i < _ulCtGridsX; i++) {
                         for (unsigned long j = 0; j < _ulCtGridsZ; j++) {
-                            indices.insert(_aulGrid[i][nY][j].begin(), _aulGrid[i][nY][j].end());
+                            auto elements = GetCellElements(i, nY, j);
+                            indices.insert(elements.begin(), elements.end());
                         }
                     }
                     nY++;
@@ -499,7 +606,8 @@ void MeshGrid::SearchNearestFromPoint(const Base::Vector3f& pnt,
                 while (indices.empty() && nY < _ulCtGridsY) {
                     for (unsigned long i = 0; i < _ulCtGridsX; i++) {
                         for (unsigned long j = 0; j < _ulCtGridsZ; j++) {
-                            indices.insert(_aulGrid[i][nY][j].begin(), _aulGrid[i][nY][j].end());
+                            auto elements = GetCellElements(i, nY, j);
+                            indices.insert(elements.begin(), elements.end());
                         }
                     }
                     nY--;
@@ -511,7 +619,8 @@ void MeshGrid::SearchNearestFromPoint(const Base::Vector3f& pnt,
                 while (indices.empty() && nZ < _ulCtGridsZ) {
                     for (unsigned long i = 0; i < _ulCtGridsX; i++) {
                         for (unsigned long j = 0; j < _ulCtGridsY; j++) {
-                            indices.insert(_aulGrid[i][j][nZ].begin(), _aulGrid[i][j][nZ].end());
+                            auto elements = GetCellElements(i, j, nZ);
+                            indices.insert(elements.begin(), elements.end());
                         }
                     }
                     nZ++;
@@ -523,7 +632,8 @@ void MeshGrid::SearchNearestFromPoint(const Base::Vector3f& pnt,
                 while (indices.empty() && nZ < _ulCtGridsZ) {
                     for (unsigned long i = 0; i < _ulCtGridsX; i++) {
                         for (unsigned long j = 0; j < _ulCtGridsY; j++) {
-                            indices.insert(_aulGrid[i][j][nZ].begin(), _aulGrid[i][j][nZ].end());
+                            auto elements = GetCellElements(i, j, nZ);
+                            indices.insert(elements.begin(), elements.end());
                         }
                     }
                     nZ--;
@@ -611,10 +721,10 @@ unsigned long MeshGrid::GetElements(unsigned long ulX,
                                     unsigned long ulZ,
                                     std::set<ElementIndex>& raclInd) const
 {
-    const std::set<ElementIndex>& rclSet = _aulGrid[ulX][ulY][ulZ];
-    if (!rclSet.empty()) {
-        raclInd.insert(rclSet.begin(), rclSet.end());
-        return rclSet.size();
+    auto elements = GetCellElements(ulX, ulY, ulZ);
+    if (!elements.empty()) {
+        raclInd.insert(elements.begin(), elements.end());
+        return elements.size();
     }
 
     return 0;
@@ -630,9 +740,8 @@ unsigned long MeshGrid::GetElements(const Base::Vector3f& rclPoint,
         return 0;
     }
 
-    aulFacets.resize(_aulGrid[ulX][ulY][ulZ].size());
-
-    std::copy(_aulGrid[ulX][ulY][ulZ].begin(), _aulGrid[ulX][ulY][ulZ].end(), aulFacets.begin());
+    auto elements = GetCellElements(ulX, ulY, ulZ);
+    aulFacets.assign(elements.begin(), elements.end());
     return aulFacets.size();
 }
 
@@ -749,13 +858,10 @@ void MeshFacetGrid::RebuildGrid()
     InitGrid();
 
     // Fill data structure
-    MeshFacetIterator clFIter(*_pclMesh);
-
-    unsigned long i = 0;
-    for (clFIter.Init(); clFIter.More(); clFIter.Next()) {
-        //    AddFacet(*clFIter, i++, 2.0f);
-        AddFacet(*clFIter, i++);
-    }
+    const MeshKernel& rclMesh = *_pclMesh;
+    FillGrid([this, &rclMesh](ElementIndex index, std::vector<unsigned long>& grids) {
+        GetFacetGrids(rclMesh.GetFacet(index), grids);
+    });
 }
 
 unsigned long MeshFacetGrid::SearchNearestFromPoint(const Base::Vector3f& rclPt) const
@@ -896,6 +1002,33 @@ unsigned long MeshFacetGrid::SearchNearestFromPoint(const Base::Vector3f& rclPt,
     return ulFacetInd;
 }
 
+void MeshFacetGrid::SearchNearestFromPoints(const std::vector<Base::Vector3f>& raclPoints,
+                                            std::vector<ElementIndex>& raulFacets) const
+{
+    raulFacets.resize(raclPoints.size());
+    std::size_t threads = numThreads(raclPoints.size(), 1000);
+    auto search = [&](std::size_t, std::size_t begin, std::size_t end) {
+        for (std::size_t index = begin; index < end; index++) {
+            raulFacets[index] = SearchNearestFromPoint(raclPoints[index]);
+        }
+    };
+    parallel_blocks(raclPoints.size(), threads, search);
+}
+
+void MeshFacetGrid::SearchNearestFromPoints(const std::vector<Base::Vector3f>& raclPoints,
+                                            float fMaxSearchArea,
+                                            std::vector<ElementIndex>& raulFacets) const
+{
+    raulFacets.resize(raclPoints.size());
+    std::size_t threads = numThreads(raclPoints.size(), 1000);
+    auto search = [&](std::size_t, std::size_t begin, std::size_t end) {
+        for (std::size_t index = begin; index < end; index++) {
+            raulFacets[index] = SearchNearestFromPoint(raclPoints[index], fMaxSearchArea);
+        }
+    };
+    parallel_blocks(raclPoints.size(), threads, search);
+}
+
 void MeshFacetGrid::SearchNearestFacetInHull(unsigned long ulX,
                                              unsigned long ulY,
                                              unsigned long ulZ,
@@ -986,8 +1119,7 @@ void MeshFacetGrid::SearchNearestFacetInGrid(unsigned long ulX,
                                              float& rfMinDist,
                                              ElementIndex& rulFacetInd) const
 {
-    const std::set<ElementIndex>& rclSet = _aulGrid[ulX][ulY][ulZ];
-    for (ElementIndex pI : rclSet) {
+    for (ElementIndex pI : GetCellElements(ulX, ulY, ulZ)) {
         float fDist = _pclMesh->GetFacet(pI).DistanceToPoint(rclPt);
         if (fDist < rfMinDist) {
             rfMinDist = fDist;
@@ -1030,18 +1162,6 @@ MeshPointGrid::MeshPointGrid(const MeshKernel& rclM, float fGridLen)
             std::max<unsigned long>(static_cast<unsigned long>(clBBMesh.LengthZ() / fGridLen), 1));
 }
 
-void MeshPointGrid::AddPoint(const MeshPoint& rclPt, ElementIndex ulPtIndex, float fEpsilon)
-{
-    (void)fEpsilon;
-    unsigned long ulX {};
-    unsigned long ulY {};
-    unsigned long ulZ {};
-    Pos(Base::Vector3f(rclPt.x, rclPt.y, rclPt.z), ulX, ulY, ulZ);
-    if ((ulX < _ulCtGridsX) && (ulY < _ulCtGridsY) && (ulZ < _ulCtGridsZ)) {
-        _aulGrid[ulX][ulY][ulZ].insert(ulPtIndex);
-    }
-}
-
 void MeshPointGrid::Validate(const MeshKernel& rclMesh)
 {
     if (_pclMesh != &rclMesh) {
@@ -1095,13 +1215,16 @@ void MeshPointGrid::RebuildGrid()
     InitGrid();
 
     // Fill data structure
-
-    MeshPointIterator cPIter(*_pclMesh);
-
-    unsigned long i = 0;
-    for (cPIter.Init(); cPIter.More(); cPIter.Next()) {
-        AddPoint(*cPIter, i++);
-    }
+    const MeshPointArray& rclPoints = _pclMesh->GetPoints();
+    FillGrid([this, &rclPoints](ElementIndex index, std::vector<unsigned long>& grids) {
+        unsigned long ulX {};
+        unsigned long ulY {};
+        unsigned long ulZ {};
+        Pos(rclPoints[index], ulX, ulY, ulZ);
+        if (CheckPos(ulX, ulY, ulZ)) {
+            grids.push_back(GetIndexToPosition(ulX, ulY, ulZ));
+        }
+    });
 }
 
 void MeshPointGrid::Pos(const Base::Vector3f& rclPoint,
@@ -1166,9 +1289,8 @@ bool MeshGridIterator::InitOnRay(const Base::Vector3f& rclPt,
     // point lies within global BB
     if (_rclGrid.GetBoundBox().IsInBox(rclPt)) {  // Determine the voxel by the starting point
         _rclGrid.Position(rclPt, _ulX, _ulY, _ulZ);
-        raulElements.insert(raulElements.end(),
-                            _rclGrid._aulGrid[_ulX][_ulY][_ulZ].begin(),
-                            _rclGrid._aulGrid[_ulX][_ulY][_ulZ].end());
+        auto elements = _rclGrid.GetCellElements(_ulX, _ulY, _ulZ);
+        raulElements.insert(raulElements.end(), elements.begin(), elements.end());
         _bValidRay = true;
     }
     else {  // Start point outside
@@ -1183,9 +1305,8 @@ bool MeshGridIterator::InitOnRay(const Base::Vector3f& rclPt,
                 _rclGrid.Position(cP1, _ulX, _ulY, _ulZ);
             }
 
-            raulElements.insert(raulElements.end(),
-                                _rclGrid._aulGrid[_ulX][_ulY][_ulZ].begin(),
-                                _rclGrid._aulGrid[_ulX][_ulY][_ulZ].end());
+            auto elements = _rclGrid.GetCellElements(_ulX, _ulY, _ulZ);
+            raulElements.insert(raulElements.end(), elements.begin(), elements.end());
             _bValidRay = true;
         }
     }
@@ -1249,9 +1370,8 @@ bool MeshGridIterator::NextOnRay(std::vector<ElementIndex>& raulElements)
     if (_bValidRay && _rclGrid.CheckPos(_ulX, _ulY, _ulZ)) {
         GridElement pos(_ulX, _ulY, _ulZ);
         _cSearchPositions.insert(pos);
-        raulElements.insert(raulElements.end(),
-                            _rclGrid._aulGrid[_ulX][_ulY][_ulZ].begin(),
-                            _rclGrid._aulGrid[_ulX][_ulY][_ulZ].end());
+        auto elements = _rclGrid.GetCellElements(_ulX, _ulY, _ulZ);
+        raulElements.insert(raulElements.end(), elements.begin(), elements.end());
     }
     else {
         _bValidRay = false;  // Beam leaked
@@ -23,8 +23,11 @@
 #ifndef MESH_GRID_H
 #define MESH_GRID_H
 
+#include <functional>
 #include <limits>
 #include <set>
+#include <span>
+#include <vector>
 
 #include <Base/BoundBox.h>
 
@@ -103,6 +106,14 @@ public:
 
     /** @name Getters */
     //@{
+    /** Returns the sorted indices of the elements in the given grid. The returned range becomes
+     * invalid when the grid is rebuilt. */
+    std::span<const ElementIndex>
+    GetCellElements(unsigned long ulX, unsigned long ulY, unsigned long ulZ) const
+    {
+        std::size_t cell = (std::size_t(ulZ) * _ulCtGridsY + ulY) * _ulCtGridsX + ulX;
+        return {_aulIndices.data() + _aulOffsets[cell], _aulIndices.data() + _aulOffsets[cell + 1]};
+    }
     /** Returns the indices of the elements in the given grid. */
     unsigned long GetElements(unsigned long ulX,
                               unsigned long ulY,
@@ -152,7 +163,7 @@ public:
     /** Returns the number of elements in a given grid. */
     unsigned long GetCtElements(unsigned long ulX, unsigned long ulY, unsigned long ulZ) const
     {
-        return static_cast<unsigned long>(_aulGrid[ulX][ulY][ulZ].size());
+        return static_cast<unsigned long>(GetCellElements(ulX, ulY, ulZ).size());
     }
     /** Validates the grid structure and rebuilds it if needed. Must be implemented in sub-classes.
      */
@@ -185,6 +196,14 @@ public:
 protected:
     /** Initializes the size of the internal structure. */
     virtual void InitGrid();
+    /** Creates the empty grid elements for the current number of grids. */
+    void InitCells();
+    /** Fills the grid structure. \a cells is called for each element of the mesh and must append
+     * the index (see GetIndexToPosition()) of each grid the element belongs to. For large meshes
+     * the elements are processed in parallel, so \a cells must not modify shared data. */
+    void FillGrid(const std::function<void(ElementIndex, std::vector<unsigned long>&)>& cells);
+    /** Appends the index of each grid that intersects the facet \a rclFacet to \a raulGrids. */
+    void GetFacetGrids(const MeshGeomFacet& rclFacet, std::vector<unsigned long>& raulGrids) const;
     /** Deletes the grid structure. */
     virtual void Clear();
     /** Calculates the grid length dependent on the number of grids per axis. */
@@ -196,19 +215,19 @@ protected:
 
 protected:
     // NOLINTBEGIN
-    std::vector<std::vector<std::vector<std::set<ElementIndex>>>>
-        _aulGrid;                /**< Grid data structure. */
-    const MeshKernel* _pclMesh;  /**< The mesh kernel. */
-    unsigned long _ulCtElements; /**< Number of grid elements for validation issues. */
-    unsigned long _ulCtGridsX;   /**< Number of grid elements in z. */
-    unsigned long _ulCtGridsY;   /**< Number of grid elements in z. */
-    unsigned long _ulCtGridsZ;   /**< Number of grid elements in z. */
-    float _fGridLenX;            /**< Length of grid elements in x. */
-    float _fGridLenY;            /**< Length of grid elements in y. */
-    float _fGridLenZ;            /**< Length of grid elements in z. */
-    float _fMinX;                /**< Grid null position in x. */
-    float _fMinY;                /**< Grid null position in y. */
-    float _fMinZ;                /**< Grid null position in z. */
+    std::vector<std::size_t> _aulOffsets;  /**< Start of each grid in _aulIndices. */
+    std::vector<ElementIndex> _aulIndices; /**< Element indices of all grids. */
+    const MeshKernel* _pclMesh;            /**< The mesh kernel. */
+    unsigned long _ulCtElements;           /**< Number of grid elements for validation issues. */
+    unsigned long _ulCtGridsX;             /**< Number of grid elements in z. */
+    unsigned long _ulCtGridsY;             /**< Number of grid elements in z. */
+    unsigned long _ulCtGridsZ;             /**< Number of grid elements in z. */
+    float _fGridLenX;                      /**< Length of grid elements in x. */
+    float _fGridLenY;                      /**< Length of grid elements in y. */
+    float _fGridLenZ;                      /**< Length of grid elements in z. */
+    float _fMinX;                          /**< Grid null position in x. */
+    float _fMinY;                          /**< Grid null position in y. */
+    float _fMinZ;                          /**< Grid null position in z. */
     // NOLINTEND
 
     // friends
@@ -248,6 +267,16 @@ public:
     unsigned long SearchNearestFromPoint(const Base::Vector3f& rclPt) const;
     /** Searches for the nearest facet from a point with the maximum search area. */
     unsigned long SearchNearestFromPoint(const Base::Vector3f& rclPt, float fMaxSearchArea) const;
+    /** Searches for the nearest facet of each point of \a raclPoints. The facet indices are
+     * stored in \a raulFacets in the order of the points. The points are processed in parallel.
+     */
+    void SearchNearestFromPoints(const std::vector<Base::Vector3f>& raclPoints,
+                                 std::vector<ElementIndex>& raulFacets) const;
+    /** Searches for the nearest facet of each point of \a raclPoints with the maximum search
+     * area. If no facet is found for a point its index is set to ELEMENT_INDEX_MAX. */
+    void SearchNearestFromPoints(const std::vector<Base::Vector3f>& raclPoints,
+                                 float fMaxSearchArea,
+                                 std::vector<ElementIndex>& raulFacets) const;
     /** Searches for the nearest facet in a given grid element and returns the facet index and the
      * actual distance. */
     void SearchNearestFacetInGrid(unsigned long ulX,
@@ -285,11 +314,6 @@ protected:
                              unsigned long& rulX,
                              unsigned long& rulY,
                              unsigned long& rulZ) const;
-    /** Adds a new facet element to the grid structure. \a rclFacet is the geometric facet and \a
-     * ulFacetIndex the corresponding index in the mesh kernel. The facet is added to each grid
-     * element that intersects the facet. */
-    inline void
-    AddFacet(const MeshGeomFacet& rclFacet, ElementIndex ulFacetIndex, float fEpsilon = 0.0F);
     /** Returns the number of stored elements. */
     unsigned long HasElements() const override
     {
@@ -337,9 +361,6 @@ public:
     bool Verify() const override;
 
 protected:
-    /** Adds a new point element to the grid structure. \a rclPt is the geometric point and \a
-     * ulPtIndex the corresponding index in the mesh kernel. */
-    void AddPoint(const MeshPoint& rclPt, ElementIndex ulPtIndex, float fEpsilon = 0.0F);
     /** Returns the grid numbers to the given point \a rclPoint. */
     void Pos(const Base::Vector3f& rclPoint,
              unsigned long& rulX,
@@ -371,9 +392,8 @@ public:
     /** Returns indices of the elements in the current grid. */
     void GetElements(std::vector<ElementIndex>& raulElements) const
     {
-        raulElements.insert(raulElements.end(),
-                            _rclGrid._aulGrid[_ulX][_ulY][_ulZ].begin(),
-                            _rclGrid._aulGrid[_ulX][_ulY][_ulZ].end());
+        auto elements = _rclGrid.GetCellElements(_ulX, _ulY, _ulZ);
+        raulElements.insert(raulElements.end(), elements.begin(), elements.end());
     }
     /** Returns the number of elements in the current grid. */
     unsigned long GetCtElements() const
@@ -561,61 +581,6 @@ inline void MeshFacetGrid::PosWithCheck(const Base::Vector3f& rclPoint,
     assert((rulX < _ulCtGridsX) && (rulY < _ulCtGridsY) && (rulZ < _ulCtGridsZ));
 }
 
-inline void MeshFacetGrid::AddFacet(const MeshGeomFacet& rclFacet,
-                                    ElementIndex ulFacetIndex,
-                                    float /*fEpsilon*/)
-{
-    unsigned long ulX {};
-    unsigned long ulY {};
-    unsigned long ulZ {};
-
-    unsigned long ulX1 {};
-    unsigned long ulY1 {};
-    unsigned long ulZ1 {};
-    unsigned long ulX2 {};
-    unsigned long ulY2 {};
-    unsigned long ulZ2 {};
-
-    Base::BoundBox3f clBB;
-
-    clBB.Add(rclFacet._aclPoints[0]);
-    clBB.Add(rclFacet._aclPoints[1]);
-    clBB.Add(rclFacet._aclPoints[2]);
-
-    // float fDiagonalLength = clBB.CalcDiagonalLength();
-
-    // clBB.Enlarge(fEpsilon*fDiagonalLength);
-
-    Pos(Base::Vector3f(clBB.MinX, clBB.MinY, clBB.MinZ), ulX1, ulY1, ulZ1);
-    Pos(Base::Vector3f(clBB.MaxX, clBB.MaxY, clBB.MaxZ), ulX2, ulY2, ulZ2);
-
-    /*
-    if (ulX1 > 0) ulX1--;
-    if (ulY1 > 0) ulY1--;
-    if (ulZ1 > 0) ulZ1--;
-
-    if (ulX2 < (_ulCtGridsX-1)) ulX2++;
-    if (ulY2 < (_ulCtGridsY-1)) ulY2++;
-    if (ulZ2 < (_ulCtGridsZ-1)) ulZ2++;
-    */
-
-    // falls Facet ueber mehrere BB reicht
-    if ((ulX1 < ulX2) || (ulY1 < ulY2) || (ulZ1 < ulZ2)) {
-        for (ulX = ulX1; ulX <= ulX2; ulX++) {
-            for (ulY = ulY1; ulY <= ulY2; ulY++) {
-                for (ulZ = ulZ1; ulZ <= ulZ2; ulZ++) {
-                    if (rclFacet.IntersectBoundingBox(GetBoundBox(ulX, ulY, ulZ))) {
-                        _aulGrid[ulX][ulY][ulZ].insert(ulFacetIndex);
-                    }
-                }
-            }
-        }
-    }
-    else {
-        _aulGrid[ulX1][ulY1][ulZ1].insert(ulFacetIndex);
-    }
-}
-
 }  // namespace MeshCore
 
 #endif  // MESH_GRID_H
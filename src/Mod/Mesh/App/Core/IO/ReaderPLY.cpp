@@ -23,6 +23,7 @@
 
 #include "PreCompiled.h"
 #ifndef _PreComp_
+#include <algorithm>
 #include <boost/lexical_cast.hpp>
 #include <istream>
 #endif
@@ -385,12 +386,34 @@ bool ReaderPLY::Load(std::istream& input)
         return false;
     }
 
+    ReserveElements(input);
+
     // clang-format off
     return format == ascii ? LoadAscii(input)
                            : LoadBinary(input);
     // clang-format on
 }
 
+void ReaderPLY::ReserveElements(std::istream& input)
+{
+    // Allocate the arrays once with their final size. As every element needs at least
+    // one byte a corrupted header cannot cause a larger allocation than the file size.
+    std::streamoff remaining = 0;
+    std::streambuf* buf = input.rdbuf();
+    if (buf) {
+        std::streamoff curr = buf->pubseekoff(0, std::ios::cur, std::ios::in);
+        remaining = buf->pubseekoff(0, std::ios::end, std::ios::in) - curr;
+        buf->pubseekoff(curr, std::ios::beg, std::ios::in);
+    }
+
+    auto limit = static_cast<std::size_t>(std::max<std::streamoff>(remaining, 0));
+    meshPoints.reserve(std::min(v_count, limit));
+    meshFacets.reserve(std::min(f_count, limit));
+    if (_material && _material->binding == MeshIO::PER_VERTEX) {
+        _material->diffuseColor.reserve(std::min(v_count, limit));
+    }
+}
+
 void ReaderPLY::CleanupMesh()
 {
     _kernel.Clear();  // remove all data before
@@ -70,6 +70,7 @@ private:
     bool ReadFaces(Base::InputStream& is);
     bool LoadAscii(std::istream& input);
     bool LoadBinary(std::istream& input);
+    void ReserveElements(std::istream& input);
     void CleanupMesh();
 
 private:
@@ -0,0 +1,273 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/***************************************************************************
+ *   This file is part of FreeCAD.                                         *
+ *                                                                         *
+ *   FreeCAD is free software: you can redistribute it and/or modify it    *
+ *   under the terms of the GNU Lesser General Public License as           *
+ *   published by the Free Software Foundation, either version 2.1 of the  *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   FreeCAD is distributed in the hope that it will be useful, but        *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with FreeCAD. If not, see                               *
+ *   <https://www.gnu.org/licenses/>.                                      *
+ *                                                                         *
+ **************************************************************************/
+
+#include "PreCompiled.h"
+#ifndef _PreComp_
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <thread>
+#include <vector>
+#endif
+
+#include <QFile>
+
+#include "Core/Functional.h"
+#include "Core/MeshKernel.h"
+#include <Base/Console.h>
+
+#include "ReaderSTL.h"
+
+
+using namespace MeshCore;
+
+namespace
+{
+const std::size_t HeaderSize = 84;
+const std::size_t FacetSize = 50;
+const uint32_t Empty = std::numeric_limits<uint32_t>::max();
+// The partition of a vertex is stored in a byte
+const std::size_t MaxPartitions = 256;
+
+using Coords = std::array<float, 3>;
+
+// Accesses the vertices of a mapped binary STL file by their index 3 * facet + corner
+class VertexData
+{
+public:
+    explicit VertexData(const uchar* data)
+        : data(data + HeaderSize)
+    {}
+
+    Coords coords(uint32_t ref) const
+    {
+        Coords pnt;
+        std::memcpy(pnt.data(), data + FacetSize * (ref / 3) + 12 * (ref % 3 + 1), sizeof(pnt));
+        // -0 and 0 are the same point
+        for (float& value : pnt) {
+            if (value == 0.0F) {
+                value = 0.0F;
+            }
+        }
+        return pnt;
+    }
+
+    static uint64_t hash(const Coords& pnt)
+    {
+        std::array<uint32_t, 3> bits {};
+        std::memcpy(bits.data(), pnt.data(), sizeof(bits));
+        uint64_t value = 0;
+        for (uint32_t it : bits) {
+            value = (value ^ it) * 0x9E3779B97F4A7C15ULL;
+        }
+        return value ^ (value >> 29);
+    }
+
+private:
+    const uchar* data;
+};
+
+// Open addressing hash table of the distinct points of one partition
+class PointTable
+{
+public:
+    PointTable(const VertexData& data, std::size_t numPoints)
+        : data(data)
+    {
+        std::size_t size = 16;
+        while (size < 2 * numPoints) {
+            size *= 2;
+        }
+        slots.assign(size, Empty);
+        peakMemory = memory();
+    }
+
+    // Returns the index of the point at the vertex, which is added if new
+    uint32_t insert(uint32_t ref, const Coords& pnt, uint64_t hash)
+    {
+        if (2 * (refs.size() + 1) > slots.size()) {
+            grow();
+        }
+
+        std::size_t mask = slots.size() - 1;
+        for (std::size_t i = hash & mask;; i = (i + 1) & mask) {
+            uint32_t id = slots[i];
+            if (id == Empty) {
+                id = static_cast<uint32_t>(refs.size());
+                slots[i] = id;
+                refs.push_back(ref);
+                peakMemory = std::max(peakMemory, memory());
+                return id;
+            }
+            if (data.coords(refs[id]) == pnt) {
+                return id;
+            }
+        }
+    }
+
+    void releaseSlots()
+    {
+        slots.clear();
+        slots.shrink_to_fit();
+    }
+
+    std::size_t memory() const
+    {
+        return (slots.capacity() + refs.capacity()) * sizeof(uint32_t);
+    }
+
+    // The first vertex of each point
+    std::vector<uint32_t> refs;
+    std::size_t peakMemory = 0;
+
+private:
+    void grow()
+    {
+        std::vector<uint32_t> table(2 * slots.size(), Empty);
+        peakMemory = std::max(peakMemory, memory() + table.size() * sizeof(uint32_t));
+        std::size_t mask = table.size() - 1;
+        for (uint32_t id = 0; id < refs.size(); id++) {
+            std::size_t i = VertexData::hash(data.coords(refs[id])) & mask;
+            while (table[i] != Empty) {
+                i = (i + 1) & mask;
+            }
+            table[i] = id;
+        }
+        slots.swap(table);
+    }
+
+    const VertexData& data;
+    std::vector<uint32_t> slots;
+};
+}  // namespace
+
+ReaderSTL::ReaderSTL(MeshKernel& kernel)
+    : _kernel(kernel)
+{}
+
+bool ReaderSTL::LoadBinary(const std::string& filename)
+{
+    peakMemory = 0;
+
+    QFile file(QString::fromStdString(filename));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    qint64 size = file.size();
+    if (size < static_cast<qint64>(HeaderSize)) {
+        return false;
+    }
+
+    const uchar* map = file.map(0, size);
+    if (!map) {
+        return false;
+    }
+
+    // compare the number of facets with the file size
+    uint32_t numFacets {};
+    std::memcpy(&numFacets, map + HeaderSize - sizeof(numFacets), sizeof(numFacets));
+    auto maxFacets = static_cast<uint64_t>(size - HeaderSize) / FacetSize;
+    if (numFacets > maxFacets || 3 * static_cast<uint64_t>(numFacets) >= Empty) {
+        return false;
+    }
+
+    VertexData data(map);
+    std::size_t numVertices = 3 * static_cast<std::size_t>(numFacets);
+    std::size_t threads = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+    std::size_t partitions = std::min(threads, MaxPartitions);
+
+    // Split the vertices by their hash into partitions
+    std::vector<uint8_t> partition(numVertices);
+    parallel_blocks(numVertices, threads, [&](std::size_t, std::size_t begin, std::size_t end) {
+        for (std::size_t ref = begin; ref < end; ref++) {
+            uint64_t hash = VertexData::hash(data.coords(static_cast<uint32_t>(ref)));
+            partition[ref] = static_cast<uint8_t>((hash >> 32) % partitions);
+        }
+    });
+
+    // Merge the vertices of each partition to points, most meshes have about half as
+    // many points as facets
+    MeshFacetArray facets(numFacets);
+    std::vector<PointTable> tables;
+    tables.reserve(partitions);
+    for (std::size_t i = 0; i < partitions; i++) {
+        tables.emplace_back(data, numFacets / (2 * partitions));
+    }
+
+    parallel_blocks(partitions, partitions, [&](std::size_t part, std::size_t, std::size_t) {
+        PointTable& table = tables[part];
+        for (std::size_t ref = 0; ref < numVertices; ref++) {
+            if (partition[ref] == part) {
+                auto index = static_cast<uint32_t>(ref);
+                Coords pnt = data.coords(index);
+                // keep the order of the points of a facet as written by MeshFastBuilder
+                facets[ref / 3]._aulPoints[(ref + 1) % 3] =
+                    table.insert(index, pnt, VertexData::hash(pnt));
+            }
+        }
+        table.releaseSlots();
+    });
+
+    std::size_t fixedMemory = facets.capacity() * sizeof(MeshFacet) + partition.capacity();
+    std::size_t tablesMemory = 0;
+    std::size_t refsMemory = 0;
+    std::vector<PointIndex> offsets(partitions + 1, 0);
+    for (std::size_t i = 0; i < partitions; i++) {
+        tablesMemory += tables[i].peakMemory;
+        refsMemory += tables[i].memory();
+        offsets[i + 1] = offsets[i] + tables[i].refs.size();
+    }
+
+    // Write the points and make the point indices of the facets global
+    MeshPointArray points(offsets.back());
+    parallel_blocks(partitions, partitions, [&](std::size_t part, std::size_t, std::size_t) {
+        PointIndex offset = offsets[part];
+        for (uint32_t ref : tables[part].refs) {
+            Coords pnt = data.coords(ref);
+            points[offset++].Set(pnt[0], pnt[1], pnt[2]);
+        }
+    });
+
+    peakMemory = fixedMemory
+        + std::max(tablesMemory, refsMemory + points.capacity() * sizeof(MeshPoint));
+    tables.clear();
+
+    parallel_blocks(numVertices, threads, [&](std::size_t, std::size_t begin, std::size_t end) {
+        for (std::size_t ref = begin; ref < end; ref++) {
+            facets[ref / 3]._aulPoints[(ref + 1) % 3] += offsets[partition[ref]];
+        }
+    });
+
+    partition.clear();
+    partition.shrink_to_fit();
+    file.unmap(const_cast<uchar*>(map));  // NOLINT
+
+    Base::Console().Log("Loaded binary STL with %lu facets and %lu points, peak memory %.1f MB\n",
+                        static_cast<unsigned long>(facets.size()),
+                        static_cast<unsigned long>(points.size()),
+                        static_cast<double>(peakMemory) / (1024.0 * 1024.0));
+
+    _kernel.Adopt(points, facets, true);
+    return true;
+}
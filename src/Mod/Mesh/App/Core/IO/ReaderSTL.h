@@ -0,0 +1,75 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/***************************************************************************
+ *   This file is part of FreeCAD.                                         *
+ *                                                                         *
+ *   FreeCAD is free software: you can redistribute it and/or modify it    *
+ *   under the terms of the GNU Lesser General Public License as           *
+ *   published by the Free Software Foundation, either version 2.1 of the  *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   FreeCAD is distributed in the hope that it will be useful, but        *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with FreeCAD. If not, see                               *
+ *   <https://www.gnu.org/licenses/>.                                      *
+ *                                                                         *
+ **************************************************************************/
+
+
+#ifndef MESH_IO_READER_STL_H
+#define MESH_IO_READER_STL_H
+
+#include <Mod/Mesh/MeshGlobal.h>
+#include <cstddef>
+#include <string>
+
+namespace MeshCore
+{
+
+class MeshKernel;
+
+/** Loads huge binary STL files.
+ *
+ * The file is mapped into memory instead of being read through a stream, and
+ * the coinciding vertices of the facets are merged with hash tables that only
+ * store indices into the mapped file. The vertices are split by their hash
+ * into one table per thread, and each thread scans the file for the vertices
+ * of its table. The points and facets are written directly into arrays that
+ * are allocated once with their final size.
+ */
+class MeshExport ReaderSTL
+{
+public:
+    /*!
+     * \brief ReaderSTL
+     */
+    explicit ReaderSTL(MeshKernel& kernel);
+    /*!
+     * \brief Load the mesh from a binary STL file
+     * \return true on success and false if the file cannot be mapped or
+     * is not a valid binary STL file
+     */
+    bool LoadBinary(const std::string& filename);
+    /*!
+     * \brief The peak of the memory in bytes allocated by the last call of
+     * LoadBinary(), without the memory of the mapped file and of the
+     * neighbourhood built by the mesh kernel
+     */
+    std::size_t GetPeakMemory() const
+    {
+        return peakMemory;
+    }
+
+private:
+    MeshKernel& _kernel;
+    std::size_t peakMemory = 0;
+};
+
+}  // namespace MeshCore
+
+
+#endif  // MESH_IO_READER_STL_H
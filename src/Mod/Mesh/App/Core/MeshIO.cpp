@@ -39,6 +39,7 @@
 #include "IO/Reader3MF.h"
 #include "IO/ReaderOBJ.h"
 #include "IO/ReaderPLY.h"
+#include "IO/ReaderSTL.h"
 #include "IO/Writer3MF.h"
 #include "IO/WriterInventor.h"
 #include "IO/WriterOBJ.h"
@@ -241,7 +242,7 @@ bool MeshInput::LoadAny(const char* FileName)
     // read file
     bool ok = false;
     if (fi.hasExtension({"stl", "ast"})) {
-        ok = LoadSTL(str);
+        ok = LoadSTL(str, FileName);
     }
     else if (fi.hasExtension("iv")) {
         ok = LoadInventor(str);
@@ -316,6 +317,11 @@ bool MeshInput::LoadFormat(std::istream& input, MeshIO::Format fmt)
  * Therefore the file header gets checked to decide if the file is binary or not.
  */
 bool MeshInput::LoadSTL(std::istream& input)
+{
+    return LoadSTL(input, nullptr);
+}
+
+bool MeshInput::LoadSTL(std::istream& input, const char* filename)
 {
     char szBuf[200];
 
@@ -352,6 +358,12 @@ bool MeshInput::LoadSTL(std::istream& input)
             && !strstr(szBuf, "VERTEX") && !strstr(szBuf, "ENDFACET")
             && !strstr(szBuf, "ENDLOOP")) {
             // probably binary STL
+            if (filename) {
+                ReaderSTL reader(this->_rclMesh);
+                if (reader.LoadBinary(filename)) {
+                    return true;
+                }
+            }
             buf->pubseekoff(0, std::ios::beg, std::ios::in);
             return LoadBinarySTL(input);
         }
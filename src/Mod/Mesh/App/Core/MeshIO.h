@@ -127,6 +127,10 @@ public:
      * Therefore the file header gets checked to decide if the file is binary or not.
      */
     bool LoadSTL(std::istream& input);
+    /** Loads an STL file either in binary or ASCII format.
+     * A binary file is read from the mapped file with the given name, see ReaderSTL.
+     */
+    bool LoadSTL(std::istream& input, const char* filename);
     /** Loads an ASCII STL file. */
     bool LoadAsciiSTL(std::istream& input);
     /** Loads a binary STL file. */
@@ -23,8 +23,10 @@
 #include "PreCompiled.h"
 
 #ifndef _PreComp_
+#include <algorithm>
 #include <fstream>
 #include <ios>
+#include <thread>
 #endif
 
 #include <Base/Builder3D.h>
@@ -34,6 +36,7 @@
 #include "Builder.h"
 #include "Definitions.h"
 #include "Elements.h"
+#include "Functional.h"
 #include "Grid.h"
 #include "Iterator.h"
 #include "SetOperations.h"
@@ -44,6 +47,77 @@
 using namespace Base;
 using namespace MeshCore;
 
+namespace
+{
+// Number of threads to process count items of which each thread gets at least minCount
+std::size_t numThreads(std::size_t count, std::size_t minCount)
+{
+    std::size_t threads = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+    return std::max<std::size_t>(std::min<std::size_t>(threads, count / minCount), 1);
+}
+
+// The cut line of two facets
+struct FacetCut
+{
+    FacetIndex facet0;
+    FacetIndex facet1;
+    MeshPoint p0;
+    MeshPoint p1;
+};
+
+// Intersects two facets and returns the end points of the cut line, which are moved to
+// the corner points of the facets that are closer than minDistanceToPoint
+bool cutFacets(const MeshGeomFacet& f1,
+               const MeshGeomFacet& f2,
+               float minDistanceToPoint,
+               MeshPoint& mp0,
+               MeshPoint& mp1)
+{
+    MeshPoint p0, p1;
+
+    int isect = f1.IntersectWithFacet(f2, p0, p1);
+    if (isect <= 0) {
+        return false;
+    }
+
+    // optimize cut line if distance to nearest point is too small
+    float minDist1 = minDistanceToPoint,
+          minDist2 = minDistanceToPoint;
+    MeshPoint np0 = p0, np1 = p1;
+    for (int i = 0; i < 3; i++)  // NOLINT
+    {
+        float d1 = (f1._aclPoints[i] - p0).Length();
+        float d2 = (f1._aclPoints[i] - p1).Length();
+        if (d1 < minDist1) {
+            minDist1 = d1;
+            np0 = f1._aclPoints[i];
+        }
+        if (d2 < minDist2) {
+            minDist2 = d2;
+            p1 = f1._aclPoints[i];
+        }
+    }  // for (int i = 0; i < 3; i++)
+
+    // optimize cut line if distance to nearest point is too small
+    for (int i = 0; i < 3; i++)  // NOLINT
+    {
+        float d1 = (f2._aclPoints[i] - p0).Length();
+        float d2 = (f2._aclPoints[i] - p1).Length();
+        if (d1 < minDist1) {
+            minDist1 = d1;
+            np0 = f2._aclPoints[i];
+        }
+        if (d2 < minDist2) {
+            minDist2 = d2;
+            np1 = f2._aclPoints[i];
+        }
+    }  // for (int i = 0; i < 3; i++)
+
+    mp0 = np0;
+    mp1 = np1;
+    return true;
+}
+}  // namespace
 
 SetOperations::SetOperations(const MeshKernel& cutMesh1,
                              const MeshKernel& cutMesh2,
@@ -68,11 +142,11 @@ void SetOperations::Do()
     // _builder.clear();
 
     // Base::Sequencer().next();
-    std::set<FacetIndex> facetsCuttingEdge0, facetsCuttingEdge1;
+    std::vector<bool> facetsCuttingEdge0, facetsCuttingEdge1;
     Cut(facetsCuttingEdge0, facetsCuttingEdge1);
 
     // no intersection curve of the meshes found
-    if (facetsCuttingEdge0.empty() || facetsCuttingEdge1.empty()) {
+    if (_facet2points[0].empty() || _facet2points[1].empty()) {
         switch (_operationType) {
             case Union: {
                 _resultMesh = _cutMesh0;
@@ -97,13 +171,13 @@ void SetOperations::Do()
     }
 
     for (auto i = 0UL; i < _cutMesh0.CountFacets(); i++) {
-        if (facetsCuttingEdge0.find(i) == facetsCuttingEdge0.end()) {
+        if (!facetsCuttingEdge0[i]) {
             _newMeshFacets[0].push_back(_cutMesh0.GetFacet(i));
         }
     }
 
     for (auto i = 0UL; i < _cutMesh1.CountFacets(); i++) {
-        if (facetsCuttingEdge1.find(i) == facetsCuttingEdge1.end()) {
+        if (!facetsCuttingEdge1[i]) {
             _newMeshFacets[1].push_back(_cutMesh1.GetFacet(i));
         }
     }
@@ -171,8 +245,8 @@ void SetOperations::Do()
     MeshDefinitions::SetMinPointDistance(saveMinMeshDistance);
 }
 
-void SetOperations::Cut(std::set<FacetIndex>& facetsCuttingEdge0,
-                        std::set<FacetIndex>& facetsCuttingEdge1)
+void SetOperations::Cut(std::vector<bool>& facetsCuttingEdge0,
+                        std::vector<bool>& facetsCuttingEdge1)
 {
     MeshFacetGrid grid1(_cutMesh0, 20);
     MeshFacetGrid grid2(_cutMesh1, 20);
@@ -180,218 +254,213 @@ void SetOperations::Cut(std::set<FacetIndex>& facetsCuttingEdge0,
     unsigned long ctGx1 {}, ctGy1 {}, ctGz1 {};
     grid1.GetCtGrids(ctGx1, ctGy1, ctGz1);
 
-    for (auto gx1 = 0UL; gx1 < ctGx1; gx1++) {
-        for (auto gy1 = 0UL; gy1 < ctGy1; gy1++) {
-            for (auto gz1 = 0UL; gz1 < ctGz1; gz1++) {
-                if (grid1.GetCtElements(gx1, gy1, gz1) > 0) {
-                    std::vector<FacetIndex> vecFacets2;
-                    grid2.Inside(grid1.GetBoundBox(gx1, gy1, gz1), vecFacets2);
-
-                    if (!vecFacets2.empty()) {
-                        std::set<FacetIndex> vecFacets1;
-                        grid1.GetElements(gx1, gy1, gz1, vecFacets1);
-
-                        std::set<FacetIndex>::iterator it1;
-                        for (it1 = vecFacets1.begin(); it1 != vecFacets1.end(); ++it1) {
-                            FacetIndex fidx1 = *it1;
-                            MeshGeomFacet f1 = _cutMesh0.GetFacet(*it1);
-
-                            std::vector<FacetIndex>::iterator it2;
-                            for (it2 = vecFacets2.begin(); it2 != vecFacets2.end(); ++it2) {
-                                FacetIndex fidx2 = *it2;
-                                MeshGeomFacet f2 = _cutMesh1.GetFacet(fidx2);
-
-                                MeshPoint p0, p1;
-
-                                int isect = f1.IntersectWithFacet(f2, p0, p1);
-                                if (isect > 0) {
-                                    // optimize cut line if distance to nearest point is too small
-                                    float minDist1 = _minDistanceToPoint,
-                                          minDist2 = _minDistanceToPoint;
-                                    MeshPoint np0 = p0, np1 = p1;
-                                    for (int i = 0; i < 3; i++)  // NOLINT
-                                    {
-                                        float d1 = (f1._aclPoints[i] - p0).Length();
-                                        float d2 = (f1._aclPoints[i] - p1).Length();
-                                        if (d1 < minDist1) {
-                                            minDist1 = d1;
-                                            np0 = f1._aclPoints[i];
-                                        }
-                                        if (d2 < minDist2) {
-                                            minDist2 = d2;
-                                            p1 = f1._aclPoints[i];
-                                        }
-                                    }  // for (int i = 0; i < 3; i++)
-
-                                    // optimize cut line if distance to nearest point is too small
-                                    for (int i = 0; i < 3; i++)  // NOLINT
-                                    {
-                                        float d1 = (f2._aclPoints[i] - p0).Length();
-                                        float d2 = (f2._aclPoints[i] - p1).Length();
-                                        if (d1 < minDist1) {
-                                            minDist1 = d1;
-                                            np0 = f2._aclPoints[i];
-                                        }
-                                        if (d2 < minDist2) {
-                                            minDist2 = d2;
-                                            np1 = f2._aclPoints[i];
-                                        }
-                                    }  // for (int i = 0; i < 3; i++)
-
-                                    MeshPoint mp0 = np0;
-                                    MeshPoint mp1 = np1;
-
-                                    if (mp0 != mp1) {
-                                        facetsCuttingEdge0.insert(fidx1);
-                                        facetsCuttingEdge1.insert(fidx2);
-
-                                        _cutPoints.insert(mp0);
-                                        _cutPoints.insert(mp1);
-
-                                        std::pair<std::set<MeshPoint>::iterator, bool> pit0 =
-                                            _cutPoints.insert(mp0);
-                                        std::pair<std::set<MeshPoint>::iterator, bool> pit1 =
-                                            _cutPoints.insert(mp1);
-
-                                        _edges[Edge(mp0, mp1)] = EdgeInfo();
-
-                                        _facet2points[0][fidx1].push_back(pit0.first);
-                                        _facet2points[0][fidx1].push_back(pit1.first);
-                                        _facet2points[1][fidx2].push_back(pit0.first);
-                                        _facet2points[1][fidx2].push_back(pit1.first);
-                                    }
-                                    else {
-                                        std::pair<std::set<MeshPoint>::iterator, bool> pit =
-                                            _cutPoints.insert(mp0);
-
-                                        // do not insert a facet when only one corner point cuts the
-                                        // edge if (!((mp0 == f1._aclPoints[0]) || (mp0 ==
-                                        // f1._aclPoints[1]) || (mp0 == f1._aclPoints[2])))
-                                        {
-                                            facetsCuttingEdge0.insert(fidx1);
-                                            _facet2points[0][fidx1].push_back(pit.first);
-                                        }
-
-                                        // if (!((mp0 == f2._aclPoints[0]) || (mp0 ==
-                                        // f2._aclPoints[1]) || (mp0 == f2._aclPoints[2])))
-                                        {
-                                            facetsCuttingEdge1.insert(fidx2);
-                                            _facet2points[1][fidx2].push_back(pit.first);
-                                        }
-                                    }
-                                }
-                            }
-                        }
+    // The grid cells are intersected in parallel. Each thread handles a consecutive range of
+    // cells and the cut lines are merged afterwards in the order of the cells, so that the
+    // result doesn't depend on the number of threads.
+    const std::size_t numCells = std::size_t(ctGx1) * ctGy1 * ctGz1;
+    const std::size_t threads = numThreads(numCells, 64);
+    std::vector<std::vector<FacetCut>> cuts(threads);
+    parallel_blocks(numCells, threads, [&](std::size_t block, std::size_t begin, std::size_t end) {
+        std::vector<FacetIndex> vecFacets2;
+        for (std::size_t cell = begin; cell < end; cell++) {
+            auto gx1 = static_cast<unsigned long>(cell / (std::size_t(ctGy1) * ctGz1));
+            auto gy1 = static_cast<unsigned long>((cell / ctGz1) % ctGy1);
+            auto gz1 = static_cast<unsigned long>(cell % ctGz1);
+            auto vecFacets1 = grid1.GetCellElements(gx1, gy1, gz1);
+            if (vecFacets1.empty()) {
+                continue;
+            }
+
+            grid2.Inside(grid1.GetBoundBox(gx1, gy1, gz1), vecFacets2);
+            for (FacetIndex fidx1 : vecFacets1) {
+                MeshGeomFacet f1 = _cutMesh0.GetFacet(fidx1);
+                for (FacetIndex fidx2 : vecFacets2) {
+                    MeshGeomFacet f2 = _cutMesh1.GetFacet(fidx2);
+                    FacetCut cut {fidx1, fidx2, {}, {}};
+                    if (cutFacets(f1, f2, _minDistanceToPoint, cut.p0, cut.p1)) {
+                        cuts[block].push_back(cut);
                     }
                 }
             }
         }
+    });
+
+    facetsCuttingEdge0.assign(_cutMesh0.CountFacets(), false);
+    facetsCuttingEdge1.assign(_cutMesh1.CountFacets(), false);
+    for (const auto& block : cuts) {
+        for (const auto& cut : block) {
+            const MeshPoint& mp0 = cut.p0;
+            const MeshPoint& mp1 = cut.p1;
+            facetsCuttingEdge0[cut.facet0] = true;
+            facetsCuttingEdge1[cut.facet1] = true;
+
+            if (mp0 != mp1) {
+                _cutPoints.insert(mp0);
+                _cutPoints.insert(mp1);
+
+                const MeshPoint* pt0 = &*_cutPoints.insert(mp0).first;
+                const MeshPoint* pt1 = &*_cutPoints.insert(mp1).first;
+
+                _edges[Edge(mp0, mp1)] = EdgeInfo();
+
+                _facet2points[0].emplace_back(cut.facet0, pt0);
+                _facet2points[0].emplace_back(cut.facet0, pt1);
+                _facet2points[1].emplace_back(cut.facet1, pt0);
+                _facet2points[1].emplace_back(cut.facet1, pt1);
+            }
+            else {
+                const MeshPoint* pt = &*_cutPoints.insert(mp0).first;
+                _facet2points[0].emplace_back(cut.facet0, pt);
+                _facet2points[1].emplace_back(cut.facet1, pt);
+            }
+        }
+    }
+
+    // group the cut points by facet, keeping the order in which they were found
+    for (auto& facet2points : _facet2points) {
+        std::stable_sort(facet2points.begin(),
+                         facet2points.end(),
+                         [](const auto& lhs, const auto& rhs) {
+                             return lhs.first < rhs.first;
+                         });
     }
 }
 
-void SetOperations::TriangulateMesh(const MeshKernel& cutMesh, int side)
+std::vector<MeshGeomFacet> SetOperations::TriangulateFacet(const MeshKernel& cutMesh,
+                                                           int side,
+                                                           std::size_t begin,
+                                                           std::size_t end) const
 {
-    // Triangulate Mesh
-    std::map<FacetIndex, std::list<std::set<MeshPoint>::iterator>>::iterator it1;
-    for (it1 = _facet2points[side].begin(); it1 != _facet2points[side].end(); ++it1) {
-        std::vector<Vector3f> points;
-        std::set<MeshPoint> pointsSet;
-
-        FacetIndex fidx = it1->first;
-        MeshGeomFacet f = cutMesh.GetFacet(fidx);
+    const auto& facet2points = _facet2points[side];
+    std::vector<MeshGeomFacet> triangles;
+    std::vector<Vector3f> points;
+    std::set<MeshPoint> pointsSet;
+
+    MeshGeomFacet f = cutMesh.GetFacet(facet2points[begin].first);
+
+    // if (side == 1)
+    //     _builder.addSingleTriangle(f._aclPoints[0], f._aclPoints[1], f._aclPoints[2], 3, 0,
+    //     1, 1);
+
+    // facet corner points
+    // const MeshFacet& mf = cutMesh._aclFacetArray[fidx];
+    for (int i = 0; i < 3; i++)  // NOLINT
+    {
+        pointsSet.insert(f._aclPoints[i]);
+        points.push_back(f._aclPoints[i]);
+    }
 
-        // if (side == 1)
-        //     _builder.addSingleTriangle(f._aclPoints[0], f._aclPoints[1], f._aclPoints[2], 3, 0,
-        //     1, 1);
-
-        // facet corner points
-        // const MeshFacet& mf = cutMesh._aclFacetArray[fidx];
-        for (int i = 0; i < 3; i++)  // NOLINT
-        {
-            pointsSet.insert(f._aclPoints[i]);
-            points.push_back(f._aclPoints[i]);
+    // triangulated facets
+    for (std::size_t i = begin; i < end; i++) {
+        const MeshPoint& point = *facet2points[i].second;
+        if (pointsSet.find(point) == pointsSet.end()) {
+            pointsSet.insert(point);
+            points.push_back(point);
         }
+    }
 
-        // triangulated facets
-        std::list<std::set<MeshPoint>::iterator>::iterator it2;
-        for (it2 = it1->second.begin(); it2 != it1->second.end(); ++it2) {
-            if (pointsSet.find(*(*it2)) == pointsSet.end()) {
-                pointsSet.insert(*(*it2));
-                points.push_back(*(*it2));
-            }
-        }
+    Vector3f normal = f.GetNormal();
+    Vector3f base = points[0];
+    Vector3f dirX = points[1] - points[0];
+    dirX.Normalize();
+    Vector3f dirY = dirX % normal;
+
+    // project points to 2D plane
+    std::vector<Vector3f>::iterator it;
+    std::vector<Vector3f> vertices;
+    for (it = points.begin(); it != points.end(); ++it) {
+        Vector3f pv = *it;
+        pv.TransformToCoordinateSystem(base, dirX, dirY);
+        vertices.push_back(pv);
+    }
 
-        Vector3f normal = f.GetNormal();
-        Vector3f base = points[0];
-        Vector3f dirX = points[1] - points[0];
-        dirX.Normalize();
-        Vector3f dirY = dirX % normal;
-
-        // project points to 2D plane
-        std::vector<Vector3f>::iterator it;
-        std::vector<Vector3f> vertices;
-        for (it = points.begin(); it != points.end(); ++it) {
-            Vector3f pv = *it;
-            pv.TransformToCoordinateSystem(base, dirX, dirY);
-            vertices.push_back(pv);
+    DelaunayTriangulator tria;
+    tria.SetPolygon(vertices);
+    tria.TriangulatePolygon();
+
+    std::vector<MeshFacet> facets = tria.GetFacets();
+    for (auto& it : facets) {
+        if ((it._aulPoints[0] == it._aulPoints[1]) || (it._aulPoints[1] == it._aulPoints[2])
+            || (it._aulPoints[2] == it._aulPoints[0])) {  // two same triangle corner points
+            continue;
         }
 
-        DelaunayTriangulator tria;
-        tria.SetPolygon(vertices);
-        tria.TriangulatePolygon();
+        MeshGeomFacet facet(points[it._aulPoints[0]],
+                            points[it._aulPoints[1]],
+                            points[it._aulPoints[2]]);
 
-        std::vector<MeshFacet> facets = tria.GetFacets();
-        for (auto& it : facets) {
-            if ((it._aulPoints[0] == it._aulPoints[1]) || (it._aulPoints[1] == it._aulPoints[2])
-                || (it._aulPoints[2] == it._aulPoints[0])) {  // two same triangle corner points
-                continue;
-            }
+        // if (side == 1)
+        //  _builder.addSingleTriangle(facet._aclPoints[0], facet._aclPoints[1],
+        //  facet._aclPoints[2], true, 3, 0, 1, 1);
 
-            MeshGeomFacet facet(points[it._aulPoints[0]],
-                                points[it._aulPoints[1]],
-                                points[it._aulPoints[2]]);
-
-            // if (side == 1)
-            //  _builder.addSingleTriangle(facet._aclPoints[0], facet._aclPoints[1],
-            //  facet._aclPoints[2], true, 3, 0, 1, 1);
-
-            // if (facet.Area() < 0.0001f)
-            //{ // too small facet
-            //   continue;
-            // }
-
-            float dist0 =
-                facet._aclPoints[0].DistanceToLine(facet._aclPoints[1],
-                                                   facet._aclPoints[1] - facet._aclPoints[2]);
-            float dist1 =
-                facet._aclPoints[1].DistanceToLine(facet._aclPoints[0],
-                                                   facet._aclPoints[0] - facet._aclPoints[2]);
-            float dist2 =
-                facet._aclPoints[2].DistanceToLine(facet._aclPoints[0],
-                                                   facet._aclPoints[0] - facet._aclPoints[1]);
-
-            if ((dist0 < _minDistanceToPoint) || (dist1 < _minDistanceToPoint)
-                || (dist2 < _minDistanceToPoint)) {
-                continue;
-            }
+        // if (facet.Area() < 0.0001f)
+        //{ // too small facet
+        //   continue;
+        // }
 
-            // dist0 = (facet._aclPoints[0] - facet._aclPoints[1]).Length();
-            // dist1 = (facet._aclPoints[1] - facet._aclPoints[2]).Length();
-            // dist2 = (facet._aclPoints[2] - facet._aclPoints[3]).Length();
+        float dist0 =
+            facet._aclPoints[0].DistanceToLine(facet._aclPoints[1],
+                                               facet._aclPoints[1] - facet._aclPoints[2]);
+        float dist1 =
+            facet._aclPoints[1].DistanceToLine(facet._aclPoints[0],
+                                               facet._aclPoints[0] - facet._aclPoints[2]);
+        float dist2 =
+            facet._aclPoints[2].DistanceToLine(facet._aclPoints[0],
+                                               facet._aclPoints[0] - facet._aclPoints[1]);
+
+        if ((dist0 < _minDistanceToPoint) || (dist1 < _minDistanceToPoint)
+            || (dist2 < _minDistanceToPoint)) {
+            continue;
+        }
 
-            // if ((dist0 < _minDistanceToPoint) || (dist1 < _minDistanceToPoint) || (dist2 <
-            // _minDistanceToPoint))
-            //{
-            //   continue;
-            // }
+        // dist0 = (facet._aclPoints[0] - facet._aclPoints[1]).Length();
+        // dist1 = (facet._aclPoints[1] - facet._aclPoints[2]).Length();
+        // dist2 = (facet._aclPoints[2] - facet._aclPoints[3]).Length();
+
+        // if ((dist0 < _minDistanceToPoint) || (dist1 < _minDistanceToPoint) || (dist2 <
+        // _minDistanceToPoint))
+        //{
+        //   continue;
+        // }
 
+        facet.CalcNormal();
+        if ((facet.GetNormal() * f.GetNormal()) < 0.0F) {  // adjust normal
+            std::swap(facet._aclPoints[0], facet._aclPoints[1]);
             facet.CalcNormal();
-            if ((facet.GetNormal() * f.GetNormal()) < 0.0F) {  // adjust normal
-                std::swap(facet._aclPoints[0], facet._aclPoints[1]);
-                facet.CalcNormal();
-            }
+        }
+
+        triangles.push_back(facet);
+    }
+
+    return triangles;
+}
+
+void SetOperations::TriangulateMesh(const MeshKernel& cutMesh, int side)
+{
+    // start of the cut points of each facet
+    const auto& facet2points = _facet2points[side];
+    std::vector<std::size_t> groups;
+    for (std::size_t i = 0; i < facet2points.size(); i++) {
+        if (i == 0 || facet2points[i].first != facet2points[i - 1].first) {
+            groups.push_back(i);
+        }
+    }
+    const std::size_t numFacets = groups.size();
+    groups.push_back(facet2points.size());
 
+    // Triangulate Mesh
+    std::vector<std::vector<MeshGeomFacet>> triangles(numFacets);
+    const std::size_t threads = numThreads(numFacets, 64);
+    parallel_blocks(numFacets, threads, [&](std::size_t, std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; i++) {
+            triangles[i] = TriangulateFacet(cutMesh, side, groups[i], groups[i + 1]);
+        }
+    });
 
+    // the edges are connected serially in the order of the facets
+    for (std::size_t i = 0; i < numFacets; i++) {
+        FacetIndex fidx = facet2points[groups[i]].first;
+        for (auto& facet : triangles[i]) {
             for (int j = 0; j < 3; j++) {
                 auto eit = _edges.find(Edge(facet._aclPoints[j], facet._aclPoints[(j + 1) % 3]));
 
@@ -410,7 +479,6 @@ void SetOperations::TriangulateMesh(const MeshKernel& cutMesh, int side)
                     }
                 }
             }
-
             _newMeshFacets[side].push_back(facet);
         }
     }
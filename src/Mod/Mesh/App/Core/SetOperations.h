@@ -26,6 +26,8 @@
 #include <list>
 #include <map>
 #include <set>
+#include <utility>
+#include <vector>
 
 #include <Base/Builder3D.h>
 
@@ -173,18 +175,21 @@ private:
     std::set<MeshPoint> _cutPoints;
     /** all edges */
     std::map<Edge, EdgeInfo> _edges;
-    /** map from facet index to its cut points (mesh 1 and mesh 2) Key: Facet-Index  Value: List of
-     * iterators of set<MeshPoint> */
-    std::map<FacetIndex, std::list<std::set<MeshPoint>::iterator>> _facet2points[2];
+    /** cut points of the facets (mesh 1 and mesh 2) as pairs of facet index and point of
+     * _cutPoints, sorted by the facet index */
+    std::vector<std::pair<FacetIndex, const MeshPoint*>> _facet2points[2];
     /** Facets collected from region growing */
     std::vector<MeshGeomFacet> _facetsOf[2];
 
     std::vector<MeshGeomFacet> _newMeshFacets[2];
 
-    /** Cut mesh 1 with mesh 2 */
-    void Cut(std::set<FacetIndex>& facetsCuttingEdge0, std::set<FacetIndex>& facetsCuttingEdge1);
+    /** Cut mesh 1 with mesh 2, the facets of both meshes that are cut get flagged */
+    void Cut(std::vector<bool>& facetsCuttingEdge0, std::vector<bool>& facetsCuttingEdge1);
     /** Trianglute each facets cut with its cutting points */
     void TriangulateMesh(const MeshKernel& cutMesh, int side);
+    /** Triangulate a facet with the cut points begin to end of _facet2points[side] */
+    std::vector<MeshGeomFacet>
+    TriangulateFacet(const MeshKernel& cutMesh, int side, std::size_t begin, std::size_t end) const;
     /** search facets for adding (with region growing) */
     void CollectFacets(int side, float mult);
     /** close gap in the mesh */
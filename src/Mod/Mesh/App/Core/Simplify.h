@@ -10,7 +10,10 @@
 // * Comment out printf statements
 // * Fix compiler warnings
 // * Remove macros loop,i,j,k
+// * Add locked vertices, vertex attributes and a progress callback
 
+#include <algorithm>
+#include <functional>
 #include <vector>
 
 using vec3f = Base::Vector3f;
@@ -80,11 +83,18 @@ class Simplify
 {
 public:
     struct Triangle { int v[3];double err[4];int deleted,dirty;vec3f n; };
-    struct Vertex { vec3f p;int tstart,tcount;SymmetricMatrix q;int border;};
+    struct Vertex { vec3f p;int tstart,tcount;SymmetricMatrix q;int border;int locked;int id;};
     struct Ref { int tid,tvertex; };
     std::vector<Triangle> triangles;
     std::vector<Vertex> vertices;
     std::vector<Ref> refs;
+    // Optional per-vertex attributes (e.g. colors), interpolated along collapsed edges
+    std::vector<vec3f> attributes;
+    // Weight of the squared attribute difference added to the error of an edge
+    double attribute_weight=0;
+    // Optional callback with the progress in [0,1], returning false cancels
+    std::function<bool(float)> progress;
+    bool canceled=false;
 
     void simplify_mesh(int target_count, double tolerance, double aggressiveness=7);
 
@@ -93,6 +103,7 @@ private:
 
     double vertex_error(const SymmetricMatrix& q, double x, double y, double z);
     double calculate_error(int id_v1, int id_v2, vec3f &p_result);
+    vec3f interpolate_attribute(int id_v1, int id_v2, const vec3f &p);
     bool flipped(vec3f p,int i0,int i1,Vertex &v0,Vertex &v1,std::vector<int> &deleted);
     void update_triangles(int i0,Vertex &v,std::vector<int> &deleted,int &deleted_triangles);
     void update_mesh(int iteration);
@@ -112,6 +123,10 @@ private:
 // the tolerance the algorithm will stop at this point. The number of the
 // remaining triangles usually will be higher than \a target_count
 //
+// Vertices with the locked flag set are neither moved nor removed, and their
+// id is kept when compacting the mesh. If the progress callback returns false
+// the algorithm stops and sets the canceled flag.
+//
 void Simplify::simplify_mesh(int target_count, double tolerance, double aggressiveness)
 {
     // init
@@ -126,6 +141,7 @@ void Simplify::simplify_mesh(int target_count, double tolerance, double aggressi
     int deleted_triangles=0;
     std::vector<int> deleted0,deleted1;
     int triangle_count=triangles.size();
+    canceled=false;
 
     for (int iteration=0;iteration<100;++iteration)
     {
@@ -134,6 +150,12 @@ void Simplify::simplify_mesh(int target_count, double tolerance, double aggressi
         if (triangle_count-deleted_triangles<=target_count)
             break;
 
+        if (progress && !progress(float(deleted_triangles)/float(triangle_count-target_count)))
+        {
+            canceled=true;
+            break;
+        }
+
         // update mesh once in a while
         if (iteration%5==0)
         {
@@ -193,6 +215,8 @@ void Simplify::simplify_mesh(int target_count, double tolerance, double aggressi
                     // Border check
                     if (v0.border != v1.border)
                         continue;
+                    if (v0.locked || v1.locked)
+                        continue;
 
                     // Compute vertex to collapse to
                     vec3f p;
@@ -208,6 +232,8 @@ void Simplify::simplify_mesh(int target_count, double tolerance, double aggressi
                         continue;
 
                     // not flipped, so remove edge
+                    if (!attributes.empty())
+                        attributes[i0]=interpolate_attribute(i0,i1,p);
                     v0.p=p;
                     v0.q=v1.q+v0.q;
                     int tstart=refs.size();
@@ -474,6 +500,10 @@ void Simplify::compact_mesh()
         {
             vertices[i].tstart=dst;
             vertices[dst].p=vertices[i].p;
+            vertices[dst].locked=vertices[i].locked;
+            vertices[dst].id=vertices[i].id;
+            if (!attributes.empty())
+                attributes[dst]=attributes[i];
             dst++;
         }
     }
@@ -484,6 +514,8 @@ void Simplify::compact_mesh()
             t.v[j]=vertices[t.v[j]].tstart;
     }
     vertices.resize(dst);
+    if (!attributes.empty())
+        attributes.resize(dst);
 }
 
 // Error between vertex and Quadric
@@ -530,8 +562,23 @@ double Simplify::calculate_error(int id_v1, int id_v2, vec3f &p_result)
         if (error3 == error)
             p_result=p3;
     }
+    if (!attributes.empty())
+        error += attribute_weight*(attributes[id_v1]-attributes[id_v2]).Sqr();
     return error;
 }
 
+// Attribute at the collapse position, interpolated along the edge
+
+vec3f Simplify::interpolate_attribute(int id_v1, int id_v2, const vec3f &p)
+{
+    vec3f p1=vertices[id_v1].p;
+    vec3f d=vertices[id_v2].p-p1;
+    double len=d.Sqr();
+    double t=len > 0 ? std::clamp(double((p-p1).Dot(d))/len,0.0,1.0) : 0.5;
+    const vec3f &a1=attributes[id_v1];
+    const vec3f &a2=attributes[id_v2];
+    return a1+(a2-a1)*float(t);
+}
+
 ///////////////////////////////////////////
 // clang-format on
@@ -1079,12 +1079,14 @@ void MeshObject::smooth(int iterations, float d_max)
 void MeshObject::decimate(float fTolerance, float fReduction)
 {
     MeshCore::MeshSimplify dm(this->_kernel);
+    dm.setChunks(0);
     dm.simplify(fTolerance, fReduction);
 }
 
 void MeshObject::decimate(int targetSize)
 {
     MeshCore::MeshSimplify dm(this->_kernel);
+    dm.setChunks(0);
     dm.simplify(targetSize);
 }
 
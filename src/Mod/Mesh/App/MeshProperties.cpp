@@ -931,6 +931,17 @@ void PropertyMeshKernel::RestoreDocFile(Base::Reader& reader)
     hasSetValue();
 }
 
+std::function<void()> PropertyMeshKernel::RestoreDocFileInThread(Base::Reader& reader)
+{
+    auto mesh = std::make_shared<MeshObject>();
+    mesh->load(reader);
+    return [this, mesh]() {
+        aboutToSetValue();
+        _meshObject->swap(mesh->getKernel());
+        hasSetValue();
+    };
+}
+
 App::Property* PropertyMeshKernel::Copy() const
 {
     // Note: Copy the content, do NOT reference the same mesh object
@@ -314,7 +314,16 @@ public:
     void Restore(Base::XMLReader& reader) override;
 
     void SaveDocFile(Base::Writer& writer) const override;
+    bool canSaveDocFileInThread(const Base::Writer& /*writer*/) const override
+    {
+        return true;
+    }
     void RestoreDocFile(Base::Reader& reader) override;
+    bool canRestoreDocFileInThread() const override
+    {
+        return true;
+    }
+    std::function<void()> RestoreDocFileInThread(Base::Reader& reader) override;
 
     App::Property* Copy() const override;
     void Paste(const App::Property& from) override;
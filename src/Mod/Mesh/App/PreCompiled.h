@@ -40,23 +40,31 @@
 // standard
 #include <cassert>
 #include <cmath>
+#include <cstdint>
 #include <cstdio>
+#include <cstring>
 #include <fcntl.h>
 #include <fstream>
 #include <ios>
 
 // STL
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <future>
 #include <iomanip>
 #include <iostream>
 #include <list>
 #include <limits>
 #include <map>
+#include <numeric>
 #include <queue>
 #include <set>
 #include <sstream>
 #include <stack>
 #include <string>
+#include <thread>
 #include <vector>
 
 // boost
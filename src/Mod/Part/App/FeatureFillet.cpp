@@ -22,6 +22,7 @@
 
 #include "PreCompiled.h"
 #ifndef _PreComp_
+# include <optional>
 # include <BRepFilletAPI_MakeFillet.hxx>
 # include <Precision.hxx>
 # include <TopExp.hxx>
@@ -34,6 +35,7 @@
 #include <Base/Exception.h>
 
 #include "FeatureFillet.h"
+#include "RecomputeCache.h"
 #include "TopoShapeOpCode.h"
 
 
@@ -56,6 +58,16 @@ App::DocumentObjectExecReturn *Fillet::execute()
 #endif
         auto baseShape = Feature::getShape(link);
         TopoShape baseTopoShape = Feature::getTopoShape(link);
+        std::optional<RecomputeCache::Key> cacheKey;
+        if (RecomputeCache::isEnabled()) {
+            cacheKey.emplace(this);
+            cacheKey->addShape(baseTopoShape);
+            TopoShape res;
+            if (RecomputeCache::find(*cacheKey, res)) {
+                this->Shape.setValue(res);
+                return Part::FilletBase::execute();
+            }
+        }
         BRepFilletAPI_MakeFillet mkFillet(baseShape);
         TopTools_IndexedMapOfShape mapOfShape;
         TopExp::MapShapes(baseShape, TopAbs_EDGE, mapOfShape);
@@ -89,7 +101,11 @@ App::DocumentObjectExecReturn *Fillet::execute()
             return new App::DocumentObjectExecReturn("Resulting shape is null");
 
         TopoShape res(0);
-        this->Shape.setValue(res.makeElementShape(mkFillet,baseTopoShape,Part::OpCodes::Fillet));
+        res.makeElementShape(mkFillet,baseTopoShape,Part::OpCodes::Fillet);
+        this->Shape.setValue(res);
+        if (cacheKey) {
+            RecomputeCache::insert(std::move(*cacheKey), res);
+        }
         return Part::FilletBase::execute();
     }
     catch (Standard_Failure& e) {
@@ -23,6 +23,7 @@
 #include "PreCompiled.h"
 #ifndef _PreComp_
 # include <memory>
+# include <optional>
 
 # include <Mod/Part/App/FCBRepAlgoAPI_BooleanOperation.h>
 # include <BRepCheck_Analyzer.hxx>
@@ -30,10 +31,12 @@
 #endif
 
 #include <App/Application.h>
+#include <App/Document.h>
 #include <Base/Exception.h>
 #include <Base/Parameter.h>
 
 #include "FeaturePartBoolean.h"
+#include "RecomputeCache.h"
 #include "TopoShapeOpCode.h"
 #include "modelRefine.h"
 
@@ -105,7 +108,12 @@ App::DocumentObjectExecReturn* Boolean::execute()
 {
     try {
 #if defined(__GNUC__) && defined(FC_OS_LINUX)
-        Base::SignalException se;
+        // The signal handlers are process wide, concurrent workers would
+        // restore each other's handlers
+        std::optional<Base::SignalException> se;
+        if (!App::Document::isRecomputeWorker()) {
+            se.emplace();
+        }
 #endif
         auto base = Base.getValue();
         auto tool = Tool.getValue();
@@ -127,7 +135,26 @@ App::DocumentObjectExecReturn* Boolean::execute()
             throw NullShapeException("Tool shape is null");
         }
 
-        std::unique_ptr<BRepAlgoAPI_BooleanOperation> mkBool(makeOperation(BaseShape, ToolShape));
+        std::optional<RecomputeCache::Key> cacheKey;
+        if (RecomputeCache::isEnabled()) {
+            cacheKey.emplace(this);
+            cacheKey->addShape(shapes[0]);
+            cacheKey->addShape(shapes[1]);
+            TopoShape res;
+            if (RecomputeCache::find(*cacheKey, res)) {
+                this->Shape.setValue(res);
+                copyMaterial(base);
+                return Part::Feature::execute();
+            }
+        }
+
+        std::unique_ptr<BRepAlgoAPI_BooleanOperation> mkBool;
+        {
+            // The operation only reads the input shapes, so let other
+            // objects recompute meanwhile.
+            App::RecomputeUnlocker unlocker;
+            mkBool.reset(makeOperation(BaseShape, ToolShape));
+        }
         if (!mkBool->IsDone()) {
             std::stringstream error;
             error << "Boolean operation failed";
@@ -152,6 +179,9 @@ App::DocumentObjectExecReturn* Boolean::execute()
             res = res.makeElementRefine();
         }
         this->Shape.setValue(res);
+        if (cacheKey) {
+            RecomputeCache::insert(std::move(*cacheKey), res);
+        }
         copyMaterial(base);
         return Part::Feature::execute();
     }
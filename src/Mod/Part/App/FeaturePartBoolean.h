@@ -49,6 +49,9 @@ public:
     /// recalculate the Feature
     App::DocumentObjectExecReturn *execute() override;
     short mustExecute() const override;
+    bool canRecomputeInParallel() const override {
+        return true;
+    }
     //@}
 
     /// returns the type name of the ViewProvider
@@ -399,6 +399,7 @@
 #include <Precision.hxx>
 
 // Poly*
+#include <Poly_Array1OfTriangle.hxx>
 #include <Poly_Connect.hxx>
 #include <Poly_Polygon3D.hxx>
 #include <Poly_PolygonOnTriangulation.hxx>
@@ -461,6 +462,8 @@
 #include <StlAPI_Writer.hxx>
 
 // Tcol*
+#include <TColgp_Array1OfDir.hxx>
+#include <TColgp_Array1OfPnt.hxx>
 #include <TColgp_Array1OfPnt2d.hxx>
 #include <TColgp_Array1OfVec.hxx>
 #include <TColgp_Array2OfPnt.hxx>
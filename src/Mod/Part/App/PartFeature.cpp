@@ -1486,11 +1486,12 @@ void Feature::onChanged(const App::Property* prop)
         }
     }
     // if the point data has changed check and adjust the transformation as well
+    // a lazily restored shape is not loaded, its placement matches the restored Placement
     else if (prop == &this->Shape) {
         if (this->isRecomputing()) {
             this->Shape._Shape.setTransform(this->Placement.getValue().toMatrix());
         }
-        else {
+        else if (this->Shape.isShapeLoaded()) {
             Base::Placement p;
             // shape must not be null to override the placement
             if (!this->Shape.getValue().IsNull()) {
@@ -47,16 +47,22 @@
 
 // STL
 #include <array>
+#include <atomic>
 #include <fcntl.h>
 #include <fstream>
+#include <future>
 #include <list>
 #include <iostream>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <numbers>
+#include <optional>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
 // Qt
@@ -23,6 +23,8 @@
 #include "PreCompiled.h"
 
 #ifndef _PreComp_
+# include <list>
+# include <mutex>
 # include <sstream>
 # include <Bnd_Box.hxx>
 # include <BRepBndLib.hxx>
@@ -57,6 +59,57 @@ FC_LOG_LEVEL_INIT("App", true, true)
 namespace sp = std::placeholders;
 using namespace Part;
 
+namespace Part
+{
+
+/** The content of a shape file kept by PropertyPartShape until the shape is accessed
+ * The data is kept in memory up to the limit given by the LazyRestoreMemoryLimit
+ * parameter (in MB), beyond that the oldest data is moved to temporary files.
+ */
+class ShapePayload
+{
+public:
+    ShapePayload(std::string&& data, std::string name, int version, bool binary);
+    ~ShapePayload();
+
+    static std::shared_ptr<ShapePayload>
+    create(std::string&& data, std::string name, int version, bool binary);
+
+    bool isBinary() const
+    {
+        return binary;
+    }
+    /// Memory used by the data not moved to a temporary file
+    std::size_t getMemSize() const;
+    /// Parse the shape
+    TopoShape load() const;
+    /// Write the unparsed data
+    void write(std::ostream& out) const;
+    /// Move the data to a temporary file
+    void evict();
+
+    ShapePayload(const ShapePayload&) = delete;
+    ShapePayload(ShapePayload&&) = delete;
+    ShapePayload& operator=(const ShapePayload&) = delete;
+    ShapePayload& operator=(ShapePayload&&) = delete;
+
+private:
+    mutable std::mutex mutex;
+    std::string data;
+    std::string tempFile;
+    std::string name;
+    int version;
+    bool binary;
+
+    // accounting of the data kept in memory, guarded by cacheMutex
+    std::size_t cached = 0;
+    static std::mutex cacheMutex;
+    static std::list<std::weak_ptr<ShapePayload>> cache;
+    static std::size_t cacheSize;
+};
+
+}  // namespace Part
+
 TYPESYSTEM_SOURCE(Part::PropertyPartShape , App::PropertyComplexGeoData)
 
 PropertyPartShape::PropertyPartShape() = default;
@@ -66,6 +119,7 @@ PropertyPartShape::~PropertyPartShape() = default;
 void PropertyPartShape::setValue(const TopoShape& sh)
 {
     aboutToSetValue();
+    _Payload.reset();
     _Shape = sh;
     auto obj = freecad_cast<App::DocumentObject*>(getContainer());
     if(obj) {
@@ -90,6 +144,7 @@ void PropertyPartShape::setValue(const TopoDS_Shape& sh, bool resetElementMap)
     auto obj = dynamic_cast<App::DocumentObject*>(getContainer());
     if(obj)
         _Shape.Tag = obj->getID();
+    _Payload.reset();
     _Shape.setShape(sh,resetElementMap);
     hasSetValue();
     _Ver.clear();
@@ -97,11 +152,13 @@ void PropertyPartShape::setValue(const TopoDS_Shape& sh, bool resetElementMap)
 
 const TopoDS_Shape& PropertyPartShape::getValue() const
 {
+    loadShape();
     return _Shape.getShape();
 }
 
 const TopoShape& PropertyPartShape::getShape() const
 {
+    loadShape();
     _Shape.initCache(-1);
     // March, 2024 Toponaming project:  There was originally an unused feature to disable
     // elementMapping that has not been kept:
@@ -118,6 +175,7 @@ const TopoShape& PropertyPartShape::getShape() const
 
 const Data::ComplexGeoData* PropertyPartShape::getComplexData() const
 {
+    loadShape();
     _Shape.initCache(-1);
     return &(this->_Shape);
 }
@@ -125,6 +183,7 @@ const Data::ComplexGeoData* PropertyPartShape::getComplexData() const
 Base::BoundBox3d PropertyPartShape::getBoundingBox() const
 {
     Base::BoundBox3d box;
+    loadShape();
     if (_Shape.getShape().IsNull())
         return box;
     try {
@@ -150,23 +209,27 @@ Base::BoundBox3d PropertyPartShape::getBoundingBox() const
 
 void PropertyPartShape::setTransform(const Base::Matrix4D &rclTrf)
 {
+    loadShape();
     _Shape.setTransform(rclTrf);
 }
 
 Base::Matrix4D PropertyPartShape::getTransform() const
 {
+    loadShape();
     return _Shape.getTransform();
 }
 
 void PropertyPartShape::transformGeometry(const Base::Matrix4D &rclTrf)
 {
     aboutToSetValue();
+    loadShape();
     _Shape.transformGeometry(rclTrf);
     hasSetValue();
 }
 
 PyObject *PropertyPartShape::getPyObject()
 {
+    loadShape();
     Base::PyObjectBase* prop = static_cast<Base::PyObjectBase*>(_Shape.getPyObject());
     if (prop)
         prop->setConst();
@@ -213,6 +276,7 @@ App::Property *PropertyPartShape::Copy() const
 //    } else
 //        prop->_Shape = this->_Shape;
     prop->_Shape = this->_Shape;
+    prop->_Payload = this->_Payload;
     prop->_Ver = this->_Ver;
     return prop;
 }
@@ -221,6 +285,7 @@ void PropertyPartShape::Paste(const App::Property &from)
 {
     auto prop = freecad_cast<const PropertyPartShape*>(&from);
     if(prop) {
+        prop->loadShape();
         setValue(prop->_Shape);
         _Ver = prop->_Ver;
     }
@@ -228,6 +293,8 @@ void PropertyPartShape::Paste(const App::Property &from)
 
 unsigned int PropertyPartShape::getMemSize () const
 {
+    if (_Payload)
+        return static_cast<unsigned int>(_Payload->getMemSize());
     return _Shape.getMemSize();
 }
 
@@ -245,12 +312,22 @@ void PropertyPartShape::getPaths(std::vector<App::ObjectIdentifier> &paths) cons
                     << App::ObjectIdentifier::Component::SimpleComponent(App::ObjectIdentifier::String("Volume")));
 }
 
+// The triangulation of the faces is optionally saved with the shape so that it
+// does not have to be recomputed for display after restoring the document.
+// BRepMesh keeps a restored triangulation if its deflection fits the requested one.
+static bool saveTriangulation()
+{
+    return App::GetApplication().GetParameterGroupByPath
+        ("User parameter:BaseApp/Preferences/Mod/Part/General")->GetBool("SaveTriangulation", false);
+}
+
 void PropertyPartShape::beforeSave() const
 {
     _HasherIndex = 0;
     _SaveHasher = false;
+    _SaveTriangulation = saveTriangulation();
     auto owner = freecad_cast<App::DocumentObject*>(getContainer());
-    if(owner && !_Shape.isNull() && _Shape.getElementMapSize()>0) {
+    if(owner && !isNullShape() && _Shape.getElementMapSize()>0) {
         auto ret = owner->getDocument()->addStringHasher(_Shape.Hasher);
         _HasherIndex = ret.second;
         _SaveHasher = ret.first;
@@ -262,7 +339,7 @@ void PropertyPartShape::Save (Base::Writer &writer) const
     //See SaveDocFile(), RestoreDocFile()
     writer.Stream() << writer.ind() << "<Part";
     auto owner = dynamic_cast<App::DocumentObject*>(getContainer());
-    if(owner && !_Shape.isNull()
+    if(owner && !isNullShape()
         && _Shape.getElementMapSize()>0
         && !_Shape.Hasher.isNull()) {
         writer.Stream() << " HasherIndex=\"" << _HasherIndex << '"';
@@ -288,12 +365,16 @@ void PropertyPartShape::Save (Base::Writer &writer) const
                         << writer.addFile(getFileName(binary?".bin":".brp").c_str(), this)
                         << "\"/>\n";
     } else if(binary) {
+        loadShape();
         writer.Stream() << " binary=\"1\">\n";
-        _Shape.exportBinary(writer.beginCharStream(Base::CharStreamFormat::Base64Encoded));
+        _Shape.exportBinary(writer.beginCharStream(Base::CharStreamFormat::Base64Encoded),
+                            _SaveTriangulation);
         writer.endCharStream() <<  writer.ind() << "</Part>\n";
     } else {
+        loadShape();
         writer.Stream() << " brep=\"1\">\n";
-        _Shape.exportBrep(writer.beginCharStream(Base::CharStreamFormat::Raw)<<'\n');
+        _Shape.exportBrep(writer.beginCharStream(Base::CharStreamFormat::Raw)<<'\n',
+                          _SaveTriangulation);
         writer.endCharStream() << '\n' << writer.ind() << "</Part>\n";
     }
 
@@ -322,6 +403,7 @@ std::string PropertyPartShape::getElementMapVersion(bool restored) const {
 void PropertyPartShape::Restore(Base::XMLReader &reader)
 {
     reader.readElement("Part");
+    _Payload.reset();
 
     auto owner = freecad_cast<App::DocumentObject*>(getContainer());
     _Ver = "?";
@@ -423,10 +505,11 @@ void PropertyPartShape::afterRestore()
 }
 
 // The following function is copied from OCCT BRepTools.cxx and modified
-// to disable saving of triangulation
+// to make saving of triangulation optional
 //
 
-static Standard_Boolean  BRepTools_Write(const TopoDS_Shape& Sh, const Standard_CString File)
+static Standard_Boolean  BRepTools_Write(const TopoDS_Shape& Sh, const Standard_CString File,
+                                         Standard_Boolean withTriangles)
 {
   std::ofstream os;
   OSD_OpenStream(os, File, std::ios::out);
@@ -445,7 +528,7 @@ static Standard_Boolean  BRepTools_Write(const TopoDS_Shape& Sh, const Standard_
       VERSION_3 = 3
   };
 
-  BRepTools_ShapeSet SS(Standard_False);
+  BRepTools_ShapeSet SS(withTriangles);
   SS.SetFormatNb(VERSION_1);
   // SS.SetProgress(PR);
   SS.Add(Sh);
@@ -473,7 +556,8 @@ void PropertyPartShape::saveToFile(Base::Writer &writer) const
     static Base::FileInfo fi(App::Application::getTempFileName());
 
     TopoDS_Shape myShape = _Shape.getShape();
-    if (!BRepTools_Write(myShape,static_cast<Standard_CString>(fi.filePath().c_str()))) {
+    if (!BRepTools_Write(myShape,static_cast<Standard_CString>(fi.filePath().c_str()),
+                         _SaveTriangulation)) {
         // Note: Do NOT throw an exception here because if the tmp. file could
         // not be created we should not abort.
         // We only print an error message but continue writing the next files to the
@@ -547,23 +631,37 @@ void PropertyPartShape::loadFromFile(Base::Reader &reader)
     setValue(shape);
 }
 
-void PropertyPartShape::loadFromStream(Base::Reader &reader)
+static bool readBrepStream(Base::Reader &reader, TopoDS_Shape &shape)
 {
     try {
         reader.exceptions(std::istream::failbit | std::istream::badbit);
         BRep_Builder builder;
-        TopoDS_Shape shape;
         BRepTools::Read(shape, reader, builder);
-        setValue(shape);
+        return true;
     }
     catch (const std::exception&) {
         if (!reader.eof())
             Base::Console().Warning("Failed to load BRep file %s\n", reader.getFileName().c_str());
     }
+    return false;
+}
+
+void PropertyPartShape::loadFromStream(Base::Reader &reader)
+{
+    TopoDS_Shape shape;
+    if (readBrepStream(reader, shape))
+        setValue(shape);
 }
 
 void PropertyPartShape::SaveDocFile (Base::Writer &writer) const
 {
+    if (_Payload && _Payload->isBinary() == writer.getMode("BinaryBrep")) {
+        // the shape has not been touched since restoring, copy the original file
+        _Payload->write(writer.Stream());
+        return;
+    }
+    loadShape();
+
     // If the shape is empty we simply store nothing. The file size will be 0 which
     // can be checked when reading in the data.
     if (_Shape.getShape().IsNull())
@@ -572,7 +670,7 @@ void PropertyPartShape::SaveDocFile (Base::Writer &writer) const
     if (writer.getMode("BinaryBrep")) {
         TopoShape shape;
         shape.setShape(myShape);
-        shape.exportBinary(writer.Stream());
+        shape.exportBinary(writer.Stream(), _SaveTriangulation);
     }
     else {
         bool direct = App::GetApplication().GetParameterGroupByPath
@@ -583,19 +681,41 @@ void PropertyPartShape::SaveDocFile (Base::Writer &writer) const
         else {
             TopoShape shape;
             shape.setShape(myShape);
-            shape.exportBrep(writer.Stream());
+            shape.exportBrep(writer.Stream(), _SaveTriangulation);
         }
     }
 }
 
+bool PropertyPartShape::canSaveDocFileInThread(const Base::Writer &writer) const
+{
+    // ASCII BRep output is not reentrant, see Gui::AutoSaver
+    return writer.getMode("BinaryBrep");
+}
+
 void PropertyPartShape::RestoreDocFile(Base::Reader &reader)
 {
+    Base::FileInfo brep(reader.getFileName());
+    auto hGrp = App::GetApplication().GetParameterGroupByPath
+        ("User parameter:BaseApp/Preferences/Mod/Part/General");
+    bool binary = brep.hasExtension("bin");
+    if (hGrp->GetBool("LazyRestore", false) && (binary || hGrp->GetBool("DirectAccess", true))) {
+        std::string data {std::istreambuf_iterator<char>(reader), std::istreambuf_iterator<char>()};
+        if (!data.empty()) {
+            // keep the file content, it is parsed on first access of the shape
+            aboutToSetValue();
+            if (auto obj = freecad_cast<App::DocumentObject*>(getContainer()))
+                _Shape.Tag = obj->getID();
+            _Payload = ShapePayload::create(std::move(data), reader.getFileName(),
+                                            reader.getFileVersion(), binary);
+            hasSetValue();
+            return;
+        }
+    }
 
     // save the element map
     auto elementMap = _Shape.resetElementMap();
     auto hasher = _Shape.Hasher;
 
-    Base::FileInfo brep(reader.getFileName());
     TopoShape shape;
 
     // In LS3 the following statement is executed right before shape.Hasher = hasher;
@@ -607,12 +727,11 @@ void PropertyPartShape::RestoreDocFile(Base::Reader &reader)
 
     std::string ver = _Ver;
 
-    if (brep.hasExtension("bin")) {
+    if (binary) {
         shape.importBinary(reader);
     }
     else {
-        bool direct = App::GetApplication().GetParameterGroupByPath
-            ("User parameter:BaseApp/Preferences/Mod/Part/General")->GetBool("DirectAccess", true);
+        bool direct = hGrp->GetBool("DirectAccess", true);
         if (!direct) {
             loadFromFile(reader);
         }
@@ -631,6 +750,195 @@ void PropertyPartShape::RestoreDocFile(Base::Reader &reader)
     _Ver = ver;
 }
 
+bool PropertyPartShape::canRestoreDocFileInThread() const
+{
+    auto hGrp = App::GetApplication().GetParameterGroupByPath
+        ("User parameter:BaseApp/Preferences/Mod/Part/General");
+    // Nothing to gain with lazy restore. Without direct access the shape is
+    // read through a temporary file.
+    return !hGrp->GetBool("LazyRestore", false) && hGrp->GetBool("DirectAccess", true);
+}
+
+std::function<void()> PropertyPartShape::RestoreDocFileInThread(Base::Reader &reader)
+{
+    // Only parse the file here, the property itself is not touched until
+    // the returned function is called in the main thread.
+    auto shape = std::make_shared<TopoShape>();
+    Base::FileInfo brep(reader.getFileName());
+    if (brep.hasExtension("bin")) {
+        shape->importBinary(reader);
+    }
+    else {
+        TopoDS_Shape result;
+        if (!readBrepStream(reader, result)) {
+            // like RestoreDocFile(), keep the current shape with the element map
+            return [this]() {
+                TopoShape shape = _Shape;
+                restoreShape(shape);
+            };
+        }
+        shape->setShape(result, false);
+    }
+
+    return [this, shape]() {
+        restoreShape(*shape);
+    };
+}
+
+void PropertyPartShape::restoreShape(TopoShape &shape)
+{
+    // keep the element map and its version, see RestoreDocFile()
+    std::string ver = _Ver;
+    shape.Hasher = _Shape.Hasher;
+    shape.resetElementMap(_Shape.resetElementMap());
+    setValue(shape);
+    _Ver = ver;
+}
+
+void PropertyPartShape::loadShape() const
+{
+    if (!_Payload)
+        return;
+
+    auto payload = std::move(_Payload);
+    TopoShape shape;
+    try {
+        shape = payload->load();
+    }
+    catch (...) {
+        FC_ERR("Failed to load shape of " << getFullName());
+    }
+
+    // keep the element map restored in Restore()
+    shape.Tag = _Shape.Tag;
+    shape.Hasher = _Shape.Hasher;
+    shape.resetElementMap(_Shape.resetElementMap());
+    _Shape = shape;
+}
+
+// -------------------------------------------------------------------------
+
+std::mutex ShapePayload::cacheMutex;
+std::list<std::weak_ptr<ShapePayload>> ShapePayload::cache;
+std::size_t ShapePayload::cacheSize = 0;
+
+ShapePayload::ShapePayload(std::string&& data, std::string name, int version, bool binary)
+    : data(std::move(data))
+    , name(std::move(name))
+    , version(version)
+    , binary(binary)
+{}
+
+ShapePayload::~ShapePayload()
+{
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        cacheSize -= cached;
+    }
+    if (!tempFile.empty()) {
+        Base::FileInfo fi(tempFile);
+        fi.deleteFile();
+    }
+}
+
+std::shared_ptr<ShapePayload>
+ShapePayload::create(std::string&& data, std::string name, int version, bool binary)
+{
+    auto payload = std::make_shared<ShapePayload>(std::move(data), std::move(name), version, binary);
+    std::size_t limit = App::GetApplication().GetParameterGroupByPath
+        ("User parameter:BaseApp/Preferences/Mod/Part/General")->GetUnsigned("LazyRestoreMemoryLimit", 512);
+    limit <<= 20;
+
+    // move the oldest data to temporary files if there is too much
+    std::vector<std::shared_ptr<ShapePayload>> evicted;
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        payload->cached = payload->data.size();
+        cacheSize += payload->cached;
+        cache.push_back(payload);
+        while (cacheSize > limit && !cache.empty()) {
+            auto oldest = cache.front().lock();
+            cache.pop_front();
+            if (oldest) {
+                cacheSize -= oldest->cached;
+                oldest->cached = 0;
+                evicted.push_back(oldest);
+            }
+        }
+        while (!cache.empty() && cache.front().expired()) {
+            cache.pop_front();
+        }
+    }
+    for (auto& it : evicted) {
+        it->evict();
+    }
+    return payload;
+}
+
+std::size_t ShapePayload::getMemSize() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return data.size();
+}
+
+TopoShape ShapePayload::load() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    std::unique_ptr<std::istream> stream;
+    std::unique_ptr<Base::Streambuf> buffer;
+    if (!tempFile.empty()) {
+        stream = std::make_unique<Base::ifstream>(Base::FileInfo(tempFile),
+                                                  std::ios::in | std::ios::binary);
+    }
+    else {
+        buffer = std::make_unique<Base::Streambuf>(data);
+        stream = std::make_unique<std::istream>(buffer.get());
+    }
+
+    Base::Reader reader(*stream, name, version);
+    TopoShape shape;
+    if (binary) {
+        shape.importBinary(reader);
+    }
+    else {
+        TopoDS_Shape result;
+        if (readBrepStream(reader, result))
+            shape.setShape(result, false);
+    }
+    return shape;
+}
+
+void ShapePayload::write(std::ostream& out) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (tempFile.empty()) {
+        out.write(data.data(), static_cast<std::streamsize>(data.size()));
+    }
+    else {
+        Base::ifstream file(Base::FileInfo(tempFile), std::ios::in | std::ios::binary);
+        out << file.rdbuf();
+    }
+}
+
+void ShapePayload::evict()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!tempFile.empty())
+        return;
+
+    Base::FileInfo fi(App::Application::getTempFileName());
+    Base::ofstream file(fi, std::ios::out | std::ios::binary);
+    file.write(data.data(), static_cast<std::streamsize>(data.size()));
+    file.close();
+    if (!file) {
+        // keep the data in memory
+        fi.deleteFile();
+        return;
+    }
+    tempFile = fi.filePath();
+    data = std::string();
+}
+
 // -------------------------------------------------------------------------
 
 ShapeHistory::ShapeHistory(BRepBuilderAPI_MakeShape& mkShape, TopAbs_ShapeEnum type,
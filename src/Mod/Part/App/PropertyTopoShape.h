@@ -24,6 +24,7 @@
 #define PART_PROPERTYTOPOSHAPE_H
 
 #include <map>
+#include <memory>
 #include <vector>
 
 #include <App/PropertyGeo.h>
@@ -36,6 +37,7 @@ namespace Part
 {
 
 class  Feature;
+class  ShapePayload;
 /** The part shape property class.
  * @author Werner Mayer
  */
@@ -57,6 +59,14 @@ public:
     const TopoDS_Shape& getValue() const;
     const TopoShape& getShape() const;
     const Data::ComplexGeoData* getComplexData() const override;
+    /** Check whether the shape is loaded
+     * With lazy restore enabled the shape file is kept unparsed by
+     * RestoreDocFile() and only loaded on first access of the shape.
+     */
+    bool isShapeLoaded() const
+    {
+        return !_Payload;
+    }
     //@}
 
     /** @name Modification */
@@ -89,7 +99,10 @@ public:
     virtual void beforeSave() const override;
 
     void SaveDocFile (Base::Writer &writer) const override;
+    bool canSaveDocFileInThread(const Base::Writer &writer) const override;
     void RestoreDocFile(Base::Reader &reader) override;
+    bool canRestoreDocFileInThread() const override;
+    std::function<void()> RestoreDocFileInThread(Base::Reader &reader) override;
 
     App::Property *Copy() const override;
     void Paste(const App::Property &from) override;
@@ -110,12 +123,23 @@ private:
     void saveToFile(Base::Writer &writer) const;
     void loadFromFile(Base::Reader &reader);
     void loadFromStream(Base::Reader &reader);
+    void restoreShape(TopoShape &shape);
+    void loadShape() const;
+    bool isNullShape() const
+    {
+        return !_Payload && _Shape.isNull();
+    }
 
 private:
-    TopoShape _Shape;
+    // both are mutable for loading the shape on first access
+    mutable TopoShape _Shape;
+    mutable std::shared_ptr<ShapePayload> _Payload;
     std::string _Ver;
     mutable int _HasherIndex = 0;
     mutable bool _SaveHasher = false;
+    // Whether to save the triangulation, set in beforeSave() because the
+    // shape may be saved in a thread
+    mutable bool _SaveTriangulation = false;
 };
 
 struct PartExport ShapeHistory {
@@ -0,0 +1,329 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/***************************************************************************
+ *   This file is part of FreeCAD.                                         *
+ *                                                                         *
+ *   FreeCAD is free software: you can redistribute it and/or modify it    *
+ *   under the terms of the GNU Lesser General Public License as           *
+ *   published by the Free Software Foundation, either version 2.1 of the  *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   FreeCAD is distributed in the hope that it will be useful, but        *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with FreeCAD. If not, see                               *
+ *   <https://www.gnu.org/licenses/>.                                      *
+ *                                                                         *
+ **************************************************************************/
+
+#include "PreCompiled.h"
+#ifndef _PreComp_
+# include <cstring>
+# include <functional>
+# include <list>
+# include <mutex>
+# include <sstream>
+# include <unordered_map>
+
+# include <gp_Trsf.hxx>
+# include <TopLoc_Location.hxx>
+#endif
+
+#include <App/Application.h>
+#include <App/Document.h>
+#include <App/DocumentObject.h>
+#include <App/PropertyExpressionEngine.h>
+#include <Base/Console.h>
+#include <Base/Writer.h>
+#include <Mod/Material/App/PropertyMaterial.h>
+
+#include "RecomputeCache.h"
+#include "PropertyTopoShape.h"
+
+
+FC_LOG_LEVEL_INIT("Part", true, true)
+
+using namespace Part;
+
+namespace Part
+{
+
+class RecomputeCacheP
+{
+public:
+    struct Entry
+    {
+        RecomputeCache::Key key;
+        std::vector<TopoShape> results;
+        std::size_t size;
+    };
+
+    struct KeyHasher
+    {
+        std::size_t operator()(const RecomputeCache::Key* key) const
+        {
+            return key->hash();
+        }
+    };
+
+    struct KeyEqual
+    {
+        bool operator()(const RecomputeCache::Key* a, const RecomputeCache::Key* b) const
+        {
+            return *a == *b;
+        }
+    };
+
+    using EntryList = std::list<Entry>;
+
+    static RecomputeCacheP& instance()
+    {
+        static RecomputeCacheP inst;
+        return inst;
+    }
+
+    RecomputeCacheP()
+    {
+        // NOLINTBEGIN
+        connDeleteDocument = App::GetApplication().signalDeleteDocument.connect(
+            [this](const App::Document& doc) {
+                remove(&doc);
+            });
+        // NOLINTEND
+    }
+
+    static std::size_t limit()
+    {
+        auto hGrp = App::GetApplication().GetParameterGroupByPath(
+            "User parameter:BaseApp/Preferences/Mod/Part/General");
+        return static_cast<std::size_t>(hGrp->GetUnsigned("RecomputeCacheSize", 256)) * 1024
+            * 1024;
+    }
+
+    static std::size_t entrySize(const Entry& entry)
+    {
+        std::size_t size = 0;
+        for (const auto& shape : entry.results) {
+            size += shape.getMemSize();
+        }
+        for (const auto& shape : entry.key.shapes) {
+            size += shape.getMemSize();
+        }
+        return size;
+    }
+
+    void touch(EntryList::iterator it)
+    {
+        entries.splice(entries.begin(), entries, it);
+    }
+
+    void erase(EntryList::iterator it)
+    {
+        index.erase(&it->key);
+        totalSize -= it->size;
+        entries.erase(it);
+    }
+
+    void shrink(std::size_t maxSize)
+    {
+        while (!entries.empty() && totalSize > maxSize) {
+            erase(std::prev(entries.end()));
+        }
+    }
+
+    void remove(const App::Document* doc)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!doc) {
+            index.clear();
+            entries.clear();
+            totalSize = 0;
+            return;
+        }
+        for (auto it = entries.begin(); it != entries.end();) {
+            auto next = std::next(it);
+            if (it->key.document == doc) {
+                erase(it);
+            }
+            it = next;
+        }
+    }
+
+    std::mutex mutex;
+    EntryList entries;
+    std::unordered_map<const RecomputeCache::Key*, EntryList::iterator, KeyHasher, KeyEqual> index;
+    std::size_t totalSize {0};
+    boost::signals2::scoped_connection connDeleteDocument;
+};
+
+}  // namespace Part
+
+namespace
+{
+
+bool isSameTransformation(const TopLoc_Location& a, const TopLoc_Location& b)
+{
+    if (a.IsEqual(b)) {
+        return true;
+    }
+    gp_Trsf ta = a.Transformation();
+    gp_Trsf tb = b.Transformation();
+    for (int row = 1; row <= 3; ++row) {
+        for (int col = 1; col <= 4; ++col) {
+            if (ta.Value(row, col) != tb.Value(row, col)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+RecomputeCache::Key::Key(const App::DocumentObject* feature)
+    : document(feature->getDocument())
+{
+    Base::StringWriter writer;
+    writer.setForceXML(true);
+    writer.Stream() << feature->getTypeId().getName() << ':' << feature->getID() << '\n';
+
+    std::vector<std::pair<const char*, App::Property*>> props;
+    feature->getPropertyNamedList(props);
+    for (const auto& [name, prop] : props) {
+        // Skip everything that does not take part in the shape computation.
+        // Placement is derived from the resulting shape, and linked shapes
+        // are added as input shapes by the feature.
+        if ((prop->getType() & (App::Prop_Output | App::Prop_Transient | App::Prop_NoRecompute))
+            || prop->testStatus(App::Property::Output)
+            || prop->testStatus(App::Property::Transient)
+            || prop->testStatus(App::Property::NoRecompute)) {
+            continue;
+        }
+        if (prop->isDerivedFrom<PropertyPartShape>()
+            || prop->isDerivedFrom<App::PropertyExpressionEngine>()
+            || prop->isDerivedFrom<Materials::PropertyMaterial>()
+            || std::strcmp(name, "Label") == 0 || std::strcmp(name, "Label2") == 0
+            || std::strcmp(name, "Placement") == 0) {
+            continue;
+        }
+        writer.Stream() << name << '=';
+        prop->Save(writer);
+        writer.Stream() << '\n';
+    }
+    data = writer.getString();
+}
+
+void RecomputeCache::Key::addShape(const TopoShape& shape)
+{
+    // Copying a TopoShape shares its element map, so resetting the map of the
+    // copy reveals the map pointer without touching the original shape.
+    TopoShape copy(shape);
+    auto elementMap = copy.resetElementMap();
+    std::ostringstream str;
+    str << "shape:" << shape.Tag << ':' << static_cast<const void*>(shape.Hasher.getValue())
+        << ':' << static_cast<const void*>(elementMap.get()) << '\n';
+    data += str.str();
+    shapes.push_back(shape);
+}
+
+void RecomputeCache::Key::addValue(const std::string& value)
+{
+    data += value;
+    data += '\n';
+}
+
+std::size_t RecomputeCache::Key::hash() const
+{
+    std::size_t seed = std::hash<std::string> {}(data);
+    for (const auto& shape : shapes) {
+        // The location is left out, as it is compared by value
+        std::size_t value = std::hash<const void*> {}(shape.getShape().TShape().get())
+            ^ static_cast<std::size_t>(shape.getShape().Orientation());
+        // copied from boost::hash_combine
+        seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    }
+    return seed;
+}
+
+bool RecomputeCache::Key::operator==(const Key& other) const
+{
+    if (document != other.document || data != other.data
+        || shapes.size() != other.shapes.size()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < shapes.size(); ++i) {
+        const TopoDS_Shape& a = shapes[i].getShape();
+        const TopoDS_Shape& b = other.shapes[i].getShape();
+        if (a.TShape() != b.TShape() || a.Orientation() != b.Orientation()
+            || !isSameTransformation(a.Location(), b.Location())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool RecomputeCache::isEnabled()
+{
+    auto hGrp = App::GetApplication().GetParameterGroupByPath(
+        "User parameter:BaseApp/Preferences/Mod/Part/General");
+    return hGrp->GetBool("RecomputeCache", false);
+}
+
+bool RecomputeCache::find(const Key& key, TopoShape& result)
+{
+    std::vector<TopoShape> results;
+    if (!find(key, results) || results.size() != 1) {
+        return false;
+    }
+    result = results.front();
+    return true;
+}
+
+bool RecomputeCache::find(const Key& key, std::vector<TopoShape>& results)
+{
+    auto& cache = RecomputeCacheP::instance();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    auto it = cache.index.find(&key);
+    if (it == cache.index.end()) {
+        return false;
+    }
+    cache.touch(it->second);
+    results = it->second->results;
+    FC_LOG("recompute cache hit, " << cache.entries.size() << " entries, " << cache.totalSize
+                                   << " bytes");
+    return true;
+}
+
+void RecomputeCache::insert(Key&& key, const TopoShape& result)
+{
+    insert(std::move(key), std::vector<TopoShape> {result});
+}
+
+void RecomputeCache::insert(Key&& key, std::vector<TopoShape> results)
+{
+    auto& cache = RecomputeCacheP::instance();
+    std::size_t maxSize = RecomputeCacheP::limit();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    auto it = cache.index.find(&key);
+    if (it != cache.index.end()) {
+        cache.erase(it->second);
+    }
+    cache.entries.push_front({std::move(key), std::move(results), 0});
+    auto& entry = cache.entries.front();
+    entry.size = RecomputeCacheP::entrySize(entry);
+    if (entry.size > maxSize) {
+        cache.entries.pop_front();
+        return;
+    }
+    cache.totalSize += entry.size;
+    cache.index.emplace(&entry.key, cache.entries.begin());
+    cache.shrink(maxSize);
+}
+
+void RecomputeCache::clear(const App::Document* doc)
+{
+    RecomputeCacheP::instance().remove(doc);
+}
@@ -0,0 +1,105 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/***************************************************************************
+ *   This file is part of FreeCAD.                                         *
+ *                                                                         *
+ *   FreeCAD is free software: you can redistribute it and/or modify it    *
+ *   under the terms of the GNU Lesser General Public License as           *
+ *   published by the Free Software Foundation, either version 2.1 of the  *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   FreeCAD is distributed in the hope that it will be useful, but        *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with FreeCAD. If not, see                               *
+ *   <https://www.gnu.org/licenses/>.                                      *
+ *                                                                         *
+ **************************************************************************/
+
+#ifndef PART_RECOMPUTECACHE_H
+#define PART_RECOMPUTECACHE_H
+
+#include <string>
+#include <vector>
+
+#include <Mod/Part/PartGlobal.h>
+
+#include "TopoShape.h"
+
+
+namespace App
+{
+class Document;
+class DocumentObject;
+}
+
+namespace Part
+{
+
+/** Cache of feature results keyed by the feature inputs
+ *
+ * A feature builds a Key from its parameters and input shapes before running
+ * the modelling operation. If a result for equal inputs is cached, e.g. after
+ * undo or when toggling a parameter back, the cached shape including its
+ * element map is used instead.
+ *
+ * Input shapes are compared by identity (TShape, orientation) and by the value
+ * of their location, together with their tag, hasher and element map. The
+ * location is compared by value, because features re-apply the placement of
+ * their inputs on each recompute. The key keeps the input shapes alive,
+ * so that their identity cannot be taken by another shape while cached. As a
+ * feature whose inputs are taken from the cache returns the very same shape,
+ * hits propagate down the dependency chain.
+ *
+ * The cache is enabled with the RecomputeCache parameter in
+ * BaseApp/Preferences/Mod/Part/General, its size is limited by
+ * RecomputeCacheSize (in MB).
+ */
+class PartExport RecomputeCache
+{
+public:
+    class PartExport Key
+    {
+    public:
+        /// Create a key with the type, ID and parameters of the given feature
+        explicit Key(const App::DocumentObject* feature);
+
+        /// Add an input shape
+        void addShape(const TopoShape& shape);
+        /// Add an additional parameter
+        void addValue(const std::string& value);
+
+        std::size_t hash() const;
+        bool operator==(const Key& other) const;
+
+    private:
+        friend class RecomputeCacheP;
+
+        const App::Document* document;
+        std::string data;
+        std::vector<TopoShape> shapes;
+    };
+
+    /// Check whether the cache is enabled
+    static bool isEnabled();
+    /// Look up the result for the given key
+    static bool find(const Key& key, TopoShape& result);
+    /// Look up the results of a feature with several result shapes
+    static bool find(const Key& key, std::vector<TopoShape>& results);
+    /// Store the result for the given key
+    static void insert(Key&& key, const TopoShape& result);
+    /// Store the results of a feature with several result shapes
+    static void insert(Key&& key, std::vector<TopoShape> results);
+    /// Remove all cached results of the given document, or all if null
+    static void clear(const App::Document* doc = nullptr);
+
+private:
+    friend class RecomputeCacheP;
+};
+
+}  // namespace Part
+
+#endif  // PART_RECOMPUTECACHE_H
@@ -0,0 +1,511 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/***************************************************************************
+ *   This file is part of FreeCAD.                                         *
+ *                                                                         *
+ *   FreeCAD is free software: you can redistribute it and/or modify it    *
+ *   under the terms of the GNU Lesser General Public License as           *
+ *   published by the Free Software Foundation, either version 2.1 of the  *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   FreeCAD is distributed in the hope that it will be useful, but        *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with FreeCAD. If not, see                               *
+ *   <https://www.gnu.org/licenses/>.                                      *
+ *                                                                         *
+ **************************************************************************/
+
+#include "PreCompiled.h"
+#ifndef _PreComp_
+# include <algorithm>
+# include <atomic>
+# include <cmath>
+# include <future>
+# include <numbers>
+# include <thread>
+# include <Bnd_Box.hxx>
+# include <BRep_Tool.hxx>
+# include <BRepBndLib.hxx>
+# include <BRepBuilderAPI_Copy.hxx>
+# include <BRepMesh_IncrementalMesh.hxx>
+# include <gp_Trsf.hxx>
+# include <Poly_Array1OfTriangle.hxx>
+# include <Poly_Polygon3D.hxx>
+# include <Poly_PolygonOnTriangulation.hxx>
+# include <Poly_Triangulation.hxx>
+# include <Precision.hxx>
+# include <Standard_Version.hxx>
+# include <TColgp_Array1OfDir.hxx>
+# include <TColgp_Array1OfPnt.hxx>
+# include <TColStd_Array1OfInteger.hxx>
+# include <TopExp.hxx>
+# include <TopExp_Explorer.hxx>
+# include <TopoDS.hxx>
+# include <TopoDS_Edge.hxx>
+# include <TopoDS_Face.hxx>
+# include <TopoDS_Vertex.hxx>
+# include <TopTools_IndexedMapOfShape.hxx>
+#endif
+
+#include "ShapeTessellation.h"
+#include "Tools.h"
+
+
+using namespace Part;
+
+namespace
+{
+
+// The node indices are terminated like the face and line sets of Coin expect it
+constexpr int32_t EndIndex = -1;
+
+// Faces with fewer triangles in total are converted by the calling thread
+constexpr int MinParallelTriangles = 10000;
+
+struct FaceData
+{
+    TopoDS_Face face;
+    Handle(Poly_Triangulation) mesh;
+    TopLoc_Location loc;
+    std::vector<int> edges;
+    int nodeOffset {0};
+    int triangleOffset {0};
+};
+
+Base::Vector3f toVector(const gp_XYZ& pnt)
+{
+    return {static_cast<float>(pnt.X()), static_cast<float>(pnt.Y()), static_cast<float>(pnt.Z())};
+}
+
+class Converter
+{
+public:
+    Converter(ShapeTessellation& tess, bool normalsFromUV)
+        : tess(tess)
+        , normalsFromUV(normalsFromUV)
+    {}
+
+    void convert(const TopoDS_Shape& shape, bool inParallel);
+
+private:
+    void convertFace(int faceIndex);
+    bool addEdgePolygon(int edgeIndex, const FaceData& data);
+    void run(int numFaces, bool inParallel);
+
+private:
+    ShapeTessellation& tess;
+    bool normalsFromUV;
+    TopTools_IndexedMapOfShape faceMap;
+    TopTools_IndexedMapOfShape edgeMap;
+    TopTools_IndexedMapOfShape vertexMap;
+    std::vector<FaceData> faces;
+    // the faces each edge belongs to, the first one with a polygon of it supplies the line
+    std::vector<std::vector<int>> edgeFaces;
+    std::vector<std::vector<int32_t>> edgeLines;
+    // whether a polygon of the edge was found, written by the face that owns the edge
+    std::vector<char> edgeDone;
+    int numTriangles {0};
+};
+
+void Converter::convert(const TopoDS_Shape& shape, bool inParallel)
+{
+    TopExp::MapShapes(shape, TopAbs_FACE, faceMap);
+    TopExp::MapShapes(shape, TopAbs_EDGE, edgeMap);
+    TopExp::MapShapes(shape, TopAbs_VERTEX, vertexMap);
+
+    int numFaces = faceMap.Extent();
+    int numEdges = edgeMap.Extent();
+    faces.resize(numFaces);
+    edgeFaces.resize(numEdges);
+    edgeLines.resize(numEdges);
+    edgeDone.assign(numEdges, 0);
+
+    // Collect the triangulations first, so that each face knows where its nodes and
+    // triangles go and the faces can be converted independently of each other
+    int numNodes = 0;
+    for (int i = 0; i < numFaces; i++) {
+        FaceData& data = faces[i];
+        data.face = TopoDS::Face(faceMap(i + 1));
+        data.mesh = BRep_Tool::Triangulation(data.face, data.loc);
+        if (data.mesh.IsNull()) {
+            data.mesh = Part::Tools::triangulationOfFace(data.face);
+        }
+        data.nodeOffset = numNodes;
+        data.triangleOffset = numTriangles;
+        // Note: we must also count empty faces
+        if (!data.mesh.IsNull()) {
+            numNodes += data.mesh->NbNodes();
+            numTriangles += data.mesh->NbTriangles();
+        }
+
+        for (TopExp_Explorer xp(data.face, TopAbs_EDGE); xp.More(); xp.Next()) {
+            int edgeIndex = edgeMap.FindIndex(xp.Current());
+            data.edges.push_back(edgeIndex);
+            auto& owners = edgeFaces[edgeIndex - 1];
+            if (owners.empty() || owners.back() != i) {
+                owners.push_back(i);
+            }
+        }
+    }
+
+    // handling of the free edges that are not associated to a face
+    // Note: The assumption that if for an edge BRep_Tool::Polygon3D
+    // returns a valid object is wrong. This e.g. happens for ruled
+    // surfaces which gets created by two edges or wires.
+    std::vector<std::pair<Handle(Poly_Polygon3D), TopLoc_Location>> freeEdges(numEdges);
+    int numFreeNodes = 0;
+    for (int i = 0; i < numEdges; i++) {
+        if (edgeFaces[i].empty()) {
+            auto& [poly, loc] = freeEdges[i];
+            poly = Part::Tools::polygonOfEdge(TopoDS::Edge(edgeMap(i + 1)), loc);
+            if (!poly.IsNull()) {
+                numFreeNodes += poly->NbNodes();
+            }
+        }
+    }
+
+    tess.numEdges = numEdges;
+    tess.points.resize(numNodes + numFreeNodes + vertexMap.Extent());
+    tess.normals.assign(numNodes, Base::Vector3f(0.0F, 0.0F, 0.0F));
+    tess.triangles.resize(4 * numTriangles);
+    tess.parts.resize(numFaces);
+
+    run(numFaces, inParallel);
+
+    // usually the first face of an edge supplies its polygon, if not take the next one
+    for (int i = 0; i < numEdges; i++) {
+        const auto& owners = edgeFaces[i];
+        for (std::size_t j = 1; j < owners.size() && !edgeDone[i]; j++) {
+            addEdgePolygon(i + 1, faces[owners[j]]);
+        }
+    }
+
+    int nodeOffset = numNodes;
+    for (int i = 0; i < numEdges; i++) {
+        const auto& [poly, loc] = freeEdges[i];
+        if (poly.IsNull()) {
+            continue;
+        }
+        gp_Trsf transf;
+        bool identity = loc.IsIdentity();
+        if (!identity) {
+            transf = loc.Transformation();
+        }
+        const TColgp_Array1OfPnt& nodes = poly->Nodes();
+        for (Standard_Integer j = 1; j <= poly->NbNodes(); j++) {
+            gp_Pnt pnt = nodes(j);
+            if (!identity) {
+                pnt.Transform(transf);
+            }
+            tess.points[nodeOffset + j - 1] = toVector(pnt.XYZ());
+            edgeLines[i].push_back(nodeOffset + j - 1);
+        }
+        nodeOffset += poly->NbNodes();
+    }
+
+    tess.vertexStart = nodeOffset;
+    for (int i = 0; i < vertexMap.Extent(); i++) {
+        gp_Pnt pnt = BRep_Tool::Pnt(TopoDS::Vertex(vertexMap(i + 1)));
+        tess.points[nodeOffset + i] = toVector(pnt.XYZ());
+    }
+
+    // the lines keep the order of the edges
+    for (const auto& line : edgeLines) {
+        if (!line.empty()) {
+            tess.lines.insert(tess.lines.end(), line.begin(), line.end());
+            tess.lines.push_back(EndIndex);
+        }
+    }
+}
+
+void Converter::run(int numFaces, bool inParallel)
+{
+    std::size_t numThreads = 1;
+    if (inParallel && numFaces > 1 && numTriangles >= MinParallelTriangles) {
+        numThreads = std::min<std::size_t>(std::max(1U, std::thread::hardware_concurrency()),
+                                           numFaces);
+    }
+
+    // Each face only writes to its own nodes, normals and triangles and to the
+    // edges it owns, so the faces do not need any locking
+    std::atomic<int> next {0};
+    auto convertFaces = [&]() {
+        for (int i = next++; i < numFaces; i = next++) {
+            convertFace(i);
+        }
+    };
+    std::vector<std::future<void>> futures;
+    for (std::size_t t = 1; t < numThreads; t++) {
+        futures.push_back(std::async(std::launch::async, convertFaces));
+    }
+    convertFaces();
+    for (auto& future : futures) {
+        future.get();
+    }
+}
+
+void Converter::convertFace(int faceIndex)
+{
+    const FaceData& data = faces[faceIndex];
+    const Handle(Poly_Triangulation)& mesh = data.mesh;
+    if (mesh.IsNull()) {
+        tess.parts[faceIndex] = 0;
+        return;
+    }
+
+    // getting the transformation of the shape/face
+    gp_Trsf myTransf;
+    bool identity = true;
+    if (!data.loc.IsIdentity()) {
+        identity = false;
+        myTransf = data.loc.Transformation();
+    }
+
+    // getting size of node and triangle array of this face
+    int nbNodesInFace = mesh->NbNodes();
+    int nbTriInFace = mesh->NbTriangles();
+    // check orientation
+    TopAbs_Orientation orient = data.face.Orientation();
+
+    Base::Vector3f* verts = tess.points.data() + data.nodeOffset;
+    Base::Vector3f* norms = tess.normals.data() + data.nodeOffset;
+    int32_t* index = tess.triangles.data() + 4 * data.triangleOffset;
+
+    // cycling through the poly mesh
+#if OCC_VERSION_HEX < 0x070600
+    const Poly_Array1OfTriangle& Triangles = mesh->Triangles();
+    const TColgp_Array1OfPnt& Nodes = mesh->Nodes();
+    TColgp_Array1OfDir Normals(Nodes.Lower(), Nodes.Upper());
+#else
+    TColgp_Array1OfDir Normals(1, nbNodesInFace);
+#endif
+    if (normalsFromUV) {
+        Part::Tools::getPointNormals(data.face, mesh, Normals);
+    }
+
+    for (int g = 1; g <= nbTriInFace; g++) {
+        // Get the triangle
+        Standard_Integer N1, N2, N3;
+#if OCC_VERSION_HEX < 0x070600
+        Triangles(g).Get(N1, N2, N3);
+#else
+        mesh->Triangle(g).Get(N1, N2, N3);
+#endif
+
+        // change orientation of the triangle if the face is reversed
+        if (orient != TopAbs_FORWARD) {
+            std::swap(N1, N2);
+        }
+
+        // get the 3 points of this triangle
+#if OCC_VERSION_HEX < 0x070600
+        gp_Pnt V1(Nodes(N1)), V2(Nodes(N2)), V3(Nodes(N3));
+#else
+        gp_Pnt V1(mesh->Node(N1)), V2(mesh->Node(N2)), V3(mesh->Node(N3));
+#endif
+
+        // get the 3 normals of this triangle
+        gp_Vec NV1, NV2, NV3;
+        if (normalsFromUV) {
+            NV1.SetXYZ(Normals(N1).XYZ());
+            NV2.SetXYZ(Normals(N2).XYZ());
+            NV3.SetXYZ(Normals(N3).XYZ());
+        }
+        else {
+            gp_Vec v1(V1.X(), V1.Y(), V1.Z()), v2(V2.X(), V2.Y(), V2.Z()),
+                v3(V3.X(), V3.Y(), V3.Z());
+            gp_Vec normal = (v2 - v1) ^ (v3 - v1);
+            NV1 = normal;
+            NV2 = normal;
+            NV3 = normal;
+        }
+
+        // transform the vertices and normals to the place of the face
+        if (!identity) {
+            V1.Transform(myTransf);
+            V2.Transform(myTransf);
+            V3.Transform(myTransf);
+            if (normalsFromUV) {
+                NV1.Transform(myTransf);
+                NV2.Transform(myTransf);
+                NV3.Transform(myTransf);
+            }
+        }
+
+        // add the normals for all points of this triangle
+        norms[N1 - 1] += toVector(NV1.XYZ());
+        norms[N2 - 1] += toVector(NV2.XYZ());
+        norms[N3 - 1] += toVector(NV3.XYZ());
+
+        // set the vertices
+        verts[N1 - 1] = toVector(V1.XYZ());
+        verts[N2 - 1] = toVector(V2.XYZ());
+        verts[N3 - 1] = toVector(V3.XYZ());
+
+        // set the index vector with the 3 point indexes and the end delimiter
+        index[4 * (g - 1)] = data.nodeOffset + N1 - 1;
+        index[4 * (g - 1) + 1] = data.nodeOffset + N2 - 1;
+        index[4 * (g - 1) + 2] = data.nodeOffset + N3 - 1;
+        index[4 * (g - 1) + 3] = EndIndex;
+    }
+
+    tess.parts[faceIndex] = nbTriInFace;
+
+    // handling the edges lying on this face
+    for (int edgeIndex : data.edges) {
+        if (edgeFaces[edgeIndex - 1].front() == faceIndex && !edgeDone[edgeIndex - 1]) {
+            addEdgePolygon(edgeIndex, data);
+        }
+    }
+
+    // normalize all normals
+    for (int i = 0; i < nbNodesInFace; i++) {
+        norms[i].Normalize();
+    }
+}
+
+bool Converter::addEdgePolygon(int edgeIndex, const FaceData& data)
+{
+    if (data.mesh.IsNull()) {
+        return false;
+    }
+
+    // this holds the indices of the edge's triangulation to the current polygon
+    const TopoDS_Edge& edge = TopoDS::Edge(edgeMap(edgeIndex));
+    Handle(Poly_PolygonOnTriangulation) aPoly =
+        BRep_Tool::PolygonOnTriangulation(edge, data.mesh, data.loc);
+    if (aPoly.IsNull()) {
+        return false;  // polygon does not exist
+    }
+
+    gp_Trsf myTransf;
+    bool identity = data.loc.IsIdentity();
+    if (!identity) {
+        myTransf = data.loc.Transformation();
+    }
+
+    // getting the indexes of the edge polygon
+    auto& line = edgeLines[edgeIndex - 1];
+    const TColStd_Array1OfInteger& indices = aPoly->Nodes();
+    for (Standard_Integer i = indices.Lower(); i <= indices.Upper(); i++) {
+        int nodeIndex = indices(i);
+        int index = data.nodeOffset + nodeIndex - 1;
+        line.push_back(index);
+
+        // usually the coordinates for this edge are already set by the
+        // triangles of the face this edge belongs to. However, there are
+        // rare cases where some points are only referenced by the polygon
+        // but not by any triangle. Thus, we must apply the coordinates to
+        // make sure that everything is properly set.
+#if OCC_VERSION_HEX < 0x070600
+        gp_Pnt p(data.mesh->Nodes()(nodeIndex));
+#else
+        gp_Pnt p(data.mesh->Node(nodeIndex));
+#endif
+        if (!identity) {
+            p.Transform(myTransf);
+        }
+        tess.points[index] = toVector(p.XYZ());
+    }
+
+    edgeDone[edgeIndex - 1] = 1;
+    return true;
+}
+
+}  // namespace
+
+void ShapeTessellation::compute(const TopoDS_Shape& shape,
+                                double deviation,
+                                double angularDeflection,
+                                bool normalsFromUV,
+                                bool inParallel)
+{
+    clear();
+    if (shape.IsNull()) {
+        return;
+    }
+
+    IMeshTools_Parameters meshParams;
+    meshParams.Deflection = getDeflection(shape, deviation);
+    meshParams.Relative = Standard_False;
+    meshParams.Angle = angularDeflection;
+    meshParams.InParallel = inParallel ? Standard_True : Standard_False;
+    meshParams.AllowQualityDecrease = Standard_True;
+
+    BRepMesh_IncrementalMesh(shape, meshParams);
+
+    convert(shape, normalsFromUV, inParallel);
+}
+
+void ShapeTessellation::computeLevel(const TopoDS_Shape& shape,
+                                     double deviation,
+                                     double angularDeflection,
+                                     int level,
+                                     bool normalsFromUV,
+                                     bool inParallel)
+{
+    if (level <= 0 || shape.IsNull()) {
+        compute(shape, deviation, angularDeflection, normalsFromUV, inParallel);
+        return;
+    }
+
+    deviation *= std::pow(4.0, level);
+    angularDeflection = std::min(angularDeflection * std::pow(2.0, level), std::numbers::pi);
+
+    // only the topology is copied, the geometry is shared
+    TopoDS_Shape copy = BRepBuilderAPI_Copy(shape, Standard_False).Shape();
+    compute(copy, deviation, angularDeflection, normalsFromUV, inParallel);
+}
+
+void ShapeTessellation::convert(const TopoDS_Shape& shape, bool normalsFromUV, bool inParallel)
+{
+    clear();
+    if (shape.IsNull()) {
+        return;
+    }
+
+    // We must reset the location here because the transformation data
+    // are set in the placement property
+    TopoDS_Shape cShape = shape;
+    cShape.Location(TopLoc_Location());
+
+    Converter(*this, normalsFromUV).convert(cShape, inParallel);
+}
+
+double ShapeTessellation::getDeflection(const TopoDS_Shape& shape, double deviation)
+{
+    Bnd_Box bounds;
+    BRepBndLib::Add(shape, bounds);
+    bounds.SetGap(0.0);
+    Standard_Real xMin, yMin, zMin, xMax, yMax, zMax;
+    bounds.Get(xMin, yMin, zMin, xMax, yMax, zMax);
+    Standard_Real deflection = ((xMax - xMin) + (yMax - yMin) + (zMax - zMin)) / 300.0 * deviation;
+
+    // Since OCCT 7.6 a value of equal 0 is not allowed any more, this can happen if a single
+    // vertex should be displayed.
+    if (deflection < gp::Resolution()) {
+        deflection = Precision::Confusion();
+    }
+
+    // For very big objects the computed deflection can become very high and thus leads to a
+    // useless tessellation. To avoid this the upper limit is set to 20.0
+    // See also forum: https://forum.freecad.org/viewtopic.php?t=77521
+    // deflection = std::min(deflection, 20.0);
+
+    return deflection;
+}
+
+void ShapeTessellation::clear()
+{
+    points.clear();
+    normals.clear();
+    triangles.clear();
+    parts.clear();
+    lines.clear();
+    vertexStart = 0;
+    numEdges = 0;
+}
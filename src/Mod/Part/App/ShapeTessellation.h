@@ -0,0 +1,101 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/***************************************************************************
+ *   This file is part of FreeCAD.                                         *
+ *                                                                         *
+ *   FreeCAD is free software: you can redistribute it and/or modify it    *
+ *   under the terms of the GNU Lesser General Public License as           *
+ *   published by the Free Software Foundation, either version 2.1 of the  *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   FreeCAD is distributed in the hope that it will be useful, but        *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with FreeCAD. If not, see                               *
+ *   <https://www.gnu.org/licenses/>.                                      *
+ *                                                                         *
+ **************************************************************************/
+
+#ifndef PART_SHAPETESSELLATION_H
+#define PART_SHAPETESSELLATION_H
+
+#include <cstdint>
+#include <vector>
+
+#include <Base/Vector3D.h>
+#include <Mod/Part/PartGlobal.h>
+
+class TopoDS_Shape;
+
+namespace Part
+{
+
+/** Triangulation of a shape prepared for display
+ *
+ * The data is laid out as needed by the Coin nodes of the Part view providers:
+ * the nodes of all faces followed by the nodes of the free edges and the
+ * vertices, one normal per face node, the triangles as node indices each
+ * terminated by -1, the number of triangles per face and the polygons of the
+ * edges as node indices each terminated by -1.
+ *
+ * compute() does not depend on the GUI and can be run in a worker thread, as
+ * long as no other thread meshes the same shape at the same time. The faces
+ * are converted in parallel.
+ */
+class PartExport ShapeTessellation
+{
+public:
+    /** Mesh the shape and convert its triangulation
+     * The location of the shape is ignored.
+     * @param shape the shape to tessellate
+     * @param deviation the deflection relative to the size of the shape, as used by the
+     * Deviation property of the view providers
+     * @param angularDeflection the angular deflection in radians
+     * @param normalsFromUV compute the normals from the surfaces instead of the triangles
+     * @param inParallel convert the faces in parallel
+     */
+    void compute(const TopoDS_Shape& shape,
+                 double deviation,
+                 double angularDeflection,
+                 bool normalsFromUV,
+                 bool inParallel = true);
+
+    /** Mesh the shape for a level of detail and convert its triangulation
+     * Level 0 is the same as compute(). Each further level uses a four times larger
+     * deviation and a twice as large angular deflection. These coarser levels mesh a
+     * copy of the shape, so that the triangulation stored in the shape is kept.
+     */
+    void computeLevel(const TopoDS_Shape& shape,
+                      double deviation,
+                      double angularDeflection,
+                      int level,
+                      bool normalsFromUV,
+                      bool inParallel = true);
+
+    /** Convert the triangulation that is already stored in the shape
+     * Faces without a triangulation are meshed on their own, see Tools::triangulationOfFace().
+     */
+    void convert(const TopoDS_Shape& shape, bool normalsFromUV, bool inParallel = true);
+
+    /// The absolute deflection for the relative \a deviation of the shape
+    static double getDeflection(const TopoDS_Shape& shape, double deviation);
+
+    /// Remove all data
+    void clear();
+
+    std::vector<Base::Vector3f> points;
+    std::vector<Base::Vector3f> normals;
+    std::vector<int32_t> triangles;
+    std::vector<int32_t> parts;
+    std::vector<int32_t> lines;
+    /// The index of the first point of the vertices
+    int32_t vertexStart {0};
+    int numEdges {0};
+};
+
+}  // namespace Part
+
+#endif  // PART_SHAPETESSELLATION_H
@@ -476,8 +476,8 @@ public:
     void exportIges(const char* FileName) const;
     void exportStep(const char* FileName) const;
     void exportBrep(const char* FileName) const;
-    void exportBrep(std::ostream&) const;
-    void exportBinary(std::ostream&) const;
+    void exportBrep(std::ostream&, bool withTriangles = false) const;
+    void exportBinary(std::ostream&, bool withTriangles = false) const;
     void exportStl(const char* FileName, double deflection) const;
     void exportFaceSet(double, double, const std::vector<Base::Color>&, std::ostream&) const;
     void exportLineSet(std::ostream&) const;
@@ -1422,6 +1422,10 @@ TopoShape& TopoShape::makeShapeWithElementMap(const TopoDS_Shape& shape,
     ShapeInfo edgeInfo(_Shape, TopAbs_EDGE, _cache->getAncestry(TopAbs_EDGE));
     ShapeInfo faceInfo(_Shape, TopAbs_FACE, _cache->getAncestry(TopAbs_FACE));
     mapSubElement(shapes);  // Intentionally leave the op off here
+    // Every sub-element of the new shape gets at least one name, so size the
+    // name table up front instead of growing it one element at a time.
+    ensureElementMap()->reserve(
+        static_cast<std::size_t>(vertexInfo.count() + edgeInfo.count() + faceInfo.count()));
 
     std::array<ShapeInfo*, 3> infos = {&vertexInfo, &edgeInfo, &faceInfo};
 
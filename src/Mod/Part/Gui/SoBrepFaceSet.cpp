@@ -175,7 +175,23 @@ SoBrepFaceSet::SoBrepFaceSet()
     pimpl = std::make_unique<VBO>();
 }
 
-SoBrepFaceSet::~SoBrepFaceSet() = default;
+SoBrepFaceSet::~SoBrepFaceSet()
+{
+    if (selectionSource) {
+        selectionSource->unref();
+    }
+}
+
+void SoBrepFaceSet::setSelectionSource(SoBrepFaceSet* source)
+{
+    if (source) {
+        source->ref();
+    }
+    if (selectionSource) {
+        selectionSource->unref();
+    }
+    selectionSource = source;
+}
 
 void SoBrepFaceSet::doAction(SoAction* action)
 {
@@ -359,7 +375,8 @@ void SoBrepFaceSet::GLRender(SoGLRenderAction *action)
         return;
 
     SelContextPtr ctx2;
-    SelContextPtr ctx = Gui::SoFCSelectionRoot::getRenderContext<SelContext>(this,selContext,ctx2);
+    SoBrepFaceSet* source = selectionSource ? selectionSource : this;
+    SelContextPtr ctx = Gui::SoFCSelectionRoot::getRenderContext<SelContext>(source,source->selContext,ctx2);
     if(ctx2 && ctx2->selectionIndex.empty())
         return;
 
@@ -511,11 +528,13 @@ void SoBrepFaceSet::GLRender(SoGLRenderAction *action)
 
     SelContextPtr ctx2;
     std::vector<SelContextPtr> ctxs;
-    SelContextPtr ctx = Gui::SoFCSelectionRoot::getRenderContext(this,selContext,ctx2);
+    // a coarser level of detail shows the selection of the full resolution
+    SoBrepFaceSet* source = selectionSource ? selectionSource : this;
+    SelContextPtr ctx = Gui::SoFCSelectionRoot::getRenderContext(source,source->selContext,ctx2);
     if(ctx2 && ctx2->selectionIndex.empty())
         return;
-    if(selContext2->checkGlobal(ctx))
-        ctx = selContext2;
+    if(source->selContext2->checkGlobal(ctx))
+        ctx = source->selContext2;
     if(ctx && (ctx->selectionIndex.empty() && ctx->highlightIndex<0))
         ctx.reset();
 
@@ -872,7 +891,8 @@ void SoBrepFaceSet::getBoundingBox(SoGetBoundingBoxAction * action) {
     if (this->coordIndex.getNum() < 3)
         return;
 
-    SelContextPtr ctx2 = Gui::SoFCSelectionRoot::getSecondaryActionContext<SelContext>(action,this);
+    SoBrepFaceSet* source = selectionSource ? selectionSource : this;
+    SelContextPtr ctx2 = Gui::SoFCSelectionRoot::getSecondaryActionContext<SelContext>(action,source);
     if(!ctx2 || ctx2->isSelectAll()) {
         inherited::getBoundingBox(action);
         return;
@@ -82,6 +82,10 @@ public:
 
     SoMFInt32 partIndex;
 
+    /// Show the selection and highlighting of \a source, e.g. when rendering a
+    /// coarser level of detail of the same faces
+    void setSelectionSource(SoBrepFaceSet* source);
+
 protected:
     ~SoBrepFaceSet() override;
     void GLRender(SoGLRenderAction *action) override;
@@ -146,6 +150,7 @@ private:
 #endif
     SelContextPtr selContext;
     SelContextPtr selContext2;
+    SoBrepFaceSet* selectionSource = nullptr;
     std::vector<int32_t> matIndex;
     std::vector<uint32_t> packedColors;
     uint32_t packedColor;
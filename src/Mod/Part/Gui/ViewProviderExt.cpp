@@ -23,24 +23,11 @@
 #include "PreCompiled.h"
 
 #ifndef _PreComp_
-# include <Bnd_Box.hxx>
 # include <BRep_Tool.hxx>
-# include <BRepBndLib.hxx>
 # include <BRepBuilderAPI_MakeVertex.hxx>
 # include <BRepExtrema_DistShapeShape.hxx>
-# include <BRepMesh_IncrementalMesh.hxx>
-# include <gp_Trsf.hxx>
 # include <Precision.hxx>
-# include <Poly_Array1OfTriangle.hxx>
-# include <Poly_Polygon3D.hxx>
-# include <Poly_PolygonOnTriangulation.hxx>
-# include <Poly_Triangulation.hxx>
-# include <Standard_Version.hxx>
-# include <TColgp_Array1OfDir.hxx>
-# include <TColgp_Array1OfPnt.hxx>
-# include <TColStd_Array1OfInteger.hxx>
 # include <TopExp.hxx>
-# include <TopExp_Explorer.hxx>
 # include <TopoDS.hxx>
 # include <TopoDS_Edge.hxx>
 # include <TopoDS_Face.hxx>
@@ -48,9 +35,14 @@
 # include <TopoDS_Vertex.hxx>
 # include <TopTools_IndexedMapOfShape.hxx>
 
+# include <algorithm>
+# include <map>
+# include <set>
+# include <sstream>
+
 # include <QAction>
 # include <QMenu>
-# include <sstream>
+# include <QTimer>
 
 # include <Inventor/SoPickedPoint.h>
 # include <Inventor/details/SoFaceDetail.h>
@@ -59,6 +51,7 @@
 # include <Inventor/errors/SoDebugError.h>
 # include <Inventor/nodes/SoCoordinate3.h>
 # include <Inventor/nodes/SoDrawStyle.h>
+# include <Inventor/nodes/SoLevelOfDetail.h>
 # include <Inventor/nodes/SoMaterial.h>
 # include <Inventor/nodes/SoMaterialBinding.h>
 # include <Inventor/nodes/SoNormal.h>
@@ -70,6 +63,8 @@
 # include <boost/algorithm/string/predicate.hpp>
 #endif
 
+#include <QtConcurrentMap>
+
 #include <App/Application.h>
 #include <App/Document.h>
 #include <Base/Console.h>
@@ -82,7 +77,7 @@
 #include <Gui/Selection/SoFCSelectionAction.h>
 #include <Gui/Selection/SoFCUnifiedSelection.h>
 #include <Gui/ViewParams.h>
-#include <Mod/Part/App/ShapeMapHasher.h>
+#include <Mod/Part/App/ShapeTessellation.h>
 #include <Mod/Part/App/Tools.h>
 
 #include "ViewProviderExt.h"
@@ -99,6 +94,137 @@ using namespace PartGui;
 
 PROPERTY_SOURCE(PartGui::ViewProviderPartExt, Gui::ViewProviderGeometryObject)
 
+namespace {
+// The tessellation of a shape for its view provider
+struct VisualJob
+{
+    ViewProviderPartExt* viewProvider;
+    TopoDS_Shape shape;
+    double deviation;
+    double angularDeflection;
+    bool normalsFromUV;
+    // the level of detail, 0 is the full resolution
+    int level {0};
+    Part::ShapeTessellation tessellation;
+    bool failed {false};
+    std::string error;
+
+    // Can be called from a worker thread
+    void run()
+    {
+        try {
+            tessellation.computeLevel(shape, deviation, angularDeflection, level, normalsFromUV);
+        }
+        catch (const Standard_Failure& e) {
+            failed = true;
+            error = e.GetMessageString();
+        }
+        catch (...) {
+            failed = true;
+        }
+    }
+
+    void report() const
+    {
+        if (error.empty()) {
+            FC_ERR("Cannot compute Inventor representation for the shape of "
+                   << viewProvider->getObject()->getFullName());
+        }
+        else {
+            FC_ERR("Cannot compute Inventor representation for the shape of "
+                   << viewProvider->getObject()->getFullName() << ": " << error);
+        }
+    }
+};
+
+// View providers whose visual is computed when their document has been restored
+std::map<const App::Document*, std::vector<ViewProviderPartExt*>> pendingVisuals;
+
+// View providers that show their coarsest level of detail until the finer ones are computed
+std::vector<ViewProviderPartExt*> pendingRefinements;
+
+void removePendingVisual(ViewProviderPartExt* vp)
+{
+    for (auto& it : pendingVisuals) {
+        auto& vps = it.second;
+        vps.erase(std::remove(vps.begin(), vps.end(), vp), vps.end());
+    }
+    pendingRefinements.erase(std::remove(pendingRefinements.begin(), pendingRefinements.end(), vp),
+                             pendingRefinements.end());
+}
+
+// Screen area in pixels from which on the faces are shown in full resolution.
+// Each level of detail quadruples the deviation, so that the next one is used
+// for a sixteenth of the area.
+constexpr float FullDetailScreenArea = 40000.0F;
+
+void setFaceNodes(SoCoordinate3* coords,
+                  SoNormal* norm,
+                  SoBrepFaceSet* faceset,
+                  const Part::ShapeTessellation& tess)
+{
+    coords  ->point      .setNum(static_cast<int>(tess.points.size()));
+    norm    ->vector     .setNum(static_cast<int>(tess.normals.size()));
+    faceset ->coordIndex .setNum(static_cast<int>(tess.triangles.size()));
+    faceset ->partIndex  .setNum(static_cast<int>(tess.parts.size()));
+    // get the raw memory for fast fill up
+    SbVec3f* verts = coords  ->point       .startEditing();
+    SbVec3f* norms = norm    ->vector      .startEditing();
+    int32_t* index = faceset ->coordIndex  .startEditing();
+    int32_t* parts = faceset ->partIndex   .startEditing();
+
+    for (const auto& pnt : tess.points) {
+        (verts++)->setValue(pnt.x, pnt.y, pnt.z);
+    }
+    for (const auto& vec : tess.normals) {
+        (norms++)->setValue(vec.x, vec.y, vec.z);
+    }
+    std::copy(tess.triangles.begin(), tess.triangles.end(), index);
+    std::copy(tess.parts.begin(), tess.parts.end(), parts);
+
+    // end the editing of the nodes
+    coords  ->point       .finishEditing();
+    norm    ->vector      .finishEditing();
+    faceset ->coordIndex  .finishEditing();
+    faceset ->partIndex   .finishEditing();
+}
+
+// Split the jobs into batches without sub-shapes in common, because the
+// triangulation is stored in the faces and edges and they must not be meshed
+// by two threads at the same time
+std::vector<std::vector<VisualJob*>> splitIntoBatches(std::vector<VisualJob>& jobs)
+{
+    std::vector<std::vector<VisualJob*>> batches;
+    std::vector<std::set<const TopoDS_TShape*>> batchShapes;
+    for (auto& job : jobs) {
+        TopTools_IndexedMapOfShape subShapes;
+        TopExp::MapShapes(job.shape, TopAbs_FACE, subShapes);
+        TopExp::MapShapes(job.shape, TopAbs_EDGE, subShapes);
+
+        std::size_t index = 0;
+        for (; index < batches.size(); ++index) {
+            const auto& shapes = batchShapes[index];
+            bool shared = false;
+            for (int i = 1; i <= subShapes.Extent() && !shared; i++) {
+                shared = shapes.count(subShapes(i).TShape().get()) > 0;
+            }
+            if (!shared) {
+                break;
+            }
+        }
+        if (index == batches.size()) {
+            batches.emplace_back();
+            batchShapes.emplace_back();
+        }
+        batches[index].push_back(&job);
+        for (int i = 1; i <= subShapes.Extent(); i++) {
+            batchShapes[index].insert(subShapes(i).TShape().get());
+        }
+    }
+    return batches;
+}
+}
+
 
 //**************************************************************************
 // Construction/Destruction
@@ -106,6 +232,7 @@ PROPERTY_SOURCE(PartGui::ViewProviderPartExt, Gui::ViewProviderGeometryObject)
 App::PropertyFloatConstraint::Constraints ViewProviderPartExt::sizeRange = {1.0,64.0,1.0};
 App::PropertyFloatConstraint::Constraints ViewProviderPartExt::tessRange = {0.01,100.0,0.01};
 App::PropertyQuantityConstraint::Constraints ViewProviderPartExt::angDeflectionRange = {1.0,180.0,0.05};
+App::PropertyIntegerConstraint::Constraints ViewProviderPartExt::lodRange = {1,4,1};
 const char* ViewProviderPartExt::LightingEnums[]= {"One side","Two side",nullptr};
 const char* ViewProviderPartExt::DrawStyleEnums[]= {"Solid","Dashed","Dotted","Dashdot",nullptr};
 
@@ -180,6 +307,11 @@ ViewProviderPartExt::ViewProviderPartExt()
             "The default value is 28.5 degrees, or 0.5 radians. The smaller the value\n"
             "the smoother the appearance in the 3D view, and the finer the mesh that will be exported.");
     AngularDeflection.setConstraints(&angDeflectionRange);
+    ADD_PROPERTY_TYPE(LevelsOfDetail,(1), osgroup, App::Prop_None,
+            "Number of tessellations of the faces with decreasing accuracy.\n"
+            "The coarser ones are shown when the object covers a small area\n"
+            "of the screen. 1 shows the faces always in full resolution.");
+    LevelsOfDetail.setConstraints(&lodRange);
     ADD_PROPERTY_TYPE(Lighting,(twoside), osgroup, App::Prop_None, "Set object lighting.");
     Lighting.setEnums(LightingEnums);
     ADD_PROPERTY_TYPE(DrawStyle,((long int)0), osgroup, App::Prop_None, "Defines the style of the edges in the 3D view.");
@@ -195,6 +327,13 @@ ViewProviderPartExt::ViewProviderPartExt()
     normb = new SoNormalBinding;
     normb->value = SoNormalBinding::PER_VERTEX_INDEXED;
     normb->ref();
+    pcFaceLOD = new SoLevelOfDetail();
+    pcFaceLOD->ref();
+    pcFaceLOD->setName("FaceLOD");
+    auto* fullDetail = new SoGroup();
+    fullDetail->addChild(norm);
+    fullDetail->addChild(faceset);
+    pcFaceLOD->addChild(fullDetail);
     lineset = new SoBrepEdgeSet();
     lineset->ref();
     nodeset = new SoBrepPointSet();
@@ -244,6 +383,7 @@ ViewProviderPartExt::ViewProviderPartExt()
 
 ViewProviderPartExt::~ViewProviderPartExt()
 {
+    removePendingVisual(this);
     pcFaceBind->unref();
     pcLineBind->unref();
     pcPointBind->unref();
@@ -256,6 +396,7 @@ ViewProviderPartExt::~ViewProviderPartExt()
     faceset->unref();
     norm->unref();
     normb->unref();
+    pcFaceLOD->unref();
     lineset->unref();
     nodeset->unref();
 }
@@ -275,13 +416,19 @@ void ViewProviderPartExt::onChanged(const App::Property* prop)
     // to freeze the GUI
     // https://forum.freecad.org/viewtopic.php?f=3&t=24912&p=195613
     if (prop == &Deviation) {
-        if(isUpdateForced()||Visibility.getValue())
+        if(!isRestoring() && (isUpdateForced()||Visibility.getValue()))
             updateVisual();
         else
             VisualTouched = true;
     }
     if (prop == &AngularDeflection) {
-        if(isUpdateForced()||Visibility.getValue())
+        if(!isRestoring() && (isUpdateForced()||Visibility.getValue()))
+            updateVisual();
+        else
+            VisualTouched = true;
+    }
+    if (prop == &LevelsOfDetail) {
+        if(!isRestoring() && (isUpdateForced()||Visibility.getValue()))
             updateVisual();
         else
             VisualTouched = true;
@@ -379,7 +526,9 @@ void ViewProviderPartExt::onChanged(const App::Property* prop)
     }
     else {
         // if the object was invisible and has been changed, recreate the visual
-        if (prop == &Visibility && (isUpdateForced() || Visibility.getValue()) && VisualTouched) {
+        // while restoring, the visual is computed in finishRestoring()
+        if (prop == &Visibility && !isRestoring()
+                && (isUpdateForced() || Visibility.getValue()) && VisualTouched) {
             updateVisual();
             // updateVisual() may not be triggered by any change (e.g.
             // triggered by an external object through forceUpdate()). And
@@ -458,9 +607,8 @@ void ViewProviderPartExt::attach(App::DocumentObject *pcFeat)
     pcFaceStyle->setName("FaceStyle");
     pcFaceStyle->style = SoDrawStyle::FILLED;
     pcFlatRoot->addChild(pcFaceStyle);
-    pcFlatRoot->addChild(norm);
     pcFlatRoot->addChild(normb);
-    pcFlatRoot->addChild(faceset);
+    pcFlatRoot->addChild(pcFaceLOD);
 
     // edges and points
     pcWireframeRoot->addChild(wireframe);
@@ -616,6 +764,10 @@ void ViewProviderPartExt::setHighlightedFaces(const std::vector<App::Material>&
 
     Gui::SoUpdateVBOAction action;
     action.apply(this->faceset);
+    for (int i = 1; i < pcFaceLOD->getNumChildren(); i++) {
+        auto level = static_cast<SoSeparator*>(pcFaceLOD->getChild(i));
+        action.apply(level->getChild(2));
+    }
 
     int size = static_cast<int>(materials.size());
     if (size > 1 && size == this->faceset->partIndex.getNum()) {
@@ -850,7 +1002,7 @@ void ViewProviderPartExt::updateData(const App::Property* prop)
     const char *propName = prop->getName();
     if (propName && (strcmp(propName, "Shape") == 0 || strstr(propName, "Touched"))) {
         // calculate the visual only if visible
-        if (isUpdateForced() || Visibility.getValue())
+        if (!isRestoring() && (isUpdateForced() || Visibility.getValue()))
             updateVisual();
         else
             VisualTouched = true;
@@ -880,6 +1032,26 @@ void ViewProviderPartExt::finishRestoring()
         onChanged(&_diffuseColor);
     }
     Gui::ViewProviderGeometryObject::finishRestoring();
+
+    if (VisualTouched && (isUpdateForced() || Visibility.getValue())) {
+        // When the whole document is restored, the visuals of all objects are
+        // computed in parallel once it is finished. Imported objects, e.g. when
+        // pasting or merging, have no such signal and are computed right away.
+        App::Document* doc = getObject()->getDocument();
+        if (doc->testStatus(App::Document::Restoring)
+            && !doc->testStatus(App::Document::Importing)) {
+            static auto connection = App::GetApplication().signalFinishRestoreDocument.connect(
+                &ViewProviderPartExt::finishRestoreVisuals);
+            (void)connection;
+            auto& vps = pendingVisuals[doc];
+            if (std::find(vps.begin(), vps.end(), this) == vps.end()) {
+                vps.push_back(this);
+            }
+        }
+        else {
+            onChanged(&Visibility);
+        }
+    }
 }
 
 void ViewProviderPartExt::setupContextMenu(QMenu* menu, QObject* receiver, const char* member)
@@ -926,405 +1098,254 @@ void ViewProviderPartExt::unsetEdit(int ModNum)
     }
 }
 
-void ViewProviderPartExt::updateVisual()
+void ViewProviderPartExt::finishRestoreVisuals(const App::Document& doc)
 {
-    Gui::SoUpdateVBOAction action;
-    action.apply(this->faceset);
-
-    // Clear selection
-    Gui::SoSelectionElementAction saction(Gui::SoSelectionElementAction::None);
-    saction.apply(this->faceset);
-    saction.apply(this->lineset);
-    saction.apply(this->nodeset);
-
-    // Clear highlighting
-    Gui::SoHighlightElementAction haction;
-    haction.apply(this->faceset);
-    haction.apply(this->lineset);
-    haction.apply(this->nodeset);
-
-    TopoDS_Shape cShape = Part::Feature::getShape(getObject());
-    if (cShape.IsNull()) {
-        coords  ->point      .setNum(0);
-        norm    ->vector     .setNum(0);
-        faceset ->coordIndex .setNum(0);
-        faceset ->partIndex  .setNum(0);
-        lineset ->coordIndex .setNum(0);
-        nodeset ->startIndex .setValue(0);
-        VisualTouched = false;
+    auto it = pendingVisuals.find(&doc);
+    if (it == pendingVisuals.end()) {
         return;
     }
+    std::vector<ViewProviderPartExt*> viewProviders;
+    viewProviders.swap(it->second);
+    pendingVisuals.erase(it);
+
+    // The shapes are tessellated in parallel, the nodes are set afterwards
+    // in the main thread
+    std::vector<VisualJob> jobs;
+    jobs.reserve(viewProviders.size());
+    for (auto vp : viewProviders) {
+        jobs.push_back({vp,
+                        Part::Feature::getShape(vp->getObject()),
+                        vp->Deviation.getValue(),
+                        Base::toRadians(vp->AngularDeflection.getValue()),
+                        vp->NormalsFromUV});
+        // with levels of detail only the coarsest one is computed here
+        jobs.back().level = vp->LevelsOfDetail.getValue() - 1;
+    }
 
-    // time measurement and book keeping
-    Base::TimeElapsed start_time;
-    int numTriangles=0,numNodes=0,numNorms=0,numFaces=0,numEdges=0,numLines=0;
-    std::set<int> faceEdges;
-
-    try {
-        // calculating the deflection value
-        Bnd_Box bounds;
-        BRepBndLib::Add(cShape, bounds);
-        bounds.SetGap(0.0);
-        Standard_Real xMin, yMin, zMin, xMax, yMax, zMax;
-        bounds.Get(xMin, yMin, zMin, xMax, yMax, zMax);
-        Standard_Real deflection = ((xMax-xMin)+(yMax-yMin)+(zMax-zMin))/300.0 * Deviation.getValue();
-
-        // Since OCCT 7.6 a value of equal 0 is not allowed any more, this can happen if a single vertex
-        // should be displayed.
-        if (deflection < gp::Resolution()) {
-            deflection = Precision::Confusion();
-        }
-
-        // For very big objects the computed deflection can become very high and thus leads to a useless
-        // tessellation. To avoid this the upper limit is set to 20.0
-        // See also forum: https://forum.freecad.org/viewtopic.php?t=77521
-        //deflection = std::min(deflection, 20.0);
-
-        // create or use the mesh on the data structure
-        Standard_Real AngDeflectionRads = Base::toRadians(AngularDeflection.getValue());
-
-        IMeshTools_Parameters meshParams;
-        meshParams.Deflection = deflection;
-        meshParams.Relative = Standard_False;
-        meshParams.Angle = AngDeflectionRads;
-        meshParams.InParallel = Standard_True;
-        meshParams.AllowQualityDecrease = Standard_True;
-
-        BRepMesh_IncrementalMesh(cShape, meshParams);
-
-        // We must reset the location here because the transformation data
-        // are set in the placement property
-        TopLoc_Location aLoc;
-        cShape.Location(aLoc);
-
-        // count triangles and nodes in the mesh
-        TopTools_IndexedMapOfShape faceMap;
-        TopExp::MapShapes(cShape, TopAbs_FACE, faceMap);
-        for (int i=1; i <= faceMap.Extent(); i++) {
-            Handle (Poly_Triangulation) mesh = BRep_Tool::Triangulation(TopoDS::Face(faceMap(i)), aLoc);
-            if (mesh.IsNull()) {
-                mesh = Part::Tools::triangulationOfFace(TopoDS::Face(faceMap(i)));
-            }
-            // Note: we must also count empty faces
-            if (!mesh.IsNull()) {
-                numTriangles += mesh->NbTriangles();
-                numNodes     += mesh->NbNodes();
-                numNorms     += mesh->NbNodes();
-            }
+    for (auto& batch : splitIntoBatches(jobs)) {
+        QtConcurrent::blockingMap(batch, [](VisualJob* job) {
+            job->run();
+        });
+    }
 
-            TopExp_Explorer xp;
-            for (xp.Init(faceMap(i),TopAbs_EDGE);xp.More();xp.Next()) {
-                faceEdges.insert(Part::ShapeMapHasher{}(xp.Current()));
-            }
-            numFaces++;
+    for (auto& job : jobs) {
+        auto vp = job.viewProvider;
+        if (job.failed) {
+            job.report();
         }
-
-        // get an indexed map of edges
-        TopTools_IndexedMapOfShape edgeMap;
-        TopExp::MapShapes(cShape, TopAbs_EDGE, edgeMap);
-
-         // key is the edge number, value the coord indexes. This is needed to keep the same order as the edges.
-        std::map<int, std::vector<int32_t> > lineSetMap;
-        std::set<int>          edgeIdxSet;
-        std::vector<int32_t>   edgeVector;
-
-        // count and index the edges
-        for (int i=1; i <= edgeMap.Extent(); i++) {
-            edgeIdxSet.insert(i);
-            numEdges++;
-
-            const TopoDS_Edge& aEdge = TopoDS::Edge(edgeMap(i));
-            TopLoc_Location aLoc;
-
-            // handling of the free edge that are not associated to a face
-            // Note: The assumption that if for an edge BRep_Tool::Polygon3D
-            // returns a valid object is wrong. This e.g. happens for ruled
-            // surfaces which gets created by two edges or wires.
-            // So, we have to store the hashes of the edges associated to a face.
-            // If the hash of a given edge is not in this list we know it's really
-            // a free edge.
-            int hash = Part::ShapeMapHasher{}(aEdge);
-            if (faceEdges.find(hash) == faceEdges.end()) {
-                Handle(Poly_Polygon3D) aPoly = Part::Tools::polygonOfEdge(aEdge, aLoc);
-                if (!aPoly.IsNull()) {
-                    int nbNodesInEdge = aPoly->NbNodes();
-                    numNodes += nbNodesInEdge;
-                }
+        else {
+            vp->setVisual(job.tessellation);
+            if (job.level > 0) {
+                vp->scheduleRefinement();
             }
         }
+        vp->VisualTouched = false;
+        vp->setHighlightedFaces(vp->ShapeAppearance.getValues());
+        vp->setHighlightedEdges(vp->LineColorArray.getValues());
+        vp->setHighlightedPoints(vp->PointColorArray.getValue());
+
+        // Same as for a change of the visibility, see onChanged()
+        Base::ObjectStatusLocker<App::Property::Status,App::Property> guard(
+                App::Property::NoModify, &vp->ShapeAppearance);
+        vp->onChanged(&vp->ShapeAppearance);
+        vp->onChanged(&vp->ShowPlacement);
+    }
+}
 
-        // handling of the vertices
-        TopTools_IndexedMapOfShape vertexMap;
-        TopExp::MapShapes(cShape, TopAbs_VERTEX, vertexMap);
-        numNodes += vertexMap.Extent();
-
-        // create memory for the nodes and indexes
-        coords  ->point      .setNum(numNodes);
-        norm    ->vector     .setNum(numNorms);
-        faceset ->coordIndex .setNum(numTriangles*4);
-        faceset ->partIndex  .setNum(numFaces);
-        // get the raw memory for fast fill up
-        SbVec3f* verts = coords  ->point       .startEditing();
-        SbVec3f* norms = norm    ->vector      .startEditing();
-        int32_t* index = faceset ->coordIndex  .startEditing();
-        int32_t* parts = faceset ->partIndex   .startEditing();
-
-        // preset the normal vector with null vector
-        for (int i=0;i < numNorms;i++)
-            norms[i]= SbVec3f(0.0,0.0,0.0);
-
-        int ii = 0,faceNodeOffset=0,faceTriaOffset=0;
-        for (int i=1; i <= faceMap.Extent(); i++, ii++) {
-            TopLoc_Location aLoc;
-            const TopoDS_Face &actFace = TopoDS::Face(faceMap(i));
-            // get the mesh of the shape
-            Handle (Poly_Triangulation) mesh = BRep_Tool::Triangulation(actFace,aLoc);
-            if (mesh.IsNull()) {
-                mesh = Part::Tools::triangulationOfFace(actFace);
-            }
-            if (mesh.IsNull()) {
-                parts[ii] = 0;
-                continue;
-            }
+void ViewProviderPartExt::updateVisual()
+{
+    removePendingVisual(this);
 
-            // getting the transformation of the shape/face
-            gp_Trsf myTransf;
-            Standard_Boolean identity = true;
-            if (!aLoc.IsIdentity()) {
-                identity = false;
-                myTransf = aLoc.Transformation();
-            }
+    // time measurement
+    Base::TimeElapsed start_time;
 
-            // getting size of node and triangle array of this face
-            int nbNodesInFace = mesh->NbNodes();
-            int nbTriInFace   = mesh->NbTriangles();
-            // check orientation
-            TopAbs_Orientation orient = actFace.Orientation();
-
-
-            // cycling through the poly mesh
-#if OCC_VERSION_HEX < 0x070600
-            const Poly_Array1OfTriangle& Triangles = mesh->Triangles();
-            const TColgp_Array1OfPnt& Nodes = mesh->Nodes();
-            TColgp_Array1OfDir Normals (Nodes.Lower(), Nodes.Upper());
-#else
-            int numNodes =  mesh->NbNodes();
-            TColgp_Array1OfDir Normals (1, numNodes);
-#endif
-            if (NormalsFromUV)
-                Part::Tools::getPointNormals(actFace, mesh, Normals);
-
-            for (int g=1;g<=nbTriInFace;g++) {
-                // Get the triangle
-                Standard_Integer N1,N2,N3;
-#if OCC_VERSION_HEX < 0x070600
-                Triangles(g).Get(N1,N2,N3);
-#else
-                mesh->Triangle(g).Get(N1,N2,N3);
-#endif
+    VisualJob job {this,
+                   Part::Feature::getShape(getObject()),
+                   Deviation.getValue(),
+                   Base::toRadians(AngularDeflection.getValue()),
+                   NormalsFromUV};
+    if (job.shape.IsNull()) {
+        setVisual(job.tessellation);
+        VisualTouched = false;
+        return;
+    }
 
-                // change orientation of the triangle if the face is reversed
-                if ( orient != TopAbs_FORWARD ) {
-                    Standard_Integer tmp = N1;
-                    N1 = N2;
-                    N2 = tmp;
-                }
+    // With levels of detail the coarsest one is shown first and the finer
+    // ones are computed afterwards
+    job.level = LevelsOfDetail.getValue() - 1;
+    job.run();
+    if (job.failed) {
+        job.report();
+    }
+    else {
+        setVisual(job.tessellation);
+        if (job.level > 0) {
+            scheduleRefinement();
+        }
+    }
 
-                // get the 3 points of this triangle
-#if OCC_VERSION_HEX < 0x070600
-                gp_Pnt V1(Nodes(N1)), V2(Nodes(N2)), V3(Nodes(N3));
-#else
-                gp_Pnt V1(mesh->Node(N1)), V2(mesh->Node(N2)), V3(mesh->Node(N3));
-#endif
+#   ifdef FC_DEBUG
+        // printing some information
+        const Part::ShapeTessellation& tess = job.tessellation;
+        Base::Console().Log("ViewProvider update time: %f s\n",Base::TimeElapsed::diffTimeF(start_time,Base::TimeElapsed()));
+        Base::Console().Log("Shape tria info: Faces:%d Edges:%d Nodes:%d Triangles:%d IdxVec:%d\n",
+                            int(tess.parts.size()),tess.numEdges,int(tess.points.size()),
+                            int(tess.triangles.size() / 4),int(tess.lines.size()));
+#   endif
+    VisualTouched = false;
 
-                // get the 3 normals of this triangle
-                gp_Vec NV1, NV2, NV3;
-                if (NormalsFromUV) {
-                    NV1.SetXYZ(Normals(N1).XYZ());
-                    NV2.SetXYZ(Normals(N2).XYZ());
-                    NV3.SetXYZ(Normals(N3).XYZ());
-                }
-                else {
-                    gp_Vec v1(V1.X(),V1.Y(),V1.Z()),
-                           v2(V2.X(),V2.Y(),V2.Z()),
-                           v3(V3.X(),V3.Y(),V3.Z());
-                    gp_Vec normal = (v2-v1)^(v3-v1);
-                    NV1 = normal;
-                    NV2 = normal;
-                    NV3 = normal;
-                }
+    // The material has to be checked again
+    setHighlightedFaces(ShapeAppearance.getValues());
+    setHighlightedEdges(LineColorArray.getValues());
+    setHighlightedPoints(PointColorArray.getValue());
+}
 
-                // transform the vertices and normals to the place of the face
-                if (!identity) {
-                    V1.Transform(myTransf);
-                    V2.Transform(myTransf);
-                    V3.Transform(myTransf);
-                    if (NormalsFromUV) {
-                        NV1.Transform(myTransf);
-                        NV2.Transform(myTransf);
-                        NV3.Transform(myTransf);
-                    }
-                }
+void ViewProviderPartExt::setVisual(const Part::ShapeTessellation& tess)
+{
+    Gui::SoUpdateVBOAction action;
+    action.apply(this->faceset);
 
-                // add the normals for all points of this triangle
-                norms[faceNodeOffset+N1-1] += SbVec3f(NV1.X(),NV1.Y(),NV1.Z());
-                norms[faceNodeOffset+N2-1] += SbVec3f(NV2.X(),NV2.Y(),NV2.Z());
-                norms[faceNodeOffset+N3-1] += SbVec3f(NV3.X(),NV3.Y(),NV3.Z());
-
-                // set the vertices
-                verts[faceNodeOffset+N1-1].setValue((float)(V1.X()),(float)(V1.Y()),(float)(V1.Z()));
-                verts[faceNodeOffset+N2-1].setValue((float)(V2.X()),(float)(V2.Y()),(float)(V2.Z()));
-                verts[faceNodeOffset+N3-1].setValue((float)(V3.X()),(float)(V3.Y()),(float)(V3.Z()));
-
-                // set the index vector with the 3 point indexes and the end delimiter
-                index[faceTriaOffset*4+4*(g-1)]   = faceNodeOffset+N1-1;
-                index[faceTriaOffset*4+4*(g-1)+1] = faceNodeOffset+N2-1;
-                index[faceTriaOffset*4+4*(g-1)+2] = faceNodeOffset+N3-1;
-                index[faceTriaOffset*4+4*(g-1)+3] = SO_END_FACE_INDEX;
-            }
+    // Clear selection
+    Gui::SoSelectionElementAction saction(Gui::SoSelectionElementAction::None);
+    saction.apply(this->faceset);
+    saction.apply(this->lineset);
+    saction.apply(this->nodeset);
 
-            parts[ii] = nbTriInFace; // new part
-
-            // handling the edges lying on this face
-            TopExp_Explorer Exp;
-            for(Exp.Init(actFace,TopAbs_EDGE);Exp.More();Exp.Next()) {
-                const TopoDS_Edge &curEdge = TopoDS::Edge(Exp.Current());
-                // get the overall index of this edge
-                int edgeIndex = edgeMap.FindIndex(curEdge);
-                edgeVector.push_back((int32_t)edgeIndex-1);
-                // already processed this index ?
-                if (edgeIdxSet.find(edgeIndex)!=edgeIdxSet.end()) {
-
-                    // this holds the indices of the edge's triangulation to the current polygon
-                    Handle(Poly_PolygonOnTriangulation) aPoly = BRep_Tool::PolygonOnTriangulation(curEdge, mesh, aLoc);
-                    if (aPoly.IsNull())
-                        continue; // polygon does not exist
-
-                    // getting the indexes of the edge polygon
-                    const TColStd_Array1OfInteger& indices = aPoly->Nodes();
-                    for (Standard_Integer i=indices.Lower();i <= indices.Upper();i++) {
-                        int nodeIndex = indices(i);
-                        int index = faceNodeOffset+nodeIndex-1;
-                        lineSetMap[edgeIndex].push_back(index);
-
-                        // usually the coordinates for this edge are already set by the
-                        // triangles of the face this edge belongs to. However, there are
-                        // rare cases where some points are only referenced by the polygon
-                        // but not by any triangle. Thus, we must apply the coordinates to
-                        // make sure that everything is properly set.
-#if OCC_VERSION_HEX < 0x070600
-                        gp_Pnt p(Nodes(nodeIndex));
-#else
-                        gp_Pnt p(mesh->Node(nodeIndex));
-#endif
-                        if (!identity)
-                            p.Transform(myTransf);
-                        verts[index].setValue((float)(p.X()),(float)(p.Y()),(float)(p.Z()));
-                    }
+    // Clear highlighting
+    Gui::SoHighlightElementAction haction;
+    haction.apply(this->faceset);
+    haction.apply(this->lineset);
+    haction.apply(this->nodeset);
 
-                    // remove the handled edge index from the set
-                    edgeIdxSet.erase(edgeIndex);
-                }
-            }
+    setFaceNodes(coords, norm, faceset, tess);
 
-            edgeVector.push_back(-1);
+    lineset ->coordIndex .setNum(static_cast<int>(tess.lines.size()));
+    int32_t* lines = lineset ->coordIndex  .startEditing();
+    std::copy(tess.lines.begin(), tess.lines.end(), lines);
+    lineset ->coordIndex  .finishEditing();
 
-            // counting up the per Face offsets
-            faceNodeOffset += nbNodesInFace;
-            faceTriaOffset += nbTriInFace;
-        }
+    nodeset->startIndex.setValue(tess.vertexStart);
 
-        // handling of the free edges
-        for (int i=1; i <= edgeMap.Extent(); i++) {
-            const TopoDS_Edge& aEdge = TopoDS::Edge(edgeMap(i));
-            Standard_Boolean identity = true;
-            gp_Trsf myTransf;
-            TopLoc_Location aLoc;
-
-            // handling of the free edge that are not associated to a face
-            int hash = Part::ShapeMapHasher{}(aEdge);
-            if (faceEdges.find(hash) == faceEdges.end()) {
-                Handle(Poly_Polygon3D) aPoly = Part::Tools::polygonOfEdge(aEdge, aLoc);
-                if (!aPoly.IsNull()) {
-                    if (!aLoc.IsIdentity()) {
-                        identity = false;
-                        myTransf = aLoc.Transformation();
-                    }
-
-                    const TColgp_Array1OfPnt& aNodes = aPoly->Nodes();
-                    int nbNodesInEdge = aPoly->NbNodes();
-
-                    gp_Pnt pnt;
-                    for (Standard_Integer j=1;j <= nbNodesInEdge;j++) {
-                        pnt = aNodes(j);
-                        if (!identity)
-                            pnt.Transform(myTransf);
-                        int index = faceNodeOffset+j-1;
-                        verts[index].setValue((float)(pnt.X()),(float)(pnt.Y()),(float)(pnt.Z()));
-                        lineSetMap[i].push_back(index);
-                    }
-
-                    faceNodeOffset += nbNodesInEdge;
-                }
-            }
-        }
+    // the coarser levels of detail are set by refineVisual()
+    setCoarseVisuals({});
+}
 
-        nodeset->startIndex.setValue(faceNodeOffset);
-        for (int i=0; i<vertexMap.Extent(); i++) {
-            const TopoDS_Vertex& aVertex = TopoDS::Vertex(vertexMap(i+1));
-            gp_Pnt pnt = BRep_Tool::Pnt(aVertex);
-            verts[faceNodeOffset+i].setValue((float)(pnt.X()),(float)(pnt.Y()),(float)(pnt.Z()));
-        }
+void ViewProviderPartExt::setCoarseVisuals(
+    const std::vector<const Part::ShapeTessellation*>& levels)
+{
+    // the first child holds the nodes of the full resolution
+    int numChildren = static_cast<int>(levels.size()) + 1;
+    while (pcFaceLOD->getNumChildren() > numChildren) {
+        pcFaceLOD->removeChild(pcFaceLOD->getNumChildren() - 1);
+    }
+    while (pcFaceLOD->getNumChildren() < numChildren) {
+        auto* level = new SoSeparator();
+        level->renderCaching = SoSeparator::OFF;
+        level->boundingBoxCaching = SoSeparator::OFF;
+        level->addChild(new SoCoordinate3());
+        level->addChild(new SoNormal());
+        auto* levelFaceSet = new SoBrepFaceSet();
+        // the selection and highlighting are applied to the full resolution only
+        levelFaceSet->setSelectionSource(faceset);
+        level->addChild(levelFaceSet);
+        pcFaceLOD->addChild(level);
+    }
 
-        // normalize all normals
-        for (int i = 0; i< numNorms ;i++)
-            norms[i].normalize();
+    pcFaceLOD->screenArea.setNum(static_cast<int>(levels.size()));
+    float area = FullDetailScreenArea;
+    Gui::SoUpdateVBOAction action;
+    for (std::size_t i = 0; i < levels.size(); i++) {
+        auto level = static_cast<SoSeparator*>(pcFaceLOD->getChild(static_cast<int>(i) + 1));
+        action.apply(level->getChild(2));
+        setFaceNodes(static_cast<SoCoordinate3*>(level->getChild(0)),
+                     static_cast<SoNormal*>(level->getChild(1)),
+                     static_cast<SoBrepFaceSet*>(level->getChild(2)),
+                     *levels[i]);
+        pcFaceLOD->screenArea.set1Value(static_cast<int>(i), area);
+        area /= 16.0F;
+    }
+}
 
-        std::vector<int32_t> lineSetCoords;
-        for (const auto & it : lineSetMap) {
-            lineSetCoords.insert(lineSetCoords.end(), it.second.begin(), it.second.end());
-            lineSetCoords.push_back(-1);
+void ViewProviderPartExt::scheduleRefinement()
+{
+    if (std::find(pendingRefinements.begin(), pendingRefinements.end(), this)
+        == pendingRefinements.end()) {
+        pendingRefinements.push_back(this);
+        if (pendingRefinements.size() == 1) {
+            QTimer::singleShot(0, &ViewProviderPartExt::refinePendingVisuals);
         }
-
-        // preset the index vector size
-        numLines =  lineSetCoords.size();
-        lineset ->coordIndex .setNum(numLines);
-        int32_t* lines = lineset ->coordIndex  .startEditing();
-
-        int l=0;
-        for (std::vector<int32_t>::const_iterator it=lineSetCoords.begin();it!=lineSetCoords.end();++it,l++)
-            lines[l] = *it;
-
-        // end the editing of the nodes
-        coords  ->point       .finishEditing();
-        norm    ->vector      .finishEditing();
-        faceset ->coordIndex  .finishEditing();
-        faceset ->partIndex   .finishEditing();
-        lineset ->coordIndex  .finishEditing();
     }
-    catch (const Standard_Failure& e) {
-        FC_ERR("Cannot compute Inventor representation for the shape of "
-               << pcObject->getFullName() << ": " << e.GetMessageString());
+}
+
+void ViewProviderPartExt::refinePendingVisuals()
+{
+    // One view provider at a time, so that the view stays responsive
+    if (pendingRefinements.empty()) {
+        return;
     }
-    catch (...) {
-        FC_ERR("Cannot compute Inventor representation for the shape of " << pcObject->getFullName());
+    ViewProviderPartExt* vp = pendingRefinements.front();
+    if (pendingRefinements.size() > 1) {
+        QTimer::singleShot(0, &ViewProviderPartExt::refinePendingVisuals);
     }
+    vp->refineVisual();
+}
 
-#   ifdef FC_DEBUG
-        // printing some information
-        Base::Console().Log("ViewProvider update time: %f s\n",Base::TimeElapsed::diffTimeF(start_time,Base::TimeElapsed()));
-        Base::Console().Log("Shape tria info: Faces:%d Edges:%d Nodes:%d Triangles:%d IdxVec:%d\n",numFaces,numEdges,numNodes,numTriangles,numLines);
-#   else
-    (void)numEdges;
-#   endif
-    VisualTouched = false;
+void ViewProviderPartExt::refineVisual()
+{
+    removePendingVisual(this);
+
+    // The full resolution meshes the shape itself. The coarser levels mesh
+    // copies of it and are computed in parallel once the shape is not
+    // modified any more.
+    TopoDS_Shape shape = Part::Feature::getShape(getObject());
+    std::vector<VisualJob> jobs;
+    for (int level = 0; level < LevelsOfDetail.getValue(); level++) {
+        jobs.push_back({this,
+                        shape,
+                        Deviation.getValue(),
+                        Base::toRadians(AngularDeflection.getValue()),
+                        NormalsFromUV});
+        jobs.back().level = level;
+    }
+    jobs.front().run();
+    QtConcurrent::blockingMap(jobs.begin() + 1, jobs.end(), [](VisualJob& job) {
+        job.run();
+    });
+
+    std::vector<const Part::ShapeTessellation*> levels;
+    for (const auto& job : jobs) {
+        if (job.failed) {
+            job.report();
+            return;
+        }
+        if (job.level > 0) {
+            levels.push_back(&job.tessellation);
+        }
+    }
 
-    // The material has to be checked again
+    setVisual(jobs.front().tessellation);
+    setCoarseVisuals(levels);
     setHighlightedFaces(ShapeAppearance.getValues());
     setHighlightedEdges(LineColorArray.getValues());
     setHighlightedPoints(PointColorArray.getValue());
 }
 
+std::vector<int> ViewProviderPartExt::getTriangleCounts()
+{
+    if (std::find(pendingRefinements.begin(), pendingRefinements.end(), this)
+        != pendingRefinements.end()) {
+        refineVisual();
+    }
+
+    std::vector<int> counts;
+    counts.push_back(faceset->coordIndex.getNum() / 4);
+    for (int i = 1; i < pcFaceLOD->getNumChildren(); i++) {
+        auto level = static_cast<SoSeparator*>(pcFaceLOD->getChild(i));
+        counts.push_back(static_cast<SoBrepFaceSet*>(level->getChild(2))->coordIndex.getNum() / 4);
+    }
+    return counts;
+}
+
 void ViewProviderPartExt::forceUpdate(bool enable) {
     if(enable) {
         if(++forceUpdateCount == 1) {
@@ -53,6 +53,11 @@ class SoNormal;
 class SoNormalBinding;
 class SoMaterialBinding;
 class SoIndexedLineSet;
+class SoLevelOfDetail;
+
+namespace Part {
+class ShapeTessellation;
+}
 
 namespace PartGui {
 
@@ -74,6 +79,7 @@ public:
     App::PropertyFloatConstraint Deviation;
     App::PropertyBool ControlPoints;
     App::PropertyAngle AngularDeflection;
+    App::PropertyIntegerConstraint LevelsOfDetail;
     App::PropertyEnumeration Lighting;
     App::PropertyEnumeration DrawStyle;
     /// Property controlling visibility of the placement indicator, useful for displaying origin
@@ -147,6 +153,9 @@ public:
     }
     void forceUpdate(bool enable = true) override;
 
+    /// The number of triangles of the faces per level of detail, beginning with the finest one
+    std::vector<int> getTriangleCounts();
+
     bool allowOverride(const App::DocumentObject &) const override;
 
     /** @name Edit methods */
@@ -166,6 +175,10 @@ protected:
     void onChanged(const App::Property* prop) override;
     bool loadParameter();
     void updateVisual();
+    /// Replace the data of the nodes by the tessellation
+    void setVisual(const Part::ShapeTessellation& tess);
+    /// Replace the faces of the coarser levels of detail
+    void setCoarseVisuals(const std::vector<const Part::ShapeTessellation*>& levels);
     void handleChangedPropertyName(Base::XMLReader& reader,
                                    const char* TypeName,
                                    const char* PropName) override;
@@ -186,10 +199,19 @@ protected:
     SoNormalBinding   * normb;
     SoBrepEdgeSet     * lineset;
     SoBrepPointSet    * nodeset;
+    SoLevelOfDetail   * pcFaceLOD;
 
     bool VisualTouched;
     bool NormalsFromUV;
 
+private:
+    /// Compute the visuals deferred during the restore of \a doc in parallel
+    static void finishRestoreVisuals(const App::Document& doc);
+    /// Compute all levels of detail after the coarsest one has been shown
+    void scheduleRefinement();
+    void refineVisual();
+    static void refinePendingVisuals();
+
 private:
     Gui::ViewProviderFaceTexture texture;
     // settings stuff
@@ -197,6 +219,7 @@ private:
     static App::PropertyFloatConstraint::Constraints sizeRange;
     static App::PropertyFloatConstraint::Constraints tessRange;
     static App::PropertyQuantityConstraint::Constraints angDeflectionRange;
+    static App::PropertyIntegerConstraint::Constraints lodRange;
     static const char* LightingEnums[];
     static const char* DrawStyleEnums[];
 
@@ -1,5 +1,6 @@
 from Base.Metadata import export
 from Gui.ViewProviderGeometryObject import ViewProviderGeometryObject
+from typing import List
 
 
 @export(
@@ -13,5 +14,13 @@ class ViewProviderPartExt(ViewProviderGeometryObject):
     Author: David Carter (dcarter@davidcarter.ca)
     Licence: LGPL
     """
-    ...
+
+    def getTriangleCounts(self) -> List[int]:
+        """
+        getTriangleCounts() -> list
+
+        Returns the number of triangles of the faces for each level of detail,
+        beginning with the full resolution. See the LevelsOfDetail property.
+        """
+        ...
     
\ No newline at end of file
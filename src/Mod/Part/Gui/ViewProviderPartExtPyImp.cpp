@@ -64,6 +64,19 @@ PyObject* ViewProviderPartExtPy::getCustomAttributes(const char* attr) const
     return nullptr;
 }
 
+PyObject* ViewProviderPartExtPy::getTriangleCounts(PyObject* args)
+{
+    if (!PyArg_ParseTuple(args, "")) {
+        return nullptr;
+    }
+
+    Py::List list;
+    for (int count : getViewProviderPartExtPtr()->getTriangleCounts()) {
+        list.append(Py::Long(count));
+    }
+    return Py::new_reference_to(list);
+}
+
 int ViewProviderPartExtPy::setCustomAttributes(const char* attr, PyObject* obj)
 {
     ViewProviderPartExt* vp = getViewProviderPartExtPtr();
@@ -76,6 +76,17 @@ class PartGuiViewProviderTestCases(unittest.TestCase):
         with self.assertRaises(TypeError):
             box.ViewObject.dropObject(box, 0)
 
+    def testCopiedObjectHasVisual(self):
+        # Imported objects are restored, but not as part of a document restore
+        box = self.Doc.addObject("Part::Box", "Box")
+        self.Doc.recompute()
+        other = FreeCAD.newDocument("PartGuiTestCopy")
+        try:
+            copy = other.copyObject(box)
+            self.assertGreater(copy.ViewObject.getTriangleCounts()[0], 0)
+        finally:
+            FreeCAD.closeDocument(other.Name)
+
     def tearDown(self):
         #closing doc
         FreeCAD.closeDocument("PartGuiTest")
@@ -24,6 +24,7 @@
 #include "PreCompiled.h"
 #ifndef _PreComp_
 # include <limits>
+# include <optional>
 # include <BRepAlgo.hxx>
 # include <BRepFilletAPI_MakeFillet.hxx>
 # include <TopoDS.hxx>
@@ -35,6 +36,7 @@
 
 #include <Base/Exception.h>
 #include <Base/Reader.h>
+#include <Mod/Part/App/RecomputeCache.h>
 #include <Mod/Part/App/TopoShape.h>
 
 #include "FeatureFillet.h"
@@ -95,22 +97,32 @@ App::DocumentObjectExecReturn *Fillet::execute()
     this->positionByBaseFeature();
 
     try {
+        std::optional<Part::RecomputeCache::Key> cacheKey;
         TopoShape shape(0);  //,getDocument()->getStringHasher());
-        shape.makeElementFillet(baseShape, edges, Radius.getValue(), Radius.getValue());
-        if (shape.isNull()) {
-            return new App::DocumentObjectExecReturn(
-                QT_TRANSLATE_NOOP("Exception", "Resulting shape is null"));
+        if (Part::RecomputeCache::isEnabled()) {
+            cacheKey.emplace(this);
+            cacheKey->addShape(baseShape);
         }
-
-        TopTools_ListOfShape aLarg;
-        aLarg.Append(baseShape.getShape());
         bool failed = false;
-        if (!BRepAlgo::IsValid(aLarg, shape.getShape(), Standard_False, Standard_False)) {
-            ShapeFix_ShapeTolerance aSFT;
-            aSFT.LimitTolerance(shape.getShape(),
-                                Precision::Confusion(),
-                                Precision::Confusion(),
-                                TopAbs_SHAPE);
+        if (!cacheKey || !Part::RecomputeCache::find(*cacheKey, shape)) {
+            shape.makeElementFillet(baseShape, edges, Radius.getValue(), Radius.getValue());
+            if (shape.isNull()) {
+                return new App::DocumentObjectExecReturn(
+                    QT_TRANSLATE_NOOP("Exception", "Resulting shape is null"));
+            }
+
+            TopTools_ListOfShape aLarg;
+            aLarg.Append(baseShape.getShape());
+            if (!BRepAlgo::IsValid(aLarg, shape.getShape(), Standard_False, Standard_False)) {
+                ShapeFix_ShapeTolerance aSFT;
+                aSFT.LimitTolerance(shape.getShape(),
+                                    Precision::Confusion(),
+                                    Precision::Confusion(),
+                                    TopAbs_SHAPE);
+            }
+            if (cacheKey) {
+                Part::RecomputeCache::insert(std::move(*cacheKey), shape);
+            }
         }
 
         if (!failed) {
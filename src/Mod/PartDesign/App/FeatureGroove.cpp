@@ -80,6 +80,13 @@ short Groove::mustExecute() const
 }
 
 App::DocumentObjectExecReturn *Groove::execute()
+{
+    return executeCached([this]() {
+        return buildGroove();
+    });
+}
+
+App::DocumentObjectExecReturn *Groove::buildGroove()
 {
     if (onlyHaveRefined()) { return App::DocumentObject::StdReturn; }
 
@@ -78,6 +78,9 @@ public:
     };
 
 protected:
+    /// computes the result of execute() without the recompute cache
+    App::DocumentObjectExecReturn* buildGroove();
+
     /// updates Axis from ReferenceAxis
     void updateAxis();
 
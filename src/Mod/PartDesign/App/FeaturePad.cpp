@@ -71,5 +71,7 @@ Pad::Pad()
 
 App::DocumentObjectExecReturn* Pad::execute()
 {
-    return buildExtrusion(ExtrudeOption::MakeFace | ExtrudeOption::MakeFuse);
+    return executeCached([this]() {
+        return buildExtrusion(ExtrudeOption::MakeFace | ExtrudeOption::MakeFuse);
+    });
 }
@@ -76,7 +76,9 @@ App::DocumentObjectExecReturn *Pocket::execute()
     // backward compatibility to upstream
     ExtrudeOptions options(ExtrudeOption::MakeFace | ExtrudeOption::MakeFuse
                            | ExtrudeOption::InverseDirection);
-    return buildExtrusion(options);
+    return executeCached([this, options]() {
+        return buildExtrusion(options);
+    });
 }
 
 Base::Vector3d Pocket::getProfileNormal() const
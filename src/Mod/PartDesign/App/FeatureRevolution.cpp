@@ -79,6 +79,13 @@ short Revolution::mustExecute() const
 }
 
 App::DocumentObjectExecReturn* Revolution::execute()
+{
+    return executeCached([this]() {
+        return buildRevolution();
+    });
+}
+
+App::DocumentObjectExecReturn* Revolution::buildRevolution()
 {
     if (onlyHaveRefined()) { return App::DocumentObject::StdReturn; }
 
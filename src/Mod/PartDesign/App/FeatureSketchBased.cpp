@@ -22,6 +22,8 @@
 
 #include "PreCompiled.h"
 #ifndef _PreComp_
+# include <limits>
+# include <sstream>
 # include <Bnd_Box.hxx>
 # include <BRep_Builder.hxx>
 # include <BRep_Tool.hxx>
@@ -56,6 +58,7 @@
 #include <App/Datums.h>
 #include <Base/Reader.h>
 #include <Mod/Part/App/FaceMakerCheese.h>
+#include <Mod/Part/App/RecomputeCache.h>
 
 #include "FeatureSketchBased.h"
 #include "DatumLine.h"
@@ -649,6 +652,49 @@ void ProfileBased::onChanged(const App::Property* prop)
     FeatureAddSub::onChanged(prop);
 }
 
+App::DocumentObjectExecReturn*
+ProfileBased::executeCached(const std::function<App::DocumentObjectExecReturn*()>& build)
+{
+    if (!Part::RecomputeCache::isEnabled()) {
+        return build();
+    }
+
+    Part::RecomputeCache::Key key(this);
+    for (auto obj : getOutList()) {
+        if (auto feature = freecad_cast<Part::Feature*>(obj)) {
+            key.addShape(feature->Shape.getShape());
+        }
+        else if (auto geoFeature = freecad_cast<App::GeoFeature*>(obj)) {
+            // e.g. the axes and planes of the origin
+            const Base::Placement& plm = geoFeature->Placement.getValue();
+            const Base::Vector3d& pos = plm.getPosition();
+            double q0 {}, q1 {}, q2 {}, q3 {};
+            plm.getRotation().getValue(q0, q1, q2, q3);
+            std::ostringstream str;
+            str.precision(std::numeric_limits<double>::digits10 + 2);
+            str << obj->getFullName() << ':' << pos.x << ',' << pos.y << ',' << pos.z << ','
+                << q0 << ',' << q1 << ',' << q2 << ',' << q3;
+            key.addValue(str.str());
+        }
+    }
+
+    std::vector<TopoShape> results;
+    if (Part::RecomputeCache::find(key, results) && results.size() == 3) {
+        positionByPrevious();
+        rawShape = results[2];
+        AddSubShape.setValue(results[1]);
+        Shape.setValue(results[0]);
+        return App::DocumentObject::StdReturn;
+    }
+
+    App::DocumentObjectExecReturn* ret = build();
+    if (ret == App::DocumentObject::StdReturn) {
+        Part::RecomputeCache::insert(std::move(key),
+                                     {Shape.getShape(), AddSubShape.getShape(), rawShape});
+    }
+    return ret;
+}
+
 void ProfileBased::getUpToFaceFromLinkSub(TopoShape& upToFace, const App::PropertyLinkSub& refFace)
 {
     App::DocumentObject* ref = refFace.getValue();
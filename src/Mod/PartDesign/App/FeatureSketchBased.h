@@ -24,6 +24,8 @@
 #ifndef PARTDESIGN_SketchBased_H
 #define PARTDESIGN_SketchBased_H
 
+#include <functional>
+
 #include <Mod/Part/App/Part2DObject.h>
 #include "FeatureAddSub.h"
 
@@ -198,6 +200,15 @@ protected:
                  Base::Vector3d& base, Base::Vector3d& dir, ForbiddenAxis checkAxis) const;
 
     void onChanged(const App::Property* prop) override;
+
+    /** Run \a build, or take its result from the recompute cache if the inputs are unchanged
+     * The key consists of the parameters of this feature and the shapes and placements of
+     * the objects it links to, e.g. the profile, the base feature and the faces to extrude
+     * up to, see Part::RecomputeCache. Shape, AddSubShape and the unrefined shape are cached.
+     */
+    App::DocumentObjectExecReturn*
+    executeCached(const std::function<App::DocumentObjectExecReturn*()>& build);
+
 private:
     bool isParallelPlane(const TopoDS_Shape&, const TopoDS_Shape&) const;
     bool isEqualGeometry(const TopoDS_Shape&, const TopoDS_Shape&) const;
@@ -133,6 +133,17 @@ void PropertyPointKernel::RestoreDocFile(Base::Reader& reader)
     hasSetValue();
 }
 
+std::function<void()> PropertyPointKernel::RestoreDocFileInThread(Base::Reader& reader)
+{
+    auto points = std::make_shared<PointKernel>();
+    points->RestoreDocFile(reader);
+    return [this, points]() {
+        aboutToSetValue();
+        _cPoints->swap(points->getBasicPoints());
+        hasSetValue();
+    };
+}
+
 App::Property* PropertyPointKernel::Copy() const
 {
     PropertyPointKernel* prop = new PropertyPointKernel();
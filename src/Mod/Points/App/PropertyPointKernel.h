@@ -75,7 +75,16 @@ public:
     void Save(Base::Writer& writer) const override;
     void Restore(Base::XMLReader& reader) override;
     void SaveDocFile(Base::Writer& writer) const override;
+    bool canSaveDocFileInThread(const Base::Writer& /*writer*/) const override
+    {
+        return true;
+    }
     void RestoreDocFile(Base::Reader& reader) override;
+    bool canRestoreDocFileInThread() const override
+    {
+        return true;
+    }
+    std::function<void()> RestoreDocFileInThread(Base::Reader& reader) override;
     //@}
 
     /** @name Modification */
@@ -294,6 +294,37 @@ bool PropertyConstraintList::getPyPathValue(const App::ObjectIdentifier& path,
     return true;
 }
 
+bool PropertyConstraintList::getNumericPathValue(const App::ObjectIdentifier& path,
+                                                 int numSubComponents,
+                                                 boost::any& value) const
+{
+    // Same lookup as getPyPathValue()
+    if (numSubComponents != 2 || path.getPropertyComponent(0).getName() != getName()) {
+        return false;
+    }
+
+    const ObjectIdentifier::Component& c1 = path.getPropertyComponent(1);
+
+    const Constraint* cstr = nullptr;
+
+    if (c1.isArray()) {
+        cstr = _lValueList[c1.getIndex(_lValueList.size())];
+    }
+    else if (c1.isSimple()) {
+        for (auto c : _lValueList) {
+            if (c->Name == c1.getName()) {
+                cstr = c;
+                break;
+            }
+        }
+    }
+    if (!cstr) {
+        return false;
+    }
+    value = cstr->getPresentationValue();
+    return true;
+}
+
 void PropertyConstraintList::setPyObject(PyObject* value)
 {
     if (PyList_Check(value)) {
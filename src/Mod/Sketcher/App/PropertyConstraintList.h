@@ -147,6 +147,9 @@ public:
     void getPaths(std::vector<App::ObjectIdentifier>& paths) const override;
 
     bool getPyPathValue(const App::ObjectIdentifier& path, Py::Object& res) const override;
+    bool getNumericPathValue(const App::ObjectIdentifier& path,
+                             int numSubComponents,
+                             boost::any& value) const override;
 
     using ConstraintInfo = std::pair<int, const Constraint*>;
 
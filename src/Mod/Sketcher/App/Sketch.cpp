@@ -74,6 +74,7 @@ Sketch::Sketch()
     , GCSsys()
     , ConstraintsCounter(0)
     , isInitMove(false)
+    , isDragMove(false)
     , isFine(true)
     , moveStep(0)
     , defaultSolver(GCS::DogLeg)
@@ -138,6 +139,7 @@ void Sketch::clear()
 
     GCSsys.clear();
     isInitMove = false;
+    isDragMove = false;
     ConstraintsCounter = 0;
     Conflicting.clear();
     Redundant.clear();
@@ -4617,7 +4619,8 @@ int Sketch::internalSolve(std::string& solvername, int level)
 
     if (isInitMove) {
         solvername = "DogLeg";  // DogLeg is used for dragging (same as before)
-        ret = GCSsys.solve(isFine, GCS::DogLeg);
+        ret = isDragMove ? GCSsys.solveDrag(isFine, GCS::DogLeg)
+                         : GCSsys.solve(isFine, GCS::DogLeg);
     }
     else {
         switch (defaultSolver) {
@@ -5015,6 +5018,7 @@ int Sketch::initMove(int geoId, PointPos pos, bool fine)
 void Sketch::resetInitMove()
 {
     isInitMove = false;
+    isDragMove = false;
 }
 
 int Sketch::initBSplinePieceMove(int geoId,
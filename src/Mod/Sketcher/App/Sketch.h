@@ -176,6 +176,15 @@ public:
      */
     void resetInitMove();
 
+    /** Sets whether the following moves are steps of an interactive drag. A drag step only
+     * solves the part of the sketch connected to the moved geometry, starting from the result
+     * of the previous step and with a bounded number of iterations. Reset by resetInitMove().
+     */
+    void setDragMode(bool drag)
+    {
+        isDragMove = drag;
+    }
+
     /** Limits a b-spline drag to the segment around `firstPoint`.
      */
     int limitBSplineMove(int geoId, PointPos pos, const Base::Vector3d& firstPoint);
@@ -611,6 +620,7 @@ private:
     std::vector<GCS::BSpline> BSplines;
 
     bool isInitMove;
+    bool isDragMove;
     bool isFine;
     Base::Vector3d initToPoint;
     double moveStep;
@@ -622,6 +632,10 @@ public:
     {
         GCSsys.dogLegGaussStep = mode;
     }
+    inline void setLinearSolver(GCS::LinearSolver solver)
+    {
+        GCSsys.linearSolver = solver;
+    }
     inline void setDebugMode(GCS::DebugMode mode)
     {
         debugMode = mode;
@@ -1382,7 +1382,8 @@ int SketchObject::moveGeometries(std::vector<GeoElementId> geoEltIds, const Base
     if (lastHasConflict)// conflicting constraints
         return -1;
 
-    // move the point and solve
+    // move the point and solve the whole sketch, also when finishing a temporary drag
+    solvedSketch.setDragMode(false);
     lastSolverStatus = solvedSketch.moveGeometries(geoEltIds, toPoint, relative);
 
     // moving the point can not result in a conflict that we did not have
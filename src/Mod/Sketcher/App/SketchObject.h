@@ -1103,6 +1103,7 @@ inline int SketchObject::initTemporaryMove(std::vector<GeoElementId> moved, bool
         solve();
     }
 
+    solvedSketch.setDragMode(true);
     return solvedSketch.initMove(moved, fine);
 }
 
@@ -1124,6 +1125,7 @@ inline int SketchObject::initTemporaryBSplinePieceMove(int geoId,
         solve();
     }
 
+    solvedSketch.setDragMode(true);
     return solvedSketch.initBSplinePieceMove(geoId, pos, firstPoint, fine);
 }
 
@@ -47,10 +47,14 @@
 #endif
 
 #include <algorithm>
+#include <atomic>
 #include <future>
 #include <iostream>
 #include <limits>
 #include <numbers>
+#include <thread>
+
+#include <Eigen/SparseCholesky>
 
 #include "GCS.h"
 #include "qp_eq.h"
@@ -466,11 +470,13 @@ System::System()
     , subSystems(0)
     , subSystemsAux(0)
     , reference(0)
+    , reusedComponents(0)
     , dofs(0)
     , hasUnknowns(false)
     , hasDiagnosis(false)
     , isInit(false)
     , emptyDiagnoseMatrix(true)
+    , dragging(false)
     , maxIter(100)
     , maxIterRedundant(100)
     , sketchSizeMultiplier(false)
@@ -479,6 +485,9 @@ System::System()
     , convergenceRedundant(1e-10)
     , qrAlgorithm(EigenSparseQR)
     , dogLegGaussStep(FullPivLU)
+    , linearSolver(EigenDense)
+    , maxIterDrag(50)
+    , incrementalDiagnosis(true)
     , qrpivotThreshold(1E-13)
     , debugMode(Minimal)
     , LM_eps(1E-10)
@@ -1984,26 +1993,95 @@ int System::solve(bool isFine, Algorithm alg, bool isRedundantsolving)
         return Failed;
     }
 
-    bool isReset = false;
+    // when dragging only the components of the temporary constraints can have changed
+    std::vector<int> components;
+    for (int cid = 0; cid < int(subSystems.size()); cid++) {
+        if (dragging ? subSystemsAux[cid] != nullptr : subSystems[cid] || subSystemsAux[cid]) {
+            components.push_back(cid);
+        }
+    }
+    if (!components.empty() && !dragging) {
+        resetToReference();
+    }
+
+    // components whose inputs are the same as in the last solve take the stored solution
+    std::vector<std::string> keys(components.size());
+    std::vector<int> results(components.size(), Success);
+    std::vector<std::size_t> unsolved;
+    std::size_t unsolvedParams = 0;
+    reusedComponents = 0;
+    for (std::size_t i = 0; i < components.size(); ++i) {
+        int cid = components[i];
+        if (!dragging) {
+            keys[i] = componentKey(cid, alg, isFine, isRedundantsolving);
+            auto it = componentSolutions.find(keys[i]);
+            if (it != componentSolutions.end()
+                && applyComponentSolution(cid, it->second, isRedundantsolving)) {
+                ++reusedComponents;
+                continue;
+            }
+        }
+        unsolved.push_back(i);
+        unsolvedParams += plists[cid].size();
+    }
+
+    // The components do not share any unknowns, so they can be solved concurrently. Small
+    // systems are solved serially as they are faster than starting the threads.
+    std::atomic<std::size_t> next {0};
+    auto solveComponents = [&]() {
+        for (std::size_t k = next++; k < unsolved.size(); k = next++) {
+            std::size_t i = unsolved[k];
+            results[i] = solveComponent(components[i], isFine, alg, isRedundantsolving);
+        }
+    };
+    std::size_t numThreads = std::min<std::size_t>(std::thread::hardware_concurrency(),
+                                                   unsolved.size());
+#ifdef _GCS_EXTRACT_SOLVER_SUBSYSTEM_
+    numThreads = 1;
+#endif
+    if (debugMode == IterationLevel || unsolvedParams < 100) {
+        numThreads = 1;
+    }
+    std::vector<std::future<void>> futures;
+    for (std::size_t t = 1; t < numThreads; ++t) {
+        futures.push_back(std::async(std::launch::async, solveComponents));
+    }
+    solveComponents();
+    for (auto& future : futures) {
+        future.get();
+    }
+
     // return success by default in order to permit coincidence constraints to be applied
     // even if no other system has to be solved
     int res = Success;
-    for (int cid = 0; cid < int(subSystems.size()); cid++) {
-        if ((subSystems[cid] || subSystemsAux[cid]) && !isReset) {
-            resetToReference();
-            isReset = true;
-        }
-        if (subSystems[cid] && subSystemsAux[cid]) {
-            res = std::max(res,
-                           solve(subSystems[cid], subSystemsAux[cid], isFine, isRedundantsolving));
+    for (std::size_t i = 0; i < components.size(); ++i) {
+        res = std::max(res, results[i]);
+    }
+
+    // the input of a drag solve changes with every step, so it is not worth storing
+    std::unordered_map<std::string, VEC_D> solutions;
+    for (std::size_t i = 0; i < components.size() && !dragging; ++i) {
+        if (results[i] != Success) {
+            continue;
         }
-        else if (subSystems[cid]) {
-            res = std::max(res, solve(subSystems[cid], isFine, alg, isRedundantsolving));
+        int cid = components[i];
+        VEC_D values = getComponentSolution(cid);
+        // also store it with the solution as input, which is what the next solve starts
+        // from once the solution has been applied
+        const VEC_pD& params = plists[cid];
+        for (std::size_t j = 0; j < params.size(); ++j) {
+            *params[j] = values[j];
         }
-        else if (subSystemsAux[cid]) {
-            res = std::max(res, solve(subSystemsAux[cid], isFine, alg, isRedundantsolving));
+        solutions[componentKey(cid, alg, isFine, isRedundantsolving)] = values;
+        for (double* param : params) {
+            *param = reference[pIndex[param]];
         }
+        solutions[keys[i]] = std::move(values);
     }
+    if (!dragging) {
+        componentSolutions = std::move(solutions);
+    }
+
     if (res == Success) {
         for (std::set<Constraint*>::const_iterator constr = redundant.begin();
              constr != redundant.end();
@@ -2021,6 +2099,125 @@ int System::solve(bool isFine, Algorithm alg, bool isRedundantsolving)
     return res;
 }
 
+int System::solveDrag(bool isFine, Algorithm alg)
+{
+    // The unknowns are not reset to the reference, so each step starts from the result of the
+    // previous one, which is close to the new solution.
+    dragging = true;
+    int res = solve(isFine, alg);
+    dragging = false;
+    return res;
+}
+
+int System::maxIterations(int xsize, bool isRedundantsolving) const
+{
+    int maxIterNumber =
+        (isRedundantsolving
+             ? (sketchSizeMultiplierRedundant ? maxIterRedundant * xsize : maxIterRedundant)
+             : (sketchSizeMultiplier ? maxIter * xsize : maxIter));
+    // bound the time of a drag step
+    if (dragging) {
+        maxIterNumber = std::min(maxIterNumber, maxIterDrag);
+    }
+    return maxIterNumber;
+}
+
+int System::solveComponent(int cid, bool isFine, Algorithm alg, bool isRedundantsolving)
+{
+    if (subSystems[cid] && subSystemsAux[cid]) {
+        return solve(subSystems[cid], subSystemsAux[cid], isFine, isRedundantsolving);
+    }
+    if (subSystems[cid]) {
+        return solve(subSystems[cid], isFine, alg, isRedundantsolving);
+    }
+    return solve(subSystemsAux[cid], isFine, alg, isRedundantsolving);
+}
+
+std::string System::componentKey(int cid, Algorithm alg, bool isFine, bool isRedundantsolving)
+{
+    // The key holds everything the solution of the component depends on: the solver, the start
+    // values of the unknowns, the parameter reduction and for each constraint its type and
+    // parameters. Unknowns are referenced by their position in the component, as the pointers
+    // change whenever the sketch is set up again.
+    std::string key;
+    auto append = [&key](const auto& value) {
+        key.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    };
+    append(static_cast<int>(alg));
+    append(isFine);
+    append(isRedundantsolving);
+
+    const VEC_pD& params = plists[cid];
+    std::unordered_map<double*, int> local;
+    for (int i = 0; i < int(params.size()); ++i) {
+        local[params[i]] = i;
+        append(*params[i]);
+    }
+    const MAP_pD_pD& reductionmap = reductionmaps[cid];
+    for (int i = 0; i < int(params.size()); ++i) {
+        auto it = reductionmap.find(params[i]);
+        if (it != reductionmap.end()) {
+            append(i);
+            append(local[it->second]);
+        }
+    }
+
+    for (auto constr : clists[cid]) {
+        append(static_cast<int>(constr->getTypeId()));
+        append(constr->getTag() >= 0);
+        for (double* param : constr->params()) {
+            auto it = local.find(param);
+            append(it != local.end() ? it->second : -1);
+            append(*param);
+        }
+    }
+    return key;
+}
+
+bool System::applyComponentSolution(int cid, const VEC_D& values, bool isRedundantsolving)
+{
+    const VEC_pD& params = plists[cid];
+    for (std::size_t i = 0; i < params.size(); ++i) {
+        *params[i] = values[i];
+    }
+    // constraints may hold data that is not part of the key, so check that it still solves them
+    double conv = isRedundantsolving ? convergenceRedundant : convergence;
+    bool solved = std::all_of(clists[cid].begin(), clists[cid].end(), [conv](auto constr) {
+        double err = constr->error();
+        return err * err <= conv;
+    });
+    for (double* param : params) {
+        *param = reference[pIndex[param]];
+    }
+    // like a solver, leave the solution in the subsystems until applySolution() is called
+    if (solved) {
+        VEC_pD plistCopy = params;
+        Eigen::VectorXd x = Eigen::Map<const Eigen::VectorXd>(values.data(), values.size());
+        for (SubSystem* subsys : {subSystems[cid], subSystemsAux[cid]}) {
+            if (subsys) {
+                subsys->setParams(plistCopy, x);
+            }
+        }
+    }
+    return solved;
+}
+
+VEC_D System::getComponentSolution(int cid)
+{
+    // the solvers leave the solution in the subsystems
+    VEC_pD params = plists[cid];
+    Eigen::VectorXd x(params.size());
+    for (std::size_t i = 0; i < params.size(); ++i) {
+        x[i] = *params[i];
+    }
+    for (SubSystem* subsys : {subSystemsAux[cid], subSystems[cid]}) {
+        if (subsys) {
+            subsys->getParams(params, x);
+        }
+    }
+    return VEC_D(x.data(), x.data() + x.size());
+}
+
 int System::solve(SubSystem* subsys, bool isFine, Algorithm alg, bool isRedundantsolving)
 {
     if (alg == BFGS) {
@@ -2072,11 +2269,9 @@ int System::solve_BFGS(SubSystem* subsys, bool /*isFine*/, bool isRedundantsolvi
     h = x - h;  // = x - xold
 
     // double convergence = isFine ? convergence : XconvergenceRough;
-    int maxIterNumber = (sketchSizeMultiplier ? maxIter * xsize : maxIter);
+    int maxIterNumber = maxIterations(xsize, isRedundantsolving);
     double convCriterion = convergence;
     if (isRedundantsolving) {
-        maxIterNumber =
-            (sketchSizeMultiplierRedundant ? maxIterRedundant * xsize : maxIterRedundant);
         convCriterion = convergenceRedundant;
     }
 
@@ -2165,6 +2360,73 @@ int System::solve_BFGS(SubSystem* subsys, bool /*isFine*/, bool isRedundantsolvi
     return Failed;
 }
 
+double System::solveAugmented(Eigen::MatrixXd& A,
+                              const Eigen::VectorXd& diag,
+                              double mu,
+                              const Eigen::VectorXd& g,
+                              Eigen::VectorXd& h)
+{
+    A.diagonal() = diag.array() + mu;
+    h = A.fullPivLu().solve(g);
+    return (A * h - g).norm() / g.norm();
+}
+
+double System::solveAugmented(Eigen::SparseMatrix<double>& A,
+                              const Eigen::VectorXd& diag,
+                              double mu,
+                              const Eigen::VectorXd& g,
+                              Eigen::VectorXd& h)
+{
+    for (int i = 0; i < A.cols(); ++i) {
+        A.coeffRef(i, i) = diag(i) + mu;
+    }
+    // A is symmetric and, as mu > 0, positive definite
+    Eigen::SimplicialLDLT<Eigen::SparseMatrix<double>> ldlt(A);
+    if (ldlt.info() != Eigen::Success) {
+        return 1.0;
+    }
+    h = ldlt.solve(g);
+    return (A * h - g).norm() / g.norm();
+}
+
+void System::calcGaussNewtonStep(const Eigen::MatrixXd& J,
+                                 const Eigen::VectorXd& f,
+                                 Eigen::VectorXd& h)
+{
+    // https://forum.freecad.org/viewtopic.php?f=10&t=12769&start=50#p106220
+    // https://forum.kde.org/viewtopic.php?f=74&t=129439#p346104
+    switch (dogLegGaussStep) {
+        case FullPivLU:
+            h = J.fullPivLu().solve(-f);
+            break;
+        case LeastNormFullPivLU:
+            h = J.adjoint() * (J * J.adjoint()).fullPivLu().solve(-f);
+            break;
+        case LeastNormLdlt:
+            h = J.adjoint() * (J * J.adjoint()).ldlt().solve(-f);
+            break;
+    }
+}
+
+void System::calcGaussNewtonStep(const Eigen::SparseMatrix<double>& J,
+                                 const Eigen::VectorXd& f,
+                                 Eigen::VectorXd& h)
+{
+    // Least norm solution h = J^T (J J^T)^-1 (-f). J J^T is singular for redundant
+    // constraints, in which case the dense decomposition selected by dogLegGaussStep is used.
+    Eigen::SparseMatrix<double> JJt = J * J.transpose();
+    Eigen::SimplicialLDLT<Eigen::SparseMatrix<double>> ldlt(JJt);
+    if (ldlt.info() == Eigen::Success) {
+        Eigen::VectorXd y = ldlt.solve(-f);
+        if (ldlt.info() == Eigen::Success && y.allFinite()
+            && (JJt * y + f).norm() <= 1e-10 * (1.0 + f.norm())) {
+            h = J.transpose() * y;
+            return;
+        }
+    }
+    calcGaussNewtonStep(Eigen::MatrixXd(J), f, h);
+}
+
 int System::solve_LM(SubSystem* subsys, bool isRedundantsolving)
 {
 #ifdef _GCS_EXTRACT_SOLVER_SUBSYSTEM_
@@ -2178,29 +2440,13 @@ int System::solve_LM(SubSystem* subsys, bool isRedundantsolving)
         return Success;
     }
 
-    Eigen::VectorXd e(csize),
-        e_new(csize);  // vector of all function errors (every constraint is one function)
-    Eigen::MatrixXd J(csize, xsize);  // Jacobi of the subsystem
-    Eigen::MatrixXd A(xsize, xsize);
-    Eigen::VectorXd x(xsize), h(xsize), x_new(xsize), g(xsize), diag_A(xsize);
-
-    subsys->redirectParams();
-
-    subsys->getParams(x);
-    subsys->calcResidual(e);
-    e *= -1;
-
-    int maxIterNumber = (sketchSizeMultiplier ? maxIter * xsize : maxIter);
-
-    double divergingLim = 1e6 * e.squaredNorm() + 1e12;
+    int maxIterNumber = maxIterations(xsize, isRedundantsolving);
 
     double eps = LM_eps;
     double eps1 = LM_eps1;
     double tau = LM_tau;
 
     if (isRedundantsolving) {
-        maxIterNumber =
-            (sketchSizeMultiplierRedundant ? maxIterRedundant * xsize : maxIterRedundant);
         eps = LM_epsRedundant;
         eps1 = LM_eps1Redundant;
         tau = LM_tauRedundant;
@@ -2216,6 +2462,32 @@ int System::solve_LM(SubSystem* subsys, bool isRedundantsolving)
         Base::Console().Log(tmp.c_str());
     }
 
+    if (linearSolver == EigenSparse) {
+        return solve_LM<Eigen::SparseMatrix<double>>(subsys, eps, eps1, tau, maxIterNumber);
+    }
+    return solve_LM<Eigen::MatrixXd>(subsys, eps, eps1, tau, maxIterNumber);
+}
+
+template<typename MatrixType>
+int System::solve_LM(SubSystem* subsys, double eps, double eps1, double tau, int maxIterNumber)
+{
+    int xsize = subsys->pSize();
+    int csize = subsys->cSize();
+
+    Eigen::VectorXd e(csize),
+        e_new(csize);  // vector of all function errors (every constraint is one function)
+    MatrixType J(csize, xsize);  // Jacobi of the subsystem
+    MatrixType A(xsize, xsize);
+    Eigen::VectorXd x(xsize), h(xsize), x_new(xsize), g(xsize), diag_A(xsize);
+
+    subsys->redirectParams();
+
+    subsys->getParams(x);
+    subsys->calcResidual(e);
+    e *= -1;
+
+    double divergingLim = 1e6 * e.squaredNorm() + 1e12;
+
     double nu = 2, mu = 0;
     int iter = 0, stop = 0;
     for (iter = 0; iter < maxIterNumber && !stop; ++iter) {
@@ -2240,7 +2512,7 @@ int System::solve_LM(SubSystem* subsys, bool isRedundantsolving)
 
         // Compute ||J^T e||_inf
         double g_inf = g.lpNorm<Eigen::Infinity>();
-        diag_A = A.diagonal();  // save diagonal entries so that augmentation can be later canceled
+        diag_A = A.diagonal();  // save diagonal entries as augmentation replaces them
 
         // check for convergence
         if (g_inf <= eps1) {
@@ -2257,14 +2529,8 @@ int System::solve_LM(SubSystem* subsys, bool isRedundantsolving)
         // determine increment using adaptive damping
         int k = 0;
         while (k < 50) {
-            // augment normal equations A = A+uI
-            for (int i = 0; i < xsize; ++i) {
-                A(i, i) += mu;
-            }
-
-            // solve augmented functions A*h=-g
-            h = A.fullPivLu().solve(g);
-            double rel_error = (A * h - g).norm() / g.norm();
+            // augment normal equations A = A+uI and solve augmented functions A*h=-g
+            double rel_error = solveAugmented(A, diag_A, mu, g, h);
 
             // check if solving works
             if (rel_error < 1e-5) {
@@ -2314,9 +2580,6 @@ int System::solve_LM(SubSystem* subsys, bool isRedundantsolving)
 
             mu *= nu;
             nu *= 2.0;
-            for (int i = 0; i < xsize; ++i) {  // restore diagonal J^T J entries
-                A(i, i) = diag_A(i);
-            }
 
             k++;
         }
@@ -2362,14 +2625,11 @@ int System::solve_DL(SubSystem* subsys, bool isRedundantsolving)
     double tolx = DL_tolx;
     double tolf = DL_tolf;
 
-    int maxIterNumber = (sketchSizeMultiplier ? maxIter * xsize : maxIter);
+    int maxIterNumber = maxIterations(xsize, isRedundantsolving);
     if (isRedundantsolving) {
         tolg = DL_tolgRedundant;
         tolx = DL_tolxRedundant;
         tolf = DL_tolfRedundant;
-
-        maxIterNumber =
-            (sketchSizeMultiplierRedundant ? maxIterRedundant * xsize : maxIterRedundant);
     }
 
     if (debugMode == IterationLevel) {
@@ -2388,9 +2648,21 @@ int System::solve_DL(SubSystem* subsys, bool isRedundantsolving)
         Base::Console().Log(tmp.c_str());
     }
 
+    if (linearSolver == EigenSparse) {
+        return solve_DL<Eigen::SparseMatrix<double>>(subsys, tolg, tolx, tolf, maxIterNumber);
+    }
+    return solve_DL<Eigen::MatrixXd>(subsys, tolg, tolx, tolf, maxIterNumber);
+}
+
+template<typename MatrixType>
+int System::solve_DL(SubSystem* subsys, double tolg, double tolx, double tolf, int maxIterNumber)
+{
+    int xsize = subsys->pSize();
+    int csize = subsys->cSize();
+
     Eigen::VectorXd x(xsize), x_new(xsize);
     Eigen::VectorXd fx(csize), fx_new(csize);
-    Eigen::MatrixXd Jx(csize, xsize), Jx_new(csize, xsize);
+    MatrixType Jx(csize, xsize), Jx_new(csize, xsize);
     Eigen::VectorXd g(xsize), h_sd(xsize), h_gn(xsize), h_dl(xsize);
 
     subsys->redirectParams();
@@ -2442,19 +2714,7 @@ int System::solve_DL(SubSystem* subsys, bool isRedundantsolving)
         h_sd = alpha * g;
 
         // get the gauss-newton step
-        // https://forum.freecad.org/viewtopic.php?f=10&t=12769&start=50#p106220
-        // https://forum.kde.org/viewtopic.php?f=74&t=129439#p346104
-        switch (dogLegGaussStep) {
-            case FullPivLU:
-                h_gn = Jx.fullPivLu().solve(-fx);
-                break;
-            case LeastNormFullPivLU:
-                h_gn = Jx.adjoint() * (Jx * Jx.adjoint()).fullPivLu().solve(-fx);
-                break;
-            case LeastNormLdlt:
-                h_gn = Jx.adjoint() * (Jx * Jx.adjoint()).ldlt().solve(-fx);
-                break;
-        }
+        calcGaussNewtonStep(Jx, fx, h_gn);
 
         double rel_error = (Jx * h_gn + fx).norm() / fx.norm();
         if (rel_error > 1e15) {
@@ -4666,10 +4926,7 @@ int System::solve(SubSystem* subsysA, SubSystem* subsysB, bool /*isFine*/, bool
     subsysA->calcResidual(resA);
 
     // double convergence = isFine ? XconvergenceFine : XconvergenceRough;
-    int maxIterNumber =
-        (isRedundantsolving
-             ? (sketchSizeMultiplierRedundant ? maxIterRedundant * xsize : maxIterRedundant)
-             : (sketchSizeMultiplier ? maxIter * xsize : maxIter));
+    int maxIterNumber = maxIterations(xsize, isRedundantsolving);
 
     double divergingLim = 1e6 * subsysA->error() + 1e12;
 
@@ -4988,6 +5245,11 @@ int System::diagnose(Algorithm alg)
     // From here on, presuming `J.rows() > 0`.
     emptyDiagnoseMatrix = false;
 
+    if (incrementalDiagnosis && diagnoseIncrementally(J, jacobianconstraintmap, pdiagnoselist)) {
+        return dofs;
+    }
+    diagnosisCache.reset();
+
     if (qrAlgorithm == EigenDenseQR) {
 #ifdef PROFILE_DIAGNOSE
         Base::TimeElapsed DenseQR_start_time;
@@ -5047,6 +5309,12 @@ int System::diagnose(Algorithm alg)
                 dofs = paramsNum - nonredundantconstrNum;
             }
         }
+        else if (incrementalDiagnosis) {
+            setDiagnosisBase(J.topRows(constrNum),
+                             std::make_shared<Eigen::FullPivHouseholderQR<Eigen::MatrixXd>>(
+                                 std::move(qrJT)),
+                             pdiagnoselist);
+        }
 
 #ifdef PROFILE_DIAGNOSE
         Base::TimeElapsed DenseQR_end_time;
@@ -5064,7 +5332,9 @@ int System::diagnose(Algorithm alg)
 #endif
         int rank = 0;
         Eigen::MatrixXd R;
-        Eigen::SparseQR<Eigen::SparseMatrix<double>, Eigen::COLAMDOrdering<int>> SqrJT;
+        // shared, as it is kept for incremental diagnosis
+        auto SqrJT = std::make_shared<
+            Eigen::SparseQR<Eigen::SparseMatrix<double>, Eigen::COLAMDOrdering<int>>>();
         // Here we give the system the possibility to run the two QR decompositions in parallel,
         // depending on the load of the system so we are using the default std::launch::async |
         // std::launch::deferred policy, as nobody better than the system nows if it can run the
@@ -5090,14 +5360,14 @@ int System::diagnose(Algorithm alg)
 
         makeSparseQRDecomposition(J,
                                   jacobianconstraintmap,
-                                  SqrJT,
+                                  *SqrJT,
                                   rank,
                                   R,
                                   /*transposed=*/true,
                                   /*silent=*/false);
 
-        int paramsNum = SqrJT.rows();
-        int constrNum = SqrJT.cols();
+        int paramsNum = SqrJT->rows();
+        int constrNum = SqrJT->cols();
 
         fut.wait();  // wait for the execution of identifyDependentParametersSparseQR to finish
 
@@ -5108,7 +5378,7 @@ int System::diagnose(Algorithm alg)
             int nonredundantconstrNum;
 
             identifyConflictingRedundantConstraints(alg,
-                                                    SqrJT,
+                                                    *SqrJT,
                                                     jacobianconstraintmap,
                                                     tagmultiplicity,
                                                     pdiagnoselist,
@@ -5122,6 +5392,9 @@ int System::diagnose(Algorithm alg)
                 dofs = paramsNum - nonredundantconstrNum;
             }
         }
+        else if (incrementalDiagnosis) {
+            setDiagnosisBase(J.topRows(constrNum), SqrJT, pdiagnoselist);
+        }
 
 #ifdef PROFILE_DIAGNOSE
         Base::TimeElapsed SparseQR_end_time;
@@ -5136,6 +5409,127 @@ int System::diagnose(Algorithm alg)
     return dofs;
 }
 
+bool System::diagnoseIncrementally(const Eigen::MatrixXd& J,
+                                   const std::map<int, int>& jacobianconstraintmap,
+                                   const GCS::VEC_pD& pdiagnoselist)
+{
+    // The base of the cache is a Jacobian with linearly independent rows, i.e. without
+    // conflicting or redundant constraints. If all rows of the new Jacobian are either rows of
+    // the base, or are linearly independent of all rows of the base, then the new Jacobian has
+    // linearly independent rows as well. This covers adding and removing constraints as long as
+    // the geometry does not change. Anything else needs a full diagnosis.
+    if (!diagnosisCache || diagnosisCache->threshold != qrpivotThreshold) {
+        return false;
+    }
+    DiagnosisCache& cache = *diagnosisCache;
+    Eigen::MatrixXd JG = J.topRows(jacobianconstraintmap.size());
+    if (JG.cols() != cache.baseJ.cols() || JG.rows() > JG.cols()) {
+        return false;
+    }
+
+    pDependentParameters.clear();
+    pDependentParametersGroups.clear();
+
+    if (qrAlgorithm == cache.lastQRAlgorithm && JG.rows() == cache.lastJ.rows()
+        && JG == cache.lastJ) {
+        // unchanged since the last diagnosis
+        dofs = JG.cols() - JG.rows();
+        for (const auto& group : cache.lastDependentParametersGroups) {
+            auto& params = pDependentParametersGroups.emplace_back();
+            for (int index : group) {
+                params.push_back(pdiagnoselist[index]);
+                pDependentParameters.push_back(pdiagnoselist[index]);
+            }
+        }
+        return true;
+    }
+
+    auto rowHash = [](const Eigen::MatrixXd& matrix, int row) {
+        std::size_t seed = 0;
+        for (int j = 0; j < matrix.cols(); ++j) {
+            // copied from boost::hash_combine
+            seed ^= std::hash<double> {}(matrix(row, j)) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+        }
+        return seed;
+    };
+    std::unordered_multimap<std::size_t, int> baseRows;
+    for (int i = 0; i < cache.baseJ.rows(); ++i) {
+        baseRows.emplace(rowHash(cache.baseJ, i), i);
+    }
+    std::vector<int> newRows;
+    for (int i = 0; i < JG.rows(); ++i) {
+        auto [begin, end] = baseRows.equal_range(rowHash(JG, i));
+        auto it = std::find_if(begin, end, [&](const auto& entry) {
+            return cache.baseJ.row(entry.second) == JG.row(i);
+        });
+        if (it != end) {
+            baseRows.erase(it);
+        }
+        else {
+            newRows.push_back(i);
+        }
+    }
+
+    if (!newRows.empty()) {
+        Eigen::MatrixXd V(JG.cols(), newRows.size());
+        for (std::size_t k = 0; k < newRows.size(); ++k) {
+            V.col(k) = JG.row(newRows[k]).transpose();
+        }
+        // the part of the new rows that is orthogonal to the rows of the base
+        Eigen::MatrixXd residual = V - cache.baseJ.transpose() * cache.baseSolve(V);
+        Eigen::FullPivHouseholderQR<Eigen::MatrixXd> qrResidual(residual);
+        // This is only a sufficient condition, so the threshold is chosen well above the one of
+        // the full diagnosis to never report a rank the full diagnosis would not find.
+        double minPivot = qrResidual.matrixQR().diagonal().cwiseAbs().minCoeff();
+        if (!(minPivot > 1e-6 * V.cwiseAbs().maxCoeff())) {
+            return false;
+        }
+    }
+
+    dofs = JG.cols() - JG.rows();
+    if (qrAlgorithm == EigenDenseQR) {
+        identifyDependentParametersDenseQR(J, jacobianconstraintmap, pdiagnoselist, true);
+    }
+#ifdef EIGEN_SPARSEQR_COMPATIBLE
+    else if (qrAlgorithm == EigenSparseQR) {
+        identifyDependentParametersSparseQR(J, jacobianconstraintmap, pdiagnoselist, true);
+    }
+#endif
+    storeDiagnosis(JG, pdiagnoselist);
+    return true;
+}
+
+template<typename T>
+void System::setDiagnosisBase(const Eigen::MatrixXd& JG,
+                              std::shared_ptr<T> qrJT,
+                              const GCS::VEC_pD& pdiagnoselist)
+{
+    diagnosisCache = std::make_unique<DiagnosisCache>();
+    diagnosisCache->baseJ = JG;
+    diagnosisCache->baseSolve = [qrJT](const Eigen::MatrixXd& b) -> Eigen::MatrixXd {
+        return qrJT->solve(b);
+    };
+    diagnosisCache->threshold = qrpivotThreshold;
+    storeDiagnosis(JG, pdiagnoselist);
+}
+
+void System::storeDiagnosis(const Eigen::MatrixXd& JG, const GCS::VEC_pD& pdiagnoselist)
+{
+    std::unordered_map<double*, int> index;
+    for (int i = 0; i < int(pdiagnoselist.size()); ++i) {
+        index[pdiagnoselist[i]] = i;
+    }
+    diagnosisCache->lastJ = JG;
+    diagnosisCache->lastQRAlgorithm = qrAlgorithm;
+    diagnosisCache->lastDependentParametersGroups.clear();
+    for (const auto& group : pDependentParametersGroups) {
+        auto& indices = diagnosisCache->lastDependentParametersGroups.emplace_back();
+        for (double* param : group) {
+            indices.push_back(index[param]);
+        }
+    }
+}
+
 void System::makeDenseQRDecomposition(const Eigen::MatrixXd& J,
                                       const std::map<int, int>& jacobianconstraintmap,
                                       Eigen::FullPivHouseholderQR<Eigen::MatrixXd>& qrJT,
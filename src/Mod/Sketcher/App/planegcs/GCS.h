@@ -23,6 +23,11 @@
 #ifndef PLANEGCS_GCS_H
 #define PLANEGCS_GCS_H
 
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
 #include <Eigen/QR>
 
 #include "../../SketcherGlobal.h"
@@ -78,6 +83,15 @@ enum QRAlgorithm
     EigenSparseQR = 1
 };
 
+// Matrix type of the Jacobian and the linear systems in LevenbergMarquardt and DogLeg.
+// With EigenSparse only the derivatives of the parameters of each constraint are computed,
+// and the normal equations are solved by a sparse Cholesky (LDLT) decomposition.
+enum LinearSolver
+{
+    EigenDense = 0,
+    EigenSparse = 1
+};
+
 enum DebugMode
 {
     NoDebug = 0,
@@ -133,6 +147,17 @@ private:
     std::vector<std::vector<Constraint*>> clists;
     std::vector<MAP_pD_pD> reductionmaps;  // for simplification of equality constraints
 
+    // Solutions of the decoupled components of the last solve, keyed by the structure and the
+    // input values of the component (see componentKey). Kept over clear(), so that components
+    // that did not change are not solved again when the sketch is set up anew.
+    std::unordered_map<std::string, VEC_D> componentSolutions;
+    std::size_t reusedComponents;  // number of components that took the stored solution
+    std::string componentKey(int cid, Algorithm alg, bool isFine, bool isRedundantsolving);
+    bool applyComponentSolution(int cid, const VEC_D& values, bool isRedundantsolving);
+    VEC_D getComponentSolution(int cid);
+    int solveComponent(int cid, bool isFine, Algorithm alg, bool isRedundantsolving);
+    int maxIterations(int xsize, bool isRedundantsolving) const;
+
     int dofs;
     std::set<Constraint*> redundant;
     VEC_I conflictingTags, redundantTags, partiallyRedundantTags;
@@ -142,11 +167,39 @@ private:
     bool isInit;        // if plists, clists, reductionmaps are up to date
 
     bool emptyDiagnoseMatrix;  // false only if there is at least one driving constraint.
+    bool dragging;             // if solving a drag step, see solveDrag()
 
     int solve_BFGS(SubSystem* subsys, bool isFine = true, bool isRedundantsolving = false);
     int solve_LM(SubSystem* subsys, bool isRedundantsolving = false);
     int solve_DL(SubSystem* subsys, bool isRedundantsolving = false);
 
+    // MatrixType is Eigen::MatrixXd or Eigen::SparseMatrix<double>, see LinearSolver
+    template<typename MatrixType>
+    int solve_LM(SubSystem* subsys, double eps, double eps1, double tau, int maxIterNumber);
+    template<typename MatrixType>
+    int solve_DL(SubSystem* subsys, double tolg, double tolx, double tolf, int maxIterNumber);
+
+    // Solve (A + mu*I) h = g, the diagonal of A is replaced by diag + mu.
+    // Returns the relative error of the solution.
+    double solveAugmented(Eigen::MatrixXd& A,
+                          const Eigen::VectorXd& diag,
+                          double mu,
+                          const Eigen::VectorXd& g,
+                          Eigen::VectorXd& h);
+    double solveAugmented(Eigen::SparseMatrix<double>& A,
+                          const Eigen::VectorXd& diag,
+                          double mu,
+                          const Eigen::VectorXd& g,
+                          Eigen::VectorXd& h);
+
+    // Gauss-Newton step of DogLeg, solves J h = -f
+    void calcGaussNewtonStep(const Eigen::MatrixXd& J,
+                             const Eigen::VectorXd& f,
+                             Eigen::VectorXd& h);
+    void calcGaussNewtonStep(const Eigen::SparseMatrix<double>& J,
+                             const Eigen::VectorXd& f,
+                             Eigen::VectorXd& h);
+
     void makeReducedJacobian(Eigen::MatrixXd& J,
                              std::map<int, int>& jacobianconstraintmap,
                              GCS::VEC_pD& pdiagnoselist,
@@ -211,6 +264,30 @@ private:
                                      const GCS::VEC_pD& pdiagnoselist,
                                      bool silent = true);
 
+    // The last diagnosis of a system without conflicting or redundant constraints. It is the
+    // base for diagnosing later changes of the system incrementally, see diagnoseIncrementally.
+    struct DiagnosisCache
+    {
+        Eigen::MatrixXd baseJ;  // reduced Jacobian of the last full diagnosis
+        // least squares solution of baseJ^T x = b, from the decomposition of the full diagnosis
+        std::function<Eigen::MatrixXd(const Eigen::MatrixXd&)> baseSolve;
+        double threshold;
+        Eigen::MatrixXd lastJ;  // reduced Jacobian of the last diagnosis
+        QRAlgorithm lastQRAlgorithm;
+        // dependent parameters of the last diagnosis as indices in pdiagnoselist
+        std::vector<std::vector<int>> lastDependentParametersGroups;
+    };
+    std::unique_ptr<DiagnosisCache> diagnosisCache;
+
+    bool diagnoseIncrementally(const Eigen::MatrixXd& J,
+                               const std::map<int, int>& jacobianconstraintmap,
+                               const GCS::VEC_pD& pdiagnoselist);
+    template<typename T>
+    void setDiagnosisBase(const Eigen::MatrixXd& JG,
+                          std::shared_ptr<T> qrJT,
+                          const GCS::VEC_pD& pdiagnoselist);
+    void storeDiagnosis(const Eigen::MatrixXd& JG, const GCS::VEC_pD& pdiagnoselist);
+
 #ifdef _GCS_EXTRACT_SOLVER_SUBSYSTEM_
     void extractSubsystem(SubSystem* subsys, bool isRedundantsolving);
 #endif
@@ -224,6 +301,12 @@ public:
     double convergenceRedundant;
     QRAlgorithm qrAlgorithm;
     DogLegGaussStep dogLegGaussStep;
+    LinearSolver linearSolver;
+    // maximum number of iterations of each solve during solveDrag()
+    int maxIterDrag;
+    // if true, diagnose() reuses the last diagnosis of a system without conflicting or redundant
+    // constraints when constraints are added or removed
+    bool incrementalDiagnosis;
     double qrpivotThreshold;
     DebugMode debugMode;
     double LM_eps;
@@ -556,6 +639,10 @@ public:
               SubSystem* subsysB,
               bool isFine = true,
               bool isRedundantsolving = false);
+    // Solves the components holding temporary constraints only, starting from the current values
+    // instead of the reference and with at most maxIterDrag iterations. Meant for interactive
+    // dragging, where the other components did not change since the last solve.
+    int solveDrag(bool isFine = true, Algorithm alg = DogLeg);
 
     void applySolution();
     void undoSolution();
@@ -626,6 +713,10 @@ protected:
             return constraint->getTag() == tagID;
         });
     }
+    size_t _getNumberOfReusedComponents() const
+    {
+        return reusedComponents;
+    }
 };
 
 
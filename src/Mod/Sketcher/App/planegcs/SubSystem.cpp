@@ -118,8 +118,10 @@ void SubSystem::initialize(VEC_pD& params, MAP_pD_pD& reductionmap)
 
     c2p.clear();
     p2c.clear();
+    c2pIndex.assign(csize, VEC_I());
+    int i = 0;
     for (std::vector<Constraint*>::iterator constr = clist.begin(); constr != clist.end();
-         ++constr) {
+         ++constr, i++) {
         (*constr)->revertParams();  // ensure that the constraint points to the original parameters
         VEC_pD constr_params_orig = (*constr)->params();
         SET_pD constr_params;
@@ -134,6 +136,7 @@ void SubSystem::initialize(VEC_pD& params, MAP_pD_pD& reductionmap)
             //            jacobi.set(*constr, *p, 0.);
             c2p[*constr].push_back(*p);
             p2c[*p].push_back(*constr);
+            c2pIndex[i].push_back(static_cast<int>(*p - pvals.data()));
         }
         //        (*constr)->redirectParams(pmap); // redirect parameters to pvec
     }
@@ -273,7 +276,26 @@ void SubSystem::calcJacobi(VEC_pD& params, Eigen::MatrixXd& jacobi)
 
 void SubSystem::calcJacobi(Eigen::MatrixXd& jacobi)
 {
-    calcJacobi(plist, jacobi);
+    // only the parameters a constraint depends on can have a non-zero derivative
+    jacobi.setZero(csize, psize);
+    for (int i = 0; i < csize; i++) {
+        for (int j : c2pIndex[i]) {
+            jacobi(i, j) = clist[i]->grad(&pvals[j]);
+        }
+    }
+}
+
+void SubSystem::calcJacobi(Eigen::SparseMatrix<double>& jacobi)
+{
+    std::vector<Eigen::Triplet<double>> triplets;
+    for (int i = 0; i < csize; i++) {
+        for (int j : c2pIndex[i]) {
+            triplets.emplace_back(i, j, clist[i]->grad(&pvals[j]));
+        }
+    }
+    // The entries are kept even if zero, so that the sparsity pattern does not change
+    jacobi.resize(csize, psize);
+    jacobi.setFromTriplets(triplets.begin(), triplets.end());
 }
 
 void SubSystem::calcGrad(VEC_pD& params, Eigen::VectorXd& grad)
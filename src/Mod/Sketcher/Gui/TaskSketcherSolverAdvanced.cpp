@@ -49,6 +49,7 @@
 #define DEFAULT_SOLVER_DEBUG 1    // None=0, Minimal=1, IterationLevel=2
 #define MAX_ITER_MULTIPLIER false
 #define DEFAULT_DOGLEG_GAUSS_STEP 0  // FullPivLU = 0, LeastNormFullPivLU = 1, LeastNormLdlt = 2
+#define DEFAULT_LINEAR_SOLVER 0      // EigenDense = 0, EigenSparse = 1
 
 using namespace SketcherGui;
 using namespace Gui::TaskView;
@@ -70,6 +71,7 @@ TaskSketcherSolverAdvanced::TaskSketcherSolverAdvanced(ViewProviderSketch* sketc
 
     ui->comboBoxDefaultSolver->onRestore();
     ui->comboBoxDogLegGaussStep->onRestore();
+    ui->comboBoxLinearSolver->onRestore();
     ui->spinBoxMaxIter->onRestore();
     ui->checkBoxSketchSizeMultiplier->onRestore();
     ui->lineEditConvergence->onRestore();
@@ -97,6 +99,10 @@ void TaskSketcherSolverAdvanced::setupConnections()
             qOverload<int>(&QComboBox::currentIndexChanged),
             this,
             &TaskSketcherSolverAdvanced::onComboBoxDogLegGaussStepCurrentIndexChanged);
+    connect(ui->comboBoxLinearSolver,
+            qOverload<int>(&QComboBox::currentIndexChanged),
+            this,
+            &TaskSketcherSolverAdvanced::onComboBoxLinearSolverCurrentIndexChanged);
     connect(ui->spinBoxMaxIter,
             qOverload<int>(&QSpinBox::valueChanged),
             this,
@@ -536,6 +542,13 @@ void TaskSketcherSolverAdvanced::onComboBoxDogLegGaussStepCurrentIndexChanged(in
     updateDefaultMethodParameters();
 }
 
+void TaskSketcherSolverAdvanced::onComboBoxLinearSolverCurrentIndexChanged(int index)
+{
+    ui->comboBoxLinearSolver->onSave();
+    const_cast<Sketcher::Sketch&>(sketchView->getSketchObject()->getSolvedSketch())
+        .setLinearSolver((GCS::LinearSolver)index);
+}
+
 void TaskSketcherSolverAdvanced::onSpinBoxMaxIterValueChanged(int i)
 {
     ui->spinBoxMaxIter->onSave();
@@ -671,6 +684,7 @@ void TaskSketcherSolverAdvanced::onPushButtonDefaultsClicked(bool checked /* = f
     // Set other settings
     hGrp->SetInt("DefaultSolver", DEFAULT_SOLVER);
     hGrp->SetInt("DogLegGaussStep", DEFAULT_DOGLEG_GAUSS_STEP);
+    hGrp->SetInt("LinearSolver", DEFAULT_LINEAR_SOLVER);
 
     hGrp->SetInt("RedundantDefaultSolver", DEFAULT_RSOLVER);
     hGrp->SetInt("MaxIter", MAX_ITER);
@@ -685,6 +699,7 @@ void TaskSketcherSolverAdvanced::onPushButtonDefaultsClicked(bool checked /* = f
 
     ui->comboBoxDefaultSolver->onRestore();
     ui->comboBoxDogLegGaussStep->onRestore();
+    ui->comboBoxLinearSolver->onRestore();
     ui->spinBoxMaxIter->onRestore();
     ui->checkBoxSketchSizeMultiplier->onRestore();
     ui->lineEditConvergence->onRestore();
@@ -726,6 +741,8 @@ void TaskSketcherSolverAdvanced::updateSketchObject()
         static_cast<GCS::Algorithm>(ui->comboBoxDefaultSolver->currentIndex());
     const_cast<Sketcher::Sketch&>(sketchView->getSketchObject()->getSolvedSketch())
         .setDogLegGaussStep((GCS::DogLegGaussStep)ui->comboBoxDogLegGaussStep->currentIndex());
+    const_cast<Sketcher::Sketch&>(sketchView->getSketchObject()->getSolvedSketch())
+        .setLinearSolver((GCS::LinearSolver)ui->comboBoxLinearSolver->currentIndex());
 
     updateDefaultMethodParameters();
     updateRedundantMethodParameters();
@@ -55,6 +55,7 @@
 
 // Qt
 #include <QLocale>
+#include <QtConcurrentMap>
 
 #endif  //_PreComp_
 
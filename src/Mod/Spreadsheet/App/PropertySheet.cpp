@@ -24,6 +24,7 @@
 #ifndef _PreComp_
 #include <algorithm>
 
+#include <boost/algorithm/string/predicate.hpp>
 #include <boost/range/adaptor/map.hpp>
 #include <boost/range/algorithm/copy.hpp>
 #include <boost/regex.hpp>
@@ -54,13 +55,40 @@ using namespace Base;
 using namespace Spreadsheet;
 namespace sp = std::placeholders;
 
+void* CellPool::allocate()
+{
+    if (!freeList.empty()) {
+        void* mem = freeList.back();
+        freeList.pop_back();
+        return mem;
+    }
+    if (usedInBlock == blockSize) {
+        blocks.push_back(std::make_unique<Slot[]>(blockSize));
+        usedInBlock = 0;
+    }
+    return &blocks.back()[usedInBlock++];
+}
+
+void CellPool::destroy(Cell* cell)
+{
+    if (cell) {
+        cell->~Cell();
+        freeList.push_back(cell);
+    }
+}
+
+std::size_t CellPool::getMemSize() const
+{
+    return blocks.size() * blockSize * sizeof(Slot) + freeList.capacity() * sizeof(void*);
+}
+
 TYPESYSTEM_SOURCE(Spreadsheet::PropertySheet, App::PropertyExpressionContainer)
 
 void PropertySheet::clear()
 {
     /* Clear cells */
     for (auto& it : data) {
-        delete it.second;
+        cellPool.destroy(it.second);
         setDirty(it.first);
     }
 
@@ -71,6 +99,8 @@ void PropertySheet::clear()
 
     propertyNameToCellMap.clear();
     cellToPropertyNameMap.clear();
+    cellToDependentCellMap.clear();
+    cellToDependencyCellMap.clear();
     documentObjectToCellMap.clear();
     cellToDocumentObjectMap.clear();
     aliasProp.clear();
@@ -202,6 +232,51 @@ std::tuple<CellAddress, CellAddress> extractRange(const std::vector<CellAddress>
     }
     return std::make_tuple(firstRowAndColumn, lastRowAndColumn);
 }
+
+// The address of a cell from the name of a property of the sheet, invalid if the name is not the
+// address of a cell, e.g. an alias or another property of the sheet
+CellAddress localCellAddress(const std::string& name)
+{
+    CellAddress address = stringToAddress(name.c_str(), true);
+    if (!address.isValid() || address.toString() != name) {
+        return CellAddress();
+    }
+    return address;
+}
+
+// Estimates of the memory of the dependency maps, with a node of a tree of the standard
+// library taking about four pointers besides its value
+constexpr std::size_t treeNodeSize = 4 * sizeof(void*);
+
+std::size_t getMemSize(const CellAddress&)
+{
+    return 0;
+}
+
+std::size_t getMemSize(const std::string& str)
+{
+    return str.capacity() < sizeof(std::string) ? 0 : str.capacity();
+}
+
+template<typename T>
+std::size_t getMemSize(const std::set<T>& set)
+{
+    std::size_t size = set.size() * (treeNodeSize + sizeof(T));
+    for (const auto& value : set) {
+        size += getMemSize(value);
+    }
+    return size;
+}
+
+template<typename K, typename T>
+std::size_t getMemSize(const std::map<K, T>& map)
+{
+    std::size_t size = map.size() * (treeNodeSize + sizeof(K) + sizeof(T));
+    for (const auto& value : map) {
+        size += getMemSize(value.first) + getMemSize(value.second);
+    }
+    return size;
+}
 }  // namespace
 
 std::vector<CellAddress> PropertySheet::getUsedCells() const
@@ -270,7 +345,7 @@ void PropertySheet::setDirty()
 
 Cell* PropertySheet::createCell(CellAddress address)
 {
-    Cell* cell = new Cell(address, this);
+    Cell* cell = cellPool.create(address, this);
 
     data[address] = cell;
 
@@ -287,6 +362,8 @@ PropertySheet::PropertySheet(const PropertySheet& other)
     , owner(other.owner)
     , propertyNameToCellMap(other.propertyNameToCellMap)
     , cellToPropertyNameMap(other.cellToPropertyNameMap)
+    , cellToDependentCellMap(other.cellToDependentCellMap)
+    , cellToDependencyCellMap(other.cellToDependencyCellMap)
     , documentObjectToCellMap(other.documentObjectToCellMap)
     , cellToDocumentObjectMap(other.cellToDocumentObjectMap)
     , aliasProp(other.aliasProp)
@@ -297,7 +374,7 @@ PropertySheet::PropertySheet(const PropertySheet& other)
 
     /* Copy cells */
     while (i != other.data.end()) {
-        data[i->first] = new Cell(this, *i->second);
+        data[i->first] = cellPool.create(this, *i->second);
         ++i;
     }
 }
@@ -342,8 +419,8 @@ void PropertySheet::Paste(const Property& from)
             *cell = *(ifrom->second);  // Exists; assign cell directly
         }
         else {
-            cell = new Cell(this,
-                            *(ifrom->second));  // Doesn't exist, copy using Cell's copy constructor
+            // Doesn't exist, copy using Cell's copy constructor
+            cell = cellPool.create(this, *(ifrom->second));
             if (cell->getSpans(rows, cols)) {
                 spanChanges.push_back(ifrom->first);
             }
@@ -764,17 +841,8 @@ void PropertySheet::setAlias(CellAddress address, const std::string& alias)
 
     /* Mark cells depending on this cell dirty; they need to be resolved when an alias changes or
      * disappears */
-    std::string fullName = owner->getFullName() + "." + address.toString();
-
-    std::map<std::string, std::set<CellAddress>>::const_iterator j =
-        propertyNameToCellMap.find(fullName);
-    if (j != propertyNameToCellMap.end()) {
-        std::set<CellAddress>::const_iterator k = j->second.begin();
-
-        while (k != j->second.end()) {
-            setDirty(*k);
-            ++k;
-        }
+    for (const auto& dependent : getDependentCells(address)) {
+        setDirty(dependent);
     }
 
     std::string oldAlias;
@@ -835,7 +903,7 @@ void PropertySheet::clear(CellAddress address, bool toClearAlias)
 
     // Delete Cell object
     removeDependencies(address);
-    delete i->second;
+    cellPool.destroy(i->second);
 
     // Mark as dirty
     dirty.insert(i->first);
@@ -1223,7 +1291,12 @@ void PropertySheet::removeColumns(int col, int count)
 
 unsigned int PropertySheet::getMemSize() const
 {
-    return sizeof(*this);
+    std::size_t size = sizeof(*this) + cellPool.getMemSize()
+        + data.size() * (treeNodeSize + sizeof(CellAddress) + sizeof(Cell*));
+    size += ::getMemSize(propertyNameToCellMap) + ::getMemSize(cellToPropertyNameMap);
+    size += ::getMemSize(cellToDependentCellMap) + ::getMemSize(cellToDependencyCellMap);
+    size += ::getMemSize(documentObjectToCellMap) + ::getMemSize(cellToDocumentObjectMap);
+    return static_cast<unsigned int>(size);
 }
 
 
@@ -1382,9 +1455,16 @@ void PropertySheet::addDependencies(CellAddress key)
                 std::string propName = docObjName + "." + name;
                 FC_LOG("dep " << key.toString() << " -> " << name);
 
-                // Insert into maps
-                propertyNameToCellMap[propName].insert(key);
-                cellToPropertyNameMap[key].insert(propName);
+                // Insert into maps, by address for the cells of this sheet
+                CellAddress address = docObj == owner ? localCellAddress(name) : CellAddress();
+                if (address.isValid()) {
+                    cellToDependentCellMap[address].insert(key);
+                    cellToDependencyCellMap[key].insert(address);
+                }
+                else {
+                    propertyNameToCellMap[propName].insert(key);
+                    cellToPropertyNameMap[key].insert(propName);
+                }
 
                 // Also an alias?
                 if (!name.empty() && docObj->isDerivedFrom<Sheet>()) {
@@ -1396,8 +1476,14 @@ void PropertySheet::addDependencies(CellAddress key)
                         FC_LOG("dep " << key.toString() << " -> " << propName);
 
                         // Insert into maps
-                        propertyNameToCellMap[propName].insert(key);
-                        cellToPropertyNameMap[key].insert(std::move(propName));
+                        if (docObj == owner) {
+                            cellToDependentCellMap[j->second].insert(key);
+                            cellToDependencyCellMap[key].insert(j->second);
+                        }
+                        else {
+                            propertyNameToCellMap[propName].insert(key);
+                            cellToPropertyNameMap[key].insert(std::move(propName));
+                        }
                     }
                 }
             }
@@ -1436,6 +1522,25 @@ void PropertySheet::removeDependencies(CellAddress key)
         cellToPropertyNameMap.erase(i1);
     }
 
+    /* Remove from Cell <-> Key maps */
+
+    auto i3 = cellToDependencyCellMap.find(key);
+
+    if (i3 != cellToDependencyCellMap.end()) {
+        for (const auto& address : i3->second) {
+            auto k = cellToDependentCellMap.find(address);
+
+            if (k != cellToDependentCellMap.end()) {
+                k->second.erase(key);
+                if (k->second.empty()) {
+                    cellToDependentCellMap.erase(k);
+                }
+            }
+        }
+
+        cellToDependencyCellMap.erase(i3);
+    }
+
     /* Remove from DocumentObject <-> Key maps */
 
     std::map<CellAddress, std::set<std::string>>::iterator i2 = cellToDocumentObjectMap.find(key);
@@ -1620,6 +1725,15 @@ void PropertySheet::documentSet()
 const std::set<CellAddress>& PropertySheet::getDeps(const std::string& name) const
 {
     static std::set<CellAddress> empty;
+
+    std::string prefix = owner ? owner->getFullName() + "." : std::string();
+    if (!prefix.empty() && boost::starts_with(name, prefix)) {
+        CellAddress address = localCellAddress(name.substr(prefix.size()));
+        if (address.isValid()) {
+            return getDependentCells(address);
+        }
+    }
+
     std::map<std::string, std::set<CellAddress>>::const_iterator i =
         propertyNameToCellMap.find(name);
 
@@ -1631,13 +1745,12 @@ const std::set<CellAddress>& PropertySheet::getDeps(const std::string& name) con
     }
 }
 
-const std::set<std::string>& PropertySheet::getDeps(CellAddress pos) const
+const std::set<CellAddress>& PropertySheet::getDependentCells(CellAddress pos) const
 {
-    static std::set<std::string> empty;
-    std::map<CellAddress, std::set<std::string>>::const_iterator i =
-        cellToPropertyNameMap.find(pos);
+    static std::set<CellAddress> empty;
+    auto i = cellToDependentCellMap.find(pos);
 
-    if (i != cellToPropertyNameMap.end()) {
+    if (i != cellToDependentCellMap.end()) {
         return i->second;
     }
     else {
@@ -1645,6 +1758,27 @@ const std::set<std::string>& PropertySheet::getDeps(CellAddress pos) const
     }
 }
 
+std::set<std::string> PropertySheet::getDeps(CellAddress pos) const
+{
+    std::set<std::string> deps;
+    std::map<CellAddress, std::set<std::string>>::const_iterator i =
+        cellToPropertyNameMap.find(pos);
+
+    if (i != cellToPropertyNameMap.end()) {
+        deps = i->second;
+    }
+
+    auto j = cellToDependencyCellMap.find(pos);
+
+    if (j != cellToDependencyCellMap.end()) {
+        std::string prefix = owner->getFullName() + ".";
+        for (const auto& address : j->second) {
+            deps.insert(prefix + address.toString());
+        }
+    }
+    return deps;
+}
+
 void PropertySheet::recomputeDependencies(CellAddress key)
 {
     AtomicPropertyChange signaller(*this);
@@ -1946,7 +2080,7 @@ void PropertySheet::setExpressions(std::map<App::ObjectIdentifier, App::Expressi
             if (!v.second) {
                 continue;
             }
-            cell = new Cell(addr, this);
+            cell = cellPool.create(addr, this);
         }
         if (!v.second) {
             clear(addr);
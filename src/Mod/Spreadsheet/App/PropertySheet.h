@@ -23,7 +23,11 @@
 #ifndef PROPERTYSHEET_H
 #define PROPERTYSHEET_H
 
+#include <cstddef>
 #include <map>
+#include <memory>
+#include <utility>
+#include <vector>
 
 #include <App/DocumentObject.h>
 #include <App/PropertyLinks.h>
@@ -38,6 +42,51 @@ class Sheet;
 class PropertySheet;
 class SheetObserver;
 
+/*! Storage of the cells of a sheet
+ *
+ * The cells are allocated in blocks, so that the cells of a sheet are close in
+ * memory and large sheets don't need an allocation per cell. Destroyed cells
+ * are reused, the memory is freed with the pool.
+ */
+class CellPool
+{
+public:
+    CellPool() = default;
+    CellPool(const CellPool&) = delete;
+    CellPool& operator=(const CellPool&) = delete;
+
+    template<typename... Args>
+    Cell* create(Args&&... args)
+    {
+        void* mem = allocate();
+        try {
+            return new (mem) Cell(std::forward<Args>(args)...);
+        }
+        catch (...) {
+            freeList.push_back(mem);
+            throw;
+        }
+    }
+
+    void destroy(Cell* cell);
+
+    /// The memory of the blocks, in bytes
+    std::size_t getMemSize() const;
+
+private:
+    void* allocate();
+
+    struct alignas(Cell) Slot
+    {
+        std::byte data[sizeof(Cell)];
+    };
+
+    static constexpr std::size_t blockSize = 256;
+    std::vector<std::unique_ptr<Slot[]>> blocks;
+    std::vector<void*> freeList;
+    std::size_t usedInBlock {blockSize};
+};
+
 class SpreadsheetExport PropertySheet: public App::PropertyExpressionContainer,
                                        private App::AtomicPropertyChangeInterface<PropertySheet>
 {
@@ -198,7 +247,10 @@ public:
 
     const std::set<App::CellAddress>& getDeps(const std::string& name) const;
 
-    const std::set<std::string>& getDeps(App::CellAddress pos) const;
+    std::set<std::string> getDeps(App::CellAddress pos) const;
+
+    /// The cells of this sheet depending on the cell at \a pos
+    const std::set<App::CellAddress>& getDependentCells(App::CellAddress pos) const;
 
     void recomputeDependencies(App::CellAddress key);
 
@@ -278,6 +330,9 @@ private:
     /*! Set of cells that have been marked dirty */
     std::set<App::CellAddress> dirty;
 
+    /*! Storage of the cells in data */
+    CellPool cellPool;
+
     /*! Cell data in this property */
     std::map<App::CellAddress, Cell*> data;
 
@@ -307,13 +362,22 @@ private:
     void recomputeDependants(const App::DocumentObject* obj, const char* propName);
 
     /*! Cell dependencies, i.e when a change occurs to property given in key,
-      the set of addresses needs to be recomputed.
+      the set of addresses needs to be recomputed. The cells of this sheet are
+      in cellToDependentCellMap instead.
       */
     std::map<std::string, std::set<App::CellAddress>> propertyNameToCellMap;
 
-    /*! Properties this cell depends on */
+    /*! Properties this cell depends on, except the cells of this sheet */
     std::map<App::CellAddress, std::set<std::string>> cellToPropertyNameMap;
 
+    /*! Cell dependencies on the cells of this sheet, i.e when the cell given in
+      key changes, the set of addresses needs to be recomputed.
+      */
+    std::map<App::CellAddress, std::set<App::CellAddress>> cellToDependentCellMap;
+
+    /*! Cells of this sheet this cell depends on */
+    std::map<App::CellAddress, std::set<App::CellAddress>> cellToDependencyCellMap;
+
     /*! Cell dependencies, i.e when a change occurs to documentObject given in key,
       the set of addresses needs to be recomputed.
       */
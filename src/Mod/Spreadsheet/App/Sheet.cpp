@@ -25,6 +25,7 @@
 #ifndef _PreComp_
 #include <boost/tokenizer.hpp>
 #include <boost/regex.hpp>
+#include <algorithm>
 #include <deque>
 #include <memory>
 #include <sstream>
@@ -34,9 +35,11 @@
 #include <string>
 #include <set>
 #include <vector>
+#include <QtConcurrentMap>
 #endif
 
 #include <App/Application.h>
+#include <App/CompiledExpression.h>
 #include <App/Document.h>
 #include <App/DynamicProperty.h>
 #include <App/ExpressionParser.h>
@@ -741,6 +744,59 @@ Property* Sheet::setObjectProperty(CellAddress key, Py::Object object)
     return pyProp;
 }
 
+namespace
+{
+
+// Whether Python may compute a bool for \a expr, which is stored as a Python object and not as a
+// number like the native evaluation gives it
+bool mayBeBoolean(const Expression* expr)
+{
+    if (auto op = freecad_cast<const OperatorExpression*>(expr)) {
+        switch (op->getOperator()) {
+            case OperatorExpression::EQ:
+            case OperatorExpression::NEQ:
+            case OperatorExpression::LT:
+            case OperatorExpression::GT:
+            case OperatorExpression::LTE:
+            case OperatorExpression::GTE:
+                return true;
+            default:
+                return false;
+        }
+    }
+    if (auto cond = freecad_cast<const ConditionalExpression*>(expr)) {
+        return mayBeBoolean(cond->getTrueExpr()) || mayBeBoolean(cond->getFalseExpr());
+    }
+    if (auto func = freecad_cast<const FunctionExpression*>(expr)) {
+        int f = func->getFunction();
+        if (f == FunctionExpression::HIDDENREF || f == FunctionExpression::HREF) {
+            return func->getArgs().empty() || mayBeBoolean(func->getArgs().front());
+        }
+        return false;
+    }
+    if (auto constant = freecad_cast<const ConstantExpression*>(expr)) {
+        return !constant->isNumber();
+    }
+    if (auto var = freecad_cast<const VariableExpression*>(expr)) {
+        auto prop = var->getPath().getProperty();
+        return !prop || prop->isDerivedFrom<PropertyBool>();
+    }
+    return false;
+}
+
+// A cell evaluated natively in another thread
+struct CellEvaluation
+{
+    const CompiledExpression* code {nullptr};
+    boost::any value;
+    bool done {false};
+};
+
+// The smallest number of cells evaluated in parallel
+constexpr std::size_t minParallelCells = 64;
+
+}  // namespace
+
 struct CurrentAddressLock
 {
     CurrentAddressLock(int& r, int& c, const CellAddress& addr)
@@ -760,6 +816,25 @@ struct CurrentAddressLock
     int& col;
 };
 
+/**
+ * Set the property of the cell at \a key to the value of \a number: a quantity if it has a
+ * unit, else an integer or a float.
+ */
+
+void Sheet::setNumberProperty(CellAddress key, const NumberExpression* number)
+{
+    long l;
+    if (!number->getUnit().isEmpty()) {
+        setQuantityProperty(key, number->getValue(), number->getUnit());
+    }
+    else if (number->isInteger(&l)) {
+        setIntegerProperty(key, l);
+    }
+    else {
+        setFloatProperty(key, number->getValue());
+    }
+}
+
 /**
  * Update the Property given by \a key. This will also eventually trigger recomputations of cells
  * depending on \a key.
@@ -796,20 +871,13 @@ void Sheet::updateProperty(CellAddress key)
          * PyObjectExpression objects */
         auto number = freecad_cast<NumberExpression*>(output.get());
         if (number) {
-            long l;
             auto constant = freecad_cast<ConstantExpression*>(output.get());
             if (constant && !constant->isNumber()) {
                 Base::PyGILStateLocker lock;
                 setObjectProperty(key, constant->getPyValue());
             }
-            else if (!number->getUnit().isEmpty()) {
-                setQuantityProperty(key, number->getValue(), number->getUnit());
-            }
-            else if (number->isInteger(&l)) {
-                setIntegerProperty(key, l);
-            }
             else {
-                setFloatProperty(key, number->getValue());
+                setNumberProperty(key, number);
             }
         }
         else {
@@ -912,6 +980,86 @@ void Sheet::recomputeCells(Range range)
     } while (range.next());
 }
 
+/**
+ * @brief Recompute the cells at \a addresses, which don't depend on each other.
+ *
+ * The numeric expressions that need no Python are evaluated in parallel, they only read
+ * properties that are not changed meanwhile. The properties are then set in the order of
+ * \a addresses, the other cells are recomputed one by one.
+ *
+ * @param addresses Addresses of the cells.
+ */
+
+void Sheet::recomputeIndependentCells(const std::vector<CellAddress>& addresses)
+{
+    std::vector<CellEvaluation> evaluations(addresses.size());
+    std::size_t count = 0;
+    if (addresses.size() >= minParallelCells) {
+        ParameterGrp::handle group = App::GetApplication().GetParameterGroupByPath(
+            "User parameter:BaseApp/Preferences/Mod/Spreadsheet");
+        if (group->GetBool("ParallelRecompute", true)) {
+            for (std::size_t i = 0; i < addresses.size(); ++i) {
+                const Cell* cell = cells.getValue(addresses[i]);
+                if (!cell || cell->hasException()) {
+                    continue;
+                }
+                const Expression* expr = cell->getExpression();
+                if (!expr || mayBeBoolean(expr)) {
+                    continue;
+                }
+                // Compiled here as the evaluation threads must not change the expression
+                const CompiledExpression* code = expr->getCompiled();
+                if (code && !code->usesPython()) {
+                    evaluations[i].code = code;
+                    ++count;
+                }
+            }
+        }
+    }
+
+    if (count >= minParallelCells) {
+        QtConcurrent::blockingMap(evaluations, [](CellEvaluation& eval) {
+            if (!eval.code) {
+                return;
+            }
+            try {
+                eval.done = eval.code->evaluate(eval.value);
+            }
+            catch (...) {
+                // Recomputed by recomputeCell(), which reports the error
+                eval.done = false;
+            }
+        });
+    }
+
+    for (std::size_t i = 0; i < addresses.size(); ++i) {
+        CellAddress p = addresses[i];
+        FC_TRACE(p.toString());
+        if (!evaluations[i].done) {
+            recomputeCell(p);
+            continue;
+        }
+
+        const boost::any& value = evaluations[i].value;
+        Base::Quantity quantity;
+        if (value.type() == typeid(long)) {
+            quantity = Base::Quantity(static_cast<double>(boost::any_cast<long>(value)));
+        }
+        else if (value.type() == typeid(double)) {
+            quantity = Base::Quantity(boost::any_cast<double>(value));
+        }
+        else {
+            quantity = boost::any_cast<const Base::Quantity&>(value);
+        }
+        NumberExpression number(this, quantity);
+        setNumberProperty(p, &number);
+        cells.clearDirty(p);
+        cellErrors.erase(p);
+        cellUpdated(p);
+        ++parallelCellCount;
+    }
+}
+
 /**
  * @brief Recompute cell at address \a p.
  * @param p Address of cell.
@@ -1053,6 +1201,7 @@ void Sheet::updateBindings()
 DocumentObjectExecReturn* Sheet::execute()
 {
     updateBindings();
+    parallelCellCount = 0;
 
     // Get dirty cells that we have to recompute
     std::set<CellAddress> dirtyCells = cells.getDirty();
@@ -1063,50 +1212,66 @@ DocumentObjectExecReturn* Sheet::execute()
         dirtyCells.insert(cellError);
     }
 
-    DependencyList graph;
-    std::map<CellAddress, Vertex> VertexList;
-    std::map<Vertex, CellAddress> VertexIndexList;
+    // Collect the cells depending on the dirty cells, counting the dirty cells each one
+    // depends on
+    std::map<CellAddress, int> inDegree;
     std::deque<CellAddress> workQueue(dirtyCells.begin(), dirtyCells.end());
+    for (const auto& pos : dirtyCells) {
+        inDegree.emplace(pos, 0);
+    }
     while (!workQueue.empty()) {
         CellAddress currPos = workQueue.front();
         workQueue.pop_front();
 
-        // Insert into map of CellPos -> Index, if it doesn't exist already
-        auto res = VertexList.emplace(currPos, Vertex());
-        if (res.second) {
-            res.first->second = add_vertex(graph);
-            VertexIndexList[res.first->second] = currPos;
-        }
-
         // Process cells that depend on the current cell
-        for (auto& dep : providesTo(currPos)) {
-            auto resDep = VertexList.emplace(dep, Vertex());
-            if (resDep.second) {
-                resDep.first->second = add_vertex(graph);
-                VertexIndexList[resDep.first->second] = dep;
-                if (dirtyCells.insert(dep).second) {
-                    workQueue.push_back(dep);
-                }
+        for (const auto& dep : providesTo(currPos)) {
+            ++inDegree[dep];
+            if (dirtyCells.insert(dep).second) {
+                workQueue.push_back(dep);
             }
-            // Add edge to graph to signal dependency
-            add_edge(res.first->second, resDep.first->second, graph);
         }
     }
-    // Compute cells
-    std::list<Vertex> make_order;
-    // Sort graph topologically to find evaluation order
+    // Sort the cells topologically to find evaluation order, a cell is ready once all the
+    // dirty cells it depends on are computed. The cells are grouped in levels, the cells of a
+    // level only depend on cells of the previous levels.
+    std::vector<std::vector<CellAddress>> levels(1);
+    for (const auto& v : inDegree) {
+        if (v.second == 0) {
+            levels.back().push_back(v.first);
+        }
+    }
     try {
-        boost::topological_sort(graph, std::front_inserter(make_order));
-        // Recompute cells
+        std::size_t count = 0;
+        while (!levels.back().empty()) {
+            std::vector<CellAddress> next;
+            for (const auto& pos : levels.back()) {
+                for (const auto& dep : providesTo(pos)) {
+                    if (--inDegree[dep] == 0) {
+                        next.push_back(dep);
+                    }
+                }
+            }
+            count += levels.back().size();
+            std::sort(next.begin(), next.end());
+            levels.push_back(std::move(next));
+        }
+        levels.pop_back();
+        // Recompute cells, the ones that are neither part of a cycle nor depend on one
         FC_LOG("recomputing " << getFullName());
-        for (auto& pos : make_order) {
-            const auto& addr = VertexIndexList[pos];
-            FC_TRACE(addr.toString());
-            recomputeCell(addr);
+        for (const auto& level : levels) {
+            recomputeIndependentCells(level);
+        }
+        if (count != inDegree.size()) {
+            throw boost::not_a_dag();
         }
     }
     catch (std::exception&) {
-        for (auto& v : VertexList) {
+        for (auto& v : inDegree) {
+            // the cell was computed above
+            if (v.second == 0) {
+                dirtyCells.erase(v.first);
+                continue;
+            }
             Cell* cell = cells.getValue(v.first);
             // Mark as erroneous
             if (cell) {
@@ -1634,9 +1799,8 @@ std::set<std::string> Sheet::dependsOn(CellAddress address) const
 void Sheet::providesTo(CellAddress address, std::set<std::string>& result) const
 {
     std::string fullName = getFullName() + ".";
-    std::set<CellAddress> tmpResult = cells.getDeps(fullName + address.toString());
 
-    for (const auto& i : tmpResult) {
+    for (const auto& i : cells.getDependentCells(address)) {
         result.insert(fullName + i.toString());
     }
 }
@@ -1647,9 +1811,9 @@ void Sheet::providesTo(CellAddress address, std::set<std::string>& result) const
  * @param result Set of links.
  */
 
-std::set<CellAddress> Sheet::providesTo(CellAddress address) const
+const std::set<CellAddress>& Sheet::providesTo(CellAddress address) const
 {
-    return cells.getDeps(getFullName() + "." + address.toString());
+    return cells.getDependentCells(address);
 }
 
 void Sheet::onDocumentRestored()
@@ -45,6 +45,11 @@
 #include "PropertyRowHeights.h"
 #include "PropertySheet.h"
 
+namespace App
+{
+class NumberExpression;
+}
+
 
 namespace Spreadsheet
 {
@@ -200,6 +205,12 @@ public:
 
     App::DocumentObjectExecReturn* execute() override;
 
+    /// Number of cells the last execute() evaluated in parallel
+    std::size_t getParallelCellCount() const
+    {
+        return parallelCellCount;
+    }
+
     bool getCellAddress(const App::Property* prop, App::CellAddress& address);
 
     App::CellAddress getCellAddress(const char* name, bool silent = false) const;
@@ -246,12 +257,14 @@ protected:
 
     void updateColumnsOrRows(bool horizontal, int section, int count);
 
-    std::set<App::CellAddress> providesTo(App::CellAddress address) const;
+    const std::set<App::CellAddress>& providesTo(App::CellAddress address) const;
 
     void onDocumentRestored() override;
 
     void recomputeCell(App::CellAddress p);
 
+    void recomputeIndependentCells(const std::vector<App::CellAddress>& addresses);
+
     App::Property* getProperty(App::CellAddress key) const;
 
     App::Property* getProperty(const char* addr) const;
@@ -268,6 +281,8 @@ protected:
 
     App::Property* setQuantityProperty(App::CellAddress key, double value, const Base::Unit& unit);
 
+    void setNumberProperty(App::CellAddress key, const App::NumberExpression* number);
+
     void onSettingDocument() override;
 
     void updateBindings();
@@ -299,6 +314,8 @@ protected:
     int currentRow = -1;
     int currentCol = -1;
 
+    std::size_t parallelCellCount = 0;
+
     std::vector<App::Range> boundRanges;
 
     std::vector<App::Range> copyCutRanges;
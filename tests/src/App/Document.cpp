@@ -5,9 +5,17 @@
 
 #include "App/Application.h"
 #include "App/Document.h"
+#include "App/DocumentObject.h"
+#include "App/Expression.h"
+#include "App/FeatureTest.h"
+#include "App/ObjectIdentifier.h"
 #include "App/StringHasher.h"
+#include "Base/BinaryXML.h"
+#include "Base/FileInfo.h"
 #include "Base/Writer.h"
+#include <memory>
 #include <src/App/InitApplication.h>
+#include <zipios++/zipfile.h>
 
 using ::testing::Eq;
 using ::testing::Ne;
@@ -94,4 +102,274 @@ TEST_F(DocumentTest, getStringHasherGivesExpectedHasher)
     EXPECT_EQ(hasher, foundHasher);
 }
 
+TEST_F(DocumentTest, recomputeStatsCountsExecutedObjects)
+{
+    // Arrange
+    doc()->addObject("App::FeatureTest");
+    doc()->addObject("App::FeatureTest");
+
+    // Act
+    int count = doc()->recompute();
+    const auto& stats = doc()->getRecomputeStats();
+
+    // Assert
+    EXPECT_EQ(stats.objectCount, count);
+    EXPECT_EQ(stats.parallelCount, 0);
+    EXPECT_LE(stats.criticalPathTime, stats.serialTime);
+}
+
+TEST_F(DocumentTest, parallelRecomputeExecutesAllObjects)
+{
+    // Arrange
+    auto hGrp = App::GetApplication().GetParameterGroupByPath(
+        "User parameter:BaseApp/Preferences/Document");
+    bool oldValue = hGrp->GetBool("ParallelRecompute", false);
+    hGrp->SetBool("ParallelRecompute", true);
+    auto first = doc()->addObject("App::FeatureTest");
+    auto second = doc()->addObject("App::FeatureTest");
+
+    // Act
+    int count = doc()->recompute();
+    hGrp->SetBool("ParallelRecompute", oldValue);
+
+    // Assert
+    EXPECT_EQ(count, 2);
+    EXPECT_FALSE(first->isTouched());
+    EXPECT_FALSE(second->isTouched());
+    EXPECT_EQ(doc()->getRecomputeStats().objectCount, 2);
+}
+
+TEST_F(DocumentTest, parallelRecomputeRunsObjectsOnWorkers)
+{
+    // Arrange
+    auto hGrp = App::GetApplication().GetParameterGroupByPath(
+        "User parameter:BaseApp/Preferences/Document");
+    bool oldValue = hGrp->GetBool("ParallelRecompute", false);
+    hGrp->SetBool("ParallelRecompute", true);
+    // two levels of two independent objects each
+    std::vector<App::FeatureTestParallel*> objects;
+    for (int i = 0; i < 4; ++i) {
+        objects.push_back(
+            static_cast<App::FeatureTestParallel*>(doc()->addObject("App::FeatureTestParallel")));
+        objects.back()->Value.setValue(i + 1);
+    }
+    objects[2]->Source.setValue(objects[0]);
+    objects[3]->Source.setValue(objects[1]);
+
+    // Act
+    int count = doc()->recompute();
+    hGrp->SetBool("ParallelRecompute", oldValue);
+
+    // Assert
+    EXPECT_EQ(count, 4);
+    EXPECT_EQ(doc()->getRecomputeStats().parallelCount, 4);
+    for (auto obj : objects) {
+        EXPECT_TRUE(obj->Worker.getValue()) << obj->getNameInDocument();
+        EXPECT_FALSE(obj->isTouched());
+    }
+    EXPECT_EQ(objects[0]->Result.getValue(), 1);
+    EXPECT_EQ(objects[1]->Result.getValue(), 2);
+    EXPECT_EQ(objects[2]->Result.getValue(), 4);
+    EXPECT_EQ(objects[3]->Result.getValue(), 6);
+    EXPECT_FALSE(App::Document::isRecomputeWorker());
+}
+
+TEST_F(DocumentTest, parallelRecomputeHasSameStringTableAsSerial)
+{
+    // Arrange
+    auto hGrp = App::GetApplication().GetParameterGroupByPath(
+        "User parameter:BaseApp/Preferences/Document");
+    bool oldValue = hGrp->GetBool("ParallelRecompute", false);
+    // The objects intern the same strings and some of their own, the later
+    // objects are done with the unlocked part first
+    auto savedTable = [&hGrp](App::Document* document, bool parallel) {
+        hGrp->SetBool("ParallelRecompute", parallel);
+        for (int i = 0; i < 4; ++i) {
+            auto obj = static_cast<App::FeatureTestParallel*>(
+                document->addObject("App::FeatureTestParallel"));
+            obj->Delay.setValue(40 - 10 * i);
+            obj->Strings.setValues(
+                std::vector<std::string> {"shared1", "own" + std::to_string(i), "shared2"});
+        }
+        document->recompute();
+        App::StringHasherRef hasher = document->getStringHasher();
+        hasher->setSaveAll(true);
+        hasher->setPersistenceFileName(nullptr);
+        Base::StringWriter writer;
+        hasher->Save(writer);
+        return writer.getString();
+    };
+    std::string name = App::GetApplication().getUniqueDocumentName("serial");
+    auto serialDoc = App::GetApplication().newDocument(name.c_str(), "testUser");
+
+    // Act
+    std::string parallel = savedTable(doc(), true);
+    std::string serial = savedTable(serialDoc, false);
+    hGrp->SetBool("ParallelRecompute", oldValue);
+    App::GetApplication().closeDocument(name.c_str());
+
+    // Assert
+    EXPECT_EQ(doc()->getRecomputeStats().parallelCount, 4);
+    EXPECT_EQ(parallel, serial);
+}
+
+TEST_F(DocumentTest, recomputeOnlyExecutesTouchedObjectsAndDependents)
+{
+    // Arrange
+    auto child = static_cast<App::FeatureTest*>(doc()->addObject("App::FeatureTest"));
+    auto parent = static_cast<App::FeatureTest*>(doc()->addObject("App::FeatureTest"));
+    auto other = static_cast<App::FeatureTest*>(doc()->addObject("App::FeatureTest"));
+    parent->Source1.setValue(child);
+    doc()->recompute();
+    int otherCount = other->ExecCount.getValue();
+
+    // Act
+    child->Integer.setValue(child->Integer.getValue() + 1);
+    int count = doc()->recompute();
+
+    // Assert
+    EXPECT_EQ(count, 2);
+    EXPECT_EQ(other->ExecCount.getValue(), otherCount);
+    EXPECT_FALSE(parent->isTouched());
+}
+
+TEST_F(DocumentTest, recomputeWithoutChangesVisitsNothing)
+{
+    // Arrange
+    auto child = static_cast<App::FeatureTest*>(doc()->addObject("App::FeatureTest"));
+    auto parent = static_cast<App::FeatureTest*>(doc()->addObject("App::FeatureTest"));
+    parent->Source1.setValue(child);
+    doc()->recompute();
+    child->Integer.setValue(child->Integer.getValue() + 1);
+    doc()->recompute();
+    std::vector<App::DocumentObject*> visited {child};
+    auto conn = doc()->signalRecomputed.connect(
+        [&visited](const App::Document&, const std::vector<App::DocumentObject*>& objs) {
+            visited = objs;
+        });
+
+    // Act
+    int count = doc()->recompute();
+
+    // Assert
+    EXPECT_EQ(count, 0);
+    EXPECT_TRUE(visited.empty());
+    conn.disconnect();
+}
+
+TEST_F(DocumentTest, recomputeFollowsChangedLinks)
+{
+    // Arrange
+    auto first = static_cast<App::FeatureTest*>(doc()->addObject("App::FeatureTest"));
+    auto second = static_cast<App::FeatureTest*>(doc()->addObject("App::FeatureTest"));
+    doc()->recompute();
+    second->Source1.setValue(first);
+    doc()->recompute();
+    int secondCount = second->ExecCount.getValue();
+
+    // Act
+    first->touch();
+    doc()->recompute();
+
+    // Assert
+    EXPECT_EQ(second->ExecCount.getValue(), secondCount + 1);
+}
+
+TEST_F(DocumentTest, getExpressionDependents)
+{
+    // Arrange
+    auto first = static_cast<App::FeatureTest*>(doc()->addObject("App::FeatureTest"));
+    auto second = static_cast<App::FeatureTest*>(doc()->addObject("App::FeatureTest"));
+    auto third = static_cast<App::FeatureTest*>(doc()->addObject("App::FeatureTest"));
+    auto bind = [](App::DocumentObject* obj, App::Property& prop, const std::string& text) {
+        std::shared_ptr<App::Expression> expr(App::Expression::parse(obj, text));
+        obj->setExpression(App::ObjectIdentifier(prop), expr);
+    };
+    bind(second, second->Integer, std::string(first->getNameInDocument()) + ".Integer * 2");
+    bind(third, third->Float, std::string(second->getNameInDocument()) + ".Integer + 1");
+
+    // Act
+    auto direct = doc()->getExpressionDependents(first, "Integer");
+    auto recursive = doc()->getExpressionDependents(first, "Integer", true);
+    auto other = doc()->getExpressionDependents(first, "Float");
+
+    // Assert
+    ASSERT_EQ(direct.size(), 1U);
+    EXPECT_EQ(direct[0].first, second);
+    EXPECT_EQ(direct[0].second.getPropertyName(), "Integer");
+    ASSERT_EQ(recursive.size(), 2U);
+    EXPECT_EQ(recursive[1].first, third);
+    EXPECT_TRUE(other.empty());
+
+    // The index follows the changes of the expressions and objects
+    second->setExpression(App::ObjectIdentifier(second->Integer), nullptr);
+    EXPECT_TRUE(doc()->getExpressionDependents(first).empty());
+    doc()->removeObject(third->getNameInDocument());
+    EXPECT_TRUE(doc()->getExpressionDependents(second).empty());
+}
+
+TEST_F(DocumentTest, binaryDocumentRoundTrip)
+{
+    // Arrange
+    auto hGrp = App::GetApplication().GetParameterGroupByPath(
+        "User parameter:BaseApp/Preferences/Document");
+    bool oldValue = hGrp->GetBool("SaveBinaryDocument", false);
+    auto obj = static_cast<App::FeatureTest*>(doc()->addObject("App::FeatureTest", "Values"));
+    // Values that need escaping in attributes and character data
+    obj->StringList.setValues(
+        std::vector<std::string> {"a & b", "<c>", "\"quoted\"\nline", "tab\tend"});
+    obj->IntegerList.setValues({1, -2, 3});
+    obj->FloatList.setValues({0.5, -1.25, 1e-9});
+    obj->Vector.setValue(Base::Vector3d(1.5, -2.5, 3.5));
+    obj->VectorList.setValues({Base::Vector3d(1, 2, 3), Base::Vector3d(-4, 5, -6)});
+    obj->Matrix.setValue(Base::Matrix4D(1.0, 0.0, 0.0, 2.0,
+                                        0.0, 0.0, -1.0, 3.0,
+                                        0.0, 1.0, 0.0, 4.0,
+                                        0.0, 0.0, 0.0, 1.0));
+    Base::FileInfo file(Base::FileInfo::getTempFileName() + ".FCStd");
+
+    // Act
+    hGrp->SetBool("SaveBinaryDocument", true);
+    bool saved = doc()->saveCopy(file.filePath().c_str());
+    hGrp->SetBool("SaveBinaryDocument", oldValue);
+    bool binary = false;
+    {
+        zipios::ZipFile zip(file.filePath());
+        std::unique_ptr<std::istream> str(zip.getInputStream("Document.xml"));
+        binary = str && Base::BinaryXML::isBinaryXML(*str);
+    }
+    App::Document* reopened = App::GetApplication().openDocument(file.filePath().c_str());
+    auto copy = reopened ? dynamic_cast<App::FeatureTest*>(reopened->getObject("Values"))
+                         : nullptr;
+    std::vector<std::string> stringList;
+    std::vector<long> integerList;
+    std::vector<double> floatList;
+    Base::Vector3d vector;
+    std::vector<Base::Vector3d> vectorList;
+    Base::Matrix4D matrix;
+    if (copy) {
+        stringList = copy->StringList.getValues();
+        integerList = copy->IntegerList.getValues();
+        floatList = copy->FloatList.getValues();
+        vector = copy->Vector.getValue();
+        vectorList = copy->VectorList.getValues();
+        matrix = copy->Matrix.getValue();
+    }
+    if (reopened) {
+        App::GetApplication().closeDocument(reopened->getName());
+    }
+    file.deleteFile();
+
+    // Assert
+    EXPECT_TRUE(saved);
+    EXPECT_TRUE(binary);
+    ASSERT_TRUE(copy);
+    EXPECT_EQ(stringList, obj->StringList.getValues());
+    EXPECT_EQ(integerList, obj->IntegerList.getValues());
+    EXPECT_EQ(floatList, obj->FloatList.getValues());
+    EXPECT_EQ(vector, obj->Vector.getValue());
+    EXPECT_EQ(vectorList, obj->VectorList.getValues());
+    EXPECT_EQ(matrix, obj->Matrix.getValue());
+}
+
 // NOLINTEND(readability-magic-numbers)
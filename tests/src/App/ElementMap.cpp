@@ -94,6 +94,25 @@ TEST_F(ElementMapTest, setElementNameDefaults)
     EXPECT_EQ(mappedToElement, mappedName);
 }
 
+TEST_F(ElementMapTest, findNameWithDifferentPostfixSplit)
+{
+    // Arrange
+    Data::ElementMap elementMap;
+    elementMap.reserve(2);
+    Data::IndexedName element("Edge", 1);
+    Data::MappedName mappedName("TE");
+    mappedName += "ST";
+    Data::MappedName sameName("TEST");
+
+    // Act
+    elementMap.setElementName(element, mappedName, 0);
+    auto found = elementMap.find(sameName);
+
+    // Assert
+    EXPECT_EQ(found, element);
+    EXPECT_EQ(elementMap.size(), 1);
+}
+
 TEST_F(ElementMapTest, setElementNameNoOverwrite)
 {
     // Arrange
@@ -1,12 +1,21 @@
 #include <gtest/gtest.h>
 
+#include <chrono>
+#include <iostream>
+#include <string>
+
+#include "Base/Exception.h"
+#include "Base/Interpreter.h"
 #include "Base/Quantity.h"
 
 #include "App/Application.h"
 #include "App/Document.h"
+#include "App/CompiledExpression.h"
 #include "App/DocumentObject.h"
 #include "App/Expression.h"
 #include "App/ExpressionParser.h"
+#include "App/ObjectIdentifier.h"
+#include "App/PropertyStandard.h"
 
 #include "src/App/InitApplication.h"
 
@@ -49,6 +58,12 @@ protected:
         return quantity_result;
     }
 
+    // The value computed by Python, the way getValueAsAny() did before expressions were compiled
+    static App::any python_value(const App::Expression* expression) {
+        Base::PyGILStateLocker lock;
+        return App::pyObjectToAny(expression->getPyValue());
+    }
+
 private:
     std::string _doc_name;
     App::Document* _this_doc {};
@@ -117,4 +132,66 @@ TEST_F(ExpressionParserTest, isTokenAConstant)
     }
 }
 
+TEST_F(ExpressionParserTest, compiledSameAsPython)
+{
+    auto prop = this_obj()->addDynamicProperty("App::PropertyFloat", "Value");
+    static_cast<App::PropertyFloat*>(prop)->setValue(2.5);
+
+    std::array<const char*, 25> numeric_expressions {
+        "1 + 2 * 3", "7 / 2", "7 % 3", "-7 % 3", "2 ^ 10", "2 ^ -1", "1.5 * 4",
+        "1 mm + 2 cm", "10 mm * 2", "3 m / 2 s", "(1 mm) ^ 2", "-(2 deg)",
+        "1 < 2", "2 mm > 1 cm", "1 == 1.0", "1 < 2 ? 3 mm : 4 mm", "0 ? 1 : 2.5",
+        "sin(30 deg)", "sqrt(4 mm^2)", "max(1 mm, 2 mm, 3 mm)", "min(2 mm, 1 cm)",
+        "sum(1, 2.5, Value)", "average(1, 2, 4)", "Value * 2", "Value > 2 ? pi : e",
+    };
+    for (auto expression_text : numeric_expressions) {
+        auto expression = App::ExpressionParser::parse(this_obj(), expression_text);
+        EXPECT_NE(expression->getCompiled(), nullptr) << expression_text;
+        auto compiled = expression->getValueAsAny();
+        auto python = python_value(expression.get());
+        EXPECT_EQ(compiled.type(), python.type()) << expression_text;
+        EXPECT_TRUE(App::isAnyEqual(compiled, python)) << expression_text;
+    }
+
+    // Errors are reported by Python
+    auto mismatch = App::ExpressionParser::parse(this_obj(), "1 mm + 1 s");
+    try {
+        mismatch->getValueAsAny();
+        ADD_FAILURE() << "no unit mismatch reported";
+    }
+    catch (const Base::Exception& e) {
+        EXPECT_NE(std::string(e.what()).find("Unit mismatch"), std::string::npos) << e.what();
+    }
+    auto division = App::ExpressionParser::parse(this_obj(), "1 / 0");
+    EXPECT_THROW(division->getValueAsAny(), Base::Exception);
+
+    // Strings have no native form
+    auto text = App::ExpressionParser::parse(this_obj(), "<<abc>>");
+    EXPECT_EQ(text->getCompiled(), nullptr);
+}
+
+TEST_F(ExpressionParserTest, DISABLED_benchmarkCompiled)
+{
+    auto prop = this_obj()->addDynamicProperty("App::PropertyFloat", "Value");
+    static_cast<App::PropertyFloat*>(prop)->setValue(2.5);
+    auto expression = App::ExpressionParser::parse(this_obj(),
+        "Value > 1 ? sqrt((Value * 2 mm + 3 cm) ^ 2) / 4 + sin(30 deg) * 1 mm : 0 mm");
+    const int count = 100000;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < count; i++) {
+        python_value(expression.get());
+    }
+    auto middle = std::chrono::steady_clock::now();
+    for (int i = 0; i < count; i++) {
+        expression->getValueAsAny();
+    }
+    auto end = std::chrono::steady_clock::now();
+    using std::chrono::duration_cast;
+    using std::chrono::milliseconds;
+    std::cout << "Python: " << duration_cast<milliseconds>(middle - start).count() << " ms, "
+              << "compiled: " << duration_cast<milliseconds>(end - middle).count() << " ms"
+              << std::endl;
+}
+
 // clang-format on
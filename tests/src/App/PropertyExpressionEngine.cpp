@@ -8,6 +8,7 @@
 #include "App/Expression.h"
 #include "App/ObjectIdentifier.h"
 #include "App/PropertyExpressionEngine.h"
+#include "App/PropertyStandard.h"
 
 #include "src/App/InitApplication.h"
 
@@ -90,4 +91,38 @@ TEST_F(PropertyExpressionEngineTest, executeCrossPropertyReference)
     ;
 }
 
+TEST_F(PropertyExpressionEngineTest, executeCachedOrder)
+{
+    auto first = static_cast<App::PropertyFloat*>(this_obj()->addDynamicProperty("App::PropertyFloat", "First"));
+    auto second = static_cast<App::PropertyFloat*>(this_obj()->addDynamicProperty("App::PropertyFloat", "Second"));
+    auto third = static_cast<App::PropertyFloat*>(this_obj()->addDynamicProperty("App::PropertyFloat", "Third"));
+    auto bind = [this](const char* name, const char* text) {
+        auto path = App::ObjectIdentifier::parse(this_obj(), name);
+        this_obj()->setExpression(path, std::shared_ptr<App::Expression>(App::Expression::parse(this_obj(), text)));
+    };
+
+    bind("Third", "Second * 2");
+    bind("Second", "First + 1");
+    first->setValue(1.0);
+    this_obj()->ExpressionEngine.execute();
+    EXPECT_DOUBLE_EQ(second->getValue(), 2.0);
+    EXPECT_DOUBLE_EQ(third->getValue(), 4.0);
+
+    // The cached order is used as long as the expressions don't change
+    first->setValue(2.0);
+    this_obj()->ExpressionEngine.execute();
+    EXPECT_DOUBLE_EQ(third->getValue(), 6.0);
+
+    // A changed expression reverses the dependency
+    bind("Third", "10");
+    bind("Second", "Third + 1");
+    bind("First", "Second * 2");
+    this_obj()->ExpressionEngine.execute();
+    EXPECT_DOUBLE_EQ(second->getValue(), 11.0);
+    EXPECT_DOUBLE_EQ(first->getValue(), 22.0);
+
+    // A cyclic reference is still rejected
+    EXPECT_ANY_THROW(bind("Third", "First"));
+}
+
 // clang-format on
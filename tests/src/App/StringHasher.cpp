@@ -9,6 +9,7 @@
 
 #include <QCryptographicHash>
 #include <array>
+#include <thread>
 
 class StringIDTest: public ::testing::Test
 {
@@ -1281,6 +1282,33 @@ TEST_F(StringHasherTest, getIDFromQByteArrayTwoIdenticalStrings)  // NOLINT
     EXPECT_EQ(idA.dataToText(), idB.dataToText());
 }
 
+TEST_F(StringHasherTest, getIDFromQByteArrayConcurrently)  // NOLINT
+{
+    // Arrange
+    const int numThreads {4};
+    const int numStrings {200};
+    std::vector<std::vector<long>> ids(numThreads);
+
+    // Act
+    std::vector<std::thread> threads;
+    for (int i = 0; i < numThreads; ++i) {
+        threads.emplace_back([this, &ids, i]() {
+            for (int j = 0; j < numStrings; ++j) {
+                ids[i].push_back(Hasher()->getID(QByteArray::number(j)).value());
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    // Assert
+    EXPECT_EQ(numStrings, Hasher()->size());
+    for (int i = 1; i < numThreads; ++i) {
+        EXPECT_EQ(ids[0], ids[i]);
+    }
+}
+
 TEST_F(StringHasherTest, getIDFromQByteArrayBinaryFlag)  // NOLINT
 {
     // Arrange
@@ -6,12 +6,14 @@
 #pragma warning(disable : 4996)
 #endif
 
+#include "Base/BinaryXML.h"
 #include "Base/Exception.h"
 #include "Base/Reader.h"
 #include <array>
 #include <filesystem>
 #include <fstream>
 #include <random>
+#include <sstream>
 #include <string>
 #include <xercesc/util/PlatformUtils.hpp>
 
@@ -70,6 +72,21 @@ public:
         _reader = std::make_unique<Base::XMLReader>(_tempFile.string().c_str(), inputStream);
     }
 
+    void givenDataAsBinaryXMLStream(const std::string& data)
+    {
+        auto stringData =
+            R"(<?xml version="1.0" encoding="UTF-8"?><document>)" + data + "</document>";
+        std::ofstream fileStream(_tempFile.string(), std::ios::binary);
+        {
+            Base::BinaryXMLEncoder encoder(fileStream);
+            std::ostream stream(&encoder);
+            stream << stringData;
+        }
+        fileStream.close();
+        inputStream.open(_tempFile.string(), std::ios::binary);
+        _reader = std::make_unique<Base::XMLReader>(_tempFile.string().c_str(), inputStream);
+    }
+
 private:
     std::unique_ptr<Base::XMLReader> _reader;
     fs::path _tempDir;
@@ -387,3 +404,82 @@ TEST_F(ReaderTest, invalidDefaults)
         { xml.Reader()->getAttributeAsInteger("missing", "Not a Float"); },
         std::invalid_argument);
 }
+
+TEST_F(ReaderTest, binaryReadElementsAndAttributes)
+{
+    // Arrange
+    auto xmlBody = R"(
+<node1 attr='1' text="a &amp; b &lt;c&gt;"/>
+<node2 attr='2'>
+    <node3/>
+</node2>
+)";
+
+    ReaderXML xml;
+    xml.givenDataAsBinaryXMLStream(xmlBody);
+
+    // Act
+    xml.Reader()->readElement("node1");
+    long value1 = xml.Reader()->getAttributeAsInteger("attr");
+    std::string text = xml.Reader()->getAttribute("text");
+    xml.Reader()->readElement("node2");
+    long value2 = xml.Reader()->getAttributeAsInteger("attr");
+    xml.Reader()->readElement("node3");
+    xml.Reader()->readEndElement("node2");
+
+    // Assert
+    EXPECT_TRUE(xml.Reader()->isBinary());
+    EXPECT_EQ(value1, 1);
+    EXPECT_EQ(text, "a & b <c>");
+    EXPECT_EQ(value2, 2);
+    EXPECT_TRUE(xml.Reader()->isEndOfElement());
+}
+
+TEST_F(ReaderTest, binaryCharStream)
+{
+    // Arrange
+    ReaderXML xml;
+    xml.givenDataAsBinaryXMLStream("<data>Test ASCII data</data>");
+    xml.Reader()->readElement("data");
+
+    // Act
+    std::string result;
+    std::getline(xml.Reader()->beginCharStream(), result);
+
+    // Assert
+    EXPECT_EQ(result, "Test ASCII data");
+}
+
+TEST_F(ReaderTest, binaryCharacterReferences)
+{
+    // Arrange
+    ReaderXML xml;
+    xml.givenDataAsBinaryXMLStream(R"(<node text="&#65;&#x42;&#X43;&#x20AC;"/>)");
+
+    // Act
+    xml.Reader()->readElement("node");
+    std::string text = xml.Reader()->getAttribute("text");
+
+    // Assert
+    EXPECT_EQ(text, "ABC\xE2\x82\xAC");
+}
+
+TEST_F(ReaderTest, binaryMalformedCharacterReferences)
+{
+    // Arrange
+    std::ostringstream out;
+    auto encode = [&out](const std::string& data) {
+        Base::BinaryXMLEncoder encoder(out);
+        encoder.sputn(data.data(), static_cast<std::streamsize>(data.size()));
+        encoder.finish();
+    };
+
+    // Act and Assert
+    EXPECT_THROW(encode(R"(<node text="&#;"/>)"), Base::XMLParseException);
+    EXPECT_THROW(encode(R"(<node text="&#x;"/>)"), Base::XMLParseException);
+    EXPECT_THROW(encode(R"(<node text="&#12a;"/>)"), Base::XMLParseException);
+    EXPECT_THROW(encode(R"(<node text="&#xZZ;"/>)"), Base::XMLParseException);
+    EXPECT_THROW(encode(R"(<node text="&#99999999999999999999999;"/>)"),
+                 Base::XMLParseException);
+    EXPECT_THROW(encode("<node>&#x110000;</node>"), Base::XMLParseException);
+}
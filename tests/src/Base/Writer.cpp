@@ -2,7 +2,17 @@
 
 #include <gtest/gtest.h>
 
+#include <iterator>
+#include <memory>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <zipios++/zipinputstream.h>
+
 #include "Base/Exception.h"
+#include "Base/Persistence.h"
+#include "Base/Reader.h"
 #include "Base/Writer.h"
 
 // Writer is designed to be a base class, so for testing we actually instantiate a StringWriter,
@@ -129,3 +139,108 @@ TEST_F(WriterTest, charStreamBase64Encoded)
     // Conversion done using https://www.base64encode.org for testing purposes
     EXPECT_EQ(std::string("RnJlZUNBRCByb2NrcyEg8J+qqPCfqqjwn6qo\n"), _writer.getString());
 }
+
+// A persistent object saving its data to a file, and optionally adding a nested file while
+// saving it
+class DocFile: public Base::Persistence
+{
+public:
+    explicit DocFile(std::string data = {}, const DocFile* nested = nullptr)
+        : data(std::move(data))
+        , nested(nested)
+    {}
+
+    unsigned int getMemSize() const override
+    {
+        return static_cast<unsigned int>(data.size());
+    }
+    void Save(Base::Writer& writer) const override
+    {
+        writer.Stream() << writer.ind() << "<File name=\"" << writer.addFile("data.bin", this)
+                        << "\"/>" << std::endl;
+    }
+    void Restore(Base::XMLReader& reader) override
+    {
+        reader.readElement("File");
+        reader.addFile(reader.getAttribute("name"), this);
+    }
+    void SaveDocFile(Base::Writer& writer) const override
+    {
+        writer.Stream() << data;
+        if (nested) {
+            writer.addFile("data.bin", nested);
+        }
+    }
+    void RestoreDocFile(Base::Reader& reader) override
+    {
+        data.assign(std::istreambuf_iterator<char>(reader), std::istreambuf_iterator<char>());
+    }
+    bool canSaveDocFileInThread(const Base::Writer& /*writer*/) const override
+    {
+        return true;
+    }
+
+    std::string data;       // NOLINT
+    const DocFile* nested;  // NOLINT
+};
+
+TEST(ZipWriterTest, writeFilesInThreadsRoundTrip)  // NOLINT
+{
+    // Arrange
+    const int count = 20;
+    std::vector<std::unique_ptr<DocFile>> nested;
+    std::vector<std::unique_ptr<DocFile>> files;
+    for (int i = 0; i < count; ++i) {
+        nested.push_back(std::make_unique<DocFile>("nested " + std::to_string(i)));
+        files.push_back(std::make_unique<DocFile>(std::string(1000 * (i + 1), char('a' + i)),
+                                                  nested.back().get()));
+    }
+    std::stringstream stream;
+
+    // Act
+    {
+        Base::ZipWriter writer(stream);
+        writer.setThreads(4);
+        writer.putNextEntry("Persistence.xml");
+        writer.Stream() << "<Content>" << std::endl;
+        for (const auto& file : files) {
+            file->Save(writer);
+        }
+        writer.Stream() << "</Content>";
+        writer.writeFiles();
+    }
+
+    std::vector<std::unique_ptr<DocFile>> restored;
+    {
+        zipios::ZipInputStream zipstream(stream);
+        Base::XMLReader reader("", zipstream);
+        reader.readElement("Content");
+        for (int i = 0; i < count; ++i) {
+            restored.push_back(std::make_unique<DocFile>());
+            restored.back()->Restore(reader);
+        }
+        reader.readFiles(zipstream);
+    }
+
+    std::vector<std::string> names {"Persistence.xml"};
+    {
+        std::istringstream copy(stream.str());
+        zipios::ZipInputStream zipstream(copy);
+        try {
+            for (auto entry = zipstream.getNextEntry(); entry && entry->isValid();
+                 entry = zipstream.getNextEntry()) {
+                names.push_back(entry->getName());
+            }
+        }
+        catch (const std::exception&) {  // NOLINT(bugprone-empty-catch)
+            // no further entry
+        }
+    }
+
+    // Assert
+    for (int i = 0; i < count; ++i) {
+        EXPECT_EQ(restored[i]->data, files[i]->data);
+    }
+    EXPECT_EQ(names.size(), static_cast<std::size_t>(1 + 2 * count));
+    EXPECT_EQ(std::set<std::string>(names.begin(), names.end()).size(), names.size());
+}
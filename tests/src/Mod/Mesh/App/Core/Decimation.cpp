@@ -0,0 +1,164 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <vector>
+#include <Mod/Mesh/App/Core/Decimation.h>
+#include <Mod/Mesh/App/Core/Degeneration.h>
+#include <Mod/Mesh/App/Core/Evaluation.h>
+#include <Mod/Mesh/App/Core/MeshKernel.h>
+
+// NOLINTBEGIN(cppcoreguidelines-*,readability-*)
+
+class DecimationTest: public ::testing::Test
+{
+protected:
+    // A wavy square surface with 2 * size * size facets
+    static void createSurface(MeshCore::MeshKernel& kernel, int size)
+    {
+        MeshCore::MeshPointArray points;
+        for (int i = 0; i <= size; i++) {
+            for (int j = 0; j <= size; j++) {
+                float z = 0.1F * float(size) * std::sin(0.05F * float(i))
+                    * std::cos(0.07F * float(j));
+                points.push_back(Base::Vector3f(float(i), float(j), z));
+            }
+        }
+
+        auto index = [size](int i, int j) {
+            return MeshCore::PointIndex(i * (size + 1) + j);
+        };
+        MeshCore::MeshFacetArray facets;
+        for (int i = 0; i < size; i++) {
+            for (int j = 0; j < size; j++) {
+                facets.emplace_back(index(i, j), index(i + 1, j), index(i + 1, j + 1));
+                facets.emplace_back(index(i, j), index(i + 1, j + 1), index(i, j + 1));
+            }
+        }
+
+        kernel.Adopt(points, facets, true);
+    }
+
+    static bool isValid(const MeshCore::MeshKernel& kernel)
+    {
+        MeshCore::MeshEvalRangePoint range(kernel);
+        MeshCore::MeshEvalTopology topology(kernel);
+        return range.Evaluate() && topology.Evaluate();
+    }
+};
+
+TEST_F(DecimationTest, testSerial)
+{
+    MeshCore::MeshKernel kernel;
+    createSurface(kernel, 100);
+    MeshCore::MeshSimplify simplify(kernel);
+    EXPECT_TRUE(simplify.simplify(2000));
+    EXPECT_LE(kernel.CountFacets(), 2000U);
+    EXPECT_GT(kernel.CountFacets(), 1000U);
+    EXPECT_TRUE(isValid(kernel));
+}
+
+TEST_F(DecimationTest, testParallel)
+{
+    MeshCore::MeshKernel kernel;
+    createSurface(kernel, 100);
+    Base::BoundBox3f box = kernel.GetBoundBox();
+    MeshCore::MeshSimplify simplify(kernel);
+    simplify.setChunks(4);
+    EXPECT_TRUE(simplify.simplify(2000));
+    EXPECT_LE(kernel.CountFacets(), 2000U);
+    EXPECT_GT(kernel.CountFacets(), 1000U);
+    EXPECT_TRUE(isValid(kernel));
+    // The borders of the surface are kept
+    EXPECT_FLOAT_EQ(kernel.GetBoundBox().LengthX(), box.LengthX());
+    EXPECT_FLOAT_EQ(kernel.GetBoundBox().LengthY(), box.LengthY());
+}
+
+TEST_F(DecimationTest, testAttributes)
+{
+    MeshCore::MeshKernel kernel;
+    createSurface(kernel, 50);
+    std::vector<Base::Vector3f> colors;
+    for (const auto& point : kernel.GetPoints()) {
+        colors.emplace_back(point.x < 25.0F ? 1.0F : 0.0F, 0.0F, 0.0F);
+    }
+
+    MeshCore::MeshSimplify simplify(kernel);
+    simplify.setChunks(2);
+    simplify.setPointAttributes(&colors, 1.0F);
+    EXPECT_TRUE(simplify.simplify(1000));
+    EXPECT_EQ(colors.size(), kernel.CountPoints());
+    for (const auto& color : colors) {
+        EXPECT_GE(color.x, 0.0F);
+        EXPECT_LE(color.x, 1.0F);
+    }
+}
+
+TEST_F(DecimationTest, testCancel)
+{
+    MeshCore::MeshKernel kernel;
+    createSurface(kernel, 100);
+    std::size_t numFacets = kernel.CountFacets();
+    for (std::size_t chunks : {1, 4}) {
+        MeshCore::MeshSimplify simplify(kernel);
+        simplify.setChunks(chunks);
+        simplify.setProgressHook([](float) {
+            return false;
+        });
+        EXPECT_FALSE(simplify.simplify(100));
+        EXPECT_EQ(kernel.CountFacets(), numFacets);
+    }
+}
+
+TEST_F(DecimationTest, testProgressOfParts)
+{
+    MeshCore::MeshKernel kernel;
+    createSurface(kernel, 100);
+    MeshCore::MeshSimplify simplify(kernel);
+    simplify.setChunks(4);
+    std::vector<float> values;
+    simplify.setProgressHook([&values](float value) {
+        values.push_back(value);
+        return true;
+    });
+    EXPECT_TRUE(simplify.simplify(2000));
+    // Before the parts are decimated and after each of them, however fast they are
+    ASSERT_GE(values.size(), 5U);
+    EXPECT_FLOAT_EQ(values.front(), 0.0F);
+}
+
+TEST_F(DecimationTest, testCancelAfterFirstPart)
+{
+    MeshCore::MeshKernel kernel;
+    createSurface(kernel, 100);
+    std::size_t numFacets = kernel.CountFacets();
+    MeshCore::MeshSimplify simplify(kernel);
+    simplify.setChunks(4);
+    // Only the call before the parts are decimated continues
+    int calls = 0;
+    simplify.setProgressHook([&calls](float) {
+        return ++calls == 1;
+    });
+    EXPECT_FALSE(simplify.simplify(100));
+    EXPECT_EQ(calls, 2);
+    EXPECT_EQ(kernel.CountFacets(), numFacets);
+}
+
+TEST_F(DecimationTest, DISABLED_benchmarkDecimation)
+{
+    // About 32 million facets
+    for (std::size_t chunks : {1, 0}) {
+        MeshCore::MeshKernel kernel;
+        createSurface(kernel, 4000);
+        MeshCore::MeshSimplify simplify(kernel);
+        simplify.setChunks(chunks);
+        auto start = std::chrono::steady_clock::now();
+        simplify.simplify(int(kernel.CountFacets() / 10));
+        auto end = std::chrono::steady_clock::now();
+        std::cout << (chunks == 1 ? "serial: " : "parallel: ")
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count()
+                  << " ms, " << kernel.CountFacets() << " facets" << std::endl;
+    }
+}
+
+// NOLINTEND(cppcoreguidelines-*,readability-*)
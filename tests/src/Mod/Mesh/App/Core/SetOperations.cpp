@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <numbers>
+#include <Mod/Mesh/App/Core/MeshKernel.h>
+#include <Mod/Mesh/App/Core/SetOperations.h>
+
+// NOLINTBEGIN(cppcoreguidelines-*,readability-*)
+
+class SetOperationsTest: public ::testing::Test
+{
+protected:
+    // A unit sphere around center with rings * 2 * rings facets
+    static void createSphere(MeshCore::MeshKernel& kernel, const Base::Vector3f& center, int rings)
+    {
+        const int segments = 2 * rings;
+        const float pi = std::numbers::pi_v<float>;
+        MeshCore::MeshPointArray points;
+        points.push_back(center + Base::Vector3f(0.0F, 0.0F, 1.0F));
+        for (int i = 1; i < rings; i++) {
+            float theta = pi * float(i) / float(rings);
+            for (int j = 0; j < segments; j++) {
+                float phi = 2.0F * pi * float(j) / float(segments);
+                points.push_back(center
+                                 + Base::Vector3f(std::sin(theta) * std::cos(phi),
+                                                  std::sin(theta) * std::sin(phi),
+                                                  std::cos(theta)));
+            }
+        }
+        points.push_back(center + Base::Vector3f(0.0F, 0.0F, -1.0F));
+
+        auto index = [segments](int i, int j) {
+            return MeshCore::PointIndex(1 + (i - 1) * segments + j % segments);
+        };
+        const auto south = MeshCore::PointIndex(points.size() - 1);
+        MeshCore::MeshFacetArray facets;
+        for (int j = 0; j < segments; j++) {
+            facets.emplace_back(0, index(1, j), index(1, j + 1));
+            for (int i = 1; i < rings - 1; i++) {
+                facets.emplace_back(index(i, j), index(i + 1, j), index(i + 1, j + 1));
+                facets.emplace_back(index(i, j), index(i + 1, j + 1), index(i, j + 1));
+            }
+            facets.emplace_back(index(rings - 1, j), south, index(rings - 1, j + 1));
+        }
+
+        kernel.Adopt(points, facets, true);
+    }
+
+    static Base::BoundBox3f
+    runOperation(MeshCore::SetOperations::OperationType type, int rings, std::size_t& numFacets)
+    {
+        MeshCore::MeshKernel sphere1, sphere2, result;
+        createSphere(sphere1, Base::Vector3f(0.0F, 0.0F, 0.0F), rings);
+        createSphere(sphere2, Base::Vector3f(1.0F, 0.0F, 0.0F), rings);
+        MeshCore::SetOperations setOp(sphere1, sphere2, result, type, 1.0e-5F);
+        setOp.Do();
+        numFacets = result.CountFacets();
+        return result.GetBoundBox();
+    }
+};
+
+TEST_F(SetOperationsTest, testUnion)
+{
+    std::size_t numFacets {};
+    Base::BoundBox3f box = runOperation(MeshCore::SetOperations::Union, 32, numFacets);
+    EXPECT_GT(numFacets, 0U);
+    EXPECT_NEAR(box.MinX, -1.0F, 0.01F);
+    EXPECT_NEAR(box.MaxX, 2.0F, 0.01F);
+}
+
+TEST_F(SetOperationsTest, testIntersect)
+{
+    std::size_t numFacets {};
+    Base::BoundBox3f box = runOperation(MeshCore::SetOperations::Intersect, 32, numFacets);
+    EXPECT_GT(numFacets, 0U);
+    EXPECT_NEAR(box.MinX, 0.0F, 0.01F);
+    EXPECT_NEAR(box.MaxX, 1.0F, 0.01F);
+    EXPECT_LT(box.MaxY, 0.9F);
+}
+
+TEST_F(SetOperationsTest, testDifference)
+{
+    std::size_t numFacets {};
+    Base::BoundBox3f box = runOperation(MeshCore::SetOperations::Difference, 32, numFacets);
+    EXPECT_GT(numFacets, 0U);
+    EXPECT_NEAR(box.MinX, -1.0F, 0.01F);
+    EXPECT_NEAR(box.MaxX, 0.5F, 0.05F);
+}
+
+TEST_F(SetOperationsTest, testDeterministic)
+{
+    // The cut lines are merged in a fixed order, the result must not vary between runs
+    std::size_t numFacets1 {}, numFacets2 {};
+    runOperation(MeshCore::SetOperations::Union, 48, numFacets1);
+    runOperation(MeshCore::SetOperations::Union, 48, numFacets2);
+    EXPECT_EQ(numFacets1, numFacets2);
+}
+
+TEST_F(SetOperationsTest, DISABLED_benchmarkUnion)
+{
+    // About 2 million facets per sphere
+    std::size_t numFacets {};
+    auto start = std::chrono::steady_clock::now();
+    runOperation(MeshCore::SetOperations::Union, 1000, numFacets);
+    auto end = std::chrono::steady_clock::now();
+    std::cout << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count()
+              << " ms, " << numFacets << " facets" << std::endl;
+}
+
+// NOLINTEND(cppcoreguidelines-*,readability-*)
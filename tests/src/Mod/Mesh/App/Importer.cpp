@@ -1,6 +1,12 @@
 #include <gtest/gtest.h>
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
 #include <Base/FileInfo.h>
 #include <Mod/Mesh/App/Core/IO/Reader3MF.h>
+#include <Mod/Mesh/App/Core/IO/ReaderSTL.h>
+#include <Mod/Mesh/App/Core/MeshKernel.h>
 #include <xercesc/util/PlatformUtils.hpp>
 #include <zipios++/fcoll.h>
 
@@ -37,4 +43,50 @@ TEST_F(ImporterTest, Test3MF)
     EXPECT_EQ(mesh2.CountEdges(), 1950);
     EXPECT_EQ(mesh2.CountFacets(), 1300);
 }
+
+TEST_F(ImporterTest, TestMappedBinarySTL)
+{
+    // The two triangles of a square, the corner at the origin uses -0 once
+    using Point = std::array<float, 3>;
+    std::array<std::array<Point, 3>, 2> triangles {{{{{-0.0F, 0, 0}, {1, 0, 0}, {1, 1, 0}}},
+                                                    {{{0, 0, 0}, {1, 1, 0}, {0, 1, 0}}}}};
+
+    Base::FileInfo fi(Base::FileInfo::getTempFileName() + ".stl");
+    {
+        std::ofstream str(fi.filePath(), std::ios::out | std::ios::binary);
+        std::array<char, 80> header {};
+        str.write(header.data(), header.size());
+        uint32_t count = triangles.size();
+        str.write(reinterpret_cast<const char*>(&count), sizeof(count));
+        for (const auto& triangle : triangles) {
+            Point normal {0, 0, 1};
+            str.write(reinterpret_cast<const char*>(normal.data()), sizeof(normal));
+            for (const auto& point : triangle) {
+                str.write(reinterpret_cast<const char*>(point.data()), sizeof(point));
+            }
+            uint16_t attribute = 0;
+            str.write(reinterpret_cast<const char*>(&attribute), sizeof(attribute));
+        }
+    }
+
+    MeshCore::MeshKernel mesh;
+    MeshCore::ReaderSTL reader(mesh);
+    EXPECT_EQ(reader.LoadBinary(fi.filePath()), true);
+    EXPECT_EQ(mesh.CountPoints(), 4);
+    EXPECT_EQ(mesh.CountEdges(), 5);
+    EXPECT_EQ(mesh.CountFacets(), 2);
+    EXPECT_GT(reader.GetPeakMemory(), 0);
+
+    MeshCore::MeshGeomFacet facet = mesh.GetFacet(1);
+    EXPECT_EQ(facet._aclPoints[0], Base::Vector3f(0, 1, 0));
+    EXPECT_EQ(facet._aclPoints[1], Base::Vector3f(0, 0, 0));
+    EXPECT_EQ(facet._aclPoints[2], Base::Vector3f(1, 1, 0));
+
+    // A file that is shorter than the number of facets requires
+    std::filesystem::resize_file(fi.filePath(), 84 + 50);
+    MeshCore::MeshKernel truncated;
+    MeshCore::ReaderSTL reader2(truncated);
+    EXPECT_EQ(reader2.LoadBinary(fi.filePath()), false);
+    fi.deleteFile();
+}
 // NOLINTEND(cppcoreguidelines-*,readability-*)
@@ -1,6 +1,10 @@
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
 #include <Mod/Mesh/App/Mesh.h>
+#include <Mod/Mesh/App/Core/Algorithm.h>
 #include <Mod/Mesh/App/Core/Grid.h>
+#include <Mod/Mesh/App/Core/Iterator.h>
 
 // NOLINTBEGIN(cppcoreguidelines-*,readability-*)
 TEST(MeshTest, TestDefault)
@@ -95,4 +99,87 @@ TEST(MeshTest, TestGrid2OfAlmostPlanarMesh)
     EXPECT_EQ(countY, 1);
     EXPECT_EQ(countZ, 1);
 }
+
+static MeshCore::MeshKernel CreateWavyMesh(int count)
+{
+    auto point = [count](int i, int j) {
+        float x = float(i) / float(count);
+        float y = float(j) / float(count);
+        return Base::Vector3f(x, y, 0.1F * std::sin(10.0F * x) * std::cos(10.0F * y));
+    };
+
+    std::vector<MeshCore::MeshGeomFacet> facets;
+    for (int i = 0; i < count; i++) {
+        for (int j = 0; j < count; j++) {
+            facets.emplace_back(point(i, j), point(i + 1, j), point(i, j + 1));
+            facets.emplace_back(point(i, j + 1), point(i + 1, j), point(i + 1, j + 1));
+        }
+    }
+
+    MeshCore::MeshKernel kernel;
+    kernel = facets;
+    return kernel;
+}
+
+TEST(MeshTest, TestGridOfLargeMesh)
+{
+    MeshCore::MeshKernel kernel = CreateWavyMesh(200);
+    MeshCore::MeshFacetGrid grid(kernel, 20);
+    EXPECT_TRUE(grid.Verify());
+
+    // every facet must be found in the grid of its center and the indices are sorted
+    MeshCore::MeshFacetIterator it(kernel);
+    for (it.Init(); it.More(); it.Next()) {
+        std::vector<MeshCore::ElementIndex> elements;
+        grid.GetElements(it->GetGravityPoint(), elements);
+        EXPECT_TRUE(std::is_sorted(elements.begin(), elements.end()));
+        EXPECT_TRUE(std::binary_search(elements.begin(), elements.end(), it.Position()));
+    }
+
+    MeshCore::MeshPointGrid pointGrid(kernel, 20);
+    unsigned long count = 0;
+    MeshCore::MeshGridIterator gridIt(pointGrid);
+    for (gridIt.Init(); gridIt.More(); gridIt.Next()) {
+        count += gridIt.GetCtElements();
+    }
+    EXPECT_EQ(count, kernel.CountPoints());
+}
+
+TEST(MeshTest, TestGridBatchQueries)
+{
+    MeshCore::MeshKernel kernel = CreateWavyMesh(100);
+    MeshCore::MeshFacetGrid grid(kernel, 20);
+
+    std::vector<Base::Vector3f> points;
+    std::vector<Base::Vector3f> dirs;
+    for (int i = 0; i < 50; i++) {
+        for (int j = 0; j < 50; j++) {
+            points.emplace_back(0.01F + float(i) * 0.0195F, 0.01F + float(j) * 0.0195F, 1.0F);
+            dirs.emplace_back(0.0F, 0.0F, -1.0F);
+        }
+    }
+
+    std::vector<MeshCore::ElementIndex> facets;
+    grid.SearchNearestFromPoints(points, facets);
+    ASSERT_EQ(facets.size(), points.size());
+    for (std::size_t i = 0; i < points.size(); i++) {
+        EXPECT_EQ(facets[i], grid.SearchNearestFromPoint(points[i]));
+    }
+
+    MeshCore::MeshAlgorithm alg(kernel);
+    std::vector<Base::Vector3f> results;
+    alg.NearestFacetsOnRays(points, dirs, grid, results, facets);
+    ASSERT_EQ(facets.size(), points.size());
+    for (std::size_t i = 0; i < points.size(); i++) {
+        Base::Vector3f res;
+        MeshCore::FacetIndex facet {};
+        if (alg.NearestFacetOnRay(points[i], dirs[i], grid, res, facet)) {
+            EXPECT_EQ(facets[i], facet);
+            EXPECT_EQ(results[i], res);
+        }
+        else {
+            EXPECT_EQ(facets[i], MeshCore::FACET_INDEX_MAX);
+        }
+    }
+}
 // NOLINTEND(cppcoreguidelines-*,readability-*)
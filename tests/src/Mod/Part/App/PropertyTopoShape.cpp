@@ -2,7 +2,11 @@
 
 #include <gtest/gtest.h>
 
+#include <functional>
+#include <sstream>
+
 #include <BRepFilletAPI_MakeFillet.hxx>
+#include <Base/FileInfo.h>
 #include "Mod/Part/App/FeaturePartCommon.h"
 #include "Mod/Part/App/PropertyTopoShape.h"
 #include <src/App/InitApplication.h>
@@ -101,7 +105,55 @@ EndMap
 )x";
     }
 
+    static void setParameter(const char* group, const char* name, bool value)
+    {
+        App::GetApplication()
+            .GetParameterGroupByPath((std::string("User parameter:BaseApp/Preferences/") + group)
+                                         .c_str())
+            ->SetBool(name, value);
+    }
+
+    static void setMemoryLimit(unsigned long megabytes)
+    {
+        App::GetApplication()
+            .GetParameterGroupByPath("User parameter:BaseApp/Preferences/Mod/Part/General")
+            ->SetUnsigned("LazyRestoreMemoryLimit", megabytes);
+    }
+
+    static std::string brep(const TopoShape& shape)
+    {
+        std::stringstream str;
+        shape.exportBrep(str);
+        return str.str();
+    }
+
+    /// Save the test document and close it, returns the file name
+    std::string saveAndClose()
+    {
+        _commonName = _common->getNameInDocument();
+        std::string fileName = Base::FileInfo::getTempFileName() + ".FCStd";
+        EXPECT_TRUE(_doc->saveAs(fileName.c_str()));
+        App::GetApplication().closeDocument(_doc->getName());
+        _doc = nullptr;
+        _common = nullptr;
+        return fileName;
+    }
+
+    /// Open the document saved by saveAndClose(), \a check gets the restored common feature
+    void restore(const std::string& fileName, const std::function<void(Part::Feature*)>& check)
+    {
+        auto doc = App::GetApplication().openDocument(fileName.c_str());
+        ASSERT_NE(doc, nullptr);
+        auto feature = freecad_cast<Part::Feature*>(doc->getObject(_commonName.c_str()));
+        EXPECT_NE(feature, nullptr);
+        if (feature) {
+            check(feature);
+        }
+        App::GetApplication().closeDocument(doc->getName());
+    }
+
     Common* _common = nullptr;  // NOLINT Can't be private in a test framework
+    std::string _commonName;    // NOLINT
 };
 
 TEST_F(PropertyTopoShapeTest, testPropertyPartShapeTopoShape)
@@ -252,6 +304,70 @@ TEST_F(PropertyTopoShapeTest, testPropertyShapeCachePyObj)
     Py_XDECREF(pyObjOutErased);
 }
 
+TEST_F(PropertyTopoShapeTest, testParallelRestoreSameAsSerial)
+{
+    // Arrange
+    TopoShape original = _common->Shape.getShape();
+    std::string fileName = saveAndClose();
+    TopoShape serial;
+    TopoShape parallel;
+
+    // Act
+    setParameter("Document", "ParallelRestore", false);
+    restore(fileName, [&](Part::Feature* feature) {
+        serial = feature->Shape.getShape();
+    });
+    setParameter("Document", "ParallelRestore", true);
+    restore(fileName, [&](Part::Feature* feature) {
+        parallel = feature->Shape.getShape();
+    });
+    setParameter("Document", "ParallelRestore", false);
+    Base::FileInfo(fileName).deleteFile();
+
+    // Assert
+    EXPECT_FALSE(parallel.isNull());
+    EXPECT_DOUBLE_EQ(getVolume(parallel.getShape()), getVolume(serial.getShape()));
+    EXPECT_DOUBLE_EQ(getVolume(parallel.getShape()), getVolume(original.getShape()));
+    EXPECT_EQ(parallel.countSubShapes(TopAbs_FACE), original.countSubShapes(TopAbs_FACE));
+    EXPECT_EQ(elementMap(parallel), elementMap(serial));
+    EXPECT_EQ(elementMap(parallel).size(), elementMap(original).size());
+}
+
+TEST_F(PropertyTopoShapeTest, testLazyRestore)
+{
+    // Arrange
+    std::string fileName = saveAndClose();
+    TopoShape serial;
+    setParameter("Mod/Part/General", "LazyRestore", false);
+    restore(fileName, [&](Part::Feature* feature) {
+        serial = feature->Shape.getShape();
+    });
+
+    // Act and assert, with the data kept in memory and moved to a temporary file
+    setParameter("Mod/Part/General", "LazyRestore", true);
+    for (unsigned long limit : {512UL, 0UL}) {
+        setMemoryLimit(limit);
+        restore(fileName, [&](Part::Feature* feature) {
+            EXPECT_FALSE(feature->Shape.isShapeLoaded());
+            if (limit > 0) {
+                EXPECT_GT(feature->Shape.getMemSize(), 0U);
+            }
+            else {
+                EXPECT_EQ(feature->Shape.getMemSize(), 0U);
+            }
+
+            TopoShape lazy = feature->Shape.getShape();
+            EXPECT_TRUE(feature->Shape.isShapeLoaded());
+            EXPECT_EQ(brep(lazy), brep(serial));
+            EXPECT_EQ(elementMap(lazy), elementMap(serial));
+            EXPECT_FALSE(elementMap(lazy).empty());
+        });
+    }
+    setMemoryLimit(512);
+    setParameter("Mod/Part/General", "LazyRestore", false);
+    Base::FileInfo(fileName).deleteFile();
+}
+
 TEST_F(PropertyTopoShapeTest, testRestore)
 {
     // Test case for https://github.com/FreeCAD/FreeCAD/pull/16576
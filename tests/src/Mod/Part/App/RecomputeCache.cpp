@@ -0,0 +1,194 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include <gtest/gtest.h>
+
+#include <src/App/InitApplication.h>
+
+#include <string>
+
+#include <App/Application.h>
+#include <Base/Parameter.h>
+#include <Mod/Part/App/RecomputeCache.h>
+
+#include "PartTestHelpers.h"
+
+#include <TopLoc_Location.hxx>
+
+// NOLINTBEGIN(readability-magic-numbers,cppcoreguidelines-avoid-magic-numbers)
+class RecomputeCacheTest: public ::testing::Test, public PartTestHelpers::PartTestHelperClass
+{
+protected:
+    static void SetUpTestSuite()
+    {
+        tests::initApplication();
+    }
+
+    void SetUp() override
+    {
+        createTestDoc();
+        _boxes[0]->execute();
+        _boxes[1]->execute();
+        _input = _boxes[0]->Shape.getShape();
+        _result = _boxes[1]->Shape.getShape();
+    }
+
+    void TearDown() override
+    {
+        Part::RecomputeCache::clear();
+        hGrp()->RemoveUnsigned("RecomputeCacheSize");
+        hGrp()->RemoveBool("RecomputeCache");
+        App::GetApplication().closeDocument(_docName.c_str());
+    }
+
+    static ParameterGrp::handle hGrp()
+    {
+        return App::GetApplication().GetParameterGroupByPath(
+            "User parameter:BaseApp/Preferences/Mod/Part/General");
+    }
+
+    /// A key of \a feature with the single input shape \a input
+    static Part::RecomputeCache::Key key(const App::DocumentObject* feature,
+                                         const Part::TopoShape& input)
+    {
+        Part::RecomputeCache::Key key(feature);
+        key.addShape(input);
+        return key;
+    }
+
+    Part::TopoShape _input;   // NOLINT Can't be private in a test framework
+    Part::TopoShape _result;  // NOLINT Can't be private in a test framework
+};
+
+TEST_F(RecomputeCacheTest, findIdenticalInputs)
+{
+    // Arrange
+    Part::RecomputeCache::insert(key(_boxes[2], _input), _result);
+    Part::TopoShape found;
+    // Act
+    bool hit = Part::RecomputeCache::find(key(_boxes[2], _input), found);
+    // Assert
+    EXPECT_TRUE(hit);
+    EXPECT_TRUE(found.getShape().IsSame(_result.getShape()));
+}
+
+TEST_F(RecomputeCacheTest, missChangedInput)
+{
+    // Arrange
+    Part::RecomputeCache::insert(key(_boxes[2], _input), _result);
+    // Same geometry, but a different shape
+    _boxes[0]->execute();
+    Part::TopoShape input = _boxes[0]->Shape.getShape();
+    Part::TopoShape found;
+    // Act
+    bool hit = Part::RecomputeCache::find(key(_boxes[2], input), found);
+    // Assert
+    EXPECT_FALSE(input.getShape().IsSame(_input.getShape()));
+    EXPECT_FALSE(hit);
+}
+
+TEST_F(RecomputeCacheTest, findRelocatedInput)
+{
+    // Arrange
+    Part::RecomputeCache::insert(key(_boxes[2], _input), _result);
+    // Same shape at the same position, but with a new location object
+    Part::TopoShape input(_input);
+    input.setShape(
+        _input.getShape().Located(TopLoc_Location(_input.getShape().Location().Transformation())),
+        false);
+    Part::TopoShape found;
+    // Act
+    bool hit = Part::RecomputeCache::find(key(_boxes[2], input), found);
+    // Assert
+    EXPECT_FALSE(input.getShape().IsEqual(_input.getShape()));
+    EXPECT_TRUE(hit);
+}
+
+TEST_F(RecomputeCacheTest, missChangedParameter)
+{
+    // Arrange
+    Part::RecomputeCache::insert(key(_boxes[2], _input), _result);
+    Part::TopoShape found;
+    // Act
+    _boxes[2]->Length.setValue(2);
+    bool changed = Part::RecomputeCache::find(key(_boxes[2], _input), found);
+    _boxes[2]->Length.setValue(1);
+    bool reverted = Part::RecomputeCache::find(key(_boxes[2], _input), found);
+    // Assert
+    EXPECT_FALSE(changed);
+    EXPECT_TRUE(reverted);
+}
+
+TEST_F(RecomputeCacheTest, missOtherFeature)
+{
+    // Arrange
+    Part::RecomputeCache::insert(key(_boxes[2], _input), _result);
+    Part::TopoShape found;
+    // Act
+    bool hit = Part::RecomputeCache::find(key(_boxes[3], _input), found);
+    // Assert
+    EXPECT_FALSE(hit);
+}
+
+TEST_F(RecomputeCacheTest, evictLeastRecentlyUsed)
+{
+    // Arrange
+    hGrp()->SetUnsigned("RecomputeCacheSize", 1);
+    std::size_t entrySize = _result.getMemSize();
+    ASSERT_GT(entrySize, 0U);
+    // Enough entries to exceed the limit of 1 MB twice
+    std::size_t count = 2 * 1024 * 1024 / entrySize + 1;
+    auto valueKey = [&](std::size_t index) {
+        Part::RecomputeCache::Key key(_boxes[2]);
+        key.addValue(std::to_string(index));
+        return key;
+    };
+    Part::TopoShape found;
+    // Act
+    for (std::size_t i = 0; i < count; ++i) {
+        Part::RecomputeCache::insert(valueKey(i), _result);
+        // Keep the first entry in use
+        Part::RecomputeCache::find(valueKey(0), found);
+    }
+    // Assert
+    EXPECT_TRUE(Part::RecomputeCache::find(valueKey(0), found));
+    EXPECT_FALSE(Part::RecomputeCache::find(valueKey(1), found));
+    EXPECT_TRUE(Part::RecomputeCache::find(valueKey(count - 1), found));
+}
+
+TEST_F(RecomputeCacheTest, clearDocument)
+{
+    // Arrange
+    Part::RecomputeCache::insert(key(_boxes[2], _input), _result);
+    Part::TopoShape found;
+    // Act
+    Part::RecomputeCache::clear(_doc);
+    // Assert
+    EXPECT_FALSE(Part::RecomputeCache::find(key(_boxes[2], _input), found));
+}
+
+TEST_F(RecomputeCacheTest, recomputeBooleanFromCache)
+{
+    // Arrange
+    hGrp()->SetBool("RecomputeCache", true);
+    auto fuse = _doc->addObject<Part::Fuse>();
+    fuse->Base.setValue(_boxes[0]);
+    fuse->Tool.setValue(_boxes[1]);
+    _doc->recompute();
+    Part::TopoShape computed = fuse->Shape.getShape();
+    // Act
+    fuse->touch();
+    _doc->recompute();
+    Part::TopoShape cached = fuse->Shape.getShape();
+    hGrp()->SetBool("RecomputeCache", false);
+    fuse->touch();
+    _doc->recompute();
+    Part::TopoShape recomputed = fuse->Shape.getShape();
+    // Assert
+    // The same shape is only returned by a cache hit, a recompute builds a new one
+    EXPECT_EQ(cached.getShape().TShape(), computed.getShape().TShape());
+    EXPECT_NE(recomputed.getShape().TShape(), computed.getShape().TShape());
+    EXPECT_GT(computed.getElementMapSize(), 0U);
+    EXPECT_EQ(cached.getElementMap(), computed.getElementMap());
+}
+
+// NOLINTEND(readability-magic-numbers,cppcoreguidelines-avoid-magic-numbers)
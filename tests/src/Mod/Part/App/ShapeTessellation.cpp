@@ -0,0 +1,144 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <iostream>
+
+#include <BRep_Builder.hxx>
+#include <BRepPrimAPI_MakeBox.hxx>
+#include <BRepPrimAPI_MakeCylinder.hxx>
+#include <BRepPrimAPI_MakeSphere.hxx>
+#include <gp_Ax2.hxx>
+#include <TopoDS_Compound.hxx>
+
+#include "Mod/Part/App/ShapeTessellation.h"
+
+// NOLINTBEGIN
+class ShapeTessellationTest: public ::testing::Test
+{
+protected:
+    static TopoDS_Shape makeCompound(int count)
+    {
+        BRep_Builder builder;
+        TopoDS_Compound comp;
+        builder.MakeCompound(comp);
+        for (int i = 0; i < count; i++) {
+            gp_Ax2 axis(gp_Pnt(i * 30.0, 0, 0), gp_Dir(0, 0, 1));
+            builder.Add(comp, BRepPrimAPI_MakeCylinder(axis, 5.0, 20.0).Shape());
+            builder.Add(comp, BRepPrimAPI_MakeSphere(gp_Pnt(i * 30.0, 30.0, 0), 10.0).Shape());
+            builder.Add(comp, BRepPrimAPI_MakeBox(gp_Pnt(i * 30.0, 60.0, 0), 10, 10, 10).Shape());
+        }
+        return comp;
+    }
+
+    static void expectEqual(const Part::ShapeTessellation& tess1,
+                            const Part::ShapeTessellation& tess2)
+    {
+        ASSERT_EQ(tess1.points.size(), tess2.points.size());
+        ASSERT_EQ(tess1.normals.size(), tess2.normals.size());
+        for (std::size_t i = 0; i < tess1.points.size(); i++) {
+            EXPECT_EQ(tess1.points[i].x, tess2.points[i].x);
+            EXPECT_EQ(tess1.points[i].y, tess2.points[i].y);
+            EXPECT_EQ(tess1.points[i].z, tess2.points[i].z);
+        }
+        for (std::size_t i = 0; i < tess1.normals.size(); i++) {
+            EXPECT_FLOAT_EQ(tess1.normals[i].x, tess2.normals[i].x);
+            EXPECT_FLOAT_EQ(tess1.normals[i].y, tess2.normals[i].y);
+            EXPECT_FLOAT_EQ(tess1.normals[i].z, tess2.normals[i].z);
+        }
+        EXPECT_EQ(tess1.triangles, tess2.triangles);
+        EXPECT_EQ(tess1.parts, tess2.parts);
+        EXPECT_EQ(tess1.lines, tess2.lines);
+        EXPECT_EQ(tess1.vertexStart, tess2.vertexStart);
+        EXPECT_EQ(tess1.numEdges, tess2.numEdges);
+    }
+};
+
+TEST_F(ShapeTessellationTest, testNullShape)
+{
+    Part::ShapeTessellation tess;
+    tess.compute(TopoDS_Shape(), 0.5, 0.5, true);
+    EXPECT_TRUE(tess.points.empty());
+    EXPECT_TRUE(tess.triangles.empty());
+    EXPECT_TRUE(tess.lines.empty());
+}
+
+TEST_F(ShapeTessellationTest, testBox)
+{
+    TopoDS_Shape box = BRepPrimAPI_MakeBox(10, 10, 10).Shape();
+    Part::ShapeTessellation tess;
+    tess.compute(box, 0.5, 0.5, true);
+
+    // 4 nodes and 2 triangles per face, followed by the 8 vertices
+    EXPECT_EQ(tess.parts, std::vector<int32_t>(6, 2));
+    EXPECT_EQ(tess.points.size(), 32U);
+    EXPECT_EQ(tess.normals.size(), 24U);
+    EXPECT_EQ(tess.vertexStart, 24);
+    EXPECT_EQ(tess.triangles.size(), 12U * 4);
+    EXPECT_EQ(tess.numEdges, 12);
+    EXPECT_EQ(tess.lines.size(), 12U * 3);
+    for (std::size_t i = 3; i < tess.triangles.size(); i += 4) {
+        EXPECT_EQ(tess.triangles[i], -1);
+    }
+    for (const auto& normal : tess.normals) {
+        EXPECT_FLOAT_EQ(normal.Length(), 1.0F);
+    }
+}
+
+TEST_F(ShapeTessellationTest, testParallelConversion)
+{
+    TopoDS_Shape shape = makeCompound(10);
+    Part::ShapeTessellation tess1;
+    tess1.compute(shape, 0.05, 0.1, true, false);
+    ASSERT_GT(tess1.triangles.size(), 40000U);
+
+    // the triangulation is stored in the shape, so both convert the same mesh
+    Part::ShapeTessellation tess2;
+    tess2.convert(shape, true, true);
+    expectEqual(tess1, tess2);
+
+    tess1.convert(shape, false, false);
+    tess2.convert(shape, false, true);
+    expectEqual(tess1, tess2);
+}
+
+TEST_F(ShapeTessellationTest, testLevelsOfDetail)
+{
+    TopoDS_Shape shape = makeCompound(2);
+    Part::ShapeTessellation fine;
+    fine.computeLevel(shape, 0.05, 0.1, 0, true);
+
+    std::size_t numTriangles = fine.triangles.size();
+    for (int level = 1; level < 4; level++) {
+        Part::ShapeTessellation coarse;
+        coarse.computeLevel(shape, 0.05, 0.1, level, true);
+        EXPECT_LE(coarse.triangles.size(), numTriangles);
+        EXPECT_EQ(coarse.parts.size(), fine.parts.size());
+        EXPECT_EQ(coarse.numEdges, fine.numEdges);
+        numTriangles = coarse.triangles.size();
+    }
+    EXPECT_LT(numTriangles, fine.triangles.size());
+
+    // the coarser levels do not replace the triangulation of the shape
+    Part::ShapeTessellation stored;
+    stored.convert(shape, true);
+    expectEqual(stored, fine);
+}
+
+TEST_F(ShapeTessellationTest, DISABLED_benchmarkTessellation)
+{
+    for (int count : {10, 100}) {
+        for (bool inParallel : {false, true}) {
+            TopoDS_Shape shape = makeCompound(count);
+            Part::ShapeTessellation tess;
+            auto start = std::chrono::steady_clock::now();
+            tess.compute(shape, 0.05, 0.1, true, inParallel);
+            auto end = std::chrono::steady_clock::now();
+            double time = std::chrono::duration<double>(end - start).count();
+            std::cout << 3 * count << " shapes, parallel " << inParallel << ": " << time
+                      << " s, " << time / (3 * count) * 1000 << " ms per shape, "
+                      << tess.triangles.size() / 4 << " triangles" << std::endl;
+        }
+    }
+}
+// NOLINTEND
@@ -5,6 +5,13 @@
 #include <Mod/Part/App/TopoShape.h>
 #include "src/App/InitApplication.h"
 
+#include <sstream>
+#include <BRep_Tool.hxx>
+#include <BRepMesh_IncrementalMesh.hxx>
+#include <BRepPrimAPI_MakeBox.hxx>
+#include <TopExp_Explorer.hxx>
+#include <TopoDS.hxx>
+
 
 class TopoShapeTest: public ::testing::Test
 {
@@ -136,4 +143,40 @@ TEST_F(TopoShapeTest, TestGetSubshape)
     EXPECT_THROW(cube1.getSubShape("WOOHOO", false), Base::ValueError);  // Invalid
 }
 
+static int countTriangulatedFaces(const TopoDS_Shape& shape)
+{
+    int count = 0;
+    TopLoc_Location loc;
+    for (TopExp_Explorer xp(shape, TopAbs_FACE); xp.More(); xp.Next()) {
+        if (!BRep_Tool::Triangulation(TopoDS::Face(xp.Current()), loc).IsNull()) {
+            count++;
+        }
+    }
+    return count;
+}
+
+TEST_F(TopoShapeTest, TestExportWithTriangulation)
+{
+    // Arrange
+    TopoDS_Shape box = BRepPrimAPI_MakeBox(10, 10, 10).Shape();
+    BRepMesh_IncrementalMesh(box, 0.1);
+    Part::TopoShape shape(box);
+    // Act
+    std::stringstream brep, brepWithTriangles, binary, binaryWithTriangles;
+    shape.exportBrep(brep);
+    shape.exportBrep(brepWithTriangles, true);
+    shape.exportBinary(binary);
+    shape.exportBinary(binaryWithTriangles, true);
+    Part::TopoShape result1, result2, result3, result4;
+    result1.importBrep(brep);
+    result2.importBrep(brepWithTriangles);
+    result3.importBinary(binary);
+    result4.importBinary(binaryWithTriangles);
+    // Assert
+    EXPECT_EQ(countTriangulatedFaces(result1.getShape()), 0);
+    EXPECT_EQ(countTriangulatedFaces(result2.getShape()), 6);
+    EXPECT_EQ(countTriangulatedFaces(result3.getShape()), 0);
+    EXPECT_EQ(countTriangulatedFaces(result4.getShape()), 6);
+}
+
 // clang-format on
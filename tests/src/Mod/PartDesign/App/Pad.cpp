@@ -5,7 +5,9 @@
 
 #include <App/Application.h>
 #include <App/Document.h>
+#include <Base/Parameter.h>
 #include <Mod/Part/App/Geometry.h>
+#include <Mod/Part/App/RecomputeCache.h>
 #include <Mod/PartDesign/App/Body.h>
 #include <Mod/PartDesign/App/FeaturePad.h>
 #include <Mod/Sketcher/App/SketchObject.h>
@@ -90,4 +92,37 @@ TEST_F(PadTest, TestMidPlaneTwoLength)
     EXPECT_DOUBLE_EQ(bbox.MinZ, -20.0);
 }
 
+TEST_F(PadTest, TestRecomputeCache)
+{
+    auto doc = getDocument();
+    auto body = getBody();
+    auto sketch = getSketch();
+    auto hGrp = App::GetApplication().GetParameterGroupByPath(
+        "User parameter:BaseApp/Preferences/Mod/Part/General");
+    hGrp->SetBool("RecomputeCache", true);
+
+    doc->recompute();
+
+    auto pad = doc->addObject<PartDesign::Pad>("Pad");
+    body->addObject(pad);
+    pad->Profile.setValue(sketch, {""});
+    pad->Length.setValue(10.0);
+    doc->recompute();
+    pad->touch();
+    doc->recompute();
+    Part::TopoShape computed = pad->Shape.getShape();
+    Part::TopoShape addSubShape = pad->AddSubShape.getShape();
+
+    pad->touch();
+    doc->recompute();
+    hGrp->RemoveBool("RecomputeCache");
+    Part::RecomputeCache::clear();
+
+    // The same shapes are only returned by a cache hit, a recompute builds new ones
+    EXPECT_FALSE(pad->isError());
+    EXPECT_EQ(pad->Shape.getShape().getShape().TShape(), computed.getShape().TShape());
+    EXPECT_EQ(pad->AddSubShape.getShape().getShape().TShape(), addSubShape.getShape().TShape());
+    EXPECT_EQ(pad->Shape.getShape().getElementMap(), computed.getElementMap());
+}
+
 // NOLINTEND(readability-magic-numbers,cppcoreguidelines-avoid-magic-numbers)
@@ -2,6 +2,12 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <limits>
+
 #include "Mod/Sketcher/App/planegcs/GCS.h"
 
 class SystemTest: public GCS::System
@@ -11,6 +17,10 @@ public:
     {
         return _getNumberOfConstraints(tagID);
     }
+    size_t getNumberOfReusedComponents() const
+    {
+        return _getNumberOfReusedComponents();
+    }
 };
 
 class GCSTest: public ::testing::Test
@@ -50,3 +60,266 @@ TEST_F(GCSTest, clearConstraints)  // NOLINT
     // Assert
     EXPECT_EQ(0, System()->getNumberOfConstraints());
 }
+
+namespace
+{
+// A polyline of numPoints points with its first point fixed and a length and direction
+// constraint on each segment. The parameters are perturbed away from the solution.
+class ChainSketch
+{
+public:
+    explicit ChainSketch(int numPoints)
+        : coords(2 * numPoints)
+        , values(2 * numPoints)
+    {
+        for (int i = 0; i < numPoints; ++i) {
+            coords[2 * i] = i + 0.1 * std::cos(i);
+            coords[2 * i + 1] = 0.2 * std::sin(3 * i);
+            points.emplace_back(&coords[2 * i], &coords[2 * i + 1]);
+            values[2 * i] = 1.0;
+            values[2 * i + 1] = 0.3 * std::sin(i);
+        }
+        for (auto& coord : coords) {
+            unknowns.push_back(&coord);
+        }
+    }
+
+    // adds the direction constraint only to the first numAngles segments
+    void addTo(GCS::System& system, int numAngles = std::numeric_limits<int>::max())
+    {
+        system.addConstraintCoordinateX(points[0], &origin);
+        system.addConstraintCoordinateY(points[0], &origin);
+        for (int i = 1; i < int(points.size()); ++i) {
+            system.addConstraintP2PDistance(points[i - 1], points[i], &values[2 * i], 2 * i);
+            if (i <= numAngles) {
+                system.addConstraintP2PAngle(points[i - 1],
+                                             points[i],
+                                             &values[2 * i + 1],
+                                             2 * i + 1);
+            }
+        }
+    }
+
+    std::vector<double> coords;
+    std::vector<double> values;
+    std::vector<GCS::Point> points;
+    GCS::VEC_pD unknowns;
+    double origin {0.0};
+};
+
+std::vector<double> solveChain(int numPoints, GCS::Algorithm alg, GCS::LinearSolver solver)
+{
+    ChainSketch sketch(numPoints);
+    GCS::System system;
+    system.linearSolver = solver;
+    sketch.addTo(system);
+    system.declareUnknowns(sketch.unknowns);
+    system.initSolution(alg);
+    if (system.solve(true, alg) != GCS::Success) {
+        return {};
+    }
+    system.applySolution();
+    return sketch.coords;
+}
+}  // namespace
+
+TEST_F(GCSTest, sparseSolversMatchDense)  // NOLINT
+{
+    for (auto alg : {GCS::LevenbergMarquardt, GCS::DogLeg}) {
+        // Act
+        auto dense = solveChain(50, alg, GCS::EigenDense);
+        auto sparse = solveChain(50, alg, GCS::EigenSparse);
+
+        // Assert
+        ASSERT_EQ(dense.size(), 100U);
+        ASSERT_EQ(sparse.size(), dense.size());
+        for (std::size_t i = 0; i < dense.size(); ++i) {
+            EXPECT_NEAR(dense[i], sparse[i], 1e-8);
+        }
+    }
+}
+
+TEST_F(GCSTest, decoupledComponentsSolvedLikeSingleSystems)  // NOLINT
+{
+    // Arrange
+    auto single = solveChain(30, GCS::DogLeg, GCS::EigenDense);
+    std::vector<std::unique_ptr<ChainSketch>> chains;
+    GCS::VEC_pD unknowns;
+    for (int i = 0; i < 8; ++i) {
+        chains.push_back(std::make_unique<ChainSketch>(30));
+        chains.back()->addTo(*System());
+        unknowns.insert(unknowns.end(),
+                        chains.back()->unknowns.begin(),
+                        chains.back()->unknowns.end());
+    }
+    System()->declareUnknowns(unknowns);
+    System()->initSolution();
+    auto start = chains.front()->coords;
+    auto checkSolved = [&]() {
+        for (const auto& chain : chains) {
+            ASSERT_EQ(chain->coords.size(), single.size());
+            for (std::size_t i = 0; i < single.size(); ++i) {
+                EXPECT_NEAR(chain->coords[i], single[i], 1e-8);
+            }
+        }
+    };
+
+    // Act
+    int first = System()->solve();
+    size_t firstReused = System()->getNumberOfReusedComponents();
+    System()->applySolution();
+    // solving again from the solution reuses it
+    System()->initSolution();
+    int second = System()->solve();
+    size_t secondReused = System()->getNumberOfReusedComponents();
+    System()->applySolution();
+    checkSolved();
+    // solving twice from the start values reuses the solution of the first solve
+    int third = GCS::Failed;
+    for (int i = 0; i < 2; ++i) {
+        for (const auto& chain : chains) {
+            std::copy(start.begin(), start.end(), chain->coords.begin());
+        }
+        System()->initSolution();
+        third = System()->solve();
+    }
+    size_t thirdReused = System()->getNumberOfReusedComponents();
+    System()->applySolution();
+
+    // Assert
+    EXPECT_EQ(first, GCS::Success);
+    EXPECT_EQ(second, GCS::Success);
+    EXPECT_EQ(third, GCS::Success);
+    EXPECT_EQ(firstReused, 0U);
+    EXPECT_EQ(secondReused, chains.size());
+    EXPECT_EQ(thirdReused, chains.size());
+    checkSolved();
+}
+
+TEST_F(GCSTest, dragSolvesOnlyComponentsOfTemporaryConstraints)  // NOLINT
+{
+    // Arrange
+    ChainSketch dragged(10);
+    ChainSketch other(10);
+    GCS::VEC_pD unknowns;
+    for (auto sketch : {&dragged, &other}) {
+        sketch->addTo(*System(), 0);
+        unknowns.insert(unknowns.end(), sketch->unknowns.begin(), sketch->unknowns.end());
+    }
+    System()->declareUnknowns(unknowns);
+    System()->initSolution();
+    ASSERT_EQ(System()->solve(), GCS::Success);
+    System()->applySolution();
+    for (auto& coord : other.coords) {
+        coord += 0.05;
+    }
+    auto otherStart = other.coords;
+    auto isSolved = [](const ChainSketch& sketch) {
+        for (std::size_t i = 1; i < sketch.points.size(); ++i) {
+            double dx = *sketch.points[i].x - *sketch.points[i - 1].x;
+            double dy = *sketch.points[i].y - *sketch.points[i - 1].y;
+            if (std::abs(std::hypot(dx, dy) - sketch.values[2 * i]) > 1e-6) {
+                return false;
+            }
+        }
+        return true;
+    };
+    double target[2] = {7.0, 3.0};
+    GCS::Point mouse(&target[0], &target[1]);
+    System()->addConstraintP2PCoincident(mouse,
+                                         dragged.points.back(),
+                                         GCS::DefaultTemporaryConstraint);
+    System()->initSolution();
+    auto distanceToMouse = [&]() {
+        return std::hypot(*dragged.points.back().x - target[0],
+                          *dragged.points.back().y - target[1]);
+    };
+    double startDistance = distanceToMouse();
+
+    // Act
+    std::vector<int> steps;
+    for (int i = 0; i < 3; ++i) {
+        target[1] += 0.1;
+        steps.push_back(System()->solveDrag(false));
+        System()->applySolution();
+    }
+
+    // Assert
+    for (int res : steps) {
+        EXPECT_EQ(res, GCS::Success);
+    }
+    EXPECT_TRUE(isSolved(dragged));
+    EXPECT_LT(distanceToMouse(), startDistance);
+    // the other component is left as it is until the next full solve
+    EXPECT_EQ(other.coords, otherStart);
+    EXPECT_EQ(System()->solve(false), GCS::Success);
+    System()->applySolution();
+    EXPECT_TRUE(isSolved(other));
+}
+
+TEST_F(GCSTest, incrementalDiagnosisMatchesFullDiagnosis)  // NOLINT
+{
+    GCS::System full;
+    full.incrementalDiagnosis = false;
+    auto diagnose = [](GCS::System& system, ChainSketch& sketch, int numAngles, bool redundant) {
+        system.clear();
+        sketch.addTo(system, numAngles);
+        if (redundant) {
+            auto& points = sketch.points;
+            system.addConstraintP2PDistance(points[0], points[1], &sketch.values[2], 1);
+        }
+        system.declareUnknowns(sketch.unknowns);
+        system.initSolution();
+    };
+    auto dependentParams = [](GCS::System& system, ChainSketch& sketch) {
+        GCS::VEC_pD params;
+        system.getDependentParams(params);
+        std::vector<long> indices;
+        for (double* param : params) {
+            indices.push_back(param - sketch.coords.data());
+        }
+        return indices;
+    };
+
+    // adding, keeping, removing constraints and a redundant constraint
+    for (auto [numAngles, redundant] : std::vector<std::pair<int, bool>> {{5, false},
+                                                                         {9, false},
+                                                                         {9, false},
+                                                                         {3, false},
+                                                                         {4, true},
+                                                                         {19, false}}) {
+        // Act
+        ChainSketch sketch(20), fullSketch(20);
+        diagnose(*System(), sketch, numAngles, redundant);
+        diagnose(full, fullSketch, numAngles, redundant);
+
+        // Assert
+        EXPECT_EQ(System()->dofsNumber(), full.dofsNumber());
+        EXPECT_EQ(System()->hasRedundant(), redundant);
+        EXPECT_EQ(full.hasRedundant(), redundant);
+        EXPECT_EQ(dependentParams(*System(), sketch), dependentParams(full, fullSketch));
+    }
+}
+
+TEST_F(GCSTest, DISABLED_benchmarkSparseSolvers)  // NOLINT
+{
+    const int numPoints = 1000;
+    for (auto alg : {GCS::LevenbergMarquardt, GCS::DogLeg}) {
+        for (auto solver : {GCS::EigenDense, GCS::EigenSparse}) {
+            ChainSketch sketch(numPoints);
+            GCS::System system;
+            system.linearSolver = solver;
+            sketch.addTo(system);
+            system.declareUnknowns(sketch.unknowns);
+            system.initSolution(alg);
+
+            auto start = std::chrono::steady_clock::now();
+            EXPECT_EQ(system.solve(true, alg), GCS::Success);
+            auto end = std::chrono::steady_clock::now();
+            std::cout << (alg == GCS::DogLeg ? "DogLeg" : "LevenbergMarquardt")
+                      << (solver == GCS::EigenSparse ? " sparse: " : " dense: ")
+                      << std::chrono::duration<double>(end - start).count() << " s, "
+                      << 2 * numPoints << " constraints\n";
+        }
+    }
+}
@@ -0,0 +1,248 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include <gtest/gtest.h>
+#include "src/App/InitApplication.h"
+
+#include <chrono>
+#include <iostream>
+#include <limits>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <App/Application.h>
+#include <App/Document.h>
+#include <App/PropertyStandard.h>
+#include <Base/Interpreter.h>
+#include <Base/Parameter.h>
+#include <Mod/Spreadsheet/App/Sheet.h>
+
+// NOLINTBEGIN(readability-magic-numbers)
+
+class SheetTest: public ::testing::Test
+{
+protected:
+    static void SetUpTestSuite()
+    {
+        tests::initApplication();
+    }
+
+    void SetUp() override
+    {
+        Base::Interpreter().runString("import Spreadsheet");
+        _docName = App::GetApplication().getUniqueDocumentName("test");
+        _doc = App::GetApplication().newDocument(_docName.c_str(), "testUser");
+        _sheet = freecad_cast<Spreadsheet::Sheet*>(_doc->addObject("Spreadsheet::Sheet"));
+        ASSERT_NE(_sheet, nullptr);
+    }
+
+    void TearDown() override
+    {
+        App::GetApplication().closeDocument(_docName.c_str());
+    }
+
+    App::Document* doc()
+    {
+        return _doc;
+    }
+
+    Spreadsheet::Sheet* sheet()
+    {
+        return _sheet;
+    }
+
+    /// The representation of the computed value of the cell at \a address
+    std::string repr(const App::CellAddress& address)
+    {
+        auto prop = _sheet->getPropertyByName(address.toString().c_str());
+        if (!prop) {
+            return {};
+        }
+        Base::PyGILStateLocker lock;
+        Py::Object value(prop->getPyObject(), true);
+        return prop->getTypeId().getName() + std::string(" ") + value.repr().as_std_string();
+    }
+
+    static void setParallelRecompute(bool on)
+    {
+        App::GetApplication()
+            .GetParameterGroupByPath("User parameter:BaseApp/Preferences/Mod/Spreadsheet")
+            ->SetBool("ParallelRecompute", on);
+    }
+
+    /// The computed value of the cell at \a address, NaN if it's no number
+    double value(const char* address)
+    {
+        auto prop = freecad_cast<App::PropertyFloat*>(_sheet->getPropertyByName(address));
+        return prop ? prop->getValue() : std::numeric_limits<double>::quiet_NaN();
+    }
+
+private:
+    std::string _docName;
+    App::Document* _doc {};
+    Spreadsheet::Sheet* _sheet {};
+};
+
+TEST_F(SheetTest, recomputeDependentCells)
+{
+    sheet()->setCell("A1", "1");
+    sheet()->setCell("A2", "=A1 + 1");
+    sheet()->setCell("A3", "=A2 * 2 + A1");
+    sheet()->setCell("B1", "=A3 - A2");
+    doc()->recompute();
+    EXPECT_DOUBLE_EQ(value("A3"), 5.0);
+    EXPECT_DOUBLE_EQ(value("B1"), 3.0);
+
+    // Only A1 is dirty, its dependents are found through the sheet
+    sheet()->setCell("A1", "5");
+    doc()->recompute();
+    EXPECT_DOUBLE_EQ(value("A2"), 6.0);
+    EXPECT_DOUBLE_EQ(value("A3"), 17.0);
+    EXPECT_DOUBLE_EQ(value("B1"), 11.0);
+
+    // A1 no longer depends on anything, A2 no longer on A1
+    sheet()->setCell("A2", "10");
+    sheet()->setCell("A1", "7");
+    doc()->recompute();
+    EXPECT_DOUBLE_EQ(value("A3"), 27.0);
+    EXPECT_DOUBLE_EQ(value("B1"), 17.0);
+}
+
+TEST_F(SheetTest, dependenciesOfLocalCells)
+{
+    sheet()->setCell("A1", "1");
+    sheet()->setAlias(App::CellAddress("A1"), "Start");
+    sheet()->setCell("A2", "=A1 + Start");
+    doc()->recompute();
+    std::string prefix = sheet()->getFullName() + ".";
+
+    // The name of the alias and the address it resolves to
+    auto deps = sheet()->dependsOn(App::CellAddress("A2"));
+    EXPECT_EQ(deps.count(prefix + "A1"), 1U);
+    EXPECT_EQ(deps.count(prefix + "Start"), 1U);
+    std::set<std::string> provides;
+    sheet()->providesTo(App::CellAddress("A1"), provides);
+    EXPECT_EQ(provides, std::set<std::string> {prefix + "A2"});
+
+    sheet()->setCell("A2", "2");
+    provides.clear();
+    sheet()->providesTo(App::CellAddress("A1"), provides);
+    EXPECT_TRUE(sheet()->dependsOn(App::CellAddress("A2")).empty());
+    EXPECT_TRUE(provides.empty());
+}
+
+TEST_F(SheetTest, recomputeCyclicCells)
+{
+    sheet()->setCell("A1", "=A2 + 1");
+    sheet()->setCell("A2", "=A1 + 1");
+    sheet()->setCell("B1", "2");
+    doc()->recompute();
+    EXPECT_TRUE(sheet()->getCell(App::CellAddress("A1"))->hasException());
+    EXPECT_TRUE(sheet()->getCell(App::CellAddress("A2"))->hasException());
+    EXPECT_FALSE(sheet()->getCell(App::CellAddress("B1"))->hasException());
+
+    // Breaking the cycle recovers both cells
+    sheet()->setCell("A2", "3");
+    doc()->recompute();
+    EXPECT_FALSE(sheet()->getCell(App::CellAddress("A1"))->hasException());
+    EXPECT_DOUBLE_EQ(value("A1"), 4.0);
+}
+
+TEST_F(SheetTest, recomputeParallelSameAsSerial)
+{
+    // Each row depends on column A only, the cells of a column are evaluated together
+    const int rows = 200;
+    const std::vector<std::string> formulas {"=A%1 * 1.5",
+                                             "=A%1 * 2 mm",
+                                             "=A%1 > 100",
+                                             "=B%1 / 4 + C%1 / 1mm",
+                                             "=A%1 < 50 ? B%1 : 2 ^ A%1",
+                                             "=D%1 * 1 mm / 2 mm",
+                                             "=A%1 / 0"};
+    auto setColumnA = [&](int offset) {
+        for (int row = 0; row < rows; ++row) {
+            sheet()->setCell(App::CellAddress(row, 0), std::to_string(row + offset).c_str());
+        }
+        doc()->recompute();
+    };
+    auto values = [&]() {
+        std::vector<std::string> result;
+        for (int row = 0; row < rows; ++row) {
+            for (int col = 1; col <= static_cast<int>(formulas.size()); ++col) {
+                result.push_back(repr(App::CellAddress(row, col)));
+            }
+        }
+        return result;
+    };
+    for (int row = 0; row < rows; ++row) {
+        for (std::size_t col = 0; col < formulas.size(); ++col) {
+            std::string contents = formulas[col];
+            std::string rowName = std::to_string(row + 1);
+            for (auto pos = contents.find("%1"); pos != std::string::npos;
+                 pos = contents.find("%1")) {
+                contents.replace(pos, 2, rowName);
+            }
+            sheet()->setCell(App::CellAddress(row, static_cast<int>(col) + 1), contents.c_str());
+        }
+    }
+
+    setParallelRecompute(false);
+    setColumnA(0);
+    auto serial = values();
+    EXPECT_EQ(sheet()->getParallelCellCount(), 0U);
+    setParallelRecompute(true);
+    setColumnA(1);
+    std::size_t updated = 0;
+    auto connection = sheet()->cellUpdated.connect([&](App::CellAddress) {
+        ++updated;
+    });
+    setColumnA(0);
+    auto parallel = values();
+    connection.disconnect();
+
+    // At least the plain numeric cells of columns B, C and E are evaluated in parallel
+    EXPECT_GE(sheet()->getParallelCellCount(), 3U * rows);
+    EXPECT_GE(updated, formulas.size() * rows);
+
+    ASSERT_EQ(serial.size(), parallel.size());
+    for (std::size_t i = 0; i < serial.size(); ++i) {
+        EXPECT_EQ(serial[i], parallel[i]);
+    }
+    EXPECT_TRUE(sheet()->getCell(App::CellAddress("H1"))->hasException());
+}
+
+TEST_F(SheetTest, DISABLED_benchmarkRecompute)
+{
+    // Chains of cells in 200 columns, each cell depending on the cell above it
+    const int rows = 200;
+    const int columns = 200;
+    for (int col = 0; col < columns; ++col) {
+        sheet()->setCell(App::CellAddress(0, col), "1");
+        for (int row = 1; row < rows; ++row) {
+            std::string contents = "=" + App::CellAddress(row - 1, col).toString() + " + 1";
+            sheet()->setCell(App::CellAddress(row, col), contents.c_str());
+        }
+    }
+    doc()->recompute();
+    // The estimate of the memory of the cells and their dependencies
+    auto cells = sheet()->getPropertyByName("cells");
+    ASSERT_NE(cells, nullptr);
+    std::cout << "memory: " << cells->getMemSize() / 1024 << " kB, " << rows * columns
+              << " cells" << std::endl;
+
+    for (bool parallel : {false, true}) {
+        setParallelRecompute(parallel);
+        auto start = std::chrono::steady_clock::now();
+        for (int col = 0; col < columns; ++col) {
+            sheet()->setCell(App::CellAddress(0, col), parallel ? "3" : "2");
+        }
+        doc()->recompute();
+        auto end = std::chrono::steady_clock::now();
+        std::cout << (parallel ? "parallel: " : "serial: ")
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count()
+                  << " ms, " << rows * columns << " cells" << std::endl;
+        EXPECT_DOUBLE_EQ(value("A200"), parallel ? 202.0 : 201.0);
+    }
+}
+
+// NOLINTEND(readability-magic-numbers)